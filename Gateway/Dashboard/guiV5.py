@@ -4,15 +4,17 @@ import tkinter as tk
 from tkinter import messagebox
 from tkinter import ttk 
 from PIL import Image, ImageTk
-import csv
 import os
 import smtplib
 from email.message import EmailMessage
 from datetime import datetime
 from collections import defaultdict
 
+import lwqms_native
+
 # ------------ Files and polling ------------
 CSV_PATH = "payloads.csv"
+STORE_PATH = "store"     # Telemetry store of lwqms_ingestd --store, for history; payloads.csv is read without it
 IMG_PATH = "lwqms_logo.png"
 POLL_MS = 5000
 bgcolor = "#82F4FF"
@@ -242,33 +244,24 @@ def open_settings_window():
 # ------------ History Window ------------
 
 def open_history_window(node_id):
-    """Open a window showing historical readings for the given node ID."""
-    if not os.path.exists(CSV_PATH):
-        messagebox.showerror("File Not Found", f"{CSV_PATH} not found.")
-        return
+    """Open a window showing historical readings for the given node ID, newest first.
 
-    # Read and extract history for the node
-    history_rows = []
+    Only the rows in view are read, a page at a time, so the window opens as
+    quickly after months of logging as on the first day.
+    """
     try:
-        with open(CSV_PATH, "r", encoding="utf-8", newline="") as f:
-            reader = csv.reader(f)
-            rows = list(reader)
-
-            for row in rows[1:]:  
-                if len(row) < 5:
-                    continue
-                timestamp = row[0]
-                this_node = str(row[1]).strip()
-                turb = row[2]
-                temp = row[3]
-                ph = row[4]
-
-                if this_node == node_id:
-                    history_rows.append((timestamp, ph, temp, turb))
+        history = lwqms_native.History(STORE_PATH, CSV_PATH)
+        count = history.seek(node_id)
+    except FileNotFoundError:
+        messagebox.showerror("File Not Found", f"{CSV_PATH} not found.")
+        return
     except Exception as e:
         messagebox.showerror("Error", f"Failed to read history: {e}")
         return
 
+    # What is in view: rows counted from the newest, and the time bounds
+    view = {"count": count, "top": 0, "rows": 1, "start": None, "end": None}
+
     # Create window
     win = tk.Toplevel(root)
     win.title(f"Node {node_id} History")
@@ -284,12 +277,26 @@ def open_history_window(node_id):
     )
     title.pack(pady=(10, 5))
 
+    # Time bounds
+    filter_frame = tk.Frame(win, bg=bgcolor)
+    filter_frame.pack(pady=(0, 5))
+
+    tk.Label(filter_frame, text="From", bg=bgcolor).pack(side="left")
+    from_entry = tk.Entry(filter_frame, width=18)
+    from_entry.pack(side="left", padx=(5, 10))
+
+    tk.Label(filter_frame, text="To", bg=bgcolor).pack(side="left")
+    to_entry = tk.Entry(filter_frame, width=18)
+    to_entry.pack(side="left", padx=(5, 10))
+
+    count_label = tk.Label(filter_frame, text="", bg=bgcolor)
+
     # Frame for Treeview + scrollbar
     table_frame = tk.Frame(win, bg=bgcolor)
     table_frame.pack(fill="both", expand=True, padx=10, pady=10)
 
     columns = ("time", "ph", "temp", "turb")
-    tree = ttk.Treeview(table_frame, columns=columns, show="headings", height=15)
+    tree = ttk.Treeview(table_frame, columns=columns, show="headings", height=1)
 
     tree.heading("time", text="Timestamp")
     tree.heading("ph", text="pH")
@@ -301,9 +308,8 @@ def open_history_window(node_id):
     tree.column("temp", width=140, anchor="center")
     tree.column("turb", width=140, anchor="center")
 
-    # Vertical scrollbar
-    vsb = ttk.Scrollbar(table_frame, orient="vertical", command=tree.yview)
-    tree.configure(yscrollcommand=vsb.set)
+    # Vertical scrollbar, over every row rather than the few in the Treeview
+    vsb = ttk.Scrollbar(table_frame, orient="vertical")
 
     tree.grid(row=0, column=0, sticky="nsew")
     vsb.grid(row=0, column=1, sticky="ns")
@@ -311,12 +317,117 @@ def open_history_window(node_id):
     table_frame.grid_rowconfigure(0, weight=1)
     table_frame.grid_columnconfigure(0, weight=1)
 
-    # Insert data (newest first)
-    for (timestamp, ph, temp, turb) in reversed(history_rows):
-        tree.insert("", "end", values=(format_timestamp(timestamp), ph, temp, turb))
+    def draw():
+        """Fill the Treeview with the rows in view."""
+        count, rows = view["count"], view["rows"]
+        view["top"] = top = max(0, min(view["top"], count - rows))
+
+        # Newest first, so the rows in view are a page ending `top` rows before the newest
+        first = max(0, count - top - rows)
+        page = list(reversed(history.page(first, count - top - first)))
+
+        items = tree.get_children()
+        if len(items) < rows:
+            for _ in range(rows - len(items)):
+                tree.insert("", "end", values=("", "", "", ""))
+        elif len(items) > rows:
+            tree.delete(*items[rows:])
+
+        for item, k in zip(tree.get_children(), range(rows)):
+            if k < len(page):
+                timestamp, ph, temp, turb = page[k]
+                tree.item(item, values=(format_timestamp(timestamp), ph, temp, turb))
+            else:
+                tree.item(item, values=("", "", "", ""))
+
+        if count > 0:
+            vsb.set(top / count, min(1.0, (top + rows) / count))
+        else:
+            vsb.set(0.0, 1.0)
+
+        count_label.config(text=f"{count} readings")
+
+    def scroll_to(top):
+        view["top"] = top
+        draw()
+
+    def on_scrollbar(*args):
+        if args[0] == "moveto":
+            scroll_to(int(float(args[1]) * view["count"]))
+        elif args[0] == "scroll":
+            step = view["rows"] if args[2] == "pages" else 1
+            scroll_to(view["top"] + int(args[1]) * step)
+
+    def on_wheel(event):
+        if event.num == 4:
+            scroll_to(view["top"] - 3)
+        elif event.num == 5:
+            scroll_to(view["top"] + 3)
+        else:
+            scroll_to(view["top"] - (event.delta // 120) * 3)
+        return "break"
+
+    def on_resize(event):
+        # Rows that fit, measured from a row once one is shown
+        items = tree.get_children()
+        bbox = tree.bbox(items[0]) if items else ""
+        header, row_height = (bbox[1], bbox[3]) if bbox else (25, 20)
+
+        rows = max(1, (event.height - header) // row_height)
+        if rows != view["rows"]:
+            view["rows"] = rows
+            draw()
+
+    def apply_bounds():
+        try:
+            start = datetime.fromisoformat(from_entry.get().strip()) if from_entry.get().strip() else None
+            end = datetime.fromisoformat(to_entry.get().strip()) if to_entry.get().strip() else None
+        except ValueError:
+            messagebox.showerror("Invalid Time", "Times are YYYY-MM-DD or YYYY-MM-DD HH:MM.", parent=win)
+            return
+
+        view["start"], view["end"] = start, end
+        view["count"] = history.seek(node_id, start, end)
+        scroll_to(0)
+
+    def poll():
+        """Show readings stored since, keeping the same rows in view unless at the newest."""
+        if not win.winfo_exists():
+            return
+
+        try:
+            count = history.seek(node_id, view["start"], view["end"])
+        except Exception:
+            count = view["count"]
+
+        if count != view["count"]:
+            if view["top"] > 0:
+                view["top"] += count - view["count"]
+            view["count"] = count
+            draw()
+
+        win.after(POLL_MS, poll)
+
+    apply_button = tk.Button(filter_frame, text="Apply", command=apply_bounds)
+    apply_button.pack(side="left", padx=(0, 10))
+    count_label.pack(side="left")
+
+    vsb.configure(command=on_scrollbar)
+    tree.bind("<Configure>", on_resize)
+    tree.bind("<MouseWheel>", on_wheel)
+    tree.bind("<Button-4>", on_wheel)
+    tree.bind("<Button-5>", on_wheel)
+    win.bind("<Prior>", lambda e: scroll_to(view["top"] - view["rows"]))
+    win.bind("<Next>", lambda e: scroll_to(view["top"] + view["rows"]))
+    win.bind("<Home>", lambda e: scroll_to(0))
+    win.bind("<End>", lambda e: scroll_to(view["count"]))
+    win.bind("<Destroy>", lambda e: history.close() if e.widget is win else None)
+
+    draw()
+    win.after(POLL_MS, poll)
 
     # If no data, show a message
-    if not history_rows:
+    if count == 0:
         messagebox.showinfo("No Data", f"No readings found for Node {node_id}.")
 
 
@@ -581,35 +692,18 @@ def refresh():
         if not os.path.exists(CSV_PATH):
             raise FileNotFoundError(f"{CSV_PATH} not found")
 
-        latest_by_node = {"1": None, "2": None}
-
-        with open(CSV_PATH, "r", encoding="utf-8", newline="") as f:
-            reader = csv.reader(f)
-            rows = list(reader)
-
-            if len(rows) > 1:
-                for row in rows[1:]:  # skip header
-                    if len(row) < 5:
-                        continue
-                    # CSV order: time, sensor node ID, turbidity, temp, pH
-                    timestamp, node_id, ph, temp, turb = row[0], row[1], row[4], row[3], row[2]
-                    node_id = str(node_id).strip()
-                    if node_id in latest_by_node:
-                        latest_by_node[node_id] = (timestamp, ph, temp, turb)
+        # Only the rows appended since the last refresh are read
+        payload_tail.poll()
+        latest_by_node = payload_tail.latest()
 
         # Update labels
-        update_node_labels("1", latest_by_node["1"])
-        update_node_labels("2", latest_by_node["2"])
-
-        # Check for alerts
-        if latest_by_node["1"]:
-            ts, ph, temp, turb = latest_by_node["1"]
-            check_alerts_for_node("1", ts, ph, temp, turb)
-            check_node_offline("1", ts)
-        if latest_by_node["2"]:
-            ts, ph, temp, turb = latest_by_node["2"]
-            check_alerts_for_node("2", ts, ph, temp, turb)
-            check_node_offline("2", ts)
+        update_node_labels("1", latest_by_node.get("1"))
+        update_node_labels("2", latest_by_node.get("2"))
+
+        # Check for alerts, for every node heard from
+        for node_id, (ts, ph, temp, turb) in latest_by_node.items():
+            check_alerts_for_node(node_id, ts, ph, temp, turb)
+            check_node_offline(node_id, ts)
 
         # Update status bar
         update_status_bar()
@@ -630,6 +724,7 @@ def refresh():
 
 
 # Start the periodic updates
+payload_tail = lwqms_native.PayloadTail(CSV_PATH)
 update_clock()
 refresh()
 root.mainloop()
@@ -0,0 +1,350 @@
+#!/usr/bin/env python3
+
+"""
+Access to liblwqms, the native host services library, from the dashboard.
+
+PayloadTail keeps its place in payloads.csv between polls, parses only the rows
+appended since the last one, and keeps the latest sample of every node, so a
+refresh costs the same after months of logging as on the first day.
+
+History pages through one node's samples, oldest first, within optional time
+bounds. From the telemetry store lwqms_ingestd writes with --store, a page
+costs the same however much history is kept. Without the store it falls back to
+payloads.csv, indexing where each of the node's rows starts on the first seek.
+
+liblwqms is built from "Gateway/Host Services/code" (cmake -S . -B build). It is
+looked for at $LWQMS_LIB, next to this file, and in that build directory. Without
+it, a slower reader in Python that works the same way is used instead.
+"""
+
+import bisect
+import csv
+import ctypes
+import os
+from datetime import datetime
+
+# ============================
+# Library loading
+# ============================
+
+_HERE = os.path.dirname(os.path.abspath(__file__))
+
+LIB_PATHS = [
+    os.environ.get("LWQMS_LIB", ""),
+    os.path.join(_HERE, "liblwqms.so"),
+    os.path.join(_HERE, "..", "Host Services", "code", "build", "liblwqms.so"),
+]
+
+TIME_TEXT_LEN = 40
+
+
+class _Latest(ctypes.Structure):
+    _fields_ = [
+        ("node_id", ctypes.c_uint16),
+        ("time_us", ctypes.c_int64),
+        ("time_text", ctypes.c_char * TIME_TEXT_LEN),
+        ("turbidity", ctypes.c_float),
+        ("temperature", ctypes.c_float),
+        ("ph", ctypes.c_float),
+        ("samples", ctypes.c_uint64),
+    ]
+
+
+class _Sample(ctypes.Structure):
+    _fields_ = [
+        ("time_us", ctypes.c_int64),
+        ("node_id", ctypes.c_uint16),
+        ("rssi_dbm", ctypes.c_int8),
+        ("snr_db", ctypes.c_int8),
+        ("link_valid", ctypes.c_uint8),
+        ("turbidity", ctypes.c_float),
+        ("temperature", ctypes.c_float),
+        ("ph", ctypes.c_float),
+    ]
+
+
+class _Cursor(ctypes.Structure):
+    _fields_ = [
+        ("node_id", ctypes.c_uint16),
+        ("from_us", ctypes.c_int64),
+        ("to_us", ctypes.c_int64),
+        ("first", ctypes.c_uint64),
+        ("count", ctypes.c_uint64),
+    ]
+
+
+INT64_MIN = -(2 ** 63)
+INT64_MAX = 2 ** 63 - 1
+
+
+def _load_library():
+    for path in LIB_PATHS:
+        if not path or not os.path.exists(path):
+            continue
+
+        lib = ctypes.CDLL(path)
+
+        lib.lwqms_tail_open.argtypes = [ctypes.c_char_p]
+        lib.lwqms_tail_open.restype = ctypes.c_void_p
+        lib.lwqms_tail_poll.argtypes = [ctypes.c_void_p]
+        lib.lwqms_tail_poll.restype = ctypes.c_int64
+        lib.lwqms_tail_latest.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Latest), ctypes.c_size_t]
+        lib.lwqms_tail_latest.restype = ctypes.c_size_t
+        lib.lwqms_tail_error.argtypes = [ctypes.c_void_p]
+        lib.lwqms_tail_error.restype = ctypes.c_char_p
+        lib.lwqms_tail_close.argtypes = [ctypes.c_void_p]
+        lib.lwqms_tail_close.restype = None
+
+        lib.lwqms_store_open.argtypes = [ctypes.c_char_p]
+        lib.lwqms_store_open.restype = ctypes.c_void_p
+        lib.lwqms_store_seek.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Cursor)]
+        lib.lwqms_store_seek.restype = ctypes.c_int
+        lib.lwqms_store_page.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Cursor), ctypes.c_uint64,
+                                         ctypes.POINTER(_Sample), ctypes.c_size_t]
+        lib.lwqms_store_page.restype = ctypes.c_int64
+        lib.lwqms_store_error.argtypes = [ctypes.c_void_p]
+        lib.lwqms_store_error.restype = ctypes.c_char_p
+        lib.lwqms_store_close.argtypes = [ctypes.c_void_p]
+        lib.lwqms_store_close.restype = None
+
+        return lib
+
+    return None
+
+
+lib = _load_library()
+
+# ============================
+# Incremental payloads.csv reader
+# ============================
+
+class _NativePayloadTail:
+    def __init__(self, path):
+        self._tail = lib.lwqms_tail_open(os.fsencode(path))
+        if not self._tail:
+            raise MemoryError("lwqms_tail_open failed")
+
+        self._buf = (_Latest * 64)()
+
+    def poll(self):
+        rows = lib.lwqms_tail_poll(self._tail)
+        if rows < 0:
+            raise OSError(lib.lwqms_tail_error(self._tail).decode())
+        return rows
+
+    def latest(self):
+        count = lib.lwqms_tail_latest(self._tail, self._buf, len(self._buf))
+
+        if count > len(self._buf):
+            self._buf = (_Latest * (count * 2))()
+            count = lib.lwqms_tail_latest(self._tail, self._buf, len(self._buf))
+
+        return {
+            str(s.node_id): (s.time_text.decode(), s.ph, s.temperature, s.turbidity)
+            for s in self._buf[:count]
+        }
+
+    def close(self):
+        if self._tail:
+            lib.lwqms_tail_close(self._tail)
+            self._tail = None
+
+    def __del__(self):
+        self.close()
+
+
+class _PythonPayloadTail:
+    def __init__(self, path):
+        self._path = path
+        self._offset = 0
+        self._ident = None
+        self._latest = {}
+
+    def poll(self):
+        st = os.stat(self._path)
+
+        # Rotated, replaced or cut short: start again from the top
+        if (st.st_dev, st.st_ino) != self._ident or st.st_size < self._offset:
+            self._ident = (st.st_dev, st.st_ino)
+            self._offset = 0
+            self._latest = {}
+
+        with open(self._path, "rb") as f:
+            f.seek(self._offset)
+            data = f.read(st.st_size - self._offset)
+
+        # Whole lines only; a row still being written waits for the next poll
+        end = data.rfind(b"\n") + 1
+        self._offset += end
+
+        rows = 0
+        for row in csv.reader(data[:end].decode("utf-8", "replace").splitlines()):
+            if len(row) < 5:
+                continue
+            try:
+                node_id = str(int(row[1]))
+                ph, temp, turb = float(row[4]), float(row[3]), float(row[2])
+            except ValueError:
+                continue     # the header
+            self._latest[node_id] = (row[0].strip(), ph, temp, turb)
+            rows += 1
+
+        return rows
+
+    def latest(self):
+        return dict(self._latest)
+
+    def close(self):
+        pass
+
+
+def PayloadTail(path):
+    """
+    Incremental reader of a payloads.csv file.
+
+    poll() reads the rows appended since the last poll and returns how many there
+    were. latest() returns {node_id: (timestamp, ph, temp, turb)} for every node
+    seen, node IDs as strings, as the dashboard has always keyed them.
+    """
+    if lib is not None:
+        return _NativePayloadTail(path)
+    return _PythonPayloadTail(path)
+
+
+# ============================
+# Paged history of a node
+# ============================
+
+def _to_us(dt, default):
+    return default if dt is None else int(dt.timestamp() * 1000000)
+
+
+def _iso_time(time_us):
+    return datetime.fromtimestamp(time_us // 1000000).replace(microsecond=time_us % 1000000).isoformat()
+
+
+class _StoreHistory:
+    def __init__(self, store_dir):
+        self._store = lib.lwqms_store_open(os.fsencode(store_dir))
+        if not self._store:
+            raise MemoryError("lwqms_store_open failed")
+
+        self._cursor = _Cursor()
+        self._buf = (_Sample * 256)()
+
+    def seek(self, node_id, start=None, end=None):
+        self._cursor.node_id = int(node_id)
+        self._cursor.from_us = _to_us(start, INT64_MIN)
+        self._cursor.to_us = _to_us(end, INT64_MAX)
+
+        if lib.lwqms_store_seek(self._store, ctypes.byref(self._cursor)) < 0:
+            raise OSError(lib.lwqms_store_error(self._store).decode())
+        return self._cursor.count
+
+    def page(self, offset, count):
+        if count > len(self._buf):
+            self._buf = (_Sample * count)()
+
+        got = lib.lwqms_store_page(self._store, ctypes.byref(self._cursor), offset, self._buf, count)
+        if got < 0:
+            raise OSError(lib.lwqms_store_error(self._store).decode())
+
+        # As payloads.csv would have them
+        return [
+            (_iso_time(s.time_us), f"{s.ph:.7g}", f"{s.temperature:.7g}", f"{s.turbidity:.7g}")
+            for s in self._buf[:got]
+        ]
+
+    def close(self):
+        if self._store:
+            lib.lwqms_store_close(self._store)
+            self._store = None
+
+    def __del__(self):
+        self.close()
+
+
+class _CsvHistory:
+    def __init__(self, path):
+        self._path = path
+        self._offset = 0
+        self._ident = None
+        self._node = None
+        self._times = []        # Timestamp of each of the node's rows, as written
+        self._starts = []       # Where each of them starts in the file
+        self._first = 0
+        self._count = 0
+
+    def _scan(self):
+        st = os.stat(self._path)
+
+        if (st.st_dev, st.st_ino) != self._ident or st.st_size < self._offset:
+            self._ident = (st.st_dev, st.st_ino)
+            self._offset = 0
+            self._times = []
+            self._starts = []
+
+        with open(self._path, "rb") as f:
+            f.seek(self._offset)
+            data = f.read(st.st_size - self._offset)
+
+        end = data.rfind(b"\n") + 1
+        node = self._node.encode()
+        pos = 0
+
+        # Only the first two fields of a row are looked at
+        while pos < end:
+            nl = data.index(b"\n", pos)
+            fields = data[pos:nl].split(b",", 2)
+            if len(fields) > 2 and fields[1].strip() == node:
+                self._times.append(fields[0].strip().decode())
+                self._starts.append(self._offset + pos)
+            pos = nl + 1
+
+        self._offset += end
+
+    def seek(self, node_id, start=None, end=None):
+        if str(node_id) != self._node:
+            self._node = str(node_id)
+            self._offset = 0
+            self._ident = None
+        self._scan()
+
+        # ISO timestamps of equal length sort as text
+        lo = 0 if start is None else bisect.bisect_left(self._times, start.isoformat())
+        hi = len(self._times) if end is None else bisect.bisect_left(self._times, end.isoformat())
+
+        self._first = lo
+        self._count = max(0, hi - lo)
+        return self._count
+
+    def page(self, offset, count):
+        lo = self._first + offset
+        hi = self._first + min(offset + count, self._count)
+        rows = []
+
+        with open(self._path, "rb") as f:
+            for start in self._starts[lo:hi]:
+                f.seek(start)
+                row = f.readline().decode("utf-8", "replace").strip().split(",")
+                rows.append((row[0].strip(), row[4], row[3], row[2]))
+
+        return rows
+
+    def close(self):
+        pass
+
+
+def History(store_dir, csv_path):
+    """
+    Paged history of one node at a time.
+
+    seek(node_id, start=None, end=None) finds the node's samples with
+    start <= time < end, datetimes in local time, and returns how many there are.
+    Seeking again picks up samples stored since. page(offset, count) then returns
+    [(timestamp, ph, temp, turb)] of those at [offset, offset + count), oldest
+    first.
+    """
+    if lib is not None and os.path.exists(os.path.join(store_dir, "store.meta")):
+        return _StoreHistory(store_dir)
+    return _CsvHistory(csv_path)
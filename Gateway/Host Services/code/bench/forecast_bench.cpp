@@ -0,0 +1,295 @@
+/*************************************************************************************
+ *
+ * @file forecast_bench.cpp
+ *
+ * @brief Benchmark of the forecast engine. Forecasts from made-up histories of every node, one after another as the host
+ *        would, and reports the latency of each forecast. The model is also run by plain loops straight over the ONNX
+ *        weights, to check the engine's forecasts against and to time alongside, when it is one LSTM and one fully
+ *        connected layer, as the water quality model is.
+ *
+ *        lwqms_forecast_bench [--model FILE] [--history N] [--horizon N] [--forecasts N] [--seed N]
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/forecast.hpp"
+#include "lwqms/onnx.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define BENCH_DEFAULT_HISTORY 92            // Steps of each training sequence: 46 hours of half-hourly samples
+#define BENCH_DEFAULT_HORIZON 4             // Two hours ahead
+#define BENCH_DEFAULT_FORECASTS 2000
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+    std::string model = LWQMS_MODEL_PATH;
+    size_t history = BENCH_DEFAULT_HISTORY;
+    size_t horizon = BENCH_DEFAULT_HORIZON;
+    size_t forecasts = BENCH_DEFAULT_FORECASTS;
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief The model run by plain loops over its ONNX weights, in the order the operators define, with nothing packed.
+ */
+class ReferenceModel {
+public:
+    /**
+     * @returns False if the model is not one LSTM and a fully connected layer
+     */
+    bool load(const lwqms::OnnxGraph &graph, const lwqms::ForecastModel &model) {
+        const auto &layers = model.layers();
+        if ((layers.size() != 2) || (layers[0].kind != lwqms::ForecastLayer::kLstm) || (layers[1].kind != lwqms::ForecastLayer::kDense)) return false;
+
+        for (const lwqms::OnnxNode &node : graph.nodes) {
+            if (node.op_type == "LSTM") {
+                w_ = graph.initializer(node.input(1))->floats;
+                r_ = graph.initializer(node.input(2))->floats;
+                b_ = graph.initializer(node.input(3))->floats;
+            }
+            else if (node.op_type == "MatMul") {
+                fc_w_ = graph.initializer(node.input(1))->floats;
+            }
+            else if (node.op_type == "Add") {
+                fc_b_ = graph.initializer(node.input(1))->floats;
+            }
+        }
+
+        in_ = layers[0].inputs;
+        hidden_ = layers[0].outputs;
+        out_ = layers[1].outputs;
+        h0_.assign(layers[0].initial_h.data(), layers[0].initial_h.data() + hidden_);
+        c0_.assign(layers[0].initial_c.data(), layers[0].initial_c.data() + hidden_);
+        norm_ = model.normalization();
+
+        return !fc_b_.empty();
+    }
+
+    void forecast(const float *history, size_t steps, size_t horizon, float *out) {
+        h_ = h0_;
+        c_ = c0_;
+
+        for (size_t t = 0; t < steps; t++) step(history + (t * in_), out);
+        for (size_t t = 1; t < horizon; t++) step(out + ((t - 1) * out_), out + (t * out_));
+    }
+
+private:
+    static float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+    void step(const float *in, float *out) {
+        std::vector<float> x(in_), gates(4 * hidden_);
+
+        for (size_t k = 0; k < in_; k++) x[k] = (in[k] - norm_.input_mean[k]) / norm_.input_std[k];
+
+        for (size_t g = 0; g < 4 * hidden_; g++) {
+            float sum = b_[g] + b_[(4 * hidden_) + g];
+
+            for (size_t k = 0; k < in_; k++) sum += w_[(g * in_) + k] * x[k];
+            for (size_t k = 0; k < hidden_; k++) sum += r_[(g * hidden_) + k] * h_[k];
+
+            gates[g] = sum;
+        }
+
+        for (size_t k = 0; k < hidden_; k++) {
+            float i = sigmoid(gates[k]);
+            float o = sigmoid(gates[hidden_ + k]);
+            float f = sigmoid(gates[(2 * hidden_) + k]);
+            float g = std::tanh(gates[(3 * hidden_) + k]);
+
+            c_[k] = (f * c_[k]) + (i * g);
+            h_[k] = o * std::tanh(c_[k]);
+        }
+
+        for (size_t j = 0; j < out_; j++) {
+            float sum = fc_b_[j];
+            for (size_t k = 0; k < hidden_; k++) sum += h_[k] * fc_w_[(k * out_) + j];
+
+            out[j] = (sum * norm_.output_std[j]) + norm_.output_mean[j];
+        }
+    }
+
+    size_t in_ = 0, hidden_ = 0, out_ = 0;
+    std::vector<float> w_, r_, b_, fc_w_, fc_b_, h0_, c0_, h_, c_;
+    lwqms::Normalization norm_;
+};
+
+/**
+ * @brief Makes up histories: each channel wanders about its mean, as a node's readings do.
+ */
+std::vector<float> make_histories(const BenchConfig &cfg, const lwqms::Normalization &norm) {
+    std::mt19937 rng(cfg.seed);
+    std::normal_distribution<float> noise(0.0f, 0.1f);
+    std::vector<float> all(cfg.forecasts * cfg.history * lwqms::kChannels);
+
+    for (size_t f = 0; f < cfg.forecasts; f++) {
+        float level[lwqms::kChannels];
+        for (size_t c = 0; c < lwqms::kChannels; c++) level[c] = noise(rng) * 5.0f;
+
+        for (size_t t = 0; t < cfg.history; t++) {
+            for (size_t c = 0; c < lwqms::kChannels; c++) {
+                level[c] = (0.98f * level[c]) + noise(rng);
+                all[(((f * cfg.history) + t) * lwqms::kChannels) + c] = norm.input_mean[c] + (level[c] * norm.input_std[c]);
+            }
+        }
+    }
+
+    return all;
+}
+
+struct Latency {
+    double mean_us, median_us, p99_us, min_us;
+};
+
+Latency summarize(std::vector<double> &us) {
+    std::sort(us.begin(), us.end());
+
+    double sum = 0;
+    for (double u : us) sum += u;
+
+    return {sum / us.size(), us[us.size() / 2], us[std::min(us.size() - 1, (us.size() * 99) / 100)], us.front()};
+}
+
+void print_latency(const char *label, const Latency &latency, size_t steps) {
+    std::printf("  %-13s %8.1f us mean, %8.1f us median, %8.1f us p99, %8.1f us min; %.2f us a step\n", label, latency.mean_us, latency.median_us,
+        latency.p99_us, latency.min_us, latency.mean_us / steps);
+}
+
+void print_usage(const char *argv0) {
+    std::printf("Usage: %s [options]\n\n", argv0);
+    std::printf("  --model FILE      ONNX model (default %s)\n", LWQMS_MODEL_PATH);
+    std::printf("  --history N       Steps of history each forecast is run over (default %d)\n", BENCH_DEFAULT_HISTORY);
+    std::printf("  --horizon N       Steps forecast past the history (default %d)\n", BENCH_DEFAULT_HORIZON);
+    std::printf("  --forecasts N     Forecasts to time, each from a history of its own (default %d)\n", BENCH_DEFAULT_FORECASTS);
+    std::printf("  --seed N          Seed of the made-up histories (default 1)\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchConfig cfg;
+
+    for (int k = 1; k < argc; k++) {
+        bool has_value = (k + 1 < argc);
+
+        if ((std::strcmp(argv[k], "--model") == 0) && has_value) cfg.model = argv[++k];
+        else if ((std::strcmp(argv[k], "--history") == 0) && has_value) cfg.history = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--horizon") == 0) && has_value) cfg.horizon = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--forecasts") == 0) && has_value) cfg.forecasts = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--seed") == 0) && has_value) cfg.seed = std::strtoul(argv[++k], nullptr, 10);
+        else {
+            print_usage(argv[0]);
+            return (std::strcmp(argv[k], "--help") == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if ((cfg.history == 0) || (cfg.horizon == 0) || (cfg.forecasts == 0)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto load_start = Clock::now();
+    lwqms::OnnxGraph graph;
+    std::unique_ptr<lwqms::ForecastModel> model;
+
+    try {
+        graph = lwqms::load_onnx(cfg.model);
+        model = std::make_unique<lwqms::ForecastModel>(graph);
+        model->set_normalization(lwqms::water_quality_normalization());
+    }
+    catch (const std::exception &err) {
+        std::fprintf(stderr, "%s\n", err.what());
+        return EXIT_FAILURE;
+    }
+
+    double load_ms = std::chrono::duration<double, std::milli>(Clock::now() - load_start).count();
+
+    if ((model->inputs() != lwqms::kChannels) || (model->outputs() != lwqms::kChannels)) {
+        std::fprintf(stderr, "%s is not a water quality model: %zu inputs, %zu outputs\n", cfg.model.c_str(), model->inputs(), model->outputs());
+        return EXIT_FAILURE;
+    }
+
+    std::vector<float> histories = make_histories(cfg, model->normalization());
+    std::vector<float> forecasts(cfg.forecasts * cfg.horizon * lwqms::kChannels);
+    std::vector<double> engine_us(cfg.forecasts);
+    lwqms::ForecastState state = model->make_state();
+    size_t per_history = cfg.history * lwqms::kChannels;
+    size_t per_forecast = cfg.horizon * lwqms::kChannels;
+
+    // A few first, so the weights are in cache as they would be on a host forecasting every node in turn
+    for (size_t f = 0; f < std::min<size_t>(cfg.forecasts, 10); f++) {
+        model->forecast(state, &histories[f * per_history], cfg.history, cfg.horizon, &forecasts[f * per_forecast]);
+    }
+
+    for (size_t f = 0; f < cfg.forecasts; f++) {
+        auto start = Clock::now();
+        model->forecast(state, &histories[f * per_history], cfg.history, cfg.horizon, &forecasts[f * per_forecast]);
+        engine_us[f] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    size_t steps = cfg.history + cfg.horizon - 1;
+    size_t weights = 0;
+    for (const auto &[name, tensor] : graph.initializers) weights += tensor.floats.size();
+
+    std::printf("Forecast bench: %s\n", cfg.model.c_str());
+    std::printf("  Model:         %zu layers, %zu weights, loaded in %.1f ms\n", model->layers().size(), weights, load_ms);
+    std::printf("  Kernels:       %s, %zu-row panels\n", lwqms::simd_name(), lwqms::panel_rows());
+    std::printf("  Forecasts:     %zu, each %zu steps of history then %zu ahead\n", cfg.forecasts, cfg.history, cfg.horizon);
+
+    Latency engine = summarize(engine_us);
+    print_latency("Engine:", engine, steps);
+
+    ReferenceModel reference;
+
+    if (reference.load(graph, *model)) {
+        std::vector<float> expected(per_forecast);
+        std::vector<double> reference_us(cfg.forecasts);
+        double max_error = 0;
+
+        for (size_t f = 0; f < cfg.forecasts; f++) {
+            auto start = Clock::now();
+            reference.forecast(&histories[f * per_history], cfg.history, cfg.horizon, expected.data());
+            reference_us[f] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+            for (size_t k = 0; k < per_forecast; k++) {
+                size_t channel = k % lwqms::kChannels;
+                double error = std::fabs(expected[k] - forecasts[(f * per_forecast) + k]) / model->normalization().output_std[channel];
+                max_error = std::max(max_error, error);
+            }
+        }
+
+        Latency plain = summarize(reference_us);
+        print_latency("Plain loops:", plain, steps);
+        std::printf("  Speedup:       %.1fx\n", plain.mean_us / engine.mean_us);
+        std::printf("  Difference:    %.2g standard deviations at most, over every forecast step\n", max_error);
+    }
+
+    std::printf("  First:        ");
+    for (size_t t = 0; t < cfg.horizon; t++) {
+        const float *y = &forecasts[t * lwqms::kChannels];
+        std::printf(" %s%.2f C, pH %.3f, %.2f NTU", (t > 0) ? "->" : "", y[lwqms::kChannelTemperature], y[lwqms::kChannelPH], y[lwqms::kChannelTurbidity]);
+    }
+    std::printf("\n");
+
+    return EXIT_SUCCESS;
+}
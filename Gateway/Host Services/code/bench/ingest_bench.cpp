@@ -0,0 +1,333 @@
+/*************************************************************************************
+ *
+ * @file ingest_bench.cpp
+ *
+ * @brief Benchmark of the ingestion path. Replays a gateway's record stream as fast as it can be taken in, through the
+ *        ingestor and into CSV files, and reports how many times faster than real time that is. The stream is a capture
+ *        made by lwqms_ingestd --record, or traffic made up for a network of many nodes, each sending on a fixed interval.
+ *        The Python logger's way of storing rows, a file opened, appended to and closed per row, can be measured alongside.
+ *
+ *        lwqms_ingest_bench [--nodes N] [--hours H] [--interval S] [--batch K] [--dup P] [--replay FILE] [--save FILE]
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/cobs.hpp"
+#include "lwqms/csv_sink.hpp"
+#include "lwqms/ingest.hpp"
+#include "lwqms/tsdb.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define BENCH_DEFAULT_NODES 300
+#define BENCH_DEFAULT_HOURS 24
+#define BENCH_DEFAULT_INTERVAL_S 60
+#define BENCH_FIRST_NODE_ID 10
+#define BENCH_GATEWAY_ID 1
+#define BENCH_READ_LEN 4096             // Bytes per read, as the daemon reads the serial port
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+struct BenchConfig {
+    uint32_t nodes = BENCH_DEFAULT_NODES;
+    double hours = BENCH_DEFAULT_HOURS;
+    uint32_t interval_s = BENCH_DEFAULT_INTERVAL_S;
+    uint32_t batch = 1;                 // Samples per packet
+    double dup = 0;                     // Chance a packet arrives a second time
+    uint32_t sync_rows = lwqms::IngestOptions{}.sync_rows;
+    uint32_t seed = 1;
+    bool naive = false;
+    bool store = false;
+    const char *replay = nullptr;
+    const char *save = nullptr;
+    std::string out_dir;
+};
+
+/**
+ * @brief Stores rows as lwqms_logger_v2.py did: opens the file, appends one row and closes it again, for every row.
+ */
+class ReopenSink : public lwqms::Sink {
+public:
+    explicit ReopenSink(const std::string &directory) : payloads_(directory + "/payloads.csv"), messages_(directory + "/messages.csv") {}
+
+    void write(const lwqms::SampleRow &row) override {
+        FILE *f = std::fopen(payloads_.c_str(), "a");
+        if (f == nullptr) return;
+
+        std::fprintf(f, "%.6f,%u,%g,%g,%g\r\n", row.time_us / 1e6, row.node_id, row.turbidity, row.temperature, row.pH);
+        std::fclose(f);
+    }
+
+    void write(const lwqms::MessageRow &row) override {
+        FILE *f = std::fopen(messages_.c_str(), "a");
+        if (f == nullptr) return;
+
+        std::fprintf(f, "%.6f,%u,%s\r\n", row.time_us / 1e6, row.node_id, row.text.c_str());
+        std::fclose(f);
+    }
+
+    void flush(bool) override {}
+
+private:
+    std::string payloads_;
+    std::string messages_;
+};
+
+/**
+ * @brief Makes up the stream a gateway would write for `cfg.nodes` nodes sending for `cfg.hours`. Each node sends at its
+ * own random point in each packet period, and its readings wander a little from one sample to the next.
+ *
+ * @returns Span of the stream, in gateway time
+ */
+uint64_t generate_stream(const BenchConfig &cfg, std::vector<uint8_t> &stream) {
+    std::mt19937 rng(cfg.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<float> wander(0.0f, 0.05f);
+
+    struct NodeState {
+        uint64_t next_us;
+        uint16_t pkt_id;
+        float turbidity, temperature, pH;
+    };
+
+    uint64_t interval_us = static_cast<uint64_t>(cfg.interval_s) * 1000000;
+    uint64_t packet_us = interval_us * cfg.batch;
+    uint64_t end_us = static_cast<uint64_t>(cfg.hours * 3600e6);
+
+    std::vector<NodeState> nodes(cfg.nodes);
+    for (NodeState &node : nodes) {
+        node = {static_cast<uint64_t>(unit(rng) * packet_us), 0, 5.0f, 15.0f, 7.0f};
+    }
+
+    lwqms::Record record = {};
+    record.type = lwqms::RecordType::Packet;
+
+    lwqms::PacketRecord &pkt = record.packet;
+    pkt.flags = lwqms::kRecordFlagLink | lwqms::kRecordFlagSamples;
+    pkt.packet_type = static_cast<uint8_t>((cfg.batch > 1) ? lwqms::PacketType::TelemetryBatch : lwqms::PacketType::Telemetry);
+    pkt.dest_id = BENCH_GATEWAY_ID;
+    pkt.qty_samples = static_cast<uint8_t>(cfg.batch);
+
+    std::vector<uint8_t> buf;
+
+    // The gateway writes packets in the order it received them, so each period's nodes are sent in order of their offsets.
+    std::vector<size_t> order(nodes.size());
+    for (size_t id = 0; id < order.size(); id++) order[id] = id;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return nodes[a].next_us < nodes[b].next_us; });
+
+    for (uint64_t period_us = 0; period_us < end_us; period_us += packet_us) {
+        for (size_t id : order) {
+            NodeState &node = nodes[id];
+
+            pkt.src_id = static_cast<uint16_t>(BENCH_FIRST_NODE_ID + id);
+            pkt.pkt_id = node.pkt_id++;
+            pkt.rx_time_us = period_us + node.next_us;
+            pkt.rssi_pkt_dbm = static_cast<int8_t>(-70 - static_cast<int>(id % 50));
+            pkt.snr_pkt_db = static_cast<int8_t>(10 - static_cast<int>(id % 20));
+            pkt.signal_rssi_pkt_dbm = pkt.rssi_pkt_dbm;
+
+            for (uint32_t k = 0; k < cfg.batch; k++) {
+                node.turbidity += wander(rng);
+                node.temperature += wander(rng);
+                node.pH += wander(rng) * 0.1f;
+
+                pkt.samples[k] = {static_cast<uint16_t>((cfg.batch - 1 - k) * cfg.interval_s), node.turbidity, node.temperature, node.pH};
+            }
+
+            // The samples as they went over the air: three floats each.
+            pkt.payload_len = static_cast<uint8_t>(cfg.batch * 12);
+            std::memcpy(pkt.payload.data(), pkt.samples.data(), pkt.payload_len);
+
+            buf.clear();
+            lwqms::encode_record(record, buf);
+
+            size_t start = stream.size();
+            lwqms::cobs_encode(buf.data(), buf.size(), stream);
+
+            if (unit(rng) < cfg.dup) {
+                std::vector<uint8_t> frame(stream.begin() + start, stream.end());
+                stream.insert(stream.end(), frame.begin(), frame.end());
+            }
+        }
+    }
+
+    return end_us;
+}
+
+/**
+ * @returns Span of a captured stream in gateway time, from its first packet to its last
+ */
+uint64_t stream_span(const std::vector<uint8_t> &stream) {
+    lwqms::RecordStream records;
+    uint64_t first_us = UINT64_MAX, last_us = 0;
+
+    records.feed(stream.data(), stream.size(), [&](const lwqms::Record &record) {
+        if (record.type != lwqms::RecordType::Packet) return;
+
+        if (record.packet.rx_time_us < first_us) first_us = record.packet.rx_time_us;
+        if (record.packet.rx_time_us > last_us) last_us = record.packet.rx_time_us;
+    });
+
+    return (last_us > first_us) ? (last_us - first_us) : 0;
+}
+
+void print_usage(const char *argv0) {
+    std::printf("Usage: %s [options]\n\n", argv0);
+    std::printf("  --nodes N         Nodes sending to the gateway (default %d)\n", BENCH_DEFAULT_NODES);
+    std::printf("  --hours H         Hours of traffic (default %d)\n", BENCH_DEFAULT_HOURS);
+    std::printf("  --interval S      Seconds between a node's samples (default %d)\n", BENCH_DEFAULT_INTERVAL_S);
+    std::printf("  --batch K         Samples per packet (default 1)\n");
+    std::printf("  --dup P           Chance each packet arrives twice (default 0)\n");
+    std::printf("  --seed N          Seed of the made-up traffic (default 1)\n");
+    std::printf("  --replay FILE     Replay a capture instead of made-up traffic\n");
+    std::printf("  --save FILE       Save the stream, for lwqms_ingestd --replay\n");
+    std::printf("  --out DIR         Directory for the CSV files (default: a new one under /tmp, removed afterwards)\n");
+    std::printf("  --sync-rows N     Rows between durable flushes (default %u)\n", lwqms::IngestOptions{}.sync_rows);
+    std::printf("  --store           Store rows in a telemetry store rather than CSV files\n");
+    std::printf("  --naive           Store rows as the Python logger did, opening and closing the file for each\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchConfig cfg;
+
+    for (int k = 1; k < argc; k++) {
+        bool has_value = (k + 1 < argc);
+
+        if ((std::strcmp(argv[k], "--nodes") == 0) && has_value) cfg.nodes = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--hours") == 0) && has_value) cfg.hours = std::strtod(argv[++k], nullptr);
+        else if ((std::strcmp(argv[k], "--interval") == 0) && has_value) cfg.interval_s = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--batch") == 0) && has_value) cfg.batch = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--dup") == 0) && has_value) cfg.dup = std::strtod(argv[++k], nullptr);
+        else if ((std::strcmp(argv[k], "--seed") == 0) && has_value) cfg.seed = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--replay") == 0) && has_value) cfg.replay = argv[++k];
+        else if ((std::strcmp(argv[k], "--save") == 0) && has_value) cfg.save = argv[++k];
+        else if ((std::strcmp(argv[k], "--out") == 0) && has_value) cfg.out_dir = argv[++k];
+        else if ((std::strcmp(argv[k], "--sync-rows") == 0) && has_value) cfg.sync_rows = std::strtoul(argv[++k], nullptr, 10);
+        else if (std::strcmp(argv[k], "--naive") == 0) cfg.naive = true;
+        else if (std::strcmp(argv[k], "--store") == 0) cfg.store = true;
+        else {
+            print_usage(argv[0]);
+            return (std::strcmp(argv[k], "--help") == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if ((cfg.nodes == 0) || (cfg.interval_s == 0) || (cfg.batch == 0) || (cfg.batch > lwqms::kSamplesMax)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> stream;
+    uint64_t span_us;
+
+    if (cfg.replay != nullptr) {
+        std::ifstream in(cfg.replay, std::ios::binary);
+
+        if (!in) {
+            std::perror(cfg.replay);
+            return EXIT_FAILURE;
+        }
+
+        stream.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        span_us = stream_span(stream);
+    }
+    else {
+        span_us = generate_stream(cfg, stream);
+    }
+
+    if (cfg.save != nullptr) {
+        std::ofstream(cfg.save, std::ios::binary).write(reinterpret_cast<const char *>(stream.data()), static_cast<std::streamsize>(stream.size()));
+    }
+
+    bool temp_dir = cfg.out_dir.empty();
+    if (temp_dir) {
+        char dir_template[] = "/tmp/lwqms_ingest_bench_XXXXXX";
+
+        if (::mkdtemp(dir_template) == nullptr) {
+            std::perror("mkdtemp");
+            return EXIT_FAILURE;
+        }
+
+        cfg.out_dir = dir_template;
+    }
+
+    lwqms::IngestOptions options;
+    options.live = false;
+    options.sync_rows = cfg.sync_rows;
+
+    lwqms::IngestStats stats;
+    double wall_s;
+
+    try {
+        std::unique_ptr<lwqms::Sink> sink;
+
+        if (cfg.store) sink = std::make_unique<lwqms::TelemetrySink>(cfg.out_dir + "/store");
+        else if (cfg.naive) sink = std::make_unique<ReopenSink>(cfg.out_dir);
+        else sink = std::make_unique<lwqms::CsvSink>(cfg.out_dir);
+
+        lwqms::Ingestor ingestor(*sink, options);
+
+        int64_t host_now_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t offset = 0; offset < stream.size(); offset += BENCH_READ_LEN) {
+            size_t len = std::min(static_cast<size_t>(BENCH_READ_LEN), stream.size() - offset);
+            ingestor.feed(stream.data() + offset, len, host_now_us);
+        }
+
+        ingestor.sync();
+
+        wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats = ingestor.stats();
+    }
+    catch (const std::exception &err) {
+        std::fprintf(stderr, "%s\n", err.what());
+        return EXIT_FAILURE;
+    }
+
+    if (temp_dir) {
+        std::error_code ignored;
+        std::filesystem::remove_all(cfg.out_dir, ignored);
+    }
+
+    uint64_t rows = stats.samples + stats.messages + stats.undecoded;
+
+    std::printf("Ingestion bench: %s, %s\n", (cfg.replay != nullptr) ? cfg.replay : "made-up traffic",
+        cfg.store ? "telemetry store, batched sync" : (cfg.naive ? "file reopened per row" : "CSV sink, batched sync"));
+    if (cfg.replay == nullptr) {
+        std::printf("  %u nodes, %u samples each per packet, one sample every %u s, %.1f h\n", cfg.nodes, cfg.batch, cfg.interval_s, cfg.hours);
+    }
+    std::printf("  Stream:       %zu bytes, %" PRIu64 " packets (%" PRIu64 " duplicates), %.1f h of gateway time\n", stream.size(), stats.packets,
+        stats.duplicates, span_us / 3600e6);
+    std::printf("  Stored:       %" PRIu64 " rows", rows);
+    if (!cfg.naive) std::printf(", %" PRIu64 " durable flushes", stats.syncs);
+    std::printf("\n");
+    std::printf("  Wall time:    %.3f s\n", wall_s);
+    std::printf("  Throughput:   %.0f packets/s, %.0f rows/s, %.1f MB/s\n", stats.packets / wall_s, rows / wall_s, stream.size() / wall_s / 1e6);
+    std::printf("  Real time:    %.0fx\n", (span_us / 1e6) / wall_s);
+
+    return EXIT_SUCCESS;
+}
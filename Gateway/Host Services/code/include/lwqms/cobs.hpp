@@ -0,0 +1,94 @@
+/*************************************************************************************
+ *
+ * @file cobs.hpp
+ *
+ * @brief Consistent Overhead Byte Stuffing, and a deframer that splits the gateway's byte stream into records
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_COBS_HPP
+#define LWQMS_COBS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lwqms {
+
+/**
+ * @brief Frames a record: the frame holds no zero byte except the one that ends it.
+ *
+ * @param record Record to frame
+ * @param len Length of the record
+ * @param frame Vector to which the frame is appended, its closing zero included
+ */
+void cobs_encode(const uint8_t *record, size_t len, std::vector<uint8_t> &frame);
+
+/**
+ * @brief Undoes the byte stuffing of one frame.
+ *
+ * @param frame Frame without its closing zero
+ * @param len Length of the frame
+ * @param record Buffer to which the record will be written. `len` bytes always fit, and it may be `frame` itself.
+ *
+ * @returns Length of the record, or 0 if the frame is not valid COBS
+ */
+size_t cobs_decode(const uint8_t *frame, size_t len, uint8_t *record);
+
+/**
+ * @brief Splits a byte stream into records at each zero byte. Bytes may be fed in pieces of any size: a frame split across
+ * two reads is put back together.
+ */
+class Deframer {
+public:
+    /**
+     * @param max_record Longest record expected. A longer frame is thrown away up to its closing zero.
+     */
+    explicit Deframer(size_t max_record);
+
+    /**
+     * @brief Feeds bytes from the stream, calling `on_record(const uint8_t *record, size_t len)` for each whole frame.
+     * The record is only valid during the call.
+     */
+    template <typename OnRecord>
+    void feed(const uint8_t *data, size_t len, OnRecord &&on_record) {
+        for (size_t k = 0; k < len; k++) {
+            uint8_t byte = data[k];
+
+            if (byte != 0x00) {
+                if (fill_ < buf_.size()) {
+                    buf_[fill_++] = byte;
+                }
+                else {
+                    overlong_ = true;
+                }
+                continue;
+            }
+
+            size_t record_len = end_frame();
+            if (record_len > 0) on_record(buf_.data(), record_len);
+            fill_ = 0;
+        }
+    }
+
+    uint64_t frames() const { return frames_; }
+    uint64_t bad_frames() const { return bad_frames_; }     // Too long, or not valid COBS
+
+private:
+    size_t end_frame();
+
+    std::vector<uint8_t> buf_;
+    size_t fill_ = 0;
+    bool overlong_ = false;
+
+    uint64_t frames_ = 0;
+    uint64_t bad_frames_ = 0;
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_COBS_HPP */
@@ -0,0 +1,51 @@
+/*************************************************************************************
+ *
+ * @file csv_reader.hpp
+ *
+ * @brief Parsing of the CSV files the loggers write: rows of payloads.csv back into samples, and their local ISO timestamps
+ * back into Unix time.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_CSV_READER_HPP
+#define LWQMS_CSV_READER_HPP
+
+#include "lwqms/ingest.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lwqms {
+
+/**
+ * @brief Parses local times as datetime.isoformat() writes them, "YYYY-MM-DDTHH:MM:SS" with an optional fraction of a
+ * second, into Unix time. The time zone is looked up once per hour of local time seen, rather than once per row.
+ */
+class LocalTimeParser {
+public:
+    /**
+     * @returns False if the text is not such a time
+     */
+    bool parse(const char *text, size_t len, int64_t &time_us);
+
+private:
+    int64_t cached_hour_key_ = -1;  // YYYYMMDDHH of the hour cached
+    int64_t cached_hour_us_ = 0;    // Unix time at its start
+};
+
+/**
+ * @brief Parses one row of payloads.csv: time, node ID, turbidity, temperature and pH. The row has no link quality.
+ *
+ * @param line Row without its line ending
+ *
+ * @returns False for the header, and for a row that is not whole
+ */
+bool parse_payload_row(const char *line, size_t len, LocalTimeParser &times, SampleRow &out);
+
+} // namespace lwqms
+
+#endif /* LWQMS_CSV_READER_HPP */
@@ -0,0 +1,81 @@
+/*************************************************************************************
+ *
+ * @file csv_sink.hpp
+ *
+ * @brief Storage sink writing the CSV files the dashboard reads: payloads.csv and messages.csv, in the columns and
+ * timestamp format the Python logger used.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_CSV_SINK_HPP
+#define LWQMS_CSV_SINK_HPP
+
+#include "lwqms/ingest.hpp"
+
+#include <string>
+
+namespace lwqms {
+
+/**
+ * @brief Appends rows to a CSV file through one descriptor held open, with rows collected in memory and written in large
+ * blocks, rather than a file opened, written and closed per row.
+ */
+class CsvFile {
+public:
+    static constexpr size_t kWriteBlock = 64 * 1024;
+
+    /**
+     * @param path File to append to. Created with `header` as its first line if it does not exist or is empty.
+     */
+    CsvFile(const std::string &path, const char *header);
+    ~CsvFile();
+
+    CsvFile(const CsvFile &) = delete;
+    CsvFile &operator=(const CsvFile &) = delete;
+
+    std::string &buffer() { return buf_; }
+
+    /**
+     * @brief Writes out the buffer once it holds a whole block.
+     */
+    void row_done() { if (buf_.size() >= kWriteBlock) write_out(); }
+
+    void flush(bool durable);
+
+private:
+    void write_out();
+
+    std::string path_;
+    int fd_ = -1;
+    std::string buf_;
+};
+
+class CsvSink : public Sink {
+public:
+    /**
+     * @param directory Directory holding payloads.csv and messages.csv
+     */
+    explicit CsvSink(const std::string &directory);
+
+    void write(const SampleRow &row) override;
+    void write(const MessageRow &row) override;
+    void flush(bool durable) override;
+
+private:
+    void append_time(std::string &out, int64_t time_us);
+
+    CsvFile payloads_;
+    CsvFile messages_;
+
+    // Rows mostly arrive within the same second, so its local date and time is formatted once.
+    int64_t cached_second_ = INT64_MIN;
+    char cached_prefix_[32];
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_CSV_SINK_HPP */
@@ -0,0 +1,258 @@
+/*************************************************************************************
+ *
+ * @file forecast.hpp
+ *
+ * @brief Forecast engine: runs the water quality forecast model trained in TimeSeriesForecastingNN.mlx and exported to
+ * model.onnx, on the gateway host, with nothing else installed.
+ *
+ * The model is a chain of recurrent (LSTM or GRU), fully connected and activation layers, each the input of the next, as
+ * MATLAB exports one. Weights are read from the ONNX file once, and packed into aligned panels of rows so the matrix-vector
+ * products of each step stream through them in order, with SSE, AVX2 or NEON, whichever the build targets.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_FORECAST_HPP
+#define LWQMS_FORECAST_HPP
+
+#include "lwqms/onnx.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+constexpr size_t kSimdAlign = 64;               // A cache line, and the widest vector
+
+/**
+ * @brief Channels of the water quality model, in the order it takes and gives them
+ */
+enum Channel : uint8_t {
+    kChannelTemperature = 0,
+    kChannelPH = 1,
+    kChannelTurbidity = 2
+};
+
+constexpr size_t kChannels = 3;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief Floats aligned to kSimdAlign, zeroed.
+ */
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(size_t count);
+    ~AlignedBuffer();
+
+    AlignedBuffer(AlignedBuffer &&other) noexcept;
+    AlignedBuffer &operator=(AlignedBuffer &&other) noexcept;
+    AlignedBuffer(const AlignedBuffer &other);
+    AlignedBuffer &operator=(const AlignedBuffer &other);
+
+    float *data() { return data_; }
+    const float *data() const { return data_; }
+    size_t size() const { return size_; }
+
+    float &operator[](size_t k) { return data_[k]; }
+    float operator[](size_t k) const { return data_[k]; }
+
+private:
+    float *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Matrix packed for multiplying vectors by: panels of kPanelRows rows, each panel column after column, so a product
+ * reads the matrix once, front to back, keeping a panel's sums in registers. Rows are padded to a whole panel with zeros.
+ */
+class PackedMatrix {
+public:
+    PackedMatrix() = default;
+
+    /**
+     * @param at Element at (row, column) of the matrix to pack
+     */
+    template <typename At>
+    PackedMatrix(size_t rows, size_t cols, At at);
+
+    /**
+     * @brief y += A x
+     *
+     * @param x cols() values
+     * @param y padded_rows() values, aligned to kSimdAlign
+     */
+    void multiply_add(const float *x, float *y) const;
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t padded_rows() const;
+
+private:
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    AlignedBuffer data_;
+};
+
+/**
+ * @brief Layer of the model
+ */
+struct ForecastLayer {
+    enum Kind : uint8_t {
+        kLstm,
+        kGru,
+        kDense,
+        kRelu,
+        kSigmoid,
+        kTanh
+    };
+
+    Kind kind;
+    size_t inputs = 0;
+    size_t outputs = 0;                 // Hidden size of a recurrent layer
+
+    // LSTM: [W R] over [x h], one row per gate in ONNX order (i, o, f, c). GRU: W over x, gates z, r, h.
+    // Dense: the weights.
+    PackedMatrix weights;
+    PackedMatrix recurrent_zr;          // GRU: R of the update and reset gates
+    PackedMatrix recurrent_h;           // GRU: R of the hidden gate
+    AlignedBuffer bias;                 // LSTM: Wb + Rb. GRU: Wb, with Rb of z and r added. Dense: B.
+    AlignedBuffer recurrent_bias;       // GRU: Rb of the hidden gate
+    bool linear_before_reset = false;   // GRU: the reset gate scales R h rather than h
+
+    AlignedBuffer initial_h;
+    AlignedBuffer initial_c;
+    size_t state = 0;                   // Recurrent layers: which of ForecastState's buffers are this layer's
+};
+
+/**
+ * @brief The recurrent state of one sequence: one node's forecast, say. Each thread forecasting needs its own.
+ */
+struct ForecastState {
+    std::vector<AlignedBuffer> h;
+    std::vector<AlignedBuffer> c;
+
+    // Scratch of a step
+    AlignedBuffer gates;
+    AlignedBuffer recurrent;
+    AlignedBuffer concat;
+    AlignedBuffer values[2];
+};
+
+/**
+ * @brief Per channel mean and standard deviation, taken off the inputs before the model and put back on its outputs, as
+ * the training data was normalized.
+ */
+struct Normalization {
+    std::vector<float> input_mean;      // Empty for none
+    std::vector<float> input_std;
+    std::vector<float> output_mean;
+    std::vector<float> output_std;
+};
+
+/**
+ * @brief A model loaded from ONNX, ready to run. Its weights are not changed by running it, so threads may share one.
+ */
+class ForecastModel {
+public:
+    /**
+     * @throws std::runtime_error If the model cannot be read or uses an operator or option not supported
+     */
+    explicit ForecastModel(const std::string &onnx_path);
+    explicit ForecastModel(const OnnxGraph &graph);
+
+    size_t inputs() const { return inputs_; }
+    size_t outputs() const { return outputs_; }
+    const std::vector<ForecastLayer> &layers() const { return layers_; }
+
+    /**
+     * @brief Sets how the inputs and outputs are normalized. None by default: the model is fed and gives normalized values.
+     *
+     * @throws std::invalid_argument If the vectors are not empty and not of the model's inputs and outputs
+     */
+    void set_normalization(const Normalization &normalization);
+    const Normalization &normalization() const { return normalization_; }
+
+    /**
+     * @returns State at the start of a sequence
+     */
+    ForecastState make_state() const;
+
+    /**
+     * @brief Puts a state back to the start of a sequence.
+     */
+    void reset(ForecastState &state) const;
+
+    /**
+     * @brief Runs one time step.
+     *
+     * @param in inputs() values
+     * @param out outputs() values: the model's prediction of the next step's inputs
+     */
+    void step(ForecastState &state, const float *in, float *out) const;
+
+    /**
+     * @brief Forecasts from a history: runs the model over it from the start of a sequence, then `horizon` steps past it,
+     * each fed the prediction before it. The first forecast step is the prediction of the last history step.
+     *
+     * @param history history_steps rows of inputs() values, oldest first
+     * @param out horizon rows of outputs() values
+     */
+    void forecast(ForecastState &state, const float *history, size_t history_steps, size_t horizon, float *out) const;
+
+private:
+    void add_layers(const OnnxGraph &graph);
+
+    std::vector<ForecastLayer> layers_;
+    size_t inputs_ = 0;
+    size_t outputs_ = 0;
+    size_t states_ = 0;
+    size_t widest_ = 0;
+    Normalization normalization_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @returns The instruction set the kernels were built for: "AVX2", "SSE2", "NEON" or "scalar"
+ */
+const char *simd_name();
+
+/**
+ * @brief Rows in a panel of a PackedMatrix
+ */
+size_t panel_rows();
+
+/**
+ * @brief Normalization of the water quality model. The mean and standard deviation of the training partition were not
+ * kept with the model, so these are of the whole data set it was partitioned from,
+ * dataset_formatted_notNormalized_smooth_withoutTime_169divisions.mat: 169 sequences of 93 half-hourly samples.
+ */
+Normalization water_quality_normalization();
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Templates
+
+template <typename At>
+PackedMatrix::PackedMatrix(size_t rows, size_t cols, At at) : rows_(rows), cols_(cols), data_(((rows + panel_rows() - 1) / panel_rows()) * panel_rows() * cols) {
+    size_t panel = panel_rows();
+
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < cols; c++) data_[((r / panel) * panel * cols) + (c * panel) + (r % panel)] = at(r, c);
+    }
+}
+
+} // namespace lwqms
+
+#endif /* LWQMS_FORECAST_HPP */
@@ -0,0 +1,195 @@
+/*************************************************************************************
+ *
+ * @file ingest.hpp
+ *
+ * @brief Ingestion of the gateway's record stream: records are decoded, duplicates dropped, gateway time turned into wall
+ * clock time, and each sample and message handed to a storage sink, which is made durable in batches.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_INGEST_HPP
+#define LWQMS_INGEST_HPP
+
+#include "lwqms/record.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief One telemetry sample, placed in time.
+ */
+struct SampleRow {
+    int64_t time_us;                // Unix time the sample was taken
+    uint16_t node_id;
+    float turbidity;
+    float temperature;
+    float pH;
+    bool link_valid;
+    int8_t rssi_dbm;                // Of the packet that carried the sample
+    int8_t snr_db;
+};
+
+struct MessageRow {
+    int64_t time_us;                // Unix time the message was received
+    uint16_t node_id;
+    std::string text;
+};
+
+/**
+ * @brief Where ingested rows are stored. Rows may sit in memory until `flush`; only a durable flush promises they survive
+ * a power cut.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    virtual void write(const SampleRow &row) = 0;
+    virtual void write(const MessageRow &row) = 0;
+
+    /**
+     * @param durable Also wait until the storage device has the rows (fsync), not just the operating system
+     */
+    virtual void flush(bool durable) = 0;
+};
+
+/**
+ * @brief Sink writing every row to two others.
+ */
+class TeeSink : public Sink {
+public:
+    TeeSink(Sink &first, Sink &second) : first_(first), second_(second) {}
+
+    void write(const SampleRow &row) override { first_.write(row); second_.write(row); }
+    void write(const MessageRow &row) override { first_.write(row); second_.write(row); }
+    void flush(bool durable) override { first_.flush(durable); second_.flush(durable); }
+
+private:
+    Sink &first_;
+    Sink &second_;
+};
+
+/**
+ * @brief Drops packets already ingested. The gateway acknowledges each packet once and never returns a retransmission, but
+ * the same packet still arrives twice when a capture is replayed over live data, or when the gateway restarts before an
+ * ACK gets through and the node resends to a gateway with no memory of it. A packet is known by its node, its packet ID
+ * and a CRC of its payload, within each node's last `kDedupWindow` packets.
+ */
+class Deduplicator {
+public:
+    static constexpr size_t kDedupWindow = 64;
+
+    /**
+     * @returns True if the packet was seen before. Otherwise it is remembered.
+     */
+    bool seen(const PacketRecord &pkt);
+
+private:
+    struct Window {
+        uint32_t keys[kDedupWindow];
+        uint8_t next = 0;
+        uint8_t count = 0;
+    };
+
+    std::unordered_map<uint16_t, Window> nodes_;
+};
+
+/**
+ * @brief Turns gateway time (microseconds since it booted) into Unix time. The offset between the two is taken from the
+ * fastest record seen so far, the one that spent the least time in the gateway and on the serial line. It is taken again
+ * when the gateway's clock goes backwards (a restart) and, on a live stream, when the gateway drifts a second off.
+ */
+class GatewayClock {
+public:
+    static constexpr int64_t kResyncUs = 1000000;
+
+    explicit GatewayClock(bool live) : live_(live) {}
+
+    int64_t to_unix_us(uint64_t gateway_us, int64_t host_now_us);
+
+    uint64_t resets() const { return resets_; }
+
+private:
+    bool live_;
+    bool anchored_ = false;
+    int64_t offset_us_ = 0;
+    uint64_t last_gateway_us_ = 0;
+    uint64_t resets_ = 0;
+};
+
+struct IngestOptions {
+    bool live = true;               // Live stream, rather than a replayed capture
+    uint32_t sync_rows = 256;       // Durable flush after this many rows...
+    uint32_t sync_interval_ms = 1000;   // ...or this long after the first row not yet durable, whichever comes first
+
+    // Called with each record as it is decoded, before it is ingested, e.g. to pace a replay
+    std::function<void(const Record &)> on_record;
+};
+
+struct IngestStats {
+    uint64_t packets = 0;
+    uint64_t samples = 0;
+    uint64_t messages = 0;
+    uint64_t duplicates = 0;
+    uint64_t undecoded = 0;         // Telemetry packets the gateway could not decode
+    uint64_t status_records = 0;
+    uint64_t syncs = 0;
+    uint32_t ring_overflows = 0;    // As of the gateway's last status record
+    uint32_t queue_overflows = 0;
+};
+
+/**
+ * @brief Takes the gateway's byte stream in, and writes its samples and messages to a sink.
+ */
+class Ingestor {
+public:
+    Ingestor(Sink &sink, const IngestOptions &options);
+
+    /**
+     * @brief Feeds bytes read from the gateway.
+     *
+     * @param host_now_us Unix time the bytes were read
+     */
+    void feed(const uint8_t *data, size_t len, int64_t host_now_us);
+
+    /**
+     * @brief Makes rows durable once the sync interval has run out. Call when no bytes have arrived for a while.
+     */
+    void poll(int64_t host_now_us);
+
+    /**
+     * @brief Makes every row durable.
+     */
+    void sync();
+
+    const IngestStats &stats() const { return stats_; }
+    const RecordStream &stream() const { return stream_; }
+    const GatewayClock &clock() const { return clock_; }
+
+private:
+    void ingest(const Record &record, int64_t host_now_us);
+
+    Sink &sink_;
+    IngestOptions options_;
+    RecordStream stream_;
+    Deduplicator dedup_;
+    GatewayClock clock_;
+    IngestStats stats_;
+
+    uint32_t unsynced_rows_ = 0;
+    int64_t first_unsynced_us_ = 0;
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_INGEST_HPP */
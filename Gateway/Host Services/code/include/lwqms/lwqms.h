@@ -0,0 +1,139 @@
+/*************************************************************************************
+ *
+ * @file lwqms.h
+ *
+ * @brief C interface of liblwqms, for the dashboard and other programs not written in C++ (Python through ctypes).
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_H
+#define LWQMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+#define LWQMS_TIME_TEXT_LEN 40
+
+typedef struct lwqms_tail lwqms_tail_t;
+typedef struct lwqms_store lwqms_store_t;
+
+/**
+ * @brief Latest sample of a node
+ */
+typedef struct lwqms_latest {
+    uint16_t node_id;
+    int64_t time_us;                            // Unix time
+    char time_text[LWQMS_TIME_TEXT_LEN];        // Time as written in the file, zero-terminated
+    float turbidity;
+    float temperature;
+    float ph;
+    uint64_t samples;                           // Rows of the node read so far
+} lwqms_latest_t;
+
+/**
+ * @brief Sample read from a telemetry store
+ */
+typedef struct lwqms_sample {
+    int64_t time_us;                            // Unix time
+    uint16_t node_id;
+    int8_t rssi_dbm;
+    int8_t snr_db;
+    uint8_t link_valid;                         // Nonzero if rssi_dbm and snr_db were received
+    float turbidity;
+    float temperature;
+    float ph;
+} lwqms_sample_t;
+
+/**
+ * @brief Place in a telemetry store: a node's samples with from_us <= time < to_us. The caller sets the node and bounds,
+ * and lwqms_store_seek finds the samples within them. Pages are then read by offset from the first, oldest, of those.
+ */
+typedef struct lwqms_cursor {
+    uint16_t node_id;
+    int64_t from_us;
+    int64_t to_us;
+    uint64_t first;                             // Position of the first sample in the node's time order
+    uint64_t count;                             // Samples within the bounds
+} lwqms_cursor_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Opens an incremental reader of a payloads.csv file. Nothing is read until the first poll, and the file need not
+ * exist yet.
+ *
+ * @returns The reader, or NULL if out of memory
+ */
+lwqms_tail_t *lwqms_tail_open(const char *path);
+
+/**
+ * @brief Reads the rows appended to the file since the last poll, and updates the latest sample of each node.
+ *
+ * @returns Rows read, or -1 if the file could not be read (see lwqms_tail_error)
+ */
+int64_t lwqms_tail_poll(lwqms_tail_t *tail);
+
+/**
+ * @brief Copies out the latest sample of each node, in order of node ID.
+ *
+ * @param out Array of `max` samples. May be NULL if `max` is 0.
+ *
+ * @returns Number of nodes, which may be more than `max`
+ */
+size_t lwqms_tail_latest(const lwqms_tail_t *tail, lwqms_latest_t *out, size_t max);
+
+/**
+ * @returns Why the last poll failed
+ */
+const char *lwqms_tail_error(const lwqms_tail_t *tail);
+
+void lwqms_tail_close(lwqms_tail_t *tail);
+
+/**
+ * @brief Opens a telemetry store for reading. The store need not exist yet: it is opened by the first call needing it, and
+ * again by later calls until it is.
+ *
+ * @returns The store, or NULL if out of memory
+ */
+lwqms_store_t *lwqms_store_open(const char *directory);
+
+/**
+ * @brief Finds the samples within a cursor's bounds, setting its first and count. Takes O(log n) of the node's samples, so
+ * seeking again to see samples appended since costs next to nothing.
+ *
+ * @returns 0, or -1 if the store could not be read (see lwqms_store_error)
+ */
+int lwqms_store_seek(lwqms_store_t *store, lwqms_cursor_t *cursor);
+
+/**
+ * @brief Reads a page of the samples a cursor was last seeked to: those at offsets [offset, offset + max) from its first,
+ * in time order.
+ *
+ * @returns Samples copied to `out`, or -1 if the store could not be read (see lwqms_store_error)
+ */
+int64_t lwqms_store_page(lwqms_store_t *store, const lwqms_cursor_t *cursor, uint64_t offset, lwqms_sample_t *out, size_t max);
+
+/**
+ * @returns Why the last call failed
+ */
+const char *lwqms_store_error(const lwqms_store_t *store);
+
+void lwqms_store_close(lwqms_store_t *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWQMS_H */
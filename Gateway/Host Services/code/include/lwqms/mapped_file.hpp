@@ -0,0 +1,75 @@
+/*************************************************************************************
+ *
+ * @file mapped_file.hpp
+ *
+ * @brief Files mapped into memory, as the telemetry store keeps its segments, indexes and rollups
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_MAPPED_FILE_HPP
+#define LWQMS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lwqms {
+
+/**
+ * @brief A file mapped into memory, read-only or writable.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    /**
+     * @brief Opens and maps a file.
+     *
+     * @param writable Map for writing, creating the file if needed
+     * @param min_size The file is grown to at least this size. Only when writable.
+     *
+     * @returns False if the file does not exist, or is empty and not writable
+     */
+    bool open(const std::string &path, bool writable, size_t min_size = 0);
+
+    /**
+     * @brief Grows the file, and maps it again. Pointers into the old mapping no longer hold.
+     */
+    void grow(size_t size);
+
+    /**
+     * @brief Maps the file again if it has grown, as another process may have grown it.
+     */
+    void remap_if_grown();
+
+    /**
+     * @brief Writes the given byte range of the mapping back to the file and waits for the storage device to have it.
+     */
+    void sync(size_t offset, size_t len);
+
+    bool is_open() const { return data_ != nullptr; }
+    uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    void map(size_t size);
+    void close();
+
+    int fd_ = -1;
+    bool writable_ = false;
+    uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_MAPPED_FILE_HPP */
@@ -0,0 +1,104 @@
+/*************************************************************************************
+ *
+ * @file onnx.hpp
+ *
+ * @brief Reader of ONNX model files, enough of them for the forecast engine: the graph's nodes, their attributes, and the
+ * weights stored with it. Decodes the protobuf wire format itself, so nothing else need be installed on the gateway host.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_ONNX_HPP
+#define LWQMS_ONNX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief Tensor stored in the model. Float tensors fill `floats`, and integer ones `ints`.
+ */
+struct OnnxTensor {
+    std::string name;
+    std::vector<int64_t> dims;
+    std::vector<float> floats;
+    std::vector<int64_t> ints;
+
+    /**
+     * @returns Number of elements, from the dimensions
+     */
+    size_t size() const;
+};
+
+struct OnnxAttribute {
+    std::string name;
+    float f = 0.0f;
+    int64_t i = 0;
+    std::string s;
+    std::vector<float> floats;
+    std::vector<int64_t> ints;
+    std::vector<std::string> strings;
+};
+
+struct OnnxNode {
+    std::string name;
+    std::string op_type;
+    std::vector<std::string> inputs;        // An empty name is an input left out
+    std::vector<std::string> outputs;
+    std::vector<OnnxAttribute> attributes;
+
+    /**
+     * @returns The attribute, or nullptr if the node does not have it
+     */
+    const OnnxAttribute *attribute(const std::string &name) const;
+
+    /**
+     * @returns Name of an input, or an empty one if there are not that many
+     */
+    const std::string &input(size_t k) const;
+};
+
+/**
+ * @brief The graph of a model: nodes in the order they run, and the weights.
+ */
+struct OnnxGraph {
+    std::vector<OnnxNode> nodes;
+    std::map<std::string, OnnxTensor> initializers;
+    std::vector<std::string> inputs;        // Those fed in when the model is run; not initializers
+    std::vector<std::string> outputs;
+    std::string producer;                   // Program that wrote the model
+
+    /**
+     * @returns The weights of that name, or nullptr if there are none
+     */
+    const OnnxTensor *initializer(const std::string &name) const;
+
+    /**
+     * @returns The node with an output of that name, or nullptr if none
+     */
+    const OnnxNode *producer_of(const std::string &name) const;
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Reads a model file.
+ *
+ * @throws std::runtime_error If the file cannot be read, is not a model, or keeps its weights in other files
+ */
+OnnxGraph load_onnx(const std::string &path);
+
+} // namespace lwqms
+
+#endif /* LWQMS_ONNX_HPP */
@@ -0,0 +1,178 @@
+/*************************************************************************************
+ *
+ * @file record.hpp
+ *
+ * @brief Decoder for the binary records the gateway sends its host. The layout is set out in lwqms_record.h of the
+ * firmware, which this follows field for field.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_RECORD_HPP
+#define LWQMS_RECORD_HPP
+
+#include "lwqms/cobs.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+constexpr uint8_t kRecordVersion = 1;
+
+constexpr uint8_t kRecordFlagLink = 0x01;       // RSSI and SNR were read for the packet
+constexpr uint8_t kRecordFlagSamples = 0x02;    // The gateway decoded the packet's telemetry
+
+constexpr size_t kPktHeaderLen = 7;
+constexpr size_t kPayloadLenMax = 256 - kPktHeaderLen;
+constexpr size_t kSamplesMax = 16;
+constexpr size_t kRecordLenMax = 22 + kPayloadLenMax + 1 + (kSamplesMax * 14) + 2;
+
+constexpr uint8_t kPktTypeMask = 0x1F;
+
+enum class RecordType : uint8_t {
+    Packet = 1,
+    Status = 2
+};
+
+enum class PacketType : uint8_t {
+    Telemetry = 0,
+    Message = 1,
+    TelemetryBatch = 2,
+    TelemetryCompact = 3
+};
+
+enum class DecodeStatus {
+    Ok,
+    TooShort,
+    BadCrc,
+    BadVersion,
+    UnknownType,
+    BadLength       // The lengths inside the record do not add up to its size
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief One telemetry sample, timestamped by its age: how long before the packet was sent it was taken.
+ */
+struct Sample {
+    uint16_t age_s;
+    float turbidity;
+    float temperature;
+    float pH;
+};
+
+/**
+ * @brief A packet the gateway received and acknowledged. Fixed size, so decoding never allocates.
+ */
+struct PacketRecord {
+    uint8_t flags;
+    uint8_t packet_type;            // Type byte of the packet, its flags included
+    uint16_t src_id;
+    uint16_t dest_id;
+    uint16_t pkt_id;
+    uint64_t rx_time_us;            // Gateway clock: microseconds since it booted
+
+    int8_t rssi_pkt_dbm;
+    int8_t snr_pkt_db;
+    int8_t signal_rssi_pkt_dbm;
+
+    uint8_t payload_len;
+    std::array<uint8_t, kPayloadLenMax> payload;    // As it came off the air, after the packet header
+
+    uint8_t qty_samples;
+    std::array<Sample, kSamplesMax> samples;
+
+    PacketType type() const { return static_cast<PacketType>(packet_type & kPktTypeMask); }
+    bool has_link() const { return (flags & kRecordFlagLink) != 0; }
+    bool has_samples() const { return (flags & kRecordFlagSamples) != 0; }
+
+    // Text of a message packet, up to its terminating zero
+    std::string message() const;
+};
+
+/**
+ * @brief Sent when a host attaches, and whenever the gateway falls behind.
+ */
+struct StatusRecord {
+    uint64_t time_us;
+    uint32_t ring_overflows;        // Times the radio core waited for the console core
+    uint32_t queue_overflows;       // Packets left unacknowledged because the console core was too far behind
+};
+
+struct Record {
+    RecordType type;
+    PacketRecord packet;            // Valid for RecordType::Packet
+    StatusRecord status;            // Valid for RecordType::Status
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief CRC-16/CCITT-FALSE, as the gateway computes it
+ */
+uint16_t crc16(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Decodes one record, taken out of its COBS frame.
+ */
+DecodeStatus decode_record(const uint8_t *buf, size_t len, Record &out);
+
+/**
+ * @brief Writes a record exactly as the gateway would, CRC included. For replaying and for testing the host services
+ * without a gateway.
+ */
+void encode_record(const Record &record, std::vector<uint8_t> &buf);
+
+const char *to_string(DecodeStatus status);
+
+/**
+ * @brief Deframes and decodes the gateway's byte stream, calling `on_record(const Record &)` for each good record and
+ * counting the rest.
+ */
+class RecordStream {
+public:
+    RecordStream() : deframer_(kRecordLenMax) {}
+
+    template <typename OnRecord>
+    void feed(const uint8_t *data, size_t len, OnRecord &&on_record) {
+        deframer_.feed(data, len, [&](const uint8_t *buf, size_t record_len) {
+            DecodeStatus status = decode_record(buf, record_len, record_);
+
+            if (status == DecodeStatus::Ok) {
+                records_++;
+                on_record(static_cast<const Record &>(record_));
+            }
+            else {
+                rejected_[static_cast<size_t>(status)]++;
+            }
+        });
+    }
+
+    uint64_t records() const { return records_; }
+    uint64_t rejected(DecodeStatus status) const { return rejected_[static_cast<size_t>(status)]; }
+    uint64_t bad_frames() const { return deframer_.bad_frames(); }
+
+private:
+    Deframer deframer_;
+    Record record_;
+
+    uint64_t records_ = 0;
+    std::array<uint64_t, static_cast<size_t>(DecodeStatus::BadLength) + 1> rejected_ = {};
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_RECORD_HPP */
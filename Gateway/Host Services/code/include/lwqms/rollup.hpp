@@ -0,0 +1,131 @@
+/*************************************************************************************
+ *
+ * @file rollup.hpp
+ *
+ * @brief Rollups of the telemetry: per node, the minimum, maximum, mean, count and last value of each measurement over
+ * 10 minute, 1 hour and 1 day buckets, kept up to date as samples are stored. A history view or the forecast model's
+ * features read a few hundred buckets rather than every sample.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_ROLLUP_HPP
+#define LWQMS_ROLLUP_HPP
+
+#include "lwqms/ingest.hpp"
+#include "lwqms/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+enum class Resolution : uint8_t {
+    TenMinutes = 0,
+    Hour = 1,
+    Day = 2                         // Local midnight to midnight, so 23 or 25 hours across a change of daylight saving time
+};
+
+constexpr size_t kResolutions = 3;
+
+enum Metric : uint8_t {
+    kTurbidity = 0,
+    kTemperature = 1,
+    kPH = 2
+};
+
+constexpr size_t kMetrics = 3;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief Aggregates of one node's samples over one bucket of time.
+ */
+struct RollupBucket {
+    int64_t start_us;               // Unix time the bucket starts
+    int64_t last_time_us;           // Time of the latest sample in it
+    double sum[kMetrics];
+    uint32_t count;
+    uint32_t seq;                   // Odd while the writer is changing the bucket
+    float min[kMetrics];
+    float max[kMetrics];
+    float last[kMetrics];           // Of the latest sample
+    uint32_t reserved;
+
+    double mean(Metric metric) const { return (count > 0) ? (sum[metric] / count) : 0.0; }
+};
+
+/**
+ * @brief One node's buckets at one resolution, in a file of the telemetry store: a header, then the buckets in time order.
+ */
+class RollupFile {
+public:
+    /**
+     * @param writable Open for the writer, creating the file if needed
+     *
+     * @returns False if the file does not exist and is not writable
+     */
+    bool open(const std::string &path, uint16_t node_id, Resolution resolution, bool writable);
+
+    /**
+     * @brief Adds a sample to the bucket holding its time, which is created if need be.
+     */
+    void add(const SampleRow &row);
+
+    /**
+     * @brief Drops every bucket.
+     */
+    void clear();
+
+    /**
+     * @brief Makes the buckets changed since the last call durable.
+     */
+    void make_durable();
+
+    uint64_t count() const;
+
+    /**
+     * @brief Copies out the buckets that start in [from_us, to_us), each as it was between two of the writer's changes.
+     *
+     * @returns Number of buckets appended to `out`
+     */
+    size_t read(int64_t from_us, int64_t to_us, std::vector<RollupBucket> &out, size_t limit = SIZE_MAX);
+
+    bool is_open() const { return file_.is_open(); }
+
+private:
+    MappedFile file_;
+    Resolution resolution_ = Resolution::TenMinutes;
+    uint64_t dirty_from_ = UINT64_MAX;
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @returns Start of the bucket holding a time
+ */
+int64_t bucket_start(Resolution resolution, int64_t time_us);
+
+/**
+ * @returns "10m", "1h" or "1d"
+ */
+const char *to_string(Resolution resolution);
+
+/**
+ * @brief Parses "10m", "1h" or "1d".
+ */
+bool parse_resolution(const char *text, Resolution &resolution);
+
+} // namespace lwqms
+
+#endif /* LWQMS_ROLLUP_HPP */
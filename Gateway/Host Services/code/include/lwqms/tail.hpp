@@ -0,0 +1,71 @@
+/*************************************************************************************
+ *
+ * @file tail.hpp
+ *
+ * @brief Incremental reader of payloads.csv: each poll parses only the rows appended since the last, and keeps the latest
+ * sample of every node, so the cost of a poll does not grow with the file.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_TAIL_HPP
+#define LWQMS_TAIL_HPP
+
+#include "lwqms/csv_reader.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lwqms {
+
+struct LatestSample {
+    SampleRow row;
+    std::string time_text;          // Time as written in the file
+    uint64_t samples = 0;           // Rows of the node read so far
+};
+
+class PayloadTail {
+public:
+    explicit PayloadTail(const std::string &path) : path_(path) {}
+
+    /**
+     * @brief Reads the rows appended since the last poll. A row still being written is left for the next. A file that
+     * has shrunk, or been replaced, is read again from the start.
+     *
+     * @returns Rows read, or -1 if the file could not be read (errno tells why)
+     */
+    int64_t poll();
+
+    /**
+     * @returns Latest sample of each node, by node ID: the last row of the node in the file
+     */
+    const std::map<uint16_t, LatestSample> &latest() const { return latest_; }
+
+    uint64_t offset() const { return offset_; }
+    uint64_t rows() const { return rows_; }
+    uint64_t rejected() const { return rejected_; }     // Lines that are not rows, the header among them
+
+private:
+    void reset();
+    void take_line(const char *line, size_t len);
+
+    std::string path_;
+    uint64_t offset_ = 0;           // Start of the first line not yet read
+    uint64_t device_ = 0;
+    uint64_t inode_ = 0;
+
+    LocalTimeParser times_;
+    std::map<uint16_t, LatestSample> latest_;
+    std::vector<char> buf_;
+    uint64_t rows_ = 0;
+    uint64_t rejected_ = 0;
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_TAIL_HPP */
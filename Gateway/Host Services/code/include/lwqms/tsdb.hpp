@@ -0,0 +1,217 @@
+/*************************************************************************************
+ *
+ * @file tsdb.hpp
+ *
+ * @brief Telemetry store: an append-only time-series store of the samples, kept in fixed-size segment files of fixed-width
+ * columns, with a time index per node. Readers map the files and find the latest sample of a node, or the start of a time
+ * range, in O(log n) regardless of how much history is kept.
+ *
+ * A store is a directory:
+ *
+ *      store.meta          Segment size, rows made durable, and whether the writer closed cleanly
+ *      seg-NNNNNNNN.lwts   kSegmentRows rows each: a header, then one array per column
+ *      node-NNNNN.lwti     Per node, (time, row) of each of its samples, in time order
+ *      rollup-NNNNN-R.lwtr Per node and resolution (10m, 1h, 1d), aggregates of its samples over each bucket of time
+ *
+ * One process writes; any number may read while it does. A reader never sees a sample half written, and reads an index
+ * again when the writer moves its entries to insert a sample out of time order.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_TSDB_HPP
+#define LWQMS_TSDB_HPP
+
+#include "lwqms/ingest.hpp"
+#include "lwqms/mapped_file.hpp"
+#include "lwqms/rollup.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+constexpr uint32_t kSegmentRows = 65536;        // 1.5 MiB a segment; about 4 hours of 300 nodes sampling once a minute
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief Entry of a node's time index: a sample's time, and the row holding it.
+ */
+struct IndexEntry {
+    int64_t time_us;
+    uint64_t row;
+};
+
+/**
+ * @brief Writes to a telemetry store. Rows are appended in any order of time, though the index is quickest kept when
+ * each node's rows come in time order, as the gateway sends them.
+ */
+class TelemetryStore {
+public:
+    /**
+     * @param directory Directory of the store. Created if it does not exist. Rows not made durable before the last writer
+     * stopped without closing are dropped.
+     */
+    explicit TelemetryStore(const std::string &directory);
+    ~TelemetryStore();
+
+    TelemetryStore(const TelemetryStore &) = delete;
+    TelemetryStore &operator=(const TelemetryStore &) = delete;
+
+    void append(const SampleRow &row);
+
+    /**
+     * @brief Makes every row appended so far durable. The indexes and rollups are made durable when the store is closed,
+     * and built again from the rows if it never was.
+     */
+    void sync();
+
+    uint64_t rows() const { return rows_; }
+
+private:
+    struct NodeFiles {
+        MappedFile index;
+        uint64_t index_dirty_from = UINT64_MAX;     // First entry changed since it was last made durable
+        RollupFile rollups[kResolutions];
+    };
+
+    void open_segment(uint32_t segment);
+    NodeFiles &node_files(uint16_t node_id);
+    void index_row(NodeFiles &files, int64_t time_us, uint64_t row);
+    void write_meta(bool clean);
+    void recover(uint64_t synced_rows);
+    void rebuild(bool indexes);
+
+    std::string dir_;
+    int meta_fd_ = -1;
+
+    std::map<uint32_t, MappedFile> segments_;      // Those written since the last sync
+    std::map<uint16_t, NodeFiles> nodes_;
+
+    uint64_t rows_ = 0;
+    uint64_t synced_rows_ = 0;
+    bool clean_ = true;             // As written in store.meta
+    bool new_files_ = false;        // Files created since the last sync
+};
+
+/**
+ * @brief Reads a telemetry store, while it is written or not.
+ */
+class TelemetryReader {
+public:
+    /**
+     * @throws std::runtime_error If the directory does not hold a store
+     */
+    explicit TelemetryReader(const std::string &directory);
+
+    /**
+     * @brief Finds nodes first heard from since the reader was opened or last refreshed. Rows appended by the writer are
+     * seen without a refresh.
+     */
+    void refresh();
+
+    /**
+     * @returns IDs of the nodes in the store, in order
+     */
+    std::vector<uint16_t> nodes() const;
+
+    /**
+     * @returns Number of samples of a node
+     */
+    uint64_t count(uint16_t node_id) const;
+
+    /**
+     * @brief Finds a node's sample with the latest time.
+     *
+     * @returns False if the node has no samples
+     */
+    bool latest(uint16_t node_id, SampleRow &out) const;
+
+    /**
+     * @brief Finds a node's samples with from_us <= time < to_us, in time order.
+     *
+     * @param limit Most samples to return
+     *
+     * @returns Number of samples appended to `out`
+     */
+    size_t range(uint16_t node_id, int64_t from_us, int64_t to_us, std::vector<SampleRow> &out, size_t limit = SIZE_MAX) const;
+
+    /**
+     * @returns Position in a node's time order of its first sample at or after `time_us`: the number of its samples before
+     * it. Positions index `at`.
+     */
+    uint64_t lower_bound(uint16_t node_id, int64_t time_us) const;
+
+    /**
+     * @brief Reads a node's sample at a position in its time order.
+     *
+     * @returns False if there is no sample at that position
+     */
+    bool at(uint16_t node_id, uint64_t position, SampleRow &out) const;
+
+    /**
+     * @brief Reads a page of a node's samples: those at positions [position, position + limit) of its time order. With
+     * lower_bound, pages through a time range without reading what comes before the page.
+     *
+     * @returns Number of samples appended to `out`
+     */
+    size_t page(uint16_t node_id, uint64_t position, size_t limit, std::vector<SampleRow> &out) const;
+
+    /**
+     * @brief Finds a node's rollup buckets that start in [from_us, to_us), in time order.
+     *
+     * @param limit Most buckets to return
+     *
+     * @returns Number of buckets appended to `out`
+     */
+    size_t rollups(uint16_t node_id, Resolution resolution, int64_t from_us, int64_t to_us, std::vector<RollupBucket> &out,
+        size_t limit = SIZE_MAX) const;
+
+    uint64_t rows() const;
+
+private:
+    const IndexEntry *index(uint16_t node_id, uint64_t &count, uint64_t &seq) const;
+    bool index_changed(uint16_t node_id, uint64_t seq) const;
+    bool read_row(uint64_t row, SampleRow &out) const;
+    const MappedFile *segment(uint32_t segment) const;
+
+    std::string dir_;
+    uint32_t segment_rows_ = kSegmentRows;
+
+    // Mapped as they are needed
+    mutable std::map<uint16_t, MappedFile> nodes_;
+    mutable std::map<uint32_t, MappedFile> segments_;
+    mutable std::map<uint32_t, RollupFile> rollups_;    // By node ID and resolution
+};
+
+/**
+ * @brief Sink writing samples to a telemetry store. Messages are not kept there.
+ */
+class TelemetrySink : public Sink {
+public:
+    explicit TelemetrySink(const std::string &directory) : store_(directory) {}
+
+    void write(const SampleRow &row) override { store_.append(row); }
+    void write(const MessageRow &) override {}
+    void flush(bool durable) override { if (durable) store_.sync(); }
+
+    TelemetryStore &store() { return store_; }
+
+private:
+    TelemetryStore store_;
+};
+
+} // namespace lwqms
+
+#endif /* LWQMS_TSDB_HPP */
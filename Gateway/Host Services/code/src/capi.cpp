@@ -0,0 +1,170 @@
+/*************************************************************************************
+ *
+ * @file capi.cpp
+ *
+ * @brief C interface of liblwqms
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/lwqms.h"
+#include "lwqms/tail.hpp"
+#include "lwqms/tsdb.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct lwqms_tail {
+    explicit lwqms_tail(const char *path) : tail(path) {}
+
+    lwqms::PayloadTail tail;
+    std::string error;
+};
+
+struct lwqms_store {
+    explicit lwqms_store(const char *directory) : dir(directory) {}
+
+    std::string dir;
+    std::unique_ptr<lwqms::TelemetryReader> reader;     // Until the store has been opened
+    std::vector<lwqms::SampleRow> rows;
+    std::string error;
+};
+
+extern "C" {
+
+lwqms_tail_t *lwqms_tail_open(const char *path) {
+    try {
+        return new lwqms_tail(path);
+    }
+    catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+int64_t lwqms_tail_poll(lwqms_tail_t *tail) {
+    try {
+        int64_t rows = tail->tail.poll();
+        if (rows < 0) tail->error = std::strerror(errno);
+
+        return rows;
+    }
+    catch (const std::exception &err) {
+        tail->error = err.what();
+        return -1;
+    }
+}
+
+size_t lwqms_tail_latest(const lwqms_tail_t *tail, lwqms_latest_t *out, size_t max) {
+    const auto &latest = tail->tail.latest();
+    size_t k = 0;
+
+    for (auto it = latest.begin(); (it != latest.end()) && (k < max); ++it, k++) {
+        const lwqms::LatestSample &sample = it->second;
+        lwqms_latest_t &copy = out[k];
+
+        copy.node_id = it->first;
+        copy.time_us = sample.row.time_us;
+        copy.turbidity = sample.row.turbidity;
+        copy.temperature = sample.row.temperature;
+        copy.ph = sample.row.pH;
+        copy.samples = sample.samples;
+
+        size_t len = std::min(sample.time_text.size(), sizeof(copy.time_text) - 1);
+        std::memcpy(copy.time_text, sample.time_text.data(), len);
+        copy.time_text[len] = '\0';
+    }
+
+    return latest.size();
+}
+
+const char *lwqms_tail_error(const lwqms_tail_t *tail) {
+    return tail->error.c_str();
+}
+
+void lwqms_tail_close(lwqms_tail_t *tail) {
+    delete tail;
+}
+
+lwqms_store_t *lwqms_store_open(const char *directory) {
+    try {
+        return new lwqms_store(directory);
+    }
+    catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+int lwqms_store_seek(lwqms_store_t *store, lwqms_cursor_t *cursor) {
+    try {
+        if (store->reader == nullptr) {
+            store->reader = std::make_unique<lwqms::TelemetryReader>(store->dir);
+        }
+        else {
+            store->reader->refresh();
+        }
+
+        const lwqms::TelemetryReader &reader = *store->reader;
+
+        cursor->first = reader.lower_bound(cursor->node_id, cursor->from_us);
+        uint64_t end = (cursor->to_us == INT64_MAX) ? reader.count(cursor->node_id) : reader.lower_bound(cursor->node_id, cursor->to_us);
+        cursor->count = (end > cursor->first) ? (end - cursor->first) : 0;
+
+        return 0;
+    }
+    catch (const std::exception &err) {
+        store->error = err.what();
+        return -1;
+    }
+}
+
+int64_t lwqms_store_page(lwqms_store_t *store, const lwqms_cursor_t *cursor, uint64_t offset, lwqms_sample_t *out, size_t max) {
+    if (store->reader == nullptr) {
+        store->error = "Not seeked";
+        return -1;
+    }
+
+    if (offset >= cursor->count) return 0;
+    max = static_cast<size_t>(std::min<uint64_t>(max, cursor->count - offset));
+
+    try {
+        store->rows.clear();
+        store->reader->page(cursor->node_id, cursor->first + offset, max, store->rows);
+    }
+    catch (const std::exception &err) {
+        store->error = err.what();
+        return -1;
+    }
+
+    for (size_t k = 0; k < store->rows.size(); k++) {
+        const lwqms::SampleRow &row = store->rows[k];
+        lwqms_sample_t &copy = out[k];
+
+        copy.time_us = row.time_us;
+        copy.node_id = row.node_id;
+        copy.rssi_dbm = row.rssi_dbm;
+        copy.snr_db = row.snr_db;
+        copy.link_valid = row.link_valid ? 1 : 0;
+        copy.turbidity = row.turbidity;
+        copy.temperature = row.temperature;
+        copy.ph = row.pH;
+    }
+
+    return static_cast<int64_t>(store->rows.size());
+}
+
+const char *lwqms_store_error(const lwqms_store_t *store) {
+    return store->error.c_str();
+}
+
+void lwqms_store_close(lwqms_store_t *store) {
+    delete store;
+}
+
+} // extern "C"
@@ -0,0 +1,89 @@
+/*************************************************************************************
+ *
+ * @file cobs.cpp
+ *
+ * @brief Consistent Overhead Byte Stuffing, and a deframer that splits the gateway's byte stream into records
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/cobs.hpp"
+
+namespace lwqms {
+
+void cobs_encode(const uint8_t *record, size_t len, std::vector<uint8_t> &frame) {
+    // Each block starts with a code byte: the distance to the next zero, or 0xFF for 254 bytes with no zero after them.
+    size_t code_pos = frame.size();
+    uint8_t code = 1;
+
+    frame.push_back(0x00);
+
+    for (size_t k = 0; k < len; k++) {
+        if (record[k] == 0x00) {
+            frame[code_pos] = code;
+            code_pos = frame.size();
+            frame.push_back(0x00);
+            code = 1;
+            continue;
+        }
+
+        frame.push_back(record[k]);
+
+        if (++code == 0xFF) {
+            frame[code_pos] = code;
+            code_pos = frame.size();
+            frame.push_back(0x00);
+            code = 1;
+        }
+    }
+
+    frame[code_pos] = code;
+    frame.push_back(0x00);
+}
+
+size_t cobs_decode(const uint8_t *frame, size_t len, uint8_t *record) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < len) {
+        uint8_t code = frame[in++];
+
+        if ((code == 0x00) || (in + code - 1 > len)) return 0;
+
+        for (uint8_t k = 1; k < code; k++) {
+            record[out++] = frame[in++];
+        }
+
+        // A block shorter than 254 bytes stood for a zero, except the last, whose zero is the end of the frame.
+        if ((code != 0xFF) && (in < len)) record[out++] = 0x00;
+    }
+
+    return out;
+}
+
+Deframer::Deframer(size_t max_record)
+    // The longest frame of the longest record: one code byte per 254 bytes, and one more.
+    : buf_(max_record + (max_record / 254) + 1) {}
+
+size_t Deframer::end_frame() {
+    // Back-to-back zeros are idle line, not frames.
+    if ((fill_ == 0) && !overlong_) return 0;
+
+    frames_++;
+
+    if (overlong_) {
+        overlong_ = false;
+        bad_frames_++;
+        return 0;
+    }
+
+    size_t len = cobs_decode(buf_.data(), fill_, buf_.data());
+    if (len == 0) bad_frames_++;
+
+    return len;
+}
+
+} // namespace lwqms
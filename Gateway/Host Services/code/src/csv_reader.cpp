@@ -0,0 +1,135 @@
+/*************************************************************************************
+ *
+ * @file csv_reader.cpp
+ *
+ * @brief Parsing of the CSV files the loggers write
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/csv_reader.hpp"
+
+#include <charconv>
+#include <ctime>
+
+namespace lwqms {
+
+namespace {
+
+bool digits(const char *text, size_t count, int &value) {
+    value = 0;
+
+    for (size_t k = 0; k < count; k++) {
+        if ((text[k] < '0') || (text[k] > '9')) return false;
+        value = (value * 10) + (text[k] - '0');
+    }
+
+    return true;
+}
+
+/**
+ * @brief Trims spaces, and the quotes of a quoted field.
+ */
+void trim(const char *&begin, const char *&end) {
+    while ((begin < end) && (*begin == ' ')) begin++;
+    while ((end > begin) && (end[-1] == ' ')) end--;
+
+    if ((end - begin >= 2) && (*begin == '"') && (end[-1] == '"')) {
+        begin++;
+        end--;
+    }
+}
+
+template <typename T>
+bool parse_number(const char *begin, const char *end, T &value) {
+    trim(begin, end);
+    auto result = std::from_chars(begin, end, value);
+
+    return (result.ec == std::errc()) && (result.ptr == end);
+}
+
+} // namespace
+
+bool LocalTimeParser::parse(const char *text, size_t len, int64_t &time_us) {
+    int year, month, day, hour, minute, second;
+
+    // 2025-11-02T14:03:05
+    if ((len < 19) || (text[4] != '-') || (text[7] != '-') || ((text[10] != 'T') && (text[10] != ' ')) || (text[13] != ':') || (text[16] != ':')) return false;
+
+    if (!digits(text, 4, year) || !digits(text + 5, 2, month) || !digits(text + 8, 2, day) || !digits(text + 11, 2, hour) ||
+        !digits(text + 14, 2, minute) || !digits(text + 17, 2, second)) return false;
+
+    // An optional fraction, of up to microseconds
+    int micros = 0;
+
+    if ((len > 19) && (text[19] == '.')) {
+        size_t places = 0;
+
+        for (size_t k = 20; (k < len) && (text[k] >= '0') && (text[k] <= '9'); k++, places++) {
+            if (places < 6) micros = (micros * 10) + (text[k] - '0');
+        }
+
+        if (places == 0) return false;
+        for (; places < 6; places++) micros *= 10;
+    }
+
+    int64_t hour_key = (static_cast<int64_t>(year) * 1000000) + (month * 10000) + (day * 100) + hour;
+
+    if (hour_key != cached_hour_key_) {
+        struct tm local = {};
+
+        local.tm_year = year - 1900;
+        local.tm_mon = month - 1;
+        local.tm_mday = day;
+        local.tm_hour = hour;
+        local.tm_isdst = -1;
+
+        time_t start = std::mktime(&local);
+        if (start == static_cast<time_t>(-1)) return false;
+
+        cached_hour_key_ = hour_key;
+        cached_hour_us_ = static_cast<int64_t>(start) * 1000000;
+    }
+
+    time_us = cached_hour_us_ + ((static_cast<int64_t>(minute) * 60 + second) * 1000000) + micros;
+
+    return true;
+}
+
+bool parse_payload_row(const char *line, size_t len, LocalTimeParser &times, SampleRow &out) {
+    const char *fields[6];
+    const char *end = line + len;
+    size_t count = 0;
+
+    // Five fields, and the end of the last
+    fields[count++] = line;
+    for (const char *c = line; (c < end) && (count < 6); c++) {
+        if (*c == ',') fields[count++] = c + 1;
+    }
+
+    if (count != 5) return false;
+    fields[5] = end + 1;
+
+    const char *time_begin = fields[0], *time_end = fields[1] - 1;
+    trim(time_begin, time_end);
+
+    uint32_t node_id;
+
+    if (!times.parse(time_begin, static_cast<size_t>(time_end - time_begin), out.time_us) ||
+        !parse_number(fields[1], fields[2] - 1, node_id) || (node_id > UINT16_MAX) ||
+        !parse_number(fields[2], fields[3] - 1, out.turbidity) ||
+        !parse_number(fields[3], fields[4] - 1, out.temperature) ||
+        !parse_number(fields[4], fields[5] - 1, out.pH)) return false;
+
+    out.node_id = static_cast<uint16_t>(node_id);
+    out.link_valid = false;
+    out.rssi_dbm = 0;
+    out.snr_db = 0;
+
+    return true;
+}
+
+} // namespace lwqms
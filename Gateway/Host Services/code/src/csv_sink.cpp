@@ -0,0 +1,176 @@
+/*************************************************************************************
+ *
+ * @file csv_sink.cpp
+ *
+ * @brief Storage sink writing the CSV files the dashboard reads
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/csv_sink.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lwqms {
+
+namespace {
+
+void append_float(std::string &out, float value) {
+    // Shortest text that reads back as the same float, as Python would print the value the logger used to parse.
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+void append_uint(std::string &out, uint32_t value) {
+    char text[16];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+// Quoted as Python's csv module quotes: only when needed, with quotes doubled.
+void append_field(std::string &out, const std::string &text) {
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        out += text;
+        return;
+    }
+
+    out += '"';
+    for (char c : text) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+[[noreturn]] void fail(const std::string &what, const std::string &path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+CsvFile::CsvFile(const std::string &path, const char *header) : path_(path) {
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) fail("Could not open", path);
+
+    struct stat st;
+    if (::fstat(fd_, &st) < 0) fail("Could not stat", path);
+
+    if (st.st_size == 0) {
+        buf_ += header;
+        buf_ += "\r\n";
+    }
+
+    buf_.reserve(kWriteBlock * 2);
+}
+
+CsvFile::~CsvFile() {
+    if (fd_ < 0) return;
+
+    try {
+        flush(true);
+    }
+    catch (const std::exception &err) {
+        std::fprintf(stderr, "%s\n", err.what());
+    }
+
+    ::close(fd_);
+}
+
+void CsvFile::write_out() {
+    size_t done = 0;
+
+    while (done < buf_.size()) {
+        ssize_t written = ::write(fd_, buf_.data() + done, buf_.size() - done);
+
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            fail("Could not write", path_);
+        }
+
+        done += static_cast<size_t>(written);
+    }
+
+    buf_.clear();
+}
+
+void CsvFile::flush(bool durable) {
+    write_out();
+
+    if (durable && (::fdatasync(fd_) < 0)) fail("Could not sync", path_);
+}
+
+CsvSink::CsvSink(const std::string &directory)
+    // Rows end in CRLF, as Python's csv writer ends them.
+    : payloads_(directory + "/payloads.csv", "Time,Sensor Node ID,Turbidity (NTU),Temperature (C),pH"),
+      messages_(directory + "/messages.csv", "Time,Sensor Node ID,Message") {}
+
+void CsvSink::append_time(std::string &out, int64_t time_us) {
+    int64_t second = (time_us >= 0) ? (time_us / 1000000) : -((-time_us + 999999) / 1000000);
+    int64_t micros = time_us - (second * 1000000);
+
+    if (second != cached_second_) {
+        time_t t = static_cast<time_t>(second);
+        struct tm local;
+
+        localtime_r(&t, &local);
+        std::strftime(cached_prefix_, sizeof(cached_prefix_), "%Y-%m-%dT%H:%M:%S", &local);
+        cached_second_ = second;
+    }
+
+    // Local time without a zone, as datetime.isoformat() gave it, always with microseconds.
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), ".%06d", static_cast<int>(micros));
+
+    out += cached_prefix_;
+    out += fraction;
+}
+
+void CsvSink::write(const SampleRow &row) {
+    std::string &out = payloads_.buffer();
+
+    append_time(out, row.time_us);
+    out += ',';
+    append_uint(out, row.node_id);
+    out += ',';
+    append_float(out, row.turbidity);
+    out += ',';
+    append_float(out, row.temperature);
+    out += ',';
+    append_float(out, row.pH);
+    out += "\r\n";
+
+    payloads_.row_done();
+}
+
+void CsvSink::write(const MessageRow &row) {
+    std::string &out = messages_.buffer();
+
+    append_time(out, row.time_us);
+    out += ',';
+    append_uint(out, row.node_id);
+    out += ',';
+    append_field(out, row.text);
+    out += "\r\n";
+
+    messages_.row_done();
+}
+
+void CsvSink::flush(bool durable) {
+    payloads_.flush(durable);
+    messages_.flush(durable);
+}
+
+} // namespace lwqms
@@ -0,0 +1,742 @@
+/*************************************************************************************
+ *
+ * @file forecast.cpp
+ *
+ * @brief Forecast engine: the layers of the model, and the SIMD kernels they run on
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/forecast.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define FORECAST_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FORECAST_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define FORECAST_NEON
+#endif
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Kernels
+
+namespace {
+
+// exp(x) = 2^n e^r, with n = round(x / ln 2) and |r| <= ln 2 / 2, r taken in two parts so it stays exact. The polynomial of
+// e^r is Cephes' expf, good to about 1 ulp. Inputs are clamped so 2^n stays a normal float.
+constexpr float kExpMax = 88.3762626647949f;
+constexpr float kExpMin = -87.3365447505531f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+
+/**
+ * @brief The vector operations the kernels are written in, for the instruction set of the build.
+ */
+struct Simd {
+#if defined(FORECAST_AVX2)
+    using V = __m256;
+    static constexpr size_t kLanes = 8;
+    static constexpr const char *kName = "AVX2";
+
+    static V load(const float *p) { return _mm256_load_ps(p); }
+    static V loadu(const float *p) { return _mm256_loadu_ps(p); }
+    static void storeu(float *p, V v) { _mm256_storeu_ps(p, v); }
+    static void store(float *p, V v) { _mm256_store_ps(p, v); }
+    static V set1(float x) { return _mm256_set1_ps(x); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V fma(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+
+    static V exp(V x) {
+        x = min(max(x, set1(kExpMin)), set1(kExpMax));
+
+        __m256i n = _mm256_cvtps_epi32(mul(x, set1(kLog2e)));
+        V nf = _mm256_cvtepi32_ps(n);
+        V r = fma(nf, set1(-kLn2Hi), x);
+        r = fma(nf, set1(-kLn2Lo), r);
+
+        V pow2n = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+
+        return mul(polynomial(r), pow2n);
+    }
+#elif defined(FORECAST_SSE2)
+    using V = __m128;
+    static constexpr size_t kLanes = 4;
+    static constexpr const char *kName = "SSE2";
+
+    static V load(const float *p) { return _mm_load_ps(p); }
+    static V loadu(const float *p) { return _mm_loadu_ps(p); }
+    static void storeu(float *p, V v) { _mm_storeu_ps(p, v); }
+    static void store(float *p, V v) { _mm_store_ps(p, v); }
+    static V set1(float x) { return _mm_set1_ps(x); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm_div_ps(a, b); }
+    static V fma(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V max(V a, V b) { return _mm_max_ps(a, b); }
+
+    static V exp(V x) {
+        x = min(max(x, set1(kExpMin)), set1(kExpMax));
+
+        __m128i n = _mm_cvtps_epi32(mul(x, set1(kLog2e)));
+        V nf = _mm_cvtepi32_ps(n);
+        V r = fma(nf, set1(-kLn2Hi), x);
+        r = fma(nf, set1(-kLn2Lo), r);
+
+        V pow2n = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+
+        return mul(polynomial(r), pow2n);
+    }
+#elif defined(FORECAST_NEON)
+    using V = float32x4_t;
+    static constexpr size_t kLanes = 4;
+    static constexpr const char *kName = "NEON";
+
+    static V load(const float *p) { return vld1q_f32(p); }
+    static V loadu(const float *p) { return vld1q_f32(p); }
+    static void storeu(float *p, V v) { vst1q_f32(p, v); }
+    static void store(float *p, V v) { vst1q_f32(p, v); }
+    static V set1(float x) { return vdupq_n_f32(x); }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V div(V a, V b) { return vdivq_f32(a, b); }
+    static V fma(V a, V b, V c) { return vfmaq_f32(c, a, b); }
+    static V min(V a, V b) { return vminq_f32(a, b); }
+    static V max(V a, V b) { return vmaxq_f32(a, b); }
+
+    static V exp(V x) {
+        x = min(max(x, set1(kExpMin)), set1(kExpMax));
+
+        int32x4_t n = vcvtnq_s32_f32(mul(x, set1(kLog2e)));
+        V nf = vcvtq_f32_s32(n);
+        V r = fma(nf, set1(-kLn2Hi), x);
+        r = fma(nf, set1(-kLn2Lo), r);
+
+        V pow2n = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23));
+
+        return mul(polynomial(r), pow2n);
+    }
+#else
+    using V = float;
+    static constexpr size_t kLanes = 1;
+    static constexpr const char *kName = "scalar";
+
+    static V load(const float *p) { return *p; }
+    static V loadu(const float *p) { return *p; }
+    static void storeu(float *p, V v) { *p = v; }
+    static void store(float *p, V v) { *p = v; }
+    static V set1(float x) { return x; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V fma(V a, V b, V c) { return (a * b) + c; }
+    static V min(V a, V b) { return std::min(a, b); }
+    static V max(V a, V b) { return std::max(a, b); }
+    static V exp(V x) { return std::exp(x); }
+#endif
+
+    static constexpr size_t kPanelRows = 4 * kLanes;    // Four vectors of sums, times two columns at once, hide the FMA latency
+
+    static V polynomial(V r) {
+        V p = fma(set1(kExpP0), r, set1(kExpP1));
+        p = fma(p, r, set1(kExpP2));
+        p = fma(p, r, set1(kExpP3));
+        p = fma(p, r, set1(kExpP4));
+        p = fma(p, r, set1(kExpP5));
+
+        return add(fma(p, mul(r, r), r), set1(1.0f));
+    }
+
+    static V sigmoid(V x) {
+        V one = set1(1.0f);
+        return div(one, add(one, exp(sub(set1(0.0f), x))));
+    }
+
+    // tanh(x) = 2 sigmoid(2x) - 1
+    static V tanh(V x) {
+        V one = set1(1.0f);
+        return sub(div(set1(2.0f), add(one, exp(mul(x, set1(-2.0f))))), one);
+    }
+};
+
+float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+size_t round_up(size_t n, size_t to) {
+    return ((n + to - 1) / to) * to;
+}
+
+/**
+ * @brief Applies an activation in place, a vector at a time, the last few values one at a time.
+ */
+template <typename Vector, typename Scalar>
+void apply(float *v, size_t n, Vector vector_op, Scalar scalar_op) {
+    size_t k = 0;
+
+    for (; k + Simd::kLanes <= n; k += Simd::kLanes) Simd::storeu(v + k, vector_op(Simd::loadu(v + k)));
+    for (; k < n; k++) v[k] = scalar_op(v[k]);
+}
+
+void apply_sigmoid(float *v, size_t n) {
+    apply(v, n, [](Simd::V x) { return Simd::sigmoid(x); }, [](float x) { return sigmoid(x); });
+}
+
+void apply_tanh(float *v, size_t n) {
+    apply(v, n, [](Simd::V x) { return Simd::tanh(x); }, [](float x) { return std::tanh(x); });
+}
+
+void apply_relu(float *v, size_t n) {
+    apply(v, n, [](Simd::V x) { return Simd::max(x, Simd::set1(0.0f)); }, [](float x) { return std::max(x, 0.0f); });
+}
+
+/**
+ * @brief One LSTM step, after the gates' sums: c = f c + i g, h = o tanh(c). Gates are in ONNX order: i, o, f, c.
+ */
+void lstm_update(const float *gates, float *c, float *h, float *scratch, size_t hidden) {
+    const float *i = gates;
+    const float *o = gates + hidden;
+    const float *f = gates + (2 * hidden);
+    const float *g = gates + (3 * hidden);
+
+    for (size_t k = 0; k < hidden; k++) c[k] = (f[k] * c[k]) + (i[k] * g[k]);
+
+    std::memcpy(scratch, c, hidden * sizeof(float));
+    apply_tanh(scratch, hidden);
+
+    for (size_t k = 0; k < hidden; k++) h[k] = o[k] * scratch[k];
+}
+
+} // namespace
+
+const char *simd_name() {
+    return Simd::kName;
+}
+
+size_t panel_rows() {
+    return Simd::kPanelRows;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Buffers
+
+AlignedBuffer::AlignedBuffer(size_t count) : size_(count) {
+    if (count == 0) return;
+
+    // aligned_alloc wants a whole number of alignments.
+    size_t bytes = round_up(count * sizeof(float), kSimdAlign);
+
+    data_ = static_cast<float *>(std::aligned_alloc(kSimdAlign, bytes));
+    if (data_ == nullptr) throw std::bad_alloc();
+
+    std::memset(data_, 0, bytes);
+}
+
+AlignedBuffer::~AlignedBuffer() {
+    std::free(data_);
+}
+
+AlignedBuffer::AlignedBuffer(AlignedBuffer &&other) noexcept : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+AlignedBuffer &AlignedBuffer::operator=(AlignedBuffer &&other) noexcept {
+    if (this != &other) {
+        std::free(data_);
+
+        data_ = other.data_;
+        size_ = other.size_;
+
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    return *this;
+}
+
+AlignedBuffer::AlignedBuffer(const AlignedBuffer &other) : AlignedBuffer(other.size_) {
+    if (size_ > 0) std::memcpy(data_, other.data_, size_ * sizeof(float));
+}
+
+AlignedBuffer &AlignedBuffer::operator=(const AlignedBuffer &other) {
+    if (this != &other) *this = AlignedBuffer(other);
+
+    return *this;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Packed Matrices
+
+size_t PackedMatrix::padded_rows() const {
+    return round_up(rows_, Simd::kPanelRows);
+}
+
+void PackedMatrix::multiply_add(const float *x, float *y) const {
+    constexpr size_t kLanes = Simd::kLanes;
+    constexpr size_t kPanel = Simd::kPanelRows;
+    constexpr size_t kVectors = kPanel / kLanes;
+
+    const float *a = data_.data();
+    size_t panels = padded_rows() / kPanel;
+
+    for (size_t p = 0; p < panels; p++) {
+        float *yp = y + (p * kPanel);
+        Simd::V even[kVectors], odd[kVectors];
+
+        for (size_t v = 0; v < kVectors; v++) {
+            even[v] = Simd::load(yp + (v * kLanes));
+            odd[v] = Simd::set1(0.0f);
+        }
+
+        // Two columns at once, into sums of their own
+        size_t c = 0;
+
+        for (; c + 1 < cols_; c += 2, a += 2 * kPanel) {
+            Simd::V x0 = Simd::set1(x[c]);
+            Simd::V x1 = Simd::set1(x[c + 1]);
+
+            for (size_t v = 0; v < kVectors; v++) {
+                even[v] = Simd::fma(Simd::load(a + (v * kLanes)), x0, even[v]);
+                odd[v] = Simd::fma(Simd::load(a + kPanel + (v * kLanes)), x1, odd[v]);
+            }
+        }
+
+        if (c < cols_) {
+            Simd::V x0 = Simd::set1(x[c]);
+
+            for (size_t v = 0; v < kVectors; v++) even[v] = Simd::fma(Simd::load(a + (v * kLanes)), x0, even[v]);
+            a += kPanel;
+        }
+
+        for (size_t v = 0; v < kVectors; v++) Simd::store(yp + (v * kLanes), Simd::add(even[v], odd[v]));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Loading
+
+namespace {
+
+[[noreturn]] void unsupported(const OnnxNode &node, const std::string &what) {
+    throw std::runtime_error("Node " + node.name + " (" + node.op_type + "): " + what);
+}
+
+const OnnxTensor &weights_of(const OnnxGraph &graph, const OnnxNode &node, size_t input, size_t size) {
+    const OnnxTensor *tensor = graph.initializer(node.input(input));
+
+    if ((tensor == nullptr) || tensor->floats.empty()) unsupported(node, "input " + std::to_string(input) + " is not stored weights");
+    if (tensor->floats.size() != size) unsupported(node, tensor->name + " is not of the size expected");
+
+    return *tensor;
+}
+
+/**
+ * @brief Finds the initial state of a recurrent layer. Exporters tile one state over the batch, so a Tile or Expand of
+ * stored weights is followed back to them.
+ */
+AlignedBuffer initial_state(const OnnxGraph &graph, const OnnxNode &node, const std::string &name, size_t hidden) {
+    AlignedBuffer state(hidden);
+    std::string source = name;
+
+    while (!source.empty()) {
+        if (const OnnxTensor *tensor = graph.initializer(source)) {
+            if (tensor->floats.size() < hidden) unsupported(node, "initial state " + source + " is too small");
+
+            std::memcpy(state.data(), tensor->floats.data(), hidden * sizeof(float));
+            return state;
+        }
+
+        const OnnxNode *producer = graph.producer_of(source);
+        if ((producer == nullptr) || ((producer->op_type != "Tile") && (producer->op_type != "Expand") && (producer->op_type != "Identity"))) {
+            unsupported(node, "initial state " + source + " is not stored weights");
+        }
+
+        source = producer->input(0);
+    }
+
+    return state;
+}
+
+void check_recurrent(const OnnxNode &node, const std::vector<std::string> &activations) {
+    const OnnxAttribute *direction = node.attribute("direction");
+    const OnnxAttribute *given = node.attribute("activations");
+    const OnnxAttribute *layout = node.attribute("layout");
+
+    if ((direction != nullptr) && (direction->s != "forward")) unsupported(node, "only forward direction is supported");
+    if ((layout != nullptr) && (layout->i != 0)) unsupported(node, "only sequence-first layout is supported");
+    if (node.attribute("clip") != nullptr) unsupported(node, "clipping is not supported");
+    if ((given != nullptr) && (given->strings != activations)) unsupported(node, "only the default activations are supported");
+    if (!node.input(4).empty()) unsupported(node, "sequence lengths are not supported");
+}
+
+} // namespace
+
+ForecastModel::ForecastModel(const std::string &onnx_path) : ForecastModel(load_onnx(onnx_path)) {}
+
+ForecastModel::ForecastModel(const OnnxGraph &graph) {
+    add_layers(graph);
+}
+
+void ForecastModel::add_layers(const OnnxGraph &graph) {
+    if ((graph.inputs.size() != 1) || (graph.outputs.size() != 1)) throw std::runtime_error("Model must have one input and one output");
+
+    // Shape plumbing feeding the recurrent layers' initial states; followed back from those layers instead
+    static const char *const kPlumbing[] = {"Shape", "Gather", "Concat", "Tile", "Expand", "Unsqueeze", "Constant", "ConstantOfShape"};
+
+    std::string current = graph.inputs[0];
+    size_t width = 0;
+
+    for (const OnnxNode &node : graph.nodes) {
+        if (std::find_if(std::begin(kPlumbing), std::end(kPlumbing), [&](const char *op) { return node.op_type == op; }) != std::end(kPlumbing)) continue;
+
+        if (std::find(node.inputs.begin(), node.inputs.end(), current) == node.inputs.end()) unsupported(node, "not part of a chain of layers");
+
+        if (node.outputs.empty()) unsupported(node, "no output");
+
+        const std::string &op = node.op_type;
+
+        if ((op == "LSTM") || (op == "GRU")) {
+            bool lstm = op == "LSTM";
+            size_t gates = lstm ? 4 : 3;
+
+            if (node.input(0) != current) unsupported(node, "the sequence must be its first input");
+            check_recurrent(node, lstm ? std::vector<std::string>{"Sigmoid", "Tanh", "Tanh"} : std::vector<std::string>{"Sigmoid", "Tanh"});
+            if (lstm && !node.input(7).empty()) unsupported(node, "peepholes are not supported");
+            if (lstm && (node.attribute("input_forget") != nullptr) && (node.attribute("input_forget")->i != 0)) unsupported(node, "coupled input and forget gates are not supported");
+
+            const OnnxTensor *w = graph.initializer(node.input(1));
+            if ((w == nullptr) || (w->dims.size() != 3) || (w->dims[0] != 1) || (w->dims[1] % gates != 0)) unsupported(node, "W is not stored weights of one direction");
+
+            size_t hidden = static_cast<size_t>(w->dims[1]) / gates;
+            size_t in = static_cast<size_t>(w->dims[2]);
+
+            if ((width != 0) && (in != width)) unsupported(node, "input size does not match the layer before");
+
+            const OnnxTensor &r = weights_of(graph, node, 2, gates * hidden * hidden);
+            std::vector<float> b(2 * gates * hidden, 0.0f);
+            if (!node.input(3).empty()) b = weights_of(graph, node, 3, 2 * gates * hidden).floats;
+
+            ForecastLayer layer;
+            layer.kind = lstm ? ForecastLayer::kLstm : ForecastLayer::kGru;
+            layer.inputs = in;
+            layer.outputs = hidden;
+            layer.initial_h = initial_state(graph, node, node.input(5), hidden);
+            layer.state = states_++;
+
+            const float *wf = w->floats.data();
+            const float *rf = r.floats.data();
+
+            if (lstm) {
+                // One product over [x h] for all four gates
+                layer.weights = PackedMatrix(gates * hidden, in + hidden, [&](size_t row, size_t col) {
+                    return (col < in) ? wf[(row * in) + col] : rf[(row * hidden) + (col - in)];
+                });
+
+                layer.bias = AlignedBuffer(layer.weights.padded_rows());
+                for (size_t k = 0; k < gates * hidden; k++) layer.bias[k] = b[k] + b[(gates * hidden) + k];
+
+                layer.initial_c = initial_state(graph, node, node.input(6), hidden);
+            }
+            else {
+                const OnnxAttribute *lbr = node.attribute("linear_before_reset");
+                layer.linear_before_reset = (lbr != nullptr) && (lbr->i != 0);
+
+                layer.weights = PackedMatrix(gates * hidden, in, [&](size_t row, size_t col) { return wf[(row * in) + col]; });
+                layer.recurrent_zr = PackedMatrix(2 * hidden, hidden, [&](size_t row, size_t col) { return rf[(row * hidden) + col]; });
+                layer.recurrent_h = PackedMatrix(hidden, hidden, [&](size_t row, size_t col) { return rf[((row + (2 * hidden)) * hidden) + col]; });
+
+                // Rb of z and r add to Wb as they do to W x; Rb of h is scaled by r with R h, if linear before reset.
+                layer.bias = AlignedBuffer(layer.weights.padded_rows());
+                for (size_t k = 0; k < gates * hidden; k++) layer.bias[k] = b[k] + ((k < 2 * hidden) ? b[(gates * hidden) + k] : 0.0f);
+
+                layer.recurrent_bias = AlignedBuffer(layer.recurrent_h.padded_rows());
+                for (size_t k = 0; k < hidden; k++) layer.recurrent_bias[k] = b[(5 * hidden) + k];
+            }
+
+            layers_.push_back(std::move(layer));
+            width = hidden;
+        }
+        else if ((op == "MatMul") || (op == "Gemm")) {
+            if (node.input(0) != current) unsupported(node, "the layer before must be its first input");
+
+            const OnnxTensor *w = graph.initializer(node.input(1));
+            if ((w == nullptr) || (w->dims.size() != 2) || w->floats.empty()) unsupported(node, "B is not stored weights");
+
+            const OnnxAttribute *trans_a = node.attribute("transA");
+            const OnnxAttribute *trans_b = node.attribute("transB");
+            const OnnxAttribute *alpha = node.attribute("alpha");
+            const OnnxAttribute *beta = node.attribute("beta");
+
+            if ((trans_a != nullptr) && (trans_a->i != 0)) unsupported(node, "transA is not supported");
+
+            bool transposed = (trans_b != nullptr) && (trans_b->i != 0);
+            size_t in = static_cast<size_t>(w->dims[transposed ? 1 : 0]);
+            size_t out = static_cast<size_t>(w->dims[transposed ? 0 : 1]);
+            float scale = (alpha != nullptr) ? alpha->f : 1.0f;
+            const float *wf = w->floats.data();
+
+            if ((width != 0) && (in != width)) unsupported(node, "input size does not match the layer before");
+
+            ForecastLayer layer;
+            layer.kind = ForecastLayer::kDense;
+            layer.inputs = in;
+            layer.outputs = out;
+            layer.weights = PackedMatrix(out, in, [&](size_t row, size_t col) { return scale * (transposed ? wf[(row * in) + col] : wf[(col * out) + row]); });
+            layer.bias = AlignedBuffer(layer.weights.padded_rows());
+
+            if ((op == "Gemm") && !node.input(2).empty()) {
+                const OnnxTensor &c = weights_of(graph, node, 2, out);
+                float c_scale = (beta != nullptr) ? beta->f : 1.0f;
+
+                for (size_t k = 0; k < out; k++) layer.bias[k] = c_scale * c.floats[k];
+            }
+
+            layers_.push_back(std::move(layer));
+            width = out;
+        }
+        else if (op == "Add") {
+            // A bias after MatMul
+            size_t other = (node.input(0) == current) ? 1 : 0;
+            const OnnxTensor *b = graph.initializer(node.input(other));
+
+            if (layers_.empty() || (layers_.back().kind != ForecastLayer::kDense)) unsupported(node, "only a bias after MatMul is supported");
+            if ((b == nullptr) || (b->floats.size() != width)) unsupported(node, "the bias is not stored weights of the layer's size");
+
+            for (size_t k = 0; k < width; k++) layers_.back().bias[k] += b->floats[k];
+        }
+        else if ((op == "Relu") || (op == "Sigmoid") || (op == "Tanh")) {
+            if (width == 0) unsupported(node, "the model must start with an LSTM, GRU or fully connected layer");
+
+            ForecastLayer layer;
+            layer.kind = (op == "Relu") ? ForecastLayer::kRelu : ((op == "Sigmoid") ? ForecastLayer::kSigmoid : ForecastLayer::kTanh);
+            layer.inputs = width;
+            layer.outputs = width;
+
+            layers_.push_back(std::move(layer));
+        }
+        else if ((op != "Dropout") && (op != "Identity") && (op != "Squeeze") && (op != "Reshape") && (op != "Flatten")) {
+            // Those change nothing when run one step of one sequence at a time.
+            unsupported(node, "operator not supported");
+        }
+
+        current = node.outputs[0];
+    }
+
+    if (layers_.empty()) throw std::runtime_error("Model has no layers");
+    if (current != graph.outputs[0]) throw std::runtime_error("Model output " + graph.outputs[0] + " is not the end of its chain of layers");
+
+    inputs_ = layers_.front().inputs;
+    outputs_ = layers_.back().outputs;
+
+    for (const ForecastLayer &layer : layers_) {
+        widest_ = std::max({widest_, round_up(layer.inputs, Simd::kPanelRows), layer.weights.padded_rows(), round_up(layer.outputs, Simd::kPanelRows)});
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Running
+
+void ForecastModel::set_normalization(const Normalization &normalization) {
+    auto check = [](const std::vector<float> &values, size_t size) {
+        if (!values.empty() && (values.size() != size)) throw std::invalid_argument("Normalization does not match the model");
+    };
+
+    check(normalization.input_mean, inputs_);
+    check(normalization.input_std, inputs_);
+    check(normalization.output_mean, outputs_);
+    check(normalization.output_std, outputs_);
+
+    normalization_ = normalization;
+}
+
+ForecastState ForecastModel::make_state() const {
+    ForecastState state;
+    size_t gates = 0, recurrent = 0, concat = 0;
+
+    for (const ForecastLayer &layer : layers_) {
+        if ((layer.kind != ForecastLayer::kLstm) && (layer.kind != ForecastLayer::kGru)) continue;
+
+        state.h.emplace_back(layer.outputs);
+        state.c.emplace_back(layer.outputs);
+
+        gates = std::max(gates, layer.weights.padded_rows());
+        recurrent = std::max(recurrent, layer.recurrent_zr.padded_rows() + layer.recurrent_h.padded_rows());
+        concat = std::max(concat, layer.inputs + layer.outputs);
+    }
+
+    state.gates = AlignedBuffer(gates);
+    state.recurrent = AlignedBuffer(recurrent);
+    state.concat = AlignedBuffer(concat);
+    state.values[0] = AlignedBuffer(widest_);
+    state.values[1] = AlignedBuffer(widest_);
+
+    reset(state);
+    return state;
+}
+
+void ForecastModel::reset(ForecastState &state) const {
+    for (const ForecastLayer &layer : layers_) {
+        if (layer.kind == ForecastLayer::kLstm) {
+            state.h[layer.state] = layer.initial_h;
+            state.c[layer.state] = layer.initial_c;
+        }
+        else if (layer.kind == ForecastLayer::kGru) {
+            state.h[layer.state] = layer.initial_h;
+        }
+    }
+}
+
+void ForecastModel::step(ForecastState &state, const float *in, float *out) const {
+    const Normalization &norm = normalization_;
+    float *x = state.values[0].data();
+    float *y = state.values[1].data();
+
+    for (size_t k = 0; k < inputs_; k++) x[k] = norm.input_mean.empty() ? in[k] : ((in[k] - norm.input_mean[k]) / norm.input_std[k]);
+
+    for (const ForecastLayer &layer : layers_) {
+        size_t hidden = layer.outputs;
+
+        switch (layer.kind) {
+            case ForecastLayer::kLstm: {
+                float *h = state.h[layer.state].data();
+                float *c = state.c[layer.state].data();
+                float *gates = state.gates.data();
+
+                std::memcpy(state.concat.data(), x, layer.inputs * sizeof(float));
+                std::memcpy(state.concat.data() + layer.inputs, h, hidden * sizeof(float));
+                std::memcpy(gates, layer.bias.data(), layer.bias.size() * sizeof(float));
+
+                layer.weights.multiply_add(state.concat.data(), gates);
+                apply_sigmoid(gates, 3 * hidden);
+                apply_tanh(gates + (3 * hidden), hidden);
+
+                lstm_update(gates, c, h, y, hidden);
+                break;
+            }
+
+            case ForecastLayer::kGru: {
+                float *h = state.h[layer.state].data();
+                float *gates = state.gates.data();
+                float *zr = state.recurrent.data();
+                float *hh = zr + layer.recurrent_zr.padded_rows();
+
+                std::memcpy(gates, layer.bias.data(), layer.bias.size() * sizeof(float));
+                std::memset(zr, 0, layer.recurrent_zr.padded_rows() * sizeof(float));
+                std::memcpy(hh, layer.recurrent_bias.data(), layer.recurrent_bias.size() * sizeof(float));
+
+                layer.weights.multiply_add(x, gates);
+                layer.recurrent_zr.multiply_add(h, zr);
+
+                for (size_t k = 0; k < 2 * hidden; k++) gates[k] += zr[k];
+                apply_sigmoid(gates, 2 * hidden);
+
+                const float *z = gates;
+                const float *r = gates + hidden;
+                float *n = gates + (2 * hidden);
+
+                if (layer.linear_before_reset) {
+                    layer.recurrent_h.multiply_add(h, hh);
+                    for (size_t k = 0; k < hidden; k++) n[k] += r[k] * hh[k];
+                }
+                else {
+                    for (size_t k = 0; k < hidden; k++) y[k] = r[k] * h[k];
+                    layer.recurrent_h.multiply_add(y, hh);
+                    for (size_t k = 0; k < hidden; k++) n[k] += hh[k];
+                }
+
+                apply_tanh(n, hidden);
+
+                for (size_t k = 0; k < hidden; k++) h[k] = n[k] + (z[k] * (h[k] - n[k]));
+                break;
+            }
+
+            case ForecastLayer::kDense:
+                std::memcpy(y, layer.bias.data(), layer.bias.size() * sizeof(float));
+                layer.weights.multiply_add(x, y);
+                break;
+
+            case ForecastLayer::kRelu:
+                std::memcpy(y, x, hidden * sizeof(float));
+                apply_relu(y, hidden);
+                break;
+
+            case ForecastLayer::kSigmoid:
+                std::memcpy(y, x, hidden * sizeof(float));
+                apply_sigmoid(y, hidden);
+                break;
+
+            case ForecastLayer::kTanh:
+                std::memcpy(y, x, hidden * sizeof(float));
+                apply_tanh(y, hidden);
+                break;
+        }
+
+        if ((layer.kind == ForecastLayer::kLstm) || (layer.kind == ForecastLayer::kGru)) {
+            std::memcpy(y, state.h[layer.state].data(), hidden * sizeof(float));
+        }
+
+        std::swap(x, y);
+    }
+
+    for (size_t k = 0; k < outputs_; k++) out[k] = norm.output_mean.empty() ? x[k] : ((x[k] * norm.output_std[k]) + norm.output_mean[k]);
+}
+
+void ForecastModel::forecast(ForecastState &state, const float *history, size_t history_steps, size_t horizon, float *out) const {
+    if (history_steps == 0) throw std::invalid_argument("A forecast needs a history");
+    if ((horizon > 1) && (inputs_ != outputs_)) throw std::invalid_argument("Model cannot be fed its own predictions");
+    if (horizon == 0) return;
+
+    reset(state);
+
+    for (size_t t = 0; t < history_steps; t++) step(state, history + (t * inputs_), out);
+
+    for (size_t t = 1; t < horizon; t++) step(state, out + ((t - 1) * outputs_), out + (t * outputs_));
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Water Quality Model
+
+Normalization water_quality_normalization() {
+    Normalization norm;
+
+    // Temperature (C), pH, turbidity (NTU). Inputs are samples 1 to 92 of each sequence, and targets 2 to 93.
+    norm.input_mean = {24.1348056f, 8.06036138f, 6.09135063f};
+    norm.input_std = {3.18477251f, 0.0728198781f, 7.42833620f};
+    norm.output_mean = {24.1347330f, 8.06036086f, 6.09147679f};
+    norm.output_std = {3.18489825f, 0.0728191035f, 7.42826806f};
+
+    return norm;
+}
+
+} // namespace lwqms
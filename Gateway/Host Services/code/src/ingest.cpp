@@ -0,0 +1,126 @@
+/*************************************************************************************
+ *
+ * @file ingest.cpp
+ *
+ * @brief Ingestion of the gateway's record stream into a storage sink
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/ingest.hpp"
+
+namespace lwqms {
+
+bool Deduplicator::seen(const PacketRecord &pkt) {
+    uint32_t key = (static_cast<uint32_t>(pkt.pkt_id) << 16) | crc16(pkt.payload.data(), pkt.payload_len);
+    Window &window = nodes_[pkt.src_id];
+
+    for (uint8_t k = 0; k < window.count; k++) {
+        if (window.keys[k] == key) return true;
+    }
+
+    window.keys[window.next] = key;
+    window.next = (window.next + 1) % kDedupWindow;
+    if (window.count < kDedupWindow) window.count++;
+
+    return false;
+}
+
+int64_t GatewayClock::to_unix_us(uint64_t gateway_us, int64_t host_now_us) {
+    int64_t offset_us = host_now_us - static_cast<int64_t>(gateway_us);
+
+    if (!anchored_ || (gateway_us < last_gateway_us_)) {
+        if (anchored_) resets_++;
+
+        anchored_ = true;
+        offset_us_ = offset_us;
+    }
+    else if (live_) {
+        // Time in the gateway and on the line only ever makes a record look later than it was.
+        if (offset_us < offset_us_) offset_us_ = offset_us;
+
+        // The gateway's crystal has run slow enough that the oldest estimate no longer holds.
+        if (offset_us - offset_us_ > kResyncUs) {
+            resets_++;
+            offset_us_ = offset_us;
+        }
+    }
+
+    last_gateway_us_ = gateway_us;
+
+    return offset_us_ + static_cast<int64_t>(gateway_us);
+}
+
+Ingestor::Ingestor(Sink &sink, const IngestOptions &options) : sink_(sink), options_(options), clock_(options.live) {}
+
+void Ingestor::feed(const uint8_t *data, size_t len, int64_t host_now_us) {
+    stream_.feed(data, len, [&](const Record &record) { ingest(record, host_now_us); });
+
+    if (unsynced_rows_ >= options_.sync_rows) sync();
+    else poll(host_now_us);
+}
+
+void Ingestor::poll(int64_t host_now_us) {
+    if ((unsynced_rows_ > 0) && (host_now_us - first_unsynced_us_ >= static_cast<int64_t>(options_.sync_interval_ms) * 1000)) sync();
+}
+
+void Ingestor::sync() {
+    if (unsynced_rows_ == 0) return;
+
+    sink_.flush(true);
+    stats_.syncs++;
+    unsynced_rows_ = 0;
+}
+
+void Ingestor::ingest(const Record &record, int64_t host_now_us) {
+    if (options_.on_record) options_.on_record(record);
+
+    if (record.type == RecordType::Status) {
+        stats_.status_records++;
+        stats_.ring_overflows = record.status.ring_overflows;
+        stats_.queue_overflows = record.status.queue_overflows;
+        return;
+    }
+
+    const PacketRecord &pkt = record.packet;
+
+    stats_.packets++;
+
+    if (dedup_.seen(pkt)) {
+        stats_.duplicates++;
+        return;
+    }
+
+    int64_t rx_unix_us = clock_.to_unix_us(pkt.rx_time_us, host_now_us);
+    uint32_t rows = 0;
+
+    if (pkt.type() == PacketType::Message) {
+        sink_.write(MessageRow{rx_unix_us, pkt.src_id, pkt.message()});
+        stats_.messages++;
+        rows = 1;
+    }
+    else if (!pkt.has_samples()) {
+        sink_.write(MessageRow{rx_unix_us, pkt.src_id, "Malformed telemetry batch"});
+        stats_.undecoded++;
+        rows = 1;
+    }
+    else {
+        for (size_t k = 0; k < pkt.qty_samples; k++) {
+            const Sample &sample = pkt.samples[k];
+
+            sink_.write(SampleRow{rx_unix_us - (static_cast<int64_t>(sample.age_s) * 1000000), pkt.src_id, sample.turbidity, sample.temperature,
+                sample.pH, pkt.has_link(), pkt.rssi_pkt_dbm, pkt.snr_pkt_db});
+        }
+
+        stats_.samples += pkt.qty_samples;
+        rows = pkt.qty_samples;
+    }
+
+    if ((unsynced_rows_ == 0) && (rows > 0)) first_unsynced_us_ = host_now_us;
+    unsynced_rows_ += rows;
+}
+
+} // namespace lwqms
@@ -0,0 +1,135 @@
+/*************************************************************************************
+ *
+ * @file mapped_file.cpp
+ *
+ * @brief Files mapped into memory
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/mapped_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lwqms {
+
+namespace {
+
+[[noreturn]] void fail(const std::string &what, const std::string &path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        close();
+
+        fd_ = other.fd_;
+        writable_ = other.writable_;
+        data_ = other.data_;
+        size_ = other.size_;
+        path_ = std::move(other.path_);
+
+        other.fd_ = -1;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    return *this;
+}
+
+bool MappedFile::open(const std::string &path, bool writable, size_t min_size) {
+    close();
+
+    path_ = path;
+    writable_ = writable;
+    fd_ = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC), 0644);
+
+    if (fd_ < 0) {
+        if (!writable && (errno == ENOENT)) return false;
+        fail("Could not open", path);
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) < 0) fail("Could not stat", path);
+
+    size_t size = static_cast<size_t>(st.st_size);
+
+    if (writable && (size < min_size)) {
+        if (::ftruncate(fd_, static_cast<off_t>(min_size)) < 0) fail("Could not grow", path);
+        size = min_size;
+    }
+
+    if (size == 0) {
+        close();
+        return false;
+    }
+
+    map(size);
+
+    return true;
+}
+
+void MappedFile::map(size_t size) {
+    void *data = ::mmap(nullptr, size, PROT_READ | (writable_ ? PROT_WRITE : 0), MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) fail("Could not map", path_);
+
+    data_ = static_cast<uint8_t *>(data);
+    size_ = size;
+}
+
+void MappedFile::grow(size_t size) {
+    if (::ftruncate(fd_, static_cast<off_t>(size)) < 0) fail("Could not grow", path_);
+
+    ::munmap(data_, size_);
+    map(size);
+}
+
+void MappedFile::remap_if_grown() {
+    struct stat st;
+
+    if ((::fstat(fd_, &st) == 0) && (static_cast<size_t>(st.st_size) > size_)) {
+        ::munmap(data_, size_);
+        map(static_cast<size_t>(st.st_size));
+    }
+}
+
+void MappedFile::sync(size_t offset, size_t len) {
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+    size_t start = offset - (offset % page);
+    len = std::min(len + (offset - start), size_ - start);
+
+    if (::msync(data_ + start, len, MS_SYNC) < 0) fail("Could not sync", path_);
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) ::munmap(data_, size_);
+    if (fd_ >= 0) ::close(fd_);
+
+    fd_ = -1;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace lwqms
@@ -0,0 +1,407 @@
+/*************************************************************************************
+ *
+ * @file onnx.cpp
+ *
+ * @brief Reader of ONNX model files
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/onnx.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace lwqms {
+
+namespace {
+
+// Field numbers of the messages read, from onnx.proto
+constexpr uint32_t kModelProducer = 2;
+constexpr uint32_t kModelGraph = 7;
+
+constexpr uint32_t kGraphNode = 1;
+constexpr uint32_t kGraphInitializer = 5;
+constexpr uint32_t kGraphInput = 11;
+constexpr uint32_t kGraphOutput = 12;
+
+constexpr uint32_t kNodeInput = 1;
+constexpr uint32_t kNodeOutput = 2;
+constexpr uint32_t kNodeName = 3;
+constexpr uint32_t kNodeOpType = 4;
+constexpr uint32_t kNodeAttribute = 5;
+
+constexpr uint32_t kAttributeName = 1;
+constexpr uint32_t kAttributeFloat = 2;
+constexpr uint32_t kAttributeInt = 3;
+constexpr uint32_t kAttributeString = 4;
+constexpr uint32_t kAttributeFloats = 7;
+constexpr uint32_t kAttributeInts = 8;
+constexpr uint32_t kAttributeStrings = 9;
+
+constexpr uint32_t kTensorDims = 1;
+constexpr uint32_t kTensorDataType = 2;
+constexpr uint32_t kTensorFloatData = 4;
+constexpr uint32_t kTensorInt64Data = 7;
+constexpr uint32_t kTensorName = 8;
+constexpr uint32_t kTensorRawData = 9;
+constexpr uint32_t kTensorDataLocation = 14;
+
+constexpr uint32_t kValueInfoName = 1;
+
+constexpr int64_t kTypeFloat = 1;
+constexpr int64_t kTypeInt64 = 7;
+
+enum WireType : uint32_t {
+    kVarint = 0,
+    kFixed64 = 1,
+    kBytes = 2,
+    kFixed32 = 5
+};
+
+/**
+ * @brief Reads the fields of one protobuf message in turn. Fields are little-endian whatever the host is, so fixed-width
+ * ones are put together byte by byte.
+ */
+class ProtoReader {
+public:
+    ProtoReader(const uint8_t *begin, const uint8_t *end) : pos_(begin), end_(end) {}
+
+    /**
+     * @brief Reads the key of the next field.
+     *
+     * @returns False at the end of the message
+     */
+    bool next() {
+        if (pos_ >= end_) return false;
+
+        uint64_t key = varint();
+        field_ = static_cast<uint32_t>(key >> 3);
+        wire_ = static_cast<uint32_t>(key & 7);
+
+        return true;
+    }
+
+    uint32_t field() const { return field_; }
+    uint32_t wire() const { return wire_; }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= end_) throw std::runtime_error("Model is cut short");
+
+            uint8_t byte = *pos_++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+
+        throw std::runtime_error("Model has a malformed number");
+    }
+
+    uint32_t fixed32() {
+        need(4);
+
+        uint32_t value = static_cast<uint32_t>(pos_[0]) | (static_cast<uint32_t>(pos_[1]) << 8) | (static_cast<uint32_t>(pos_[2]) << 16) |
+            (static_cast<uint32_t>(pos_[3]) << 24);
+        pos_ += 4;
+
+        return value;
+    }
+
+    float f32() {
+        uint32_t bits = fixed32();
+        float value;
+
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @returns Reader of a length-delimited field: a message, string or packed array
+     */
+    ProtoReader bytes() {
+        uint64_t len = varint();
+        need(len);
+
+        ProtoReader inner(pos_, pos_ + len);
+        pos_ += len;
+
+        return inner;
+    }
+
+    std::string string() {
+        ProtoReader inner = bytes();
+        return std::string(reinterpret_cast<const char *>(inner.pos_), static_cast<size_t>(inner.end_ - inner.pos_));
+    }
+
+    /**
+     * @brief Reads a repeated integer field, packed or not.
+     */
+    void ints(std::vector<int64_t> &out) {
+        if (wire_ == kBytes) {
+            ProtoReader packed = bytes();
+            while (packed.pos_ < packed.end_) out.push_back(static_cast<int64_t>(packed.varint()));
+        }
+        else {
+            out.push_back(static_cast<int64_t>(varint()));
+        }
+    }
+
+    /**
+     * @brief Reads a repeated float field, packed or not.
+     */
+    void floats(std::vector<float> &out) {
+        if (wire_ == kBytes) {
+            ProtoReader packed = bytes();
+            while (packed.pos_ < packed.end_) out.push_back(packed.f32());
+        }
+        else {
+            out.push_back(f32());
+        }
+    }
+
+    void skip() {
+        switch (wire_) {
+            case kVarint: varint(); break;
+            case kFixed64: need(8); pos_ += 8; break;
+            case kBytes: bytes(); break;
+            case kFixed32: need(4); pos_ += 4; break;
+            default: throw std::runtime_error("Model has a field of unknown wire type");
+        }
+    }
+
+private:
+    void need(uint64_t len) const {
+        if (len > static_cast<uint64_t>(end_ - pos_)) throw std::runtime_error("Model is cut short");
+    }
+
+    const uint8_t *pos_;
+    const uint8_t *end_;
+    uint32_t field_ = 0;
+    uint32_t wire_ = 0;
+};
+
+OnnxAttribute read_attribute(ProtoReader in) {
+    OnnxAttribute attribute;
+
+    while (in.next()) {
+        switch (in.field()) {
+            case kAttributeName: attribute.name = in.string(); break;
+            case kAttributeFloat: attribute.f = in.f32(); break;
+            case kAttributeInt: attribute.i = static_cast<int64_t>(in.varint()); break;
+            case kAttributeString: attribute.s = in.string(); break;
+            case kAttributeFloats: in.floats(attribute.floats); break;
+            case kAttributeInts: in.ints(attribute.ints); break;
+            case kAttributeStrings: attribute.strings.push_back(in.string()); break;
+            default: in.skip(); break;
+        }
+    }
+
+    return attribute;
+}
+
+OnnxNode read_node(ProtoReader in) {
+    OnnxNode node;
+
+    while (in.next()) {
+        switch (in.field()) {
+            case kNodeInput: node.inputs.push_back(in.string()); break;
+            case kNodeOutput: node.outputs.push_back(in.string()); break;
+            case kNodeName: node.name = in.string(); break;
+            case kNodeOpType: node.op_type = in.string(); break;
+            case kNodeAttribute: node.attributes.push_back(read_attribute(in.bytes())); break;
+            default: in.skip(); break;
+        }
+    }
+
+    return node;
+}
+
+OnnxTensor read_tensor(ProtoReader in) {
+    OnnxTensor tensor;
+    int64_t type = 0;
+    std::string raw;
+
+    while (in.next()) {
+        switch (in.field()) {
+            case kTensorDims: in.ints(tensor.dims); break;
+            case kTensorDataType: type = static_cast<int64_t>(in.varint()); break;
+            case kTensorFloatData: in.floats(tensor.floats); break;
+            case kTensorInt64Data: in.ints(tensor.ints); break;
+            case kTensorName: tensor.name = in.string(); break;
+            case kTensorRawData: raw = in.string(); break;
+
+            case kTensorDataLocation:
+                if (in.varint() != 0) throw std::runtime_error("Weights of " + tensor.name + " are kept outside the model file");
+                break;
+
+            default: in.skip(); break;
+        }
+    }
+
+    // Raw data is little-endian, as the fields are.
+    if (!raw.empty()) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(raw.data());
+
+        if (type == kTypeFloat) {
+            tensor.floats.resize(raw.size() / 4);
+
+            for (size_t k = 0; k < tensor.floats.size(); k++) {
+                uint32_t bits = static_cast<uint32_t>(bytes[4 * k]) | (static_cast<uint32_t>(bytes[4 * k + 1]) << 8) |
+                    (static_cast<uint32_t>(bytes[4 * k + 2]) << 16) | (static_cast<uint32_t>(bytes[4 * k + 3]) << 24);
+                std::memcpy(&tensor.floats[k], &bits, sizeof(bits));
+            }
+        }
+        else if (type == kTypeInt64) {
+            tensor.ints.resize(raw.size() / 8);
+
+            for (size_t k = 0; k < tensor.ints.size(); k++) {
+                uint64_t value = 0;
+                for (size_t b = 0; b < 8; b++) value |= static_cast<uint64_t>(bytes[8 * k + b]) << (8 * b);
+                tensor.ints[k] = static_cast<int64_t>(value);
+            }
+        }
+    }
+
+    if ((type != kTypeFloat) && (type != kTypeInt64)) throw std::runtime_error("Weights of " + tensor.name + " are of a type not supported");
+
+    size_t stored = (type == kTypeFloat) ? tensor.floats.size() : tensor.ints.size();
+    if (stored != tensor.size()) throw std::runtime_error("Weights of " + tensor.name + " do not match their dimensions");
+
+    return tensor;
+}
+
+std::string read_value_name(ProtoReader in) {
+    std::string name;
+
+    while (in.next()) {
+        if (in.field() == kValueInfoName) name = in.string();
+        else in.skip();
+    }
+
+    return name;
+}
+
+OnnxGraph read_graph(ProtoReader in) {
+    OnnxGraph graph;
+    std::vector<std::string> inputs;
+
+    while (in.next()) {
+        switch (in.field()) {
+            case kGraphNode: graph.nodes.push_back(read_node(in.bytes())); break;
+
+            case kGraphInitializer: {
+                OnnxTensor tensor = read_tensor(in.bytes());
+                std::string name = tensor.name;
+                graph.initializers[name] = std::move(tensor);
+                break;
+            }
+
+            case kGraphInput: inputs.push_back(read_value_name(in.bytes())); break;
+            case kGraphOutput: graph.outputs.push_back(read_value_name(in.bytes())); break;
+            default: in.skip(); break;
+        }
+    }
+
+    // Older models list their weights among the inputs too.
+    for (std::string &name : inputs) {
+        if (graph.initializers.find(name) == graph.initializers.end()) graph.inputs.push_back(std::move(name));
+    }
+
+    return graph;
+}
+
+[[noreturn]] void fail(const std::string &what, const std::string &path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+size_t OnnxTensor::size() const {
+    size_t count = 1;
+    for (int64_t dim : dims) count *= static_cast<size_t>(dim);
+
+    return count;
+}
+
+const OnnxAttribute *OnnxNode::attribute(const std::string &name) const {
+    for (const OnnxAttribute &attribute : attributes) {
+        if (attribute.name == name) return &attribute;
+    }
+
+    return nullptr;
+}
+
+const std::string &OnnxNode::input(size_t k) const {
+    static const std::string none;
+    return (k < inputs.size()) ? inputs[k] : none;
+}
+
+const OnnxTensor *OnnxGraph::initializer(const std::string &name) const {
+    auto found = initializers.find(name);
+    return (found != initializers.end()) ? &found->second : nullptr;
+}
+
+const OnnxNode *OnnxGraph::producer_of(const std::string &name) const {
+    for (const OnnxNode &node : nodes) {
+        for (const std::string &output : node.outputs) {
+            if (output == name) return &node;
+        }
+    }
+
+    return nullptr;
+}
+
+OnnxGraph load_onnx(const std::string &path) {
+    FILE *in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr) fail("Could not open", path);
+
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t len;
+
+    while ((len = std::fread(buf, 1, sizeof(buf), in)) > 0) data.insert(data.end(), buf, buf + len);
+
+    bool failed = std::ferror(in) != 0;
+    std::fclose(in);
+    if (failed) fail("Could not read", path);
+
+    ProtoReader model(data.data(), data.data() + data.size());
+    OnnxGraph graph;
+    std::string producer;
+    bool found = false;
+
+    try {
+        while (model.next()) {
+            if ((model.field() == kModelGraph) && (model.wire() == kBytes)) {
+                graph = read_graph(model.bytes());
+                found = true;
+            }
+            else if ((model.field() == kModelProducer) && (model.wire() == kBytes)) {
+                producer = model.string();
+            }
+            else {
+                model.skip();
+            }
+        }
+    }
+    catch (const std::runtime_error &err) {
+        throw std::runtime_error(path + ": " + err.what());
+    }
+
+    if (!found) throw std::runtime_error(path + " is not an ONNX model");
+
+    graph.producer = producer;
+    return graph;
+}
+
+} // namespace lwqms
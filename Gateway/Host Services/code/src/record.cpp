@@ -0,0 +1,245 @@
+/*************************************************************************************
+ *
+ * @file record.cpp
+ *
+ * @brief Decoder for the binary records the gateway sends its host
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/record.hpp"
+
+#include <cstring>
+
+namespace lwqms {
+
+namespace {
+
+constexpr size_t kPrefixLen = 4;
+constexpr size_t kPacketFixedLen = 22;
+constexpr size_t kSampleLen = 14;
+constexpr size_t kStatusLen = 20;
+constexpr size_t kCrcLen = 2;
+
+// Fields are little-endian whatever the host is, so they are put together byte by byte.
+class Reader {
+public:
+    explicit Reader(const uint8_t *buf) : buf_(buf) {}
+
+    uint8_t u8() { return buf_[pos_++]; }
+    int8_t i8() { return static_cast<int8_t>(u8()); }
+
+    uint16_t u16() {
+        uint16_t value = static_cast<uint16_t>(buf_[pos_] | (buf_[pos_ + 1] << 8));
+        pos_ += 2;
+        return value;
+    }
+
+    uint32_t u32() {
+        uint32_t value = static_cast<uint32_t>(u16());
+        return value | (static_cast<uint32_t>(u16()) << 16);
+    }
+
+    uint64_t u64() {
+        uint64_t value = u32();
+        return value | (static_cast<uint64_t>(u32()) << 32);
+    }
+
+    float f32() {
+        uint32_t bits = u32();
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void bytes(uint8_t *out, size_t len) {
+        std::memcpy(out, buf_ + pos_, len);
+        pos_ += len;
+    }
+
+private:
+    const uint8_t *buf_;
+    size_t pos_ = kPrefixLen;
+};
+
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t> &buf) : buf_(buf) {}
+
+    void u8(uint8_t value) { buf_.push_back(value); }
+
+    void u16(uint16_t value) {
+        u8(static_cast<uint8_t>(value));
+        u8(static_cast<uint8_t>(value >> 8));
+    }
+
+    void u32(uint32_t value) {
+        u16(static_cast<uint16_t>(value));
+        u16(static_cast<uint16_t>(value >> 16));
+    }
+
+    void u64(uint64_t value) {
+        u32(static_cast<uint32_t>(value));
+        u32(static_cast<uint32_t>(value >> 32));
+    }
+
+    void f32(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u32(bits);
+    }
+
+private:
+    std::vector<uint8_t> &buf_;
+};
+
+DecodeStatus decode_packet(const uint8_t *buf, size_t len, PacketRecord &pkt) {
+    if (len < kPacketFixedLen + 1) return DecodeStatus::TooShort;
+
+    Reader in(buf);
+
+    pkt.flags = buf[2];
+    pkt.packet_type = buf[3];
+    pkt.src_id = in.u16();
+    pkt.dest_id = in.u16();
+    pkt.pkt_id = in.u16();
+    pkt.rx_time_us = in.u64();
+    pkt.rssi_pkt_dbm = in.i8();
+    pkt.snr_pkt_db = in.i8();
+    pkt.signal_rssi_pkt_dbm = in.i8();
+    pkt.payload_len = in.u8();
+
+    if ((pkt.payload_len > kPayloadLenMax) || (len < kPacketFixedLen + pkt.payload_len + 1)) return DecodeStatus::BadLength;
+
+    in.bytes(pkt.payload.data(), pkt.payload_len);
+    pkt.qty_samples = in.u8();
+
+    if ((pkt.qty_samples > kSamplesMax) || (len != kPacketFixedLen + pkt.payload_len + 1 + (pkt.qty_samples * kSampleLen))) {
+        return DecodeStatus::BadLength;
+    }
+
+    for (size_t k = 0; k < pkt.qty_samples; k++) {
+        Sample &sample = pkt.samples[k];
+
+        sample.age_s = in.u16();
+        sample.turbidity = in.f32();
+        sample.temperature = in.f32();
+        sample.pH = in.f32();
+    }
+
+    return DecodeStatus::Ok;
+}
+
+DecodeStatus decode_status(const uint8_t *buf, size_t len, StatusRecord &status) {
+    if (len != kStatusLen) return DecodeStatus::BadLength;
+
+    Reader in(buf);
+
+    status.time_us = in.u64();
+    status.ring_overflows = in.u32();
+    status.queue_overflows = in.u32();
+
+    return DecodeStatus::Ok;
+}
+
+} // namespace
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF
+uint16_t crc16(const uint8_t *buf, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    for (size_t k = 0; k < len; k++) {
+        crc ^= static_cast<uint16_t>(buf[k] << 8);
+
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+std::string PacketRecord::message() const {
+    const char *text = reinterpret_cast<const char *>(payload.data());
+
+    return std::string(text, strnlen(text, payload_len));
+}
+
+DecodeStatus decode_record(const uint8_t *buf, size_t len, Record &out) {
+    if (len < kPrefixLen + kCrcLen) return DecodeStatus::TooShort;
+
+    len -= kCrcLen;
+
+    if (crc16(buf, len) != static_cast<uint16_t>(buf[len] | (buf[len + 1] << 8))) return DecodeStatus::BadCrc;
+    if (buf[0] != kRecordVersion) return DecodeStatus::BadVersion;
+
+    out.type = static_cast<RecordType>(buf[1]);
+
+    switch (out.type) {
+        case RecordType::Packet:
+            return decode_packet(buf, len, out.packet);
+        case RecordType::Status:
+            return decode_status(buf, len, out.status);
+    }
+
+    return DecodeStatus::UnknownType;
+}
+
+void encode_record(const Record &record, std::vector<uint8_t> &buf) {
+    size_t start = buf.size();
+    Writer out(buf);
+
+    out.u8(kRecordVersion);
+    out.u8(static_cast<uint8_t>(record.type));
+
+    if (record.type == RecordType::Packet) {
+        const PacketRecord &pkt = record.packet;
+
+        out.u8(pkt.flags);
+        out.u8(pkt.packet_type);
+        out.u16(pkt.src_id);
+        out.u16(pkt.dest_id);
+        out.u16(pkt.pkt_id);
+        out.u64(pkt.rx_time_us);
+        out.u8(static_cast<uint8_t>(pkt.rssi_pkt_dbm));
+        out.u8(static_cast<uint8_t>(pkt.snr_pkt_db));
+        out.u8(static_cast<uint8_t>(pkt.signal_rssi_pkt_dbm));
+        out.u8(pkt.payload_len);
+        buf.insert(buf.end(), pkt.payload.begin(), pkt.payload.begin() + pkt.payload_len);
+        out.u8(pkt.qty_samples);
+
+        for (size_t k = 0; k < pkt.qty_samples; k++) {
+            out.u16(pkt.samples[k].age_s);
+            out.f32(pkt.samples[k].turbidity);
+            out.f32(pkt.samples[k].temperature);
+            out.f32(pkt.samples[k].pH);
+        }
+    }
+    else {
+        out.u8(0);
+        out.u8(0);
+        out.u64(record.status.time_us);
+        out.u32(record.status.ring_overflows);
+        out.u32(record.status.queue_overflows);
+    }
+
+    out.u16(crc16(buf.data() + start, buf.size() - start));
+}
+
+const char *to_string(DecodeStatus status) {
+    switch (status) {
+        case DecodeStatus::Ok: return "ok";
+        case DecodeStatus::TooShort: return "too short";
+        case DecodeStatus::BadCrc: return "bad CRC";
+        case DecodeStatus::BadVersion: return "unknown version";
+        case DecodeStatus::UnknownType: return "unknown record type";
+        case DecodeStatus::BadLength: return "bad length";
+    }
+
+    return "?";
+}
+
+} // namespace lwqms
@@ -0,0 +1,307 @@
+/*************************************************************************************
+ *
+ * @file rollup.cpp
+ *
+ * @brief Rollups of the telemetry over 10 minute, 1 hour and 1 day buckets
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/rollup.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define ROLLUP_VERSION 1
+#define ROLLUP_HEADER_LEN 64
+#define ROLLUP_GROW_BUCKETS 256             // 22 KiB at a time: 42 hours of 10 minute buckets
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+namespace {
+
+struct RollupHeader {
+    char magic[8];                  // "LWQMSRUP"
+    uint32_t version;
+    uint16_t node_id;
+    uint8_t resolution;
+    uint8_t reserved;
+    uint64_t count;                 // Written after a new bucket, so a reader never sees one half made
+    uint64_t seq;                   // Odd while the writer moves buckets to insert one out of time order
+};
+
+const char kRollupMagic[8] = {'L', 'W', 'Q', 'M', 'S', 'R', 'U', 'P'};
+
+RollupHeader *header(const MappedFile &file) {
+    return reinterpret_cast<RollupHeader *>(file.data());
+}
+
+RollupBucket *buckets(const MappedFile &file) {
+    return reinterpret_cast<RollupBucket *>(file.data() + ROLLUP_HEADER_LEN);
+}
+
+size_t capacity(const MappedFile &file) {
+    return (file.size() - ROLLUP_HEADER_LEN) / sizeof(RollupBucket);
+}
+
+void begin_change(uint64_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void end_change(uint64_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+int64_t floor_to(int64_t time_us, int64_t width_us) {
+    int64_t q = time_us / width_us;
+    if ((time_us % width_us) < 0) q--;
+
+    return q * width_us;
+}
+
+/**
+ * @returns Local midnight starting the day of a time. The day is cached, as samples come in time order.
+ */
+int64_t local_day_start(int64_t time_us) {
+    thread_local int64_t cached_start_us = 0;
+    thread_local int64_t cached_end_us = 0;
+
+    if ((time_us >= cached_start_us) && (time_us < cached_end_us)) return cached_start_us;
+
+    time_t seconds = static_cast<time_t>(floor_to(time_us, 1000000) / 1000000);
+    struct tm local;
+
+    localtime_r(&seconds, &local);
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_isdst = -1;
+
+    time_t start = std::mktime(&local);
+
+    local.tm_mday++;
+    local.tm_hour = 0;
+    local.tm_min = 0;
+    local.tm_sec = 0;
+    local.tm_isdst = -1;
+
+    time_t end = std::mktime(&local);
+
+    cached_start_us = static_cast<int64_t>(start) * 1000000;
+    cached_end_us = static_cast<int64_t>(end) * 1000000;
+
+    return cached_start_us;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Functions
+
+int64_t bucket_start(Resolution resolution, int64_t time_us) {
+    // 10 minute and hour buckets line up with Unix time; days with the local calendar.
+    switch (resolution) {
+        case Resolution::TenMinutes: return floor_to(time_us, 600LL * 1000000);
+        case Resolution::Hour: return floor_to(time_us, 3600LL * 1000000);
+        case Resolution::Day: return local_day_start(time_us);
+    }
+
+    return time_us;
+}
+
+const char *to_string(Resolution resolution) {
+    switch (resolution) {
+        case Resolution::TenMinutes: return "10m";
+        case Resolution::Hour: return "1h";
+        case Resolution::Day: return "1d";
+    }
+
+    return "?";
+}
+
+bool parse_resolution(const char *text, Resolution &resolution) {
+    for (Resolution candidate : {Resolution::TenMinutes, Resolution::Hour, Resolution::Day}) {
+        if (std::strcmp(text, to_string(candidate)) == 0) {
+            resolution = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Rollup Files
+
+bool RollupFile::open(const std::string &path, uint16_t node_id, Resolution resolution, bool writable) {
+    resolution_ = resolution;
+
+    if (!file_.open(path, writable, ROLLUP_HEADER_LEN + (ROLLUP_GROW_BUCKETS * sizeof(RollupBucket)))) return false;
+
+    RollupHeader *h = header(file_);
+
+    if (writable && (std::memcmp(h->magic, kRollupMagic, sizeof(kRollupMagic)) != 0)) {
+        h->version = ROLLUP_VERSION;
+        h->node_id = node_id;
+        h->resolution = static_cast<uint8_t>(resolution);
+        h->count = 0;
+        h->seq = 0;
+        std::memcpy(h->magic, kRollupMagic, sizeof(kRollupMagic));
+        dirty_from_ = 0;
+    }
+
+    return true;
+}
+
+uint64_t RollupFile::count() const {
+    return __atomic_load_n(&header(file_)->count, __ATOMIC_ACQUIRE);
+}
+
+void RollupFile::add(const SampleRow &row) {
+    const float values[kMetrics] = {row.turbidity, row.temperature, row.pH};
+    int64_t start = bucket_start(resolution_, row.time_us);
+    uint64_t count = header(file_)->count;
+    RollupBucket *all = buckets(file_);
+
+    // Nearly always the last bucket, or one after it.
+    uint64_t position = count;
+    while ((position > 0) && (all[position - 1].start_us > start)) position--;
+
+    if ((position > 0) && (all[position - 1].start_us == start)) {
+        RollupBucket &bucket = all[position - 1];
+        uint32_t seq = bucket.seq;
+
+        __atomic_store_n(&bucket.seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        for (size_t m = 0; m < kMetrics; m++) {
+            bucket.sum[m] += values[m];
+            bucket.min[m] = std::min(bucket.min[m], values[m]);
+            bucket.max[m] = std::max(bucket.max[m], values[m]);
+        }
+
+        bucket.count++;
+
+        if (row.time_us >= bucket.last_time_us) {
+            bucket.last_time_us = row.time_us;
+            std::memcpy(bucket.last, values, sizeof(values));
+        }
+
+        __atomic_store_n(&bucket.seq, seq + 2, __ATOMIC_RELEASE);
+        dirty_from_ = std::min(dirty_from_, position - 1);
+        return;
+    }
+
+    if (count == capacity(file_)) {
+        file_.grow(file_.size() + (ROLLUP_GROW_BUCKETS * sizeof(RollupBucket)));
+        all = buckets(file_);
+    }
+
+    // Buckets readers may be reading are only moved inside a change of the file's sequence, which they read again after.
+    bool moving = position < count;
+
+    if (moving) {
+        begin_change(&header(file_)->seq);
+        std::memmove(&all[position + 1], &all[position], (count - position) * sizeof(RollupBucket));
+    }
+
+    RollupBucket &bucket = all[position];
+
+    bucket = {};
+    bucket.start_us = start;
+    bucket.last_time_us = row.time_us;
+    bucket.count = 1;
+
+    for (size_t m = 0; m < kMetrics; m++) {
+        bucket.sum[m] = values[m];
+        bucket.min[m] = values[m];
+        bucket.max[m] = values[m];
+        bucket.last[m] = values[m];
+    }
+
+    dirty_from_ = std::min(dirty_from_, position);
+    __atomic_store_n(&header(file_)->count, count + 1, __ATOMIC_RELEASE);
+
+    if (moving) end_change(&header(file_)->seq);
+}
+
+void RollupFile::clear() {
+    RollupHeader *h = header(file_);
+
+    // The buckets are made again from the first, under readers still holding the old count. A writer that stopped part way
+    // through moving them left the sequence odd.
+    if (h->seq & 1) end_change(&h->seq);
+
+    begin_change(&h->seq);
+    __atomic_store_n(&h->count, 0, __ATOMIC_RELEASE);
+    end_change(&h->seq);
+    dirty_from_ = 0;
+}
+
+void RollupFile::make_durable() {
+    if (dirty_from_ == UINT64_MAX) return;
+
+    uint64_t count = header(file_)->count;
+
+    file_.sync(0, ROLLUP_HEADER_LEN);
+    if (count > dirty_from_) file_.sync(ROLLUP_HEADER_LEN + (dirty_from_ * sizeof(RollupBucket)), (count - dirty_from_) * sizeof(RollupBucket));
+
+    dirty_from_ = UINT64_MAX;
+}
+
+size_t RollupFile::read(int64_t from_us, int64_t to_us, std::vector<RollupBucket> &out, size_t limit) {
+    size_t out_len = out.size();
+    uint64_t seq;
+
+    // Read again if the writer moved the buckets meanwhile.
+    do {
+        out.resize(out_len);
+
+        do {
+            seq = __atomic_load_n(&header(file_)->seq, __ATOMIC_ACQUIRE);
+        } while (seq & 1);
+
+        uint64_t count = this->count();
+
+        // The writer has grown the file past the part mapped here.
+        if (count > capacity(file_)) {
+            file_.remap_if_grown();
+            count = std::min<uint64_t>(count, capacity(file_));
+        }
+
+        const RollupBucket *all = buckets(file_);
+        const RollupBucket *first = std::lower_bound(all, all + count, from_us, [](const RollupBucket &b, int64_t t) { return b.start_us < t; });
+
+        for (const RollupBucket *b = first; (b < all + count) && (b->start_us < to_us) && (out.size() - out_len < limit); b++) {
+            RollupBucket copy;
+            uint32_t before, after;
+
+            // Read again if the writer changed the bucket meanwhile.
+            do {
+                before = __atomic_load_n(&b->seq, __ATOMIC_ACQUIRE);
+                std::memcpy(&copy, b, sizeof(copy));
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                after = __atomic_load_n(&b->seq, __ATOMIC_RELAXED);
+            } while ((before != after) || (before & 1));
+
+            out.push_back(copy);
+        }
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&header(file_)->seq, __ATOMIC_RELAXED) != seq);
+
+    return out.size() - out_len;
+}
+
+} // namespace lwqms
@@ -0,0 +1,123 @@
+/*************************************************************************************
+ *
+ * @file tail.cpp
+ *
+ * @brief Incremental reader of payloads.csv
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/tail.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define TAIL_READ_LEN (1024 * 1024)
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lwqms {
+
+void PayloadTail::reset() {
+    offset_ = 0;
+    latest_.clear();
+    rows_ = 0;
+    rejected_ = 0;
+}
+
+void PayloadTail::take_line(const char *line, size_t len) {
+    if ((len > 0) && (line[len - 1] == '\r')) len--;
+    if (len == 0) return;
+
+    SampleRow row;
+
+    if (!parse_payload_row(line, len, times_, row)) {
+        rejected_++;
+        return;
+    }
+
+    const char *comma = static_cast<const char *>(std::memchr(line, ',', len));
+    LatestSample &latest = latest_[row.node_id];
+
+    latest.row = row;
+    latest.time_text.assign(line, comma);
+    latest.samples++;
+    rows_++;
+}
+
+int64_t PayloadTail::poll() {
+    int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+
+    if (::fstat(fd, &st) < 0) {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        return -1;
+    }
+
+    // Rotated, replaced or cut short: what was read no longer describes the file.
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+
+    if ((static_cast<uint64_t>(st.st_dev) != device_) || (static_cast<uint64_t>(st.st_ino) != inode_) || (size < offset_)) {
+        reset();
+        device_ = static_cast<uint64_t>(st.st_dev);
+        inode_ = static_cast<uint64_t>(st.st_ino);
+    }
+
+    uint64_t rows_before = rows_;
+    buf_.resize(TAIL_READ_LEN);
+
+    // Whole lines only: the offset stays at the start of a line still being written.
+    while (offset_ < size) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(buf_.size(), size - offset_));
+        ssize_t len = ::pread(fd, buf_.data(), want, static_cast<off_t>(offset_));
+
+        if (len < 0) {
+            if (errno == EINTR) continue;
+
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            return -1;
+        }
+
+        if (len == 0) break;
+
+        const char *begin = buf_.data();
+        const char *end = begin + len;
+        const char *newline;
+
+        while ((newline = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)))) != nullptr) {
+            take_line(begin, static_cast<size_t>(newline - begin));
+            begin = newline + 1;
+        }
+
+        offset_ += static_cast<uint64_t>(begin - buf_.data());
+
+        // A line longer than the buffer is read again with a larger one.
+        if (begin == buf_.data()) {
+            if (static_cast<size_t>(len) < buf_.size()) break;
+            buf_.resize(buf_.size() * 2);
+        }
+    }
+
+    ::close(fd);
+
+    return static_cast<int64_t>(rows_ - rows_before);
+}
+
+} // namespace lwqms
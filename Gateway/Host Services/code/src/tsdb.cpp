@@ -0,0 +1,715 @@
+/*************************************************************************************
+ *
+ * @file tsdb.cpp
+ *
+ * @brief Telemetry store: append-only segment files of fixed-width columns, with a time index per node
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/tsdb.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lwqms {
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define TSDB_VERSION 1
+#define TSDB_SEGMENT_HEADER_LEN 4096        // The columns start on a page of their own
+#define TSDB_INDEX_HEADER_LEN 64
+#define TSDB_INDEX_GROW_ENTRIES 4096        // 64 KiB at a time
+#define TSDB_FLAG_LINK 0x01
+#define TSDB_FEATURE_ROLLUPS 0x01
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+namespace {
+
+struct StoreMeta {
+    char magic[8];                  // "LWQMSTSM"
+    uint32_t version;
+    uint32_t segment_rows;
+    uint64_t synced_rows;           // Rows made durable
+    uint32_t clean;                 // The writer closed the store, so every row, index and rollup is durable
+    uint32_t features;              // TSDB_FEATURE_* kept up to date by the writer
+};
+
+struct SegmentHeader {
+    char magic[8];                  // "LWQMSSEG"
+    uint32_t version;
+    uint32_t capacity;
+    uint64_t rows;                  // Written after a row's columns, so a reader never sees a row half written
+    int64_t min_time_us;
+    int64_t max_time_us;
+};
+
+struct IndexHeader {
+    char magic[8];                  // "LWQMSIDX"
+    uint32_t version;
+    uint16_t node_id;
+    uint16_t reserved;
+    uint64_t count;                 // Written after an entry, as for segments
+    uint64_t seq;                   // Odd while the writer moves entries to insert one out of time order
+};
+
+const char kMetaMagic[8] = {'L', 'W', 'Q', 'M', 'S', 'T', 'S', 'M'};
+const char kSegmentMagic[8] = {'L', 'W', 'Q', 'M', 'S', 'S', 'E', 'G'};
+const char kIndexMagic[8] = {'L', 'W', 'Q', 'M', 'S', 'I', 'D', 'X'};
+
+/**
+ * @brief Where each column of a segment lies. Columns are laid out widest first, so each is aligned.
+ */
+struct SegmentLayout {
+    size_t time, node, turbidity, temperature, pH, rssi, snr, flags, size;
+
+    explicit SegmentLayout(uint32_t capacity) {
+        time = TSDB_SEGMENT_HEADER_LEN;
+        turbidity = time + (sizeof(int64_t) * capacity);
+        temperature = turbidity + (sizeof(float) * capacity);
+        pH = temperature + (sizeof(float) * capacity);
+        node = pH + (sizeof(float) * capacity);
+        rssi = node + (sizeof(uint16_t) * capacity);
+        snr = rssi + capacity;
+        flags = snr + capacity;
+        size = flags + capacity;
+    }
+};
+
+template <typename T>
+T *column(const MappedFile &file, size_t offset) {
+    return reinterpret_cast<T *>(file.data() + offset);
+}
+
+uint64_t load_acquire(const uint64_t *value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void store_release(uint64_t *value, uint64_t to) {
+    __atomic_store_n(value, to, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Starts a change readers must not see half made: they read again if the sequence is odd or has moved on.
+ */
+void begin_change(uint64_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void end_change(uint64_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+IndexHeader *index_header(const MappedFile &file) {
+    return reinterpret_cast<IndexHeader *>(file.data());
+}
+
+IndexEntry *index_entries(const MappedFile &file) {
+    return reinterpret_cast<IndexEntry *>(file.data() + TSDB_INDEX_HEADER_LEN);
+}
+
+size_t index_capacity(const MappedFile &file) {
+    return (file.size() - TSDB_INDEX_HEADER_LEN) / sizeof(IndexEntry);
+}
+
+/**
+ * @returns Position of the first entry at or after a time
+ */
+uint64_t first_at_or_after(const IndexEntry *entries, uint64_t count, int64_t time_us) {
+    if (count == 0) return 0;
+
+    const IndexEntry *found = std::lower_bound(entries, entries + count, time_us, [](const IndexEntry &entry, int64_t t) { return entry.time_us < t; });
+
+    return static_cast<uint64_t>(found - entries);
+}
+
+std::string segment_path(const std::string &dir, uint32_t segment) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/seg-%08u.lwts", segment);
+    return dir + name;
+}
+
+std::string index_path(const std::string &dir, uint16_t node_id) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/node-%05u.lwti", node_id);
+    return dir + name;
+}
+
+std::string rollup_path(const std::string &dir, uint16_t node_id, Resolution resolution) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "/rollup-%05u-%s.lwtr", node_id, to_string(resolution));
+    return dir + name;
+}
+
+void read_segment_row(const MappedFile &file, const SegmentLayout &layout, uint32_t offset, SampleRow &out) {
+    out.time_us = column<int64_t>(file, layout.time)[offset];
+    out.node_id = column<uint16_t>(file, layout.node)[offset];
+    out.turbidity = column<float>(file, layout.turbidity)[offset];
+    out.temperature = column<float>(file, layout.temperature)[offset];
+    out.pH = column<float>(file, layout.pH)[offset];
+    out.rssi_dbm = column<int8_t>(file, layout.rssi)[offset];
+    out.snr_db = column<int8_t>(file, layout.snr)[offset];
+    out.link_valid = (column<uint8_t>(file, layout.flags)[offset] & TSDB_FLAG_LINK) != 0;
+}
+
+/**
+ * @returns IDs of the nodes with an index file in the store
+ */
+std::vector<uint16_t> list_nodes(const std::string &dir) {
+    std::vector<uint16_t> ids;
+    DIR *d = ::opendir(dir.c_str());
+    if (d == nullptr) return ids;
+
+    while (struct dirent *entry = ::readdir(d)) {
+        unsigned id;
+        char ext[8];
+
+        if ((std::sscanf(entry->d_name, "node-%5u.%7s", &id, ext) == 2) && (std::strcmp(ext, "lwti") == 0) && (id <= UINT16_MAX)) {
+            ids.push_back(static_cast<uint16_t>(id));
+        }
+    }
+
+    ::closedir(d);
+    std::sort(ids.begin(), ids.end());
+
+    return ids;
+}
+
+bool read_meta(const std::string &dir, StoreMeta &meta) {
+    int fd = ::open((dir + "/store.meta").c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    bool ok = (::pread(fd, &meta, sizeof(meta), 0) == sizeof(meta)) && (std::memcmp(meta.magic, kMetaMagic, sizeof(kMetaMagic)) == 0) &&
+        (meta.version == TSDB_VERSION) && (meta.segment_rows > 0);
+    ::close(fd);
+
+    return ok;
+}
+
+[[noreturn]] void fail(const std::string &what, const std::string &path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Writer
+
+TelemetryStore::TelemetryStore(const std::string &directory) : dir_(directory) {
+    if ((::mkdir(dir_.c_str(), 0755) < 0) && (errno != EEXIST)) fail("Could not create", dir_);
+
+    StoreMeta meta;
+    bool existed = read_meta(dir_, meta);
+
+    if (existed && (meta.segment_rows != kSegmentRows)) {
+        throw std::runtime_error("Store " + dir_ + " has segments of a different size");
+    }
+
+    meta_fd_ = ::open((dir_ + "/store.meta").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (meta_fd_ < 0) fail("Could not open", dir_ + "/store.meta");
+
+    // Rows are counted from the segments: all but the last are full.
+    uint32_t segment_count = 0;
+    while (::access(segment_path(dir_, segment_count).c_str(), F_OK) == 0) segment_count++;
+
+    if (segment_count > 0) {
+        uint32_t last = segment_count - 1;
+
+        open_segment(last);
+        rows_ = (static_cast<uint64_t>(last) * kSegmentRows) + load_acquire(&column<SegmentHeader>(segments_.at(last), 0)->rows);
+    }
+
+    if (existed && !meta.clean) {
+        recover(meta.synced_rows);
+    }
+    else if (existed && !(meta.features & TSDB_FEATURE_ROLLUPS)) {
+        // Written before rollups were kept
+        rebuild(false);
+    }
+
+    synced_rows_ = rows_;
+
+    if (!existed) write_meta(true);
+}
+
+TelemetryStore::~TelemetryStore() {
+    try {
+        sync();
+
+        // Every index and rollup made durable is what lets the next writer skip rebuilding them.
+        for (auto &[node_id, files] : nodes_) {
+            (void)node_id;
+
+            for (RollupFile &rollup : files.rollups) rollup.make_durable();
+
+            if (files.index_dirty_from == UINT64_MAX) continue;
+
+            uint64_t count = index_header(files.index)->count;
+
+            files.index.sync(0, TSDB_INDEX_HEADER_LEN);
+            if (count > files.index_dirty_from) {
+                files.index.sync(TSDB_INDEX_HEADER_LEN + (files.index_dirty_from * sizeof(IndexEntry)), (count - files.index_dirty_from) * sizeof(IndexEntry));
+            }
+            files.index_dirty_from = UINT64_MAX;
+        }
+
+        if (!clean_) write_meta(true);
+    }
+    catch (const std::exception &err) {
+        std::fprintf(stderr, "%s\n", err.what());
+    }
+
+    if (meta_fd_ >= 0) ::close(meta_fd_);
+}
+
+/**
+ * @brief Drops the rows after the last that was made durable. The writer stopped without closing, so the pages of those
+ * rows, and of the indexes and rollups, which are only made durable on closing, may have reached the disk in any order or
+ * not at all. The indexes and rollups are built again.
+ */
+void TelemetryStore::recover(uint64_t synced_rows) {
+    if (synced_rows > rows_) synced_rows = rows_;
+
+    uint32_t keep_segments = static_cast<uint32_t>((synced_rows + kSegmentRows - 1) / kSegmentRows);
+    uint32_t segment_count = static_cast<uint32_t>((rows_ + kSegmentRows - 1) / kSegmentRows);
+
+    for (uint32_t segment = keep_segments; segment < segment_count; segment++) {
+        segments_.erase(segment);
+        ::unlink(segment_path(dir_, segment).c_str());
+    }
+
+    if (keep_segments > 0) {
+        uint32_t last = keep_segments - 1;
+
+        open_segment(last);
+        store_release(&column<SegmentHeader>(segments_.at(last), 0)->rows, synced_rows - (static_cast<uint64_t>(last) * kSegmentRows));
+    }
+
+    rows_ = synced_rows;
+    rebuild(true);
+}
+
+/**
+ * @brief Builds every rollup, and the indexes if asked, again from the segments.
+ */
+void TelemetryStore::rebuild(bool indexes) {
+    for (uint16_t node_id : list_nodes(dir_)) {
+        NodeFiles &files = node_files(node_id);
+
+        if (indexes) {
+            IndexHeader *header = index_header(files.index);
+
+            // The entries are written again from the first, under readers still holding the old count. A writer that stopped
+            // part way through moving them left the sequence odd.
+            if (header->seq & 1) end_change(&header->seq);
+
+            begin_change(&header->seq);
+            store_release(&header->count, 0);
+            end_change(&header->seq);
+            files.index_dirty_from = 0;
+        }
+
+        for (RollupFile &rollup : files.rollups) rollup.clear();
+    }
+
+    SegmentLayout layout(kSegmentRows);
+    uint32_t segment_count = static_cast<uint32_t>((rows_ + kSegmentRows - 1) / kSegmentRows);
+
+    for (uint32_t segment = 0; segment < segment_count; segment++) {
+        uint32_t rows = static_cast<uint32_t>(std::min<uint64_t>(rows_ - (static_cast<uint64_t>(segment) * kSegmentRows), kSegmentRows));
+
+        if (segments_.find(segment) == segments_.end()) open_segment(segment);
+
+        const MappedFile &file = segments_.at(segment);
+
+        for (uint32_t offset = 0; offset < rows; offset++) {
+            SampleRow row;
+            read_segment_row(file, layout, offset, row);
+
+            NodeFiles &files = node_files(row.node_id);
+
+            if (indexes) index_row(files, row.time_us, (static_cast<uint64_t>(segment) * kSegmentRows) + offset);
+            for (RollupFile &rollup : files.rollups) rollup.add(row);
+        }
+
+        if (segment + 1 < segment_count) segments_.erase(segment);
+    }
+
+    // Nothing is durable until the store is closed.
+    if (clean_) write_meta(false);
+}
+
+void TelemetryStore::open_segment(uint32_t segment) {
+    SegmentLayout layout(kSegmentRows);
+    MappedFile file;
+
+    // The file is made its full size at once, so readers map it once.
+    file.open(segment_path(dir_, segment), true, layout.size);
+
+    SegmentHeader *header = column<SegmentHeader>(file, 0);
+
+    if (std::memcmp(header->magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0) {
+        header->version = TSDB_VERSION;
+        header->capacity = kSegmentRows;
+        header->rows = 0;
+        header->min_time_us = INT64_MAX;
+        header->max_time_us = INT64_MIN;
+        std::memcpy(header->magic, kSegmentMagic, sizeof(kSegmentMagic));
+        new_files_ = true;
+    }
+
+    segments_[segment] = std::move(file);
+}
+
+TelemetryStore::NodeFiles &TelemetryStore::node_files(uint16_t node_id) {
+    auto found = nodes_.find(node_id);
+    if (found != nodes_.end()) return found->second;
+
+    NodeFiles &files = nodes_[node_id];
+    files.index.open(index_path(dir_, node_id), true, TSDB_INDEX_HEADER_LEN + (TSDB_INDEX_GROW_ENTRIES * sizeof(IndexEntry)));
+
+    IndexHeader *header = index_header(files.index);
+
+    if (std::memcmp(header->magic, kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        header->version = TSDB_VERSION;
+        header->node_id = node_id;
+        header->count = 0;
+        header->seq = 0;
+        std::memcpy(header->magic, kIndexMagic, sizeof(kIndexMagic));
+        files.index_dirty_from = 0;
+        new_files_ = true;
+    }
+
+    for (size_t k = 0; k < kResolutions; k++) {
+        Resolution resolution = static_cast<Resolution>(k);
+        files.rollups[k].open(rollup_path(dir_, node_id, resolution), node_id, resolution, true);
+    }
+
+    return files;
+}
+
+void TelemetryStore::append(const SampleRow &row) {
+    if (clean_) write_meta(false);
+
+    uint32_t segment = static_cast<uint32_t>(rows_ / kSegmentRows);
+    uint32_t offset = static_cast<uint32_t>(rows_ % kSegmentRows);
+
+    if (segments_.find(segment) == segments_.end()) open_segment(segment);
+
+    // Columns first, then the count that makes the row visible.
+    const MappedFile &file = segments_.at(segment);
+    SegmentLayout layout(kSegmentRows);
+    SegmentHeader *header = column<SegmentHeader>(file, 0);
+
+    column<int64_t>(file, layout.time)[offset] = row.time_us;
+    column<uint16_t>(file, layout.node)[offset] = row.node_id;
+    column<float>(file, layout.turbidity)[offset] = row.turbidity;
+    column<float>(file, layout.temperature)[offset] = row.temperature;
+    column<float>(file, layout.pH)[offset] = row.pH;
+    column<int8_t>(file, layout.rssi)[offset] = row.rssi_dbm;
+    column<int8_t>(file, layout.snr)[offset] = row.snr_db;
+    column<uint8_t>(file, layout.flags)[offset] = row.link_valid ? TSDB_FLAG_LINK : 0;
+
+    header->min_time_us = std::min(header->min_time_us, row.time_us);
+    header->max_time_us = std::max(header->max_time_us, row.time_us);
+    store_release(&header->rows, offset + 1);
+
+    NodeFiles &files = node_files(row.node_id);
+
+    index_row(files, row.time_us, rows_);
+    for (RollupFile &rollup : files.rollups) rollup.add(row);
+
+    rows_++;
+}
+
+void TelemetryStore::index_row(NodeFiles &files, int64_t time_us, uint64_t row) {
+    IndexHeader *header = index_header(files.index);
+    uint64_t count = header->count;
+
+    if (count == index_capacity(files.index)) {
+        files.index.grow(files.index.size() + (TSDB_INDEX_GROW_ENTRIES * sizeof(IndexEntry)));
+        header = index_header(files.index);
+    }
+
+    // Kept in time order. Rows come in time order but for a node's retransmission delayed behind newer packets, which
+    // lands a few entries from the end.
+    IndexEntry *entries = index_entries(files.index);
+    uint64_t position = count;
+
+    while ((position > 0) && (entries[position - 1].time_us > time_us)) position--;
+
+    // Appending only writes past the count readers see. Moving entries they may be reading is a change they read again after.
+    bool moving = position < count;
+
+    if (moving) {
+        begin_change(&header->seq);
+        std::memmove(&entries[position + 1], &entries[position], (count - position) * sizeof(IndexEntry));
+    }
+
+    entries[position] = {time_us, row};
+    files.index_dirty_from = std::min(files.index_dirty_from, position);
+    store_release(&header->count, count + 1);
+
+    if (moving) end_change(&header->seq);
+}
+
+void TelemetryStore::sync() {
+    if ((rows_ == synced_rows_) && !new_files_) return;
+
+    SegmentLayout layout(kSegmentRows);
+
+    for (auto &[segment, file] : segments_) {
+        (void)segment;
+        file.sync(0, layout.size);
+    }
+
+    // A file created since the last sync is only durable once the directory entry naming it is.
+    if (new_files_) {
+        int dir_fd = ::open(dir_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if ((dir_fd < 0) || (::fsync(dir_fd) < 0)) fail("Could not sync", dir_);
+
+        ::close(dir_fd);
+        new_files_ = false;
+    }
+
+    synced_rows_ = rows_;
+    write_meta(false);
+
+    // Only the segment being filled stays mapped.
+    uint32_t current = static_cast<uint32_t>(rows_ / kSegmentRows);
+
+    for (auto it = segments_.begin(); it != segments_.end();) {
+        if (it->first != current) it = segments_.erase(it);
+        else ++it;
+    }
+}
+
+void TelemetryStore::write_meta(bool clean) {
+    StoreMeta meta = {};
+
+    std::memcpy(meta.magic, kMetaMagic, sizeof(kMetaMagic));
+    meta.version = TSDB_VERSION;
+    meta.segment_rows = kSegmentRows;
+    meta.synced_rows = synced_rows_;
+    meta.clean = clean ? 1 : 0;
+    meta.features = TSDB_FEATURE_ROLLUPS;
+
+    if ((::pwrite(meta_fd_, &meta, sizeof(meta), 0) != sizeof(meta)) || (::fdatasync(meta_fd_) < 0)) fail("Could not write", dir_ + "/store.meta");
+
+    clean_ = clean;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Reader
+
+TelemetryReader::TelemetryReader(const std::string &directory) : dir_(directory) {
+    StoreMeta meta;
+    if (!read_meta(dir_, meta)) throw std::runtime_error(dir_ + " is not a telemetry store");
+
+    segment_rows_ = meta.segment_rows;
+    refresh();
+}
+
+void TelemetryReader::refresh() {
+    for (uint16_t node_id : list_nodes(dir_)) {
+        if (nodes_.find(node_id) != nodes_.end()) continue;
+
+        MappedFile file;
+        if (file.open(index_path(dir_, node_id), false) && (file.size() >= TSDB_INDEX_HEADER_LEN)) nodes_[node_id] = std::move(file);
+    }
+}
+
+std::vector<uint16_t> TelemetryReader::nodes() const {
+    std::vector<uint16_t> ids;
+
+    for (const auto &[node_id, file] : nodes_) {
+        if (load_acquire(&index_header(file)->count) > 0) ids.push_back(node_id);
+    }
+
+    return ids;
+}
+
+const IndexEntry *TelemetryReader::index(uint16_t node_id, uint64_t &count, uint64_t &seq) const {
+    auto found = nodes_.find(node_id);
+
+    if (found == nodes_.end()) {
+        count = 0;
+        seq = 0;
+        return nullptr;
+    }
+
+    MappedFile &file = found->second;
+
+    // The writer is moving entries, which takes it only as long as copying a few of them.
+    do {
+        seq = load_acquire(&index_header(file)->seq);
+    } while (seq & 1);
+
+    count = load_acquire(&index_header(file)->count);
+
+    // The writer has grown the file past the part mapped here.
+    if (count > index_capacity(file)) {
+        file.remap_if_grown();
+        count = std::min<uint64_t>(count, index_capacity(file));
+    }
+
+    return index_entries(file);
+}
+
+bool TelemetryReader::index_changed(uint16_t node_id, uint64_t seq) const {
+    auto found = nodes_.find(node_id);
+    if (found == nodes_.end()) return false;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&index_header(found->second)->seq, __ATOMIC_RELAXED) != seq;
+}
+
+const MappedFile *TelemetryReader::segment(uint32_t segment) const {
+    auto found = segments_.find(segment);
+    if (found != segments_.end()) return &found->second;
+
+    MappedFile file;
+    if (!file.open(segment_path(dir_, segment), false) || (file.size() < SegmentLayout(segment_rows_).size)) return nullptr;
+
+    auto added = segments_.emplace(segment, std::move(file)).first;
+
+    return &added->second;
+}
+
+bool TelemetryReader::read_row(uint64_t row, SampleRow &out) const {
+    const MappedFile *file = segment(static_cast<uint32_t>(row / segment_rows_));
+    if (file == nullptr) return false;
+
+    read_segment_row(*file, SegmentLayout(segment_rows_), static_cast<uint32_t>(row % segment_rows_), out);
+
+    return true;
+}
+
+uint64_t TelemetryReader::count(uint16_t node_id) const {
+    uint64_t count, seq;
+    index(node_id, count, seq);
+
+    return count;
+}
+
+// Each lookup below reads the index again if the writer moved its entries meanwhile.
+
+bool TelemetryReader::latest(uint16_t node_id, SampleRow &out) const {
+    uint64_t count, seq;
+    bool found;
+
+    do {
+        const IndexEntry *entries = index(node_id, count, seq);
+        found = (count > 0) && read_row(entries[count - 1].row, out);
+    } while (index_changed(node_id, seq));
+
+    return found;
+}
+
+uint64_t TelemetryReader::lower_bound(uint16_t node_id, int64_t time_us) const {
+    uint64_t count, seq, position;
+
+    do {
+        const IndexEntry *entries = index(node_id, count, seq);
+        position = first_at_or_after(entries, count, time_us);
+    } while (index_changed(node_id, seq));
+
+    return position;
+}
+
+bool TelemetryReader::at(uint16_t node_id, uint64_t position, SampleRow &out) const {
+    uint64_t count, seq;
+    bool found;
+
+    do {
+        const IndexEntry *entries = index(node_id, count, seq);
+        found = (position < count) && read_row(entries[position].row, out);
+    } while (index_changed(node_id, seq));
+
+    return found;
+}
+
+size_t TelemetryReader::page(uint16_t node_id, uint64_t position, size_t limit, std::vector<SampleRow> &out) const {
+    size_t out_len = out.size();
+    uint64_t count, seq;
+
+    do {
+        out.resize(out_len);
+
+        const IndexEntry *entries = index(node_id, count, seq);
+
+        for (uint64_t k = position; (k < count) && (out.size() - out_len < limit); k++) {
+            SampleRow row;
+            if (!read_row(entries[k].row, row)) break;
+
+            out.push_back(row);
+        }
+    } while (index_changed(node_id, seq));
+
+    return out.size() - out_len;
+}
+
+size_t TelemetryReader::rollups(uint16_t node_id, Resolution resolution, int64_t from_us, int64_t to_us, std::vector<RollupBucket> &out,
+    size_t limit) const {
+    uint32_t key = (static_cast<uint32_t>(node_id) << 8) | static_cast<uint32_t>(resolution);
+    auto found = rollups_.find(key);
+
+    if (found == rollups_.end()) {
+        RollupFile file;
+        if (!file.open(rollup_path(dir_, node_id, resolution), node_id, resolution, false)) return 0;
+
+        found = rollups_.emplace(key, std::move(file)).first;
+    }
+
+    return found->second.read(from_us, to_us, out, limit);
+}
+
+size_t TelemetryReader::range(uint16_t node_id, int64_t from_us, int64_t to_us, std::vector<SampleRow> &out, size_t limit) const {
+    size_t out_len = out.size();
+    uint64_t count, seq;
+
+    do {
+        out.resize(out_len);
+
+        const IndexEntry *entries = index(node_id, count, seq);
+
+        for (uint64_t k = first_at_or_after(entries, count, from_us); (k < count) && (entries[k].time_us < to_us) && (out.size() - out_len < limit); k++) {
+            SampleRow row;
+            if (!read_row(entries[k].row, row)) break;
+
+            out.push_back(row);
+        }
+    } while (index_changed(node_id, seq));
+
+    return out.size() - out_len;
+}
+
+uint64_t TelemetryReader::rows() const {
+    uint32_t segment_count = static_cast<uint32_t>(segments_.empty() ? 0 : segments_.rbegin()->first);
+    while (::access(segment_path(dir_, segment_count).c_str(), F_OK) == 0) segment_count++;
+
+    if (segment_count == 0) return 0;
+
+    const MappedFile *last = segment(segment_count - 1);
+    if (last == nullptr) return 0;
+
+    return (static_cast<uint64_t>(segment_count - 1) * segment_rows_) + load_acquire(&column<SegmentHeader>(*last, 0)->rows);
+}
+
+} // namespace lwqms
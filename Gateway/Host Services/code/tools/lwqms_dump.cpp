@@ -0,0 +1,100 @@
+/*************************************************************************************
+ *
+ * @file lwqms_dump.cpp
+ *
+ * @brief Prints the records of the gateway's byte stream, one line each: from a capture, or from the gateway itself.
+ *
+ *        lwqms_dump [file]         Reads standard input if no file is given
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/record.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace {
+
+const char *type_name(lwqms::PacketType type) {
+    switch (type) {
+        case lwqms::PacketType::Telemetry: return "TELEMETRY";
+        case lwqms::PacketType::Message: return "MESSAGE";
+        case lwqms::PacketType::TelemetryBatch: return "BATCH";
+        case lwqms::PacketType::TelemetryCompact: return "COMPACT";
+    }
+
+    return "UNKNOWN";
+}
+
+void print_record(const lwqms::Record &record) {
+    if (record.type == lwqms::RecordType::Status) {
+        const lwqms::StatusRecord &status = record.status;
+
+        std::printf("%.6f STATUS ring_overflows=%" PRIu32 " queue_overflows=%" PRIu32 "\n", status.time_us / 1e6, status.ring_overflows, status.queue_overflows);
+        return;
+    }
+
+    const lwqms::PacketRecord &pkt = record.packet;
+
+    std::printf("%.6f %s src=%u dest=%u pkt=%u", pkt.rx_time_us / 1e6, type_name(pkt.type()), pkt.src_id, pkt.dest_id, pkt.pkt_id);
+
+    if (pkt.has_link()) std::printf(" rssi=%d snr=%d", pkt.rssi_pkt_dbm, pkt.snr_pkt_db);
+
+    if (pkt.type() == lwqms::PacketType::Message) {
+        std::printf(" \"%s\"\n", pkt.message().c_str());
+        return;
+    }
+
+    if (!pkt.has_samples()) {
+        std::printf(" undecoded payload of %u bytes\n", pkt.payload_len);
+        return;
+    }
+
+    std::printf("\n");
+
+    for (size_t k = 0; k < pkt.qty_samples; k++) {
+        const lwqms::Sample &sample = pkt.samples[k];
+
+        std::printf("    age=%us turbidity=%f temperature=%f pH=%f\n", sample.age_s, sample.turbidity, sample.temperature, sample.pH);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    FILE *in = stdin;
+
+    if (argc > 1) {
+        in = std::fopen(argv[1], "rb");
+
+        if (in == nullptr) {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    lwqms::RecordStream stream;
+    uint8_t buf[4096];
+    size_t len;
+
+    // Unbuffered reads, so a live gateway's records print as they arrive.
+    setvbuf(in, nullptr, _IONBF, 0);
+
+    while ((len = std::fread(buf, 1, sizeof(buf), in)) > 0) {
+        stream.feed(buf, len, print_record);
+        std::fflush(stdout);
+    }
+
+    uint64_t rejected = stream.bad_frames();
+    for (auto status : {lwqms::DecodeStatus::TooShort, lwqms::DecodeStatus::BadCrc, lwqms::DecodeStatus::BadVersion, lwqms::DecodeStatus::UnknownType, lwqms::DecodeStatus::BadLength}) {
+        rejected += stream.rejected(status);
+    }
+
+    std::fprintf(stderr, "%" PRIu64 " records, %" PRIu64 " frames rejected (%" PRIu64 " bad CRC)\n", stream.records(), rejected, stream.rejected(lwqms::DecodeStatus::BadCrc));
+
+    return 0;
+}
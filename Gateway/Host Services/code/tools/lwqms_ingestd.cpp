@@ -0,0 +1,280 @@
+/*************************************************************************************
+ *
+ * @file lwqms_ingestd.cpp
+ *
+ * @brief Gateway ingestion daemon. Reads the receiver's record stream from its serial port (or a pty, or a capture being
+ *        replayed), drops duplicates, and appends the samples and messages to the dashboard's CSV files, made durable in
+ *        batches. Replaces lwqms_logger_v2.py, which opened, appended to and closed a file for every row.
+ *
+ *        lwqms_ingestd --port /dev/ttyACM0 [--out DIR] [--store DIR] [--record FILE]
+ *        lwqms_ingestd --replay FILE [--speed X] [--out DIR]
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/csv_sink.hpp"
+#include "lwqms/ingest.hpp"
+#include "lwqms/tsdb.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define INGESTD_DEFAULT_BAUD 115200         // The receiver is a USB CDC device, which ignores it; a UART bridge would not
+#define INGESTD_REOPEN_MS 1000              // Wait before trying again to open a port that has gone away
+#define INGESTD_READ_LEN 4096
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+volatile sig_atomic_t stop_requested = 0;
+
+void on_stop(int) {
+    stop_requested = 1;
+}
+
+int64_t unix_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+speed_t baud_constant(uint32_t baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B115200;
+    }
+}
+
+/**
+ * @brief Opens the receiver's port, raw: no echo, no line editing, and no byte turned into another.
+ */
+int open_port(const char *path, uint32_t baud) {
+    int fd = ::open(path, O_RDONLY | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct termios tty;
+
+    if (::isatty(fd) && (::tcgetattr(fd, &tty) == 0)) {
+        cfmakeraw(&tty);
+        cfsetispeed(&tty, baud_constant(baud));
+        cfsetospeed(&tty, baud_constant(baud));
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cc[VMIN] = 1;
+        tty.c_cc[VTIME] = 0;
+        ::tcsetattr(fd, TCSANOW, &tty);
+    }
+
+    return fd;
+}
+
+void print_stats(const lwqms::Ingestor &ingestor) {
+    const lwqms::IngestStats &stats = ingestor.stats();
+    const lwqms::RecordStream &stream = ingestor.stream();
+
+    std::fprintf(stderr, "lwqms_ingestd: %" PRIu64 " packets (%" PRIu64 " samples, %" PRIu64 " messages, %" PRIu64 " duplicates, %" PRIu64
+        " undecoded), %" PRIu64 " bad CRC, %" PRIu64 " bad frames, %" PRIu64 " syncs, %" PRIu64 " clock resets\n", stats.packets, stats.samples,
+        stats.messages, stats.duplicates, stats.undecoded, stream.rejected(lwqms::DecodeStatus::BadCrc), stream.bad_frames(), stats.syncs,
+        ingestor.clock().resets());
+
+    if ((stats.ring_overflows > 0) || (stats.queue_overflows > 0)) {
+        std::fprintf(stderr, "lwqms_ingestd: gateway output fell behind; radio core waited %u times, %u packets left unacknowledged\n",
+            stats.ring_overflows, stats.queue_overflows);
+    }
+}
+
+void print_usage(const char *argv0) {
+    std::printf("Usage: %s --port PATH | --replay FILE [--out DIR] [--store DIR] [--baud N] [--record FILE] [--speed X] [--sync-rows N] [--sync-ms MS]\n\n", argv0);
+    std::printf("  --port PATH       Serial port or pty of the receiver, reopened whenever it goes away\n");
+    std::printf("  --replay FILE     Capture of the receiver's output to ingest instead, then exit\n");
+    std::printf("  --out DIR         Directory of payloads.csv and messages.csv (default .)\n");
+    std::printf("  --store DIR       Also write the samples to a telemetry store\n");
+    std::printf("  --baud N          Baud rate of a UART port (default %d)\n", INGESTD_DEFAULT_BAUD);
+    std::printf("  --record FILE     Append everything read from the port to a capture, for replaying later\n");
+    std::printf("  --speed X         Replay at X times the rate it was received (default 0: as fast as possible)\n");
+    std::printf("  --sync-rows N     Rows between durable flushes (default %u)\n", lwqms::IngestOptions{}.sync_rows);
+    std::printf("  --sync-ms MS      Longest a row waits for a durable flush (default %u)\n", lwqms::IngestOptions{}.sync_interval_ms);
+}
+
+/**
+ * @brief Holds each replayed record back until its time has come: the gap since the first record, as the gateway timed it,
+ * divided by the speed.
+ */
+class ReplayPacer {
+public:
+    explicit ReplayPacer(double speed) : speed_(speed) {}
+
+    void pace(const lwqms::Record &record) {
+        if ((speed_ <= 0) || (record.type != lwqms::RecordType::Packet)) return;
+
+        uint64_t gateway_us = record.packet.rx_time_us;
+
+        // A gateway restart begins a new run of gateway time.
+        if (!started_ || (gateway_us < first_gateway_us_)) {
+            started_ = true;
+            first_gateway_us_ = gateway_us;
+            start_ = std::chrono::steady_clock::now();
+            return;
+        }
+
+        auto due = start_ + std::chrono::microseconds(static_cast<int64_t>((gateway_us - first_gateway_us_) / speed_));
+        std::this_thread::sleep_until(due);
+    }
+
+private:
+    double speed_;
+    bool started_ = false;
+    uint64_t first_gateway_us_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *port = nullptr;
+    const char *replay = nullptr;
+    const char *record = nullptr;
+    const char *store = nullptr;
+    std::string out_dir = ".";
+    uint32_t baud = INGESTD_DEFAULT_BAUD;
+    double speed = 0;
+    lwqms::IngestOptions options;
+
+    for (int k = 1; k < argc; k++) {
+        bool has_value = (k + 1 < argc);
+
+        if ((std::strcmp(argv[k], "--port") == 0) && has_value) port = argv[++k];
+        else if ((std::strcmp(argv[k], "--replay") == 0) && has_value) replay = argv[++k];
+        else if ((std::strcmp(argv[k], "--out") == 0) && has_value) out_dir = argv[++k];
+        else if ((std::strcmp(argv[k], "--store") == 0) && has_value) store = argv[++k];
+        else if ((std::strcmp(argv[k], "--baud") == 0) && has_value) baud = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--record") == 0) && has_value) record = argv[++k];
+        else if ((std::strcmp(argv[k], "--speed") == 0) && has_value) speed = std::strtod(argv[++k], nullptr);
+        else if ((std::strcmp(argv[k], "--sync-rows") == 0) && has_value) options.sync_rows = std::strtoul(argv[++k], nullptr, 10);
+        else if ((std::strcmp(argv[k], "--sync-ms") == 0) && has_value) options.sync_interval_ms = std::strtoul(argv[++k], nullptr, 10);
+        else {
+            print_usage(argv[0]);
+            return (std::strcmp(argv[k], "--help") == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if ((port == nullptr) == (replay == nullptr)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    struct sigaction stop = {};
+    stop.sa_handler = on_stop;
+    ::sigaction(SIGINT, &stop, nullptr);
+    ::sigaction(SIGTERM, &stop, nullptr);
+
+    ReplayPacer pacer(speed);
+    options.live = (port != nullptr);
+    if (replay != nullptr) options.on_record = [&](const lwqms::Record &r) { pacer.pace(r); };
+
+    try {
+        lwqms::CsvSink csv(out_dir);
+        std::unique_ptr<lwqms::TelemetrySink> telemetry;
+        std::unique_ptr<lwqms::TeeSink> tee;
+
+        if (store != nullptr) {
+            telemetry = std::make_unique<lwqms::TelemetrySink>(store);
+            tee = std::make_unique<lwqms::TeeSink>(csv, *telemetry);
+        }
+
+        lwqms::Ingestor ingestor(tee ? static_cast<lwqms::Sink &>(*tee) : static_cast<lwqms::Sink &>(csv), options);
+
+        int record_fd = -1;
+        if (record != nullptr) {
+            record_fd = ::open(record, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (record_fd < 0) std::perror(record);
+        }
+
+        uint8_t buf[INGESTD_READ_LEN];
+        int fd = -1;
+
+        while (!stop_requested) {
+            if (fd < 0) {
+                fd = (replay != nullptr) ? ::open(replay, O_RDONLY | O_CLOEXEC) : open_port(port, baud);
+
+                if (fd < 0) {
+                    if (replay != nullptr) {
+                        std::perror(replay);
+                        return EXIT_FAILURE;
+                    }
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(INGESTD_REOPEN_MS));
+                    continue;
+                }
+
+                if (port != nullptr) std::fprintf(stderr, "lwqms_ingestd: listening on %s\n", port);
+            }
+
+            // Wake at least once per sync interval, so rows are made durable when the stream goes quiet.
+            struct pollfd pfd = {fd, POLLIN, 0};
+            int ready = ::poll(&pfd, 1, static_cast<int>(options.sync_interval_ms));
+
+            if ((ready < 0) && (errno != EINTR)) break;
+
+            if (ready <= 0) {
+                ingestor.poll(unix_now_us());
+                continue;
+            }
+
+            ssize_t len = ::read(fd, buf, sizeof(buf));
+
+            if (len > 0) {
+                if (record_fd >= 0) (void)!::write(record_fd, buf, static_cast<size_t>(len));
+                ingestor.feed(buf, static_cast<size_t>(len), unix_now_us());
+                continue;
+            }
+
+            if ((len < 0) && (errno == EINTR || errno == EAGAIN)) continue;
+
+            // End of a replay, or the receiver was unplugged.
+            ::close(fd);
+            fd = -1;
+            ingestor.sync();
+
+            if (replay != nullptr) break;
+
+            std::fprintf(stderr, "lwqms_ingestd: lost %s\n", port);
+            print_stats(ingestor);
+        }
+
+        ingestor.sync();
+        print_stats(ingestor);
+
+        if (fd >= 0) ::close(fd);
+        if (record_fd >= 0) ::close(record_fd);
+    }
+    catch (const std::exception &err) {
+        std::fprintf(stderr, "lwqms_ingestd: %s\n", err.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,331 @@
+/*************************************************************************************
+ *
+ * @file lwqms_tsdb.cpp
+ *
+ * @brief Imports payloads.csv files into a telemetry store, and queries one.
+ *
+ *        lwqms_tsdb import STORE payloads.csv...      Rows no later than a node's latest stored sample are skipped, so a
+ *                                                      file imported again only adds what was appended since
+ *        lwqms_tsdb info STORE                         Rows, and samples per node
+ *        lwqms_tsdb latest STORE                       Latest sample of each node
+ *        lwqms_tsdb range STORE NODE [FROM [TO]]       A node's samples, as payloads.csv rows. FROM and TO are local times.
+ *        lwqms_tsdb rollup STORE NODE 10m|1h|1d [FROM [TO]]
+ *                                                      A node's rollup buckets starting in a time range: the count, then the
+ *                                                      minimum, mean, maximum and last of turbidity, temperature and pH
+ *        lwqms_tsdb forecast STORE NODE MODEL [STEPS]  Runs the water quality forecast model over a node's last 46 hours, as
+ *                                                      half-hour means, and forecasts STEPS half hours past them (default 4)
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms/csv_reader.hpp"
+#include "lwqms/forecast.hpp"
+#include "lwqms/tsdb.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define TSDB_IMPORT_READ_LEN (1024 * 1024)
+#define TSDB_FORECAST_STEP_US (30LL * 60 * 1000000)   // The model was trained on half-hourly samples
+#define TSDB_FORECAST_HISTORY 92                        // Steps of each training sequence
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+void print_time(int64_t time_us) {
+    time_t seconds = static_cast<time_t>(time_us / 1000000);
+    struct tm local;
+    char text[32];
+
+    localtime_r(&seconds, &local);
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &local);
+    std::printf("%s.%06d", text, static_cast<int>(time_us % 1000000));
+}
+
+void print_row(const lwqms::SampleRow &row) {
+    print_time(row.time_us);
+    std::printf(",%u,%g,%g,%g", row.node_id, row.turbidity, row.temperature, row.pH);
+
+    if (row.link_valid) std::printf(",%d,%d", row.rssi_dbm, row.snr_db);
+    std::printf("\n");
+}
+
+int import(const char *store_dir, int file_count, char **files) {
+    lwqms::TelemetryStore store(store_dir);
+    lwqms::TelemetryReader reader(store_dir);
+    lwqms::LocalTimeParser times;
+
+    std::map<uint16_t, int64_t> latest;
+    for (uint16_t node_id : reader.nodes()) {
+        lwqms::SampleRow row;
+        if (reader.latest(node_id, row)) latest[node_id] = row.time_us;
+    }
+
+    uint64_t imported = 0, skipped = 0, rejected = 0;
+    std::vector<char> buf(TSDB_IMPORT_READ_LEN);
+    std::string partial;
+    auto start = std::chrono::steady_clock::now();
+
+    auto take_line = [&](const char *line, size_t len) {
+        if ((len > 0) && (line[len - 1] == '\r')) len--;
+        if (len == 0) return;
+
+        lwqms::SampleRow row;
+
+        if (!lwqms::parse_payload_row(line, len, times, row)) {
+            rejected++;
+            return;
+        }
+
+        auto found = latest.find(row.node_id);
+        if ((found != latest.end()) && (row.time_us <= found->second)) {
+            skipped++;
+            return;
+        }
+
+        store.append(row);
+        imported++;
+    };
+
+    for (int k = 0; k < file_count; k++) {
+        FILE *in = std::fopen(files[k], "rb");
+
+        if (in == nullptr) {
+            std::perror(files[k]);
+            return EXIT_FAILURE;
+        }
+
+        size_t len;
+        partial.clear();
+
+        while ((len = std::fread(buf.data(), 1, buf.size(), in)) > 0) {
+            const char *begin = buf.data();
+            const char *end = begin + len;
+
+            for (const char *newline; (newline = static_cast<const char *>(std::memchr(begin, '\n', end - begin))) != nullptr; begin = newline + 1) {
+                if (partial.empty()) {
+                    take_line(begin, newline - begin);
+                }
+                else {
+                    partial.append(begin, newline);
+                    take_line(partial.data(), partial.size());
+                    partial.clear();
+                }
+            }
+
+            partial.append(begin, end);
+        }
+
+        take_line(partial.data(), partial.size());
+        std::fclose(in);
+    }
+
+    store.sync();
+
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The header of each file is counted as rejected.
+    std::printf("%" PRIu64 " rows imported, %" PRIu64 " already stored, %" PRIu64 " not rows, in %.2f s\n", imported, skipped,
+        rejected, wall_s);
+
+    return EXIT_SUCCESS;
+}
+
+int info(const lwqms::TelemetryReader &reader) {
+    std::vector<uint16_t> nodes = reader.nodes();
+
+    std::printf("%" PRIu64 " rows, %zu nodes\n", reader.rows(), nodes.size());
+
+    for (uint16_t node_id : nodes) {
+        lwqms::SampleRow first, last;
+
+        reader.at(node_id, 0, first);
+        reader.latest(node_id, last);
+
+        std::printf("  Node %u: %" PRIu64 " samples, ", node_id, reader.count(node_id));
+        print_time(first.time_us);
+        std::printf(" to ");
+        print_time(last.time_us);
+        std::printf("\n");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int latest(const lwqms::TelemetryReader &reader) {
+    for (uint16_t node_id : reader.nodes()) {
+        lwqms::SampleRow row;
+        if (reader.latest(node_id, row)) print_row(row);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int range(const lwqms::TelemetryReader &reader, int argc, char **argv) {
+    lwqms::LocalTimeParser times;
+    uint16_t node_id = static_cast<uint16_t>(std::strtoul(argv[0], nullptr, 10));
+    int64_t from_us = INT64_MIN, to_us = INT64_MAX;
+
+    if (((argc > 1) && !times.parse(argv[1], std::strlen(argv[1]), from_us)) || ((argc > 2) && !times.parse(argv[2], std::strlen(argv[2]), to_us))) {
+        std::fprintf(stderr, "Times are local, as YYYY-MM-DDTHH:MM:SS\n");
+        return EXIT_FAILURE;
+    }
+
+    // A sample at a time, so a long history is never held in memory all at once.
+    for (uint64_t position = reader.lower_bound(node_id, from_us);; position++) {
+        lwqms::SampleRow row;
+        if (!reader.at(node_id, position, row) || (row.time_us >= to_us)) break;
+
+        print_row(row);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int rollup(const lwqms::TelemetryReader &reader, int argc, char **argv) {
+    lwqms::LocalTimeParser times;
+    lwqms::Resolution resolution;
+    uint16_t node_id = static_cast<uint16_t>(std::strtoul(argv[0], nullptr, 10));
+    int64_t from_us = INT64_MIN, to_us = INT64_MAX;
+
+    if (!lwqms::parse_resolution(argv[1], resolution)) {
+        std::fprintf(stderr, "Resolutions are 10m, 1h and 1d\n");
+        return EXIT_FAILURE;
+    }
+
+    if (((argc > 2) && !times.parse(argv[2], std::strlen(argv[2]), from_us)) || ((argc > 3) && !times.parse(argv[3], std::strlen(argv[3]), to_us))) {
+        std::fprintf(stderr, "Times are local, as YYYY-MM-DDTHH:MM:SS\n");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<lwqms::RollupBucket> buckets;
+    reader.rollups(node_id, resolution, from_us, to_us, buckets);
+
+    for (const lwqms::RollupBucket &bucket : buckets) {
+        print_time(bucket.start_us);
+        std::printf(",%u", bucket.count);
+
+        for (lwqms::Metric metric : {lwqms::kTurbidity, lwqms::kTemperature, lwqms::kPH}) {
+            std::printf(",%g,%g,%g,%g", bucket.min[metric], bucket.mean(metric), bucket.max[metric], bucket.last[metric]);
+        }
+
+        std::printf("\n");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int forecast(const lwqms::TelemetryReader &reader, int argc, char **argv) {
+    uint16_t node_id = static_cast<uint16_t>(std::strtoul(argv[0], nullptr, 10));
+    size_t steps = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 4;
+    lwqms::SampleRow latest;
+
+    if (!reader.latest(node_id, latest) || (steps == 0)) {
+        std::fprintf(stderr, "Node %u has no samples\n", node_id);
+        return EXIT_FAILURE;
+    }
+
+    lwqms::ForecastModel model(argv[1]);
+    model.set_normalization(lwqms::water_quality_normalization());
+
+    // Half-hour means from the 10 minute rollups, which line up with them
+    int64_t last_slot = (latest.time_us / TSDB_FORECAST_STEP_US) * TSDB_FORECAST_STEP_US;
+    int64_t first_slot = last_slot - ((TSDB_FORECAST_HISTORY - 1) * TSDB_FORECAST_STEP_US);
+    std::vector<lwqms::RollupBucket> buckets;
+    std::vector<double> sums(TSDB_FORECAST_HISTORY * lwqms::kChannels, 0.0);
+    std::vector<uint32_t> counts(TSDB_FORECAST_HISTORY, 0);
+
+    reader.rollups(node_id, lwqms::Resolution::TenMinutes, first_slot, last_slot + TSDB_FORECAST_STEP_US, buckets);
+
+    for (const lwqms::RollupBucket &bucket : buckets) {
+        size_t slot = static_cast<size_t>((bucket.start_us - first_slot) / TSDB_FORECAST_STEP_US);
+
+        sums[(slot * lwqms::kChannels) + lwqms::kChannelTemperature] += bucket.sum[lwqms::kTemperature];
+        sums[(slot * lwqms::kChannels) + lwqms::kChannelPH] += bucket.sum[lwqms::kPH];
+        sums[(slot * lwqms::kChannels) + lwqms::kChannelTurbidity] += bucket.sum[lwqms::kTurbidity];
+        counts[slot] += bucket.count;
+    }
+
+    // Half hours without samples take the mean before them; those before the first sample are left out.
+    std::vector<float> history;
+
+    for (size_t slot = 0; slot < TSDB_FORECAST_HISTORY; slot++) {
+        for (size_t c = 0; c < lwqms::kChannels; c++) {
+            if (counts[slot] > 0) history.push_back(static_cast<float>(sums[(slot * lwqms::kChannels) + c] / counts[slot]));
+            else if (!history.empty()) history.push_back(history[history.size() - lwqms::kChannels]);
+        }
+    }
+
+    size_t history_steps = history.size() / lwqms::kChannels;
+    std::vector<float> out(steps * lwqms::kChannels);
+    lwqms::ForecastState state = model.make_state();
+
+    auto start = std::chrono::steady_clock::now();
+    model.forecast(state, history.data(), history_steps, steps, out.data());
+    double forecast_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("Node %u: %zu half hours of history, forecast in %.0f us\n", node_id, history_steps, forecast_us);
+
+    for (size_t k = 0; k < steps; k++) {
+        const float *y = &out[k * lwqms::kChannels];
+
+        print_time(last_slot + (static_cast<int64_t>(k + 1) * TSDB_FORECAST_STEP_US));
+        std::printf(",%u,%g,%g,%g\n", node_id, y[lwqms::kChannelTurbidity], y[lwqms::kChannelTemperature], y[lwqms::kChannelPH]);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void print_usage(const char *argv0) {
+    std::printf("Usage: %s import STORE payloads.csv...\n", argv0);
+    std::printf("       %s info STORE\n", argv0);
+    std::printf("       %s latest STORE\n", argv0);
+    std::printf("       %s range STORE NODE [FROM [TO]]\n", argv0);
+    std::printf("       %s rollup STORE NODE 10m|1h|1d [FROM [TO]]\n", argv0);
+    std::printf("       %s forecast STORE NODE MODEL [STEPS]\n", argv0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char *command = argv[1];
+    const char *store_dir = argv[2];
+
+    try {
+        if (std::strcmp(command, "import") == 0) return import(store_dir, argc - 3, argv + 3);
+
+        lwqms::TelemetryReader reader(store_dir);
+
+        if (std::strcmp(command, "info") == 0) return info(reader);
+        if (std::strcmp(command, "latest") == 0) return latest(reader);
+        if ((std::strcmp(command, "range") == 0) && (argc > 3)) return range(reader, argc - 3, argv + 3);
+        if ((std::strcmp(command, "rollup") == 0) && (argc > 4)) return rollup(reader, argc - 3, argv + 3);
+        if ((std::strcmp(command, "forecast") == 0) && (argc > 4)) return forecast(reader, argc - 3, argv + 3);
+    }
+    catch (const std::exception &err) {
+        std::fprintf(stderr, "%s\n", err.what());
+        return EXIT_FAILURE;
+    }
+
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+}
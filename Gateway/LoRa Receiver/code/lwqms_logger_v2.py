@@ -3,10 +3,10 @@
 import serial
 import csv
 import os
-import re
+import struct
 import time
 import random
-from datetime import datetime
+from datetime import datetime, timedelta
 
 # ============================
 # User Configuration
@@ -59,38 +59,94 @@ def append_to_csv(filename, row):
         writer = csv.writer(f)
         writer.writerow(row)
 
-def parse_payload(line):
+# ============================
+# Gateway Records
+# ============================
+# The receiver sends binary records, each ending in a zero byte. The layout is
+# set out in lwqms_record.h of the firmware.
+
+RECORD_VERSION = 1
+RECORD_PACKET = 1
+RECORD_STATUS = 2
+RECORD_FLAG_SAMPLES = 0x02
+
+PACKET_TYPE_MESSAGE = 1
+PACKET_TYPE_MASK = 0x1F
+
+PACKET_FIXED = struct.Struct("<BBBBHHHQbbbB")   # Up to and including payload_len
+SAMPLE = struct.Struct("<Hfff")                 # age_s, turbidity, temperature, pH
+STATUS = struct.Struct("<BBBBQII")
+
+def cobs_decode(frame):
+    """Undo the byte stuffing of one frame (without its closing zero). Returns None if it is not valid COBS."""
+    out = bytearray()
+    k = 0
+    while k < len(frame):
+        code = frame[k]
+        if code == 0 or k + code > len(frame):
+            return None
+        out += frame[k + 1:k + code]
+        k += code
+        if code != 0xFF and k < len(frame):
+            out.append(0)
+    return bytes(out)
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, as the gateway computes it."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+def decode_record(frame):
     """
-    Parse LWQMS_PLD packets like:
-    LWQMS_PLD[1]: 0.000450 23.000000 7.000000 END
+    Decode one record. Returns (payload_rows, message_rows), with rows in the
+    CSV layout, or None if the record is damaged or of no interest.
+
+    Samples carry their age in seconds, and are timestamped when they were
+    taken rather than when they arrived.
     """
-    match = re.match(
-        r"LWQMS_PLD\[(\d+)\]:\s*([\d\.\-Ee]+)\s+([\d\.\-Ee]+)\s+([\d\.\-Ee]+)\s+END",
-        line,
-    )
-    if match:
-        node_id = int(match.group(1))
-        turbidity = float(match.group(2))
-        temperature = float(match.group(3))
-        ph = float(match.group(4))
-        timestamp = datetime.now().isoformat()
+    record = cobs_decode(frame)
+    if record is None or len(record) < 6:
+        return None
+
+    body, crc = record[:-2], struct.unpack("<H", record[-2:])[0]
+    if crc16(body) != crc or body[0] != RECORD_VERSION:
+        return None
+
+    if body[1] == RECORD_STATUS and len(body) == STATUS.size:
+        _, _, _, _, _, ring_overflows, queue_overflows = STATUS.unpack(body)
+        if ring_overflows or queue_overflows:
+            print(f"[GATEWAY] output fell behind; radio core waited {ring_overflows} times, {queue_overflows} packets left unacknowledged")
+        return None
+
+    if body[1] != RECORD_PACKET or len(body) < PACKET_FIXED.size + 1:
+        return None
+
+    _, _, flags, packet_type, node_id, _, _, _, _, _, _, payload_len = PACKET_FIXED.unpack_from(body)
+    payload = body[PACKET_FIXED.size:PACKET_FIXED.size + payload_len]
+    now = datetime.now()
+
+    if (packet_type & PACKET_TYPE_MASK) == PACKET_TYPE_MESSAGE:
+        message = payload.split(b"\0", 1)[0].decode(errors="ignore")
+        return [], [[now.isoformat(), node_id, message]]
+
+    if not (flags & RECORD_FLAG_SAMPLES):
+        return [], [[now.isoformat(), node_id, "Malformed telemetry batch"]]
+
+    offset = PACKET_FIXED.size + payload_len
+    qty_samples = body[offset]
+    rows = []
+    for k in range(qty_samples):
+        age_s, turbidity, temperature, ph = SAMPLE.unpack_from(body, offset + 1 + (k * SAMPLE.size))
+        timestamp = (now - timedelta(seconds=age_s)).isoformat()
         # IMPORTANT: order matches your dashboard expectation:
         # [Time, Sensor Node ID, Turbidity (NTU), Temperature (C), pH]
-        return [timestamp, node_id, turbidity, temperature, ph]
-    return None
-
-def parse_message(line):
-    """
-    Parse LWQMS_MSG packets like:
-    LWQMS_MSG[1]: Transmitter Ready END
-    """
-    match = re.match(r"LWQMS_MSG\[(\d+)\]:\s*(.*?)\s*END", line)
-    if match:
-        node_id = int(match.group(1))
-        message = match.group(2)
-        timestamp = datetime.now().isoformat()
-        return [timestamp, node_id, message]
-    return None
+        rows.append([timestamp, node_id, turbidity, temperature, ph])
+    return rows, []
 
 def _bounded_random_step(current, base, frac_of_base_step, hard_min, hard_max):
     # Make a small random step around 'current' with limits based on base and hard bounds.
@@ -156,23 +212,28 @@ def main():
     # Track when we last generated a Node 2 sample
     last_node2_time = time.time()
 
+    pending = bytearray()
+
     try:
         with serial.Serial(PORT, BAUDRATE, timeout=TIMEOUT) as ser:
             while True:
                 try:
-                    line = ser.readline().decode(errors="ignore").strip()
-
-                    # 1) Handle real packets from the receiver (Node 1)
-                    if line:
-                        if "LWQMS_PLD" in line:
-                            payload_data = parse_payload(line)
-                            if payload_data:
+                    frame = ser.read_until(b"\0")
+
+                    # 1) Handle real packets from the receiver (Node 1).
+                    # A read that timed out mid-frame is kept for the next one.
+                    pending += frame
+                    if pending.endswith(b"\0"):
+                        decoded = decode_record(bytes(pending[:-1]))
+                        pending.clear()
+
+                        if decoded:
+                            payload_rows, message_rows = decoded
+                            for payload_data in payload_rows:
                                 append_to_csv(PAYLOAD_FILE, payload_data)
                                 print(f"[PAYLOAD] {payload_data}")
 
-                        elif "LWQMS_MSG" in line:
-                            message_data = parse_message(line)
-                            if message_data:
+                            for message_data in message_rows:
                                 append_to_csv(MESSAGE_FILE, message_data)
                                 print(f"[MESSAGE] {message_data}")
 
@@ -11,41 +11,68 @@
 *********************************************************************************************************************/
 
 #include "main.h"
+#include "spsc_ring.h"
+#include "lwqms_record.h"
 
-void print_banner(void) {
-    printf("\n\n-- LoRa Water Quality Management System Receiver --\n");
-    printf("Version 0.1, compiled %s, %s\n\n", __DATE__, __TIME__);
-}
+/**
+ * Core 1 owns the radio: it services its interrupts, runs the RDT receive path and sends every ACK. Core 0 owns the USB
+ * console: it decodes the payloads and writes them to the host as binary records. Frames pass from one to the other through
+ * a lock-free ring, so a slow or missing console host can hold up the output but never an ACK.
+ */
+
+#define RECEIVER_POLL_MS 1000
+#define RECEIVER_RING_LEN 16                // Power of two
+#define RECEIVER_RING_RETRY_MS 10           // How long the radio core keeps servicing the radio before retrying a full ring
+
+// A packet as it is handed from the radio core to the console core
+typedef struct receiver_frame_s {
+    lora_pkt_t pkt;                         // Without its CRC trailer
+    lwqms_pkt_t header;                     // Decoded on the radio core
+    rdt3_0_gw_rx_info_t info;
+} receiver_frame_t;
+
+static receiver_frame_t frame_ring_storage[RECEIVER_RING_LEN];
+static spsc_ring_t frame_ring;
+
+// Packets the radio core left unacknowledged because the console core had fallen too far behind. Written by the radio core only.
+static _Atomic uint32_t radio_queue_overflows;
 
 int receiver_setup(void) {
     /**
      * 1. Initialize GPIO
-     * 2. Initialize SPI Bus
-     * 3. Initialize Radio
+     * 2. Initialize the USB console, without waiting for a host to attach
+     * 3. Initialize the frame ring
      */
 
+    uint8_t output_pins[] = {STATUS_LED, TX_LED, RX_LED, ERR_LED};
+
+    // Initialize the gpio pins and assert LOW on all.
+    for (int k = 0; k < sizeof(output_pins); k++) {
+        gpio_setup_hal(output_pins[k], true);
+        gpio_write_hal(output_pins[k], GPIO_LOW);
+    }
+
     init_usb_console_hal();
 
-    wait_for_usb_console_connection_hal();
+    return spsc_ring_init(&frame_ring, frame_ring_storage, sizeof(receiver_frame_t), RECEIVER_RING_LEN) ? 0 : -1;
+}
 
-    print_banner();
+int radio_setup(void) {
+    /**
+     * 1. Initialize SPI Bus
+     * 2. Initialize Radio
+     * 
+     * Runs on the radio core, so that the radio and SPI DMA interrupts are serviced there.
+     */
 
     bool init_ok = false;
     for (int k = 0; k < COMMS_RETRIES; k++) {
         do {
-            uint8_t output_pins[] = {STATUS_LED, TX_LED, RX_LED, ERR_LED};
-            
-            // Initialize the gpio pins and assert LOW on all.
-            for (int k = 0; k < sizeof(output_pins); k++) {
-                gpio_setup_hal(output_pins[k], true);
-                gpio_write_hal(output_pins[k], GPIO_LOW);
-            }
-        
             // Initialize all SPI peripherals.
             if (spi_init_hal(&context_spi_0) < 0) break;
             sx126x_initialize_hardware_context(&context_radio_0);
-            sx126x_radio_setup(&context_radio_0);
             sx126x_interrupt_setup(&context_radio_0);
+            sx126x_radio_setup(&context_radio_0);
             
             init_ok = true;
     
@@ -77,32 +104,138 @@ lora_setup_t dedicated_receiver_setup = {
     .node_config = &rx_config,
 };
 
+// The radio stays in continuous receive, and the ACK for each node is sent while the next frames are already arriving.
+static rdt3_0_gateway_t gateway;
+
+static lwqms_telemetry_batch_t rx_batch;
+
+void radio_core_main(void) {
+    receiver_frame_t frame;
+    bool holding = false;
+
+    if (radio_setup() < 0) {
+        err_raise(ERR_POST_FAIL, ERR_SEV_FATAL, "Failed to initialize the radio!", "radio_core_main");
+    }
+
+    if (!rdt3_0_gateway_start(&gateway, &dedicated_receiver_setup)) {
+        err_raise(ERR_LORA_FAIL, ERR_SEV_FATAL, "Failed to start receiving!", "radio_core_main");
+    }
+
+    while (1) {
+        if (!holding) {
+            // Retransmissions of packets already received are acknowledged again in here, but never returned, so each
+            // packet is printed once.
+            if (!rdt3_0_gateway_receive(&gateway, &frame.pkt, &frame.info, RECEIVER_POLL_MS)) continue;
+
+            lwqms_pkt_decode(frame.pkt.buf, frame.pkt.len, &frame.header);
+            holding = true;
+        }
+
+        if (spsc_ring_push(&frame_ring, &frame)) {
+            holding = false;
+            signal_event_hal();
+            continue;
+        }
+
+        // The console core is behind. Keep acknowledging while it catches up; once the gateway's own queue is full as well,
+        // new packets go unacknowledged and their nodes send them again later.
+        rdt3_0_gateway_service(&gateway, RECEIVER_RING_RETRY_MS);
+        atomic_store_explicit(&radio_queue_overflows, gateway.stats.queue_overflows, memory_order_relaxed);
+    }
+}
+
+// Records go out one at a time from the console core, so one pair of buffers serves them all.
+static uint8_t record_buf[LWQMS_RECORD_LEN_MAX];
+static uint8_t frame_buf[LWQMS_COBS_FRAME_LEN_MAX(LWQMS_RECORD_LEN_MAX)];
+
+static void send_record(size_t record_len) {
+    size_t frame_len = lwqms_cobs_encode(record_buf, record_len, frame_buf, sizeof(frame_buf));
+
+    if ((record_len == 0) || (frame_len == 0)) return;
+
+    usb_console_write_bytes_hal(frame_buf, frame_len);
+}
+
+static void send_frame(receiver_frame_t *frame) {
+    lora_pkt_t *rxPacket = &frame->pkt;
+    lwqms_pkt_t *processed_packet = &frame->header;
+    lwqms_telemetry_batch_t *samples = &rx_batch;
+
+    // Telemetry goes out decoded as well as raw: compact packets can only be decoded against the node's previous packet,
+    // which only the gateway is sure to have seen. The radio core acknowledged them only once it held that sample, and
+    // passes it along with each one.
+    switch (processed_packet->packet_type & LWQMS_PKT_TYPE_MASK) {
+        case LWQMS_PACKET_TYPE_TELEMETRY:
+            rx_batch.qty_samples = 1;
+            rx_batch.samples[0].age_s = 0;
+            rx_batch.samples[0].telemetry = processed_packet->payload.telemetry;
+            break;
+        case LWQMS_PACKET_TYPE_TELEMETRY_BATCH:
+            if (!lwqms_pkt_decode_batch(rxPacket->buf, rxPacket->len, processed_packet, &rx_batch)) samples = NULL;
+            break;
+        case LWQMS_PACKET_TYPE_TELEMETRY_COMPACT:
+            if (!lwqms_pkt_decode_compact(rxPacket->buf, rxPacket->len, &frame->info.telemetry_ref, processed_packet, &rx_batch)) samples = NULL;
+            break;
+        default:
+            samples = NULL;
+            break;
+    }
+
+    const sx126x_pkt_status_lora_t *link = rxPacket->link_valid ? &rxPacket->link : NULL;
+
+    send_record(lwqms_record_encode_packet(rxPacket->buf, rxPacket->len, frame->info.rx_time_us, link, samples, record_buf, sizeof(record_buf)));
+}
+
+static void send_status(void) {
+    uint32_t ring_overflows = spsc_ring_overflows(&frame_ring);
+    uint32_t queue_overflows = atomic_load_explicit(&radio_queue_overflows, memory_order_relaxed);
+
+    send_record(lwqms_record_encode_status(to_us_since_boot(get_absolute_time()), ring_overflows, queue_overflows, record_buf, sizeof(record_buf)));
+}
+
+static void report_overflows(void) {
+    static uint32_t reported_ring_overflows;
+    static uint32_t reported_queue_overflows;
+
+    uint32_t ring_overflows = spsc_ring_overflows(&frame_ring);
+    uint32_t queue_overflows = atomic_load_explicit(&radio_queue_overflows, memory_order_relaxed);
+
+    if ((ring_overflows == reported_ring_overflows) && (queue_overflows == reported_queue_overflows)) return;
+
+    send_status();
+
+    reported_ring_overflows = ring_overflows;
+    reported_queue_overflows = queue_overflows;
+}
+
 int main(void) {
 
     if (receiver_setup() < 0) {
         err_raise(ERR_POST_FAIL, ERR_SEV_FATAL, "Failed to initialize!", "main");
     }
 
-    printf("READY\n");
+    if (!launch_core1_hal(radio_core_main)) {
+        err_raise(ERR_BAD_SETUP, ERR_SEV_FATAL, "The receiver needs a second core for the radio", "main");
+    }
+
+    bool console_connected = false;
 
     while (1) {
-        printf("RX MODE ENABLED\n");
-
-        lora_pkt_t rxPacket;
-        rdt3_0_receive((rdt_packet_t)(&rxPacket), sizeof(lwqms_pkt_t), &dedicated_receiver_setup);
-        
-        lwqms_pkt_t processed_packet;
-        lwqms_pkt_decode(rxPacket.buf, rxPacket.len, &processed_packet);
-
-        switch (processed_packet.packet_type) {
-            case LWQMS_PACKET_TYPE_MESSAGE:
-                printf("LWQMS_MSG[%d]: %s END", processed_packet.src_id, processed_packet.payload.message);
-                break;
-            case LWQMS_PACKET_TYPE_TELEMETRY:
-                printf("LWQMS_PLD[%d]: %f %f %f END", processed_packet.src_id, processed_packet.payload.telemetry.turbidity_measurement, processed_packet.payload.telemetry.temperature_measurement, processed_packet.payload.telemetry.pH_measurement);
-                break;
+        // Each host that attaches is sent a status record first; until one does, output is simply dropped.
+        if (is_usb_console_connected_hal() != console_connected) {
+            console_connected = !console_connected;
+
+            if (console_connected) send_status();
         }
-        
-        printf("\n\n");
+
+        receiver_frame_t frame;
+
+        if (!spsc_ring_pop(&frame_ring, &frame)) {
+            report_overflows();
+            sleep_until_event_hal(make_timeout_time_ms(RECEIVER_POLL_MS));
+            continue;
+        }
+
+        send_frame(&frame);
     }
 }
\ No newline at end of file
@@ -118,7 +118,8 @@ int main()
                 &prototyping_irq_masks,
                 &prototyping_pkt_params,
                 txBuf,
-                89
+                89,
+                LORA_TIMEOUT_MS
         );
 
         usb_console_write_hal("DONE\n");
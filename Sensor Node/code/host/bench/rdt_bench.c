@@ -0,0 +1,584 @@
+/********************************************************************************************************************
+*
+*   @file rdt_bench.c
+*
+*   @brief Host-native benchmark of the Reliable Data Transfer 3.0 layer. Runs the unmodified rdt3_0_transmit_ctx() or
+*          rdt3_0_receive_ctx() against the simulated SX1262 and a simulated gateway over an airtime-accurate LoRa link with
+*          configurable loss, corruption and latency, and reports the throughput, latency and energy of each operation.
+*          With several sending nodes, it instead measures the receive side under contention: the frames per second it
+*          sustains and the packets lost, with rdt3_0_receive_ctx() or the continuous-receive gateway service.
+*
+*          All times are virtual: they are what the firmware would see on the board, not how long the benchmark takes.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "main.h"
+
+#include "host_sim.h"
+#include "host_board.h"
+
+#include <signal.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define BENCH_DEFAULT_PACKETS 100
+#define BENCH_DEFAULT_INTERVAL_MS 1000
+#define BENCH_DEFAULT_HANG_LIMIT_S 60
+#define BENCH_DEFAULT_GATEWAY_NODES 4
+#define BENCH_FIRST_NODE_ID 10
+#define BENCH_GATEWAY_POLL_MS 100
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef enum bench_mode_e {
+    BENCH_MODE_TX = 0,      // The node sends with rdt3_0_transmit(), the gateway acknowledges
+    BENCH_MODE_RX = 1,      // The gateway sends, the node receives with rdt3_0_receive()
+    BENCH_MODE_GATEWAY = 2, // Several nodes send, the firmware receives with the continuous-receive gateway service
+} bench_mode_t;
+
+typedef struct bench_result_s {
+    uint32_t operations;
+    uint32_t succeeded;
+    uint64_t *latency_us;           // Per operation
+    uint64_t elapsed_us;
+    double energy_uj;
+    double radio_energy_uj;
+    uint32_t radio_commands;
+    uint64_t spi_bytes;
+    uint32_t rx_missed;             // Frames that reached the node's antenna while its radio was not listening for them
+    uint32_t rx_frames;             // Frames the node's radio received to the end, damaged or not
+    uint32_t rx_collisions;
+    uint64_t turnaround_total_us;   // From TX done to the radio receiving again
+    uint32_t turnarounds;
+} bench_result_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+static FILE *report = NULL;     // The real stdout; the firmware's own output goes to stdout, which is silenced unless --verbose
+
+static bench_mode_t mode = BENCH_MODE_TX;
+static uint32_t packets = BENCH_DEFAULT_PACKETS;
+static uint32_t interval_ms = BENCH_DEFAULT_INTERVAL_MS;
+static uint32_t hang_limit_s = BENCH_DEFAULT_HANG_LIMIT_S;
+static uint32_t turnaround_us = SIM_LORA_PEER_DEFAULT_TURNAROUND_US;
+static uint32_t rx_delay_us = 0;
+static uint32_t qty_nodes = 0;      // Sending nodes in the contention benchmark; 0 for the single-link benchmark
+static uint8_t path_loss_db = 0;    // Extra loss of the furthest node; the others are spread evenly between it and the nearest
+static uint64_t channel_seed = HOST_CHANNEL_SEED;
+static bool verbose = false;
+static bool windowed = false;
+static sim_lora_link_cfg_t link_cfg = {.rssi_dbm = -60, .snr_db = 8};
+
+static lora_setup_t bench_phy_setup = {
+    .hw = &context_radio_0,
+    .mod_setting = &prototyping_mod_params,
+    .operation_timeout_ms = LORA_TIMEOUT_MS,
+    .pa_setting = &sx1262_22dBm_pa_params,
+    .pkt_setting = &prototyping_pkt_params,
+    .ramp_time = SX126X_RAMP_200_US,
+    .rx_interrupt_setting = &prototyping_irq_masks,
+    .tx_interrupt_setting = &prototyping_irq_masks,
+    .txPower = LORA_TX_POWER_DBM,
+    .node_config = &sys_configuration,
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Simulation Hooks
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Simulation Hooks
+
+void host_sim_end_boot_cycle(host_exit_reason_t reason) {
+    fflush(stdout);
+
+    fprintf(report, "Benchmark aborted: the firmware ended its boot cycle (reason %d) at %.3f s\n", reason, host_world->now_us / 1e6);
+    fflush(report);
+
+    _exit(EXIT_FAILURE);
+}
+
+static void on_hang_limit(int signum) {
+    (void)signum;
+    host_sim_end_boot_cycle(HOST_EXIT_HANG);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Benchmark
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Benchmark
+
+// The benchmark drives the allocation-free transport, as the firmware does.
+static lora_pkt_t rdt_scratch_pkt;
+static rdt3_0_ctx_t rdt_ctx = RDT3_0_CTX_INIT(&rdt_scratch_pkt, &bench_phy_setup);
+
+static rdt3_0_gateway_t gateway;
+
+static void encode_telemetry(lora_pkt_t *pkt, uint32_t k) {
+    lwqms_pkt_t telem_packet = {
+        .src_id = sys_configuration.ID,
+        .dest_id = sys_configuration.gateway_ID,
+        .packet_type = LWQMS_PACKET_TYPE_TELEMETRY,
+        .pkt_id = (uint16_t)(k + 1),
+        .payload = {
+            .telemetry = {
+                .turbidity_measurement = 13.0f,
+                .temperature_measurement = 18.0f,
+                .pH_measurement = 7.0f
+            }
+        }
+    };
+
+    pkt->len = LWQMS_PKT_LEN_MAX;
+    lwqms_pkt_encode(&telem_packet, pkt->buf, pkt->len);
+}
+
+static rdt3_0_result_codes_t run_operation(uint32_t k) {
+    lora_pkt_t pkt;
+
+    if (mode == BENCH_MODE_TX) {
+        encode_telemetry(&pkt, k);
+
+        return rdt3_0_transmit_ctx(&rdt_ctx, &pkt);
+    }
+
+    return rdt3_0_receive_ctx(&rdt_ctx, &pkt);
+}
+
+static void run_window_transfer(bench_result_t *result) {
+    // The whole run is one backlog, drained by a single selective repeat transfer.
+    lora_pkt_t *backlog = calloc(packets, sizeof(lora_pkt_t));
+    size_t delivered = 0;
+
+    for (uint32_t k = 0; k < packets; k++) encode_telemetry(&backlog[k], k);
+
+    uint64_t op_start_us = host_sim_now_us();
+
+    rdt3_0_transmit_window_ctx(&rdt_ctx, backlog, packets, &delivered);
+
+    result->latency_us[0] = host_sim_now_us() - op_start_us;
+    result->operations = 1;
+    result->succeeded = (delivered == packets) ? 1 : 0;
+
+    free(backlog);
+}
+
+static void start_nodes(void) {
+    // A node gives up on the ACK once the gateway's turnaround and the whole ACK could have gone by.
+    uint64_t ack_toa_us = sim_lora_time_on_air_us(&host_world->peer.phy.lora, LWQMS_PKT_LEN_MAX + LWQMS_PKT_CRC_LEN);
+
+    host_world->peer.mode = SIM_LORA_PEER_OFF;
+    host_world->qty_nodes = qty_nodes;
+
+    for (uint32_t k = 0; k < qty_nodes; k++) {
+        sim_lora_peer_t *node = &host_world->nodes[k];
+
+        sim_lora_peer_init(node, BENCH_FIRST_NODE_ID + k, &host_world->peer.phy);
+        node->path_loss_db = (qty_nodes > 1) ? (uint8_t)((path_loss_db * k) / (qty_nodes - 1)) : 0;
+        node->ack_timeout_us = (RDT3_0_ACK_TURNAROUND_MS * 1000) + ack_toa_us + (RDT3_0_IRQ_MARGIN_MS * 1000);
+
+        // Nodes wake on their own clocks, and back off by a random amount before resending.
+        node->send_jitter_us = interval_ms * 1000;
+        sim_lora_peer_start_sending(node, sys_configuration.ID, packets, interval_ms * 1000);
+    }
+}
+
+static bool nodes_done(void) {
+    for (uint32_t k = 0; k < qty_nodes; k++) {
+        if (host_world->nodes[k].send_remaining > 0) return false;
+    }
+
+    return true;
+}
+
+static void run_contention(bench_result_t *result) {
+    if (mode == BENCH_MODE_GATEWAY) rdt3_0_gateway_start(&gateway, &bench_phy_setup);
+
+    while (!nodes_done()) {
+        lora_pkt_t pkt;
+        bool received;
+
+        if (mode == BENCH_MODE_GATEWAY) {
+            received = rdt3_0_gateway_receive(&gateway, &pkt, NULL, BENCH_GATEWAY_POLL_MS);
+        }
+        else {
+            received = (rdt3_0_receive_ctx(&rdt_ctx, &pkt) == RDT3_0_RESULT_CODES_OK);
+        }
+
+        result->operations++;
+        if (received) result->succeeded++;
+    }
+}
+
+static void run_benchmark(bench_result_t *result) {
+    result->latency_us = calloc(packets, sizeof(uint64_t));
+
+    if (qty_nodes > 0) start_nodes();
+
+    else if (mode == BENCH_MODE_RX) {
+        sim_lora_peer_start_sending(&host_world->peer, sys_configuration.ID, packets, interval_ms * 1000);
+    }
+
+    uint64_t start_us = host_sim_now_us();
+    double start_energy_uj = host_board_energy_uj();
+    double start_radio_energy_uj = sim_sx1262_energy_uj(&host_world->radio);
+    uint32_t start_radio_commands = host_world->radio.commands;
+    uint64_t start_spi_bytes = host_world->stats.spi_bytes;
+    uint32_t start_rx_missed = host_world->radio.rx_missed;
+    uint32_t start_rx_frames = host_world->radio.rx_done;
+    uint32_t start_rx_collisions = host_world->radio.rx_collisions;
+    uint64_t start_turnaround_total_us = host_world->radio.turnaround_total_us;
+    uint32_t start_turnarounds = host_world->radio.turnarounds;
+
+    if (windowed) run_window_transfer(result);
+    if (qty_nodes > 0) run_contention(result);
+
+    for (uint32_t k = 0; (k < packets) && !windowed && (qty_nodes == 0); k++) {
+        uint64_t op_start_us = host_sim_now_us();
+
+        if (run_operation(k) == RDT3_0_RESULT_CODES_OK) result->succeeded++;
+
+        result->latency_us[k] = host_sim_now_us() - op_start_us;
+        result->operations++;
+
+        // In TX mode the node paces itself like the FSM would between samples.
+        if ((mode == BENCH_MODE_TX) && (k + 1 < packets)) sleep_ms(interval_ms);
+    }
+
+    result->elapsed_us = host_sim_now_us() - start_us;
+
+    // Under contention the run ends with the last node's last packet, not with the receive call that noticed.
+    if (qty_nodes > 0) {
+        uint64_t done_us = start_us;
+        for (uint32_t k = 0; k < qty_nodes; k++) {
+            if (host_world->nodes[k].done_us > done_us) done_us = host_world->nodes[k].done_us;
+        }
+        result->elapsed_us = done_us - start_us;
+    }
+    result->energy_uj = host_board_energy_uj() - start_energy_uj;
+    result->radio_energy_uj = sim_sx1262_energy_uj(&host_world->radio) - start_radio_energy_uj;
+    result->radio_commands = host_world->radio.commands - start_radio_commands;
+    result->spi_bytes = host_world->stats.spi_bytes - start_spi_bytes;
+    result->rx_missed = host_world->radio.rx_missed - start_rx_missed;
+    result->rx_frames = host_world->radio.rx_done - start_rx_frames;
+    result->rx_collisions = host_world->radio.rx_collisions - start_rx_collisions;
+    result->turnaround_total_us = host_world->radio.turnaround_total_us - start_turnaround_total_us;
+    result->turnarounds = host_world->radio.turnarounds - start_turnarounds;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Report
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Report
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void print_report(bench_result_t *result) {
+    const sim_lora_peer_stats_t *peer = &host_world->peer.stats;
+    uint64_t latency_total_us = 0;
+
+    for (uint32_t k = 0; k < result->operations; k++) latency_total_us += result->latency_us[k];
+    qsort(result->latency_us, result->operations, sizeof(uint64_t), compare_u64);
+
+    double n = (result->operations > 0) ? result->operations : 1;
+    double delivered = (mode == BENCH_MODE_TX) ? peer->data_received - peer->duplicates : result->succeeded;
+    double payload_bits = delivered * LWQMS_PKT_LEN_MAX * 8;
+    double radio_on_s = (host_world->radio.mode_time_us[SIM_SX1262_MODE_TX] + host_world->radio.mode_time_us[SIM_SX1262_MODE_RX]) / 1e6;
+
+    fprintf(report, "\n-- RDT 3.0 Benchmark (%s) --\n", windowed ? "rdt3_0_transmit_window_ctx" : (mode == BENCH_MODE_TX) ? "rdt3_0_transmit_ctx" : "rdt3_0_receive_ctx");
+    fprintf(report, "Link:\t\t\tloss %.3f, corruption %.3f, latency %u us + %u us jitter, seed %llu\n", link_cfg.loss_prob, link_cfg.corrupt_prob,
+        link_cfg.latency_us, link_cfg.jitter_us, (unsigned long long)channel_seed);
+    fprintf(report, "LoRa:\t\t\tSF%d, BW code %d, CR 4/%d, %d byte payload, %.1f ms time-on-air\n", prototyping_mod_params.sf, prototyping_mod_params.bw,
+        prototyping_mod_params.cr + 4, LWQMS_PKT_LEN_MAX, sim_lora_time_on_air_us(&host_world->peer.phy.lora, LWQMS_PKT_LEN_MAX) / 1e3);
+    if (windowed) {
+        fprintf(report, "Operations:\t\t1 transfer of %u packets, %s, window of %d\n", packets, result->succeeded ? "succeeded" : "failed",
+            RDT3_0_SR_WINDOW_SIZE);
+    }
+    else {
+        fprintf(report, "Operations:\t\t%u, %u succeeded (%.1f %%)\n", result->operations, result->succeeded, 100.0 * result->succeeded / n);
+    }
+
+    fprintf(report, "Packets delivered:\t%.0f unique\n", delivered);
+    fprintf(report, "Elapsed:\t\t%.3f s\n", result->elapsed_us / 1e6);
+    fprintf(report, "Throughput:\t\t%.1f bit/s of payload\n", (result->elapsed_us > 0) ? payload_bits / (result->elapsed_us / 1e6) : 0.0);
+    fprintf(report, "Radio-on throughput:\t%.1f bit/s of payload per second of TX or RX\n", (radio_on_s > 0) ? payload_bits / radio_on_s : 0.0);
+
+    if (windowed) {
+        fprintf(report, "Transfer time:\t\t%.1f ms, %.1f ms per packet\n", result->latency_us[0] / 1e3, result->latency_us[0] / 1e3 / packets);
+    }
+    else if (result->operations > 0) {
+        fprintf(report, "Latency:\t\tmean %.1f ms, p50 %.1f ms, p95 %.1f ms, max %.1f ms\n", (latency_total_us / n) / 1e3,
+            result->latency_us[result->operations / 2] / 1e3, result->latency_us[(uint32_t)(0.95 * (result->operations - 1))] / 1e3,
+            result->latency_us[result->operations - 1] / 1e3);
+    }
+
+    fprintf(report, "Energy:\t\t\t%.3f mJ total (%.3f mJ radio), %.3f mJ per delivered packet\n", result->energy_uj / 1e3, result->radio_energy_uj / 1e3,
+        (delivered > 0) ? result->energy_uj / 1e3 / delivered : 0.0);
+    fprintf(report, "Radio time:\t\t%.3f s TX, %.3f s RX\n", host_world->radio.mode_time_us[SIM_SX1262_MODE_TX] / 1e6,
+        host_world->radio.mode_time_us[SIM_SX1262_MODE_RX] / 1e6);
+    fprintf(report, "Radio commands:\t\t%u, %.1f per operation (%llu SPI bytes)\n", result->radio_commands,
+        (result->operations > 0) ? (double)result->radio_commands / result->operations : 0.0, (unsigned long long)result->spi_bytes);
+
+    for (int dir = SIM_LORA_DIR_UPLINK; dir <= SIM_LORA_DIR_DOWNLINK; dir++) {
+        const sim_lora_link_stats_t *link = &host_world->channel.stats[dir];
+        fprintf(report, "%s:\t\t%u frames, %u lost, %u corrupted\n", (dir == SIM_LORA_DIR_UPLINK) ? "Uplink" : "Downlink", link->frames,
+            link->lost, link->corrupted);
+    }
+
+    if (mode == BENCH_MODE_TX) {
+        fprintf(report, "Gateway:\t\t%u packets received, %u duplicates, %u ACKs sent, %u NACKs sent, %u frames missed\n", peer->data_received,
+            peer->duplicates, peer->acks_sent, peer->nacks_sent, peer->frames_missed);
+        // Everything the gateway sends the node is an ACK or NACK, so any of them the radio was not listening for was missed.
+        uint32_t acks_on_air = peer->acks_sent + peer->nacks_sent;
+        fprintf(report, "Missed ACKs:\t\t%u of %u (%.1f %%), TX to RX turnaround %.1f us mean\n", result->rx_missed, acks_on_air,
+            (acks_on_air > 0) ? 100.0 * result->rx_missed / acks_on_air : 0.0,
+            (result->turnarounds > 0) ? (double)result->turnaround_total_us / result->turnarounds : 0.0);
+        fprintf(report, "ACK timing:\t\tSRTT %u ms, RTTVAR %u ms, RTO %u ms\n", rdt_ctx.rtt.srtt_ms, rdt_ctx.rtt.rttvar_ms,
+            (unsigned)rdt3_0_rto_ms(&rdt_ctx));
+    }
+    else {
+        fprintf(report, "Gateway:\t\t%u sends (%u retransmissions), %u acknowledged, %u NACKed, %u abandoned, %u frames missed\n", peer->data_sent,
+            peer->retransmissions, peer->data_acked, peer->nacks_received, peer->data_abandoned, peer->frames_missed);
+    }
+}
+
+static void print_contention_report(bench_result_t *result) {
+    sim_lora_peer_stats_t total = {0};
+    uint32_t least_acked = UINT32_MAX;
+    uint32_t most_acked = 0;
+
+    for (uint32_t k = 0; k < qty_nodes; k++) {
+        const sim_lora_peer_stats_t *node = &host_world->nodes[k].stats;
+
+        total.data_sent += node->data_sent;
+        total.retransmissions += node->retransmissions;
+        total.data_acked += node->data_acked;
+        total.nacks_received += node->nacks_received;
+        total.data_abandoned += node->data_abandoned;
+        total.ack_latency_total_us += node->ack_latency_total_us;
+
+        if (node->data_acked < least_acked) least_acked = node->data_acked;
+        if (node->data_acked > most_acked) most_acked = node->data_acked;
+    }
+
+    const sim_lora_link_stats_t *downlink = &host_world->channel.stats[SIM_LORA_DIR_DOWNLINK];
+    double elapsed_s = (result->elapsed_us > 0) ? result->elapsed_us / 1e6 : 1.0;
+    double generated = (double)qty_nodes * packets;
+
+    fprintf(report, "\n-- RDT 3.0 Contention Benchmark (%s) --\n", (mode == BENCH_MODE_GATEWAY) ? "rdt3_0_gateway_receive" : "rdt3_0_receive_ctx");
+    fprintf(report, "Link:\t\t\tloss %.3f, corruption %.3f, latency %u us + %u us jitter, seed %llu\n", link_cfg.loss_prob, link_cfg.corrupt_prob,
+        link_cfg.latency_us, link_cfg.jitter_us, (unsigned long long)channel_seed);
+    fprintf(report, "LoRa:\t\t\tSF%d, BW code %d, CR 4/%d, %.1f ms time-on-air per frame\n", prototyping_mod_params.sf, prototyping_mod_params.bw,
+        prototyping_mod_params.cr + 4, sim_lora_time_on_air_us(&host_world->peer.phy.lora, LWQMS_PKT_LEN_MAX + LWQMS_PKT_CRC_LEN) / 1e3);
+    fprintf(report, "Nodes:\t\t\t%u x %u packets, every %u ms + up to %u ms at random, ACK timeout %.0f ms\n", qty_nodes, packets, interval_ms,
+        interval_ms, host_world->nodes[0].ack_timeout_us / 1e3);
+    fprintf(report, "Offered load:\t\t%.1f %% of the channel (%u data frames, %u retransmissions)\n", 100.0 * downlink->airtime_us / result->elapsed_us,
+        total.data_sent, total.retransmissions);
+    fprintf(report, "Elapsed:\t\t%.3f s\n", result->elapsed_us / 1e6);
+    fprintf(report, "Frames received:\t%u (%.2f frames/s), %u collisions, %u missed\n", result->rx_frames, result->rx_frames / elapsed_s,
+        result->rx_collisions, result->rx_missed);
+    fprintf(report, "Packets delivered:\t%u of %.0f unique (%.2f packets/s)\n", result->succeeded, generated, result->succeeded / elapsed_s);
+    fprintf(report, "Loss:\t\t\t%.1f %% (%u packets abandoned by their nodes)\n", (generated > 0) ? 100.0 * (generated - result->succeeded) / generated : 0.0,
+        total.data_abandoned);
+    fprintf(report, "Delivery latency:\tmean %.1f ms, first send to ACK\n", (total.data_acked > 0) ? total.ack_latency_total_us / 1e3 / total.data_acked : 0.0);
+    fprintf(report, "Fairness:\t\t%u to %u packets acknowledged per node\n", (qty_nodes > 0) ? least_acked : 0, most_acked);
+    fprintf(report, "Energy:\t\t\t%.3f mJ total (%.3f mJ radio), %.3f mJ per delivered packet\n", result->energy_uj / 1e3, result->radio_energy_uj / 1e3,
+        (result->succeeded > 0) ? result->energy_uj / 1e3 / result->succeeded : 0.0);
+    fprintf(report, "Radio commands:\t\t%u, %.1f per delivered packet\n", result->radio_commands,
+        (result->succeeded > 0) ? (double)result->radio_commands / result->succeeded : 0.0);
+
+    if (mode == BENCH_MODE_GATEWAY) {
+        const rdt3_0_gw_stats_t *gw = &gateway.stats;
+        uint32_t duplicates = 0;
+
+        for (int k = 0; k < RDT3_0_GW_MAX_NODES; k++) duplicates += gateway.sessions[k].duplicates;
+
+        fprintf(report, "Gateway:\t\t%u CRC errors, %u duplicates acknowledged, %u queue overflows\n", gw->crc_errors, duplicates,
+            gw->queue_overflows);
+        fprintf(report, "ACK scheduling:\t\t%u deferred for a frame in progress, %u sent over one, %u expired\n", gw->acks_deferred,
+            gw->acks_preempting, gw->acks_expired);
+        fprintf(report, "Below SNR floor:\t%u frames lost\n", downlink->below_floor);
+        fprintf(report, "\nLink quality over each node's last %d packets (margin above the SF%d floor; fastest SF leaving %d dB):\n",
+            RDT3_0_GW_LINK_WINDOW, prototyping_mod_params.sf, RDT3_0_GW_LINK_MARGIN_DB);
+
+        for (uint32_t k = 0; k < qty_nodes; k++) {
+            rdt3_0_gw_link_stats_t link;
+            uint16_t node_id = host_world->nodes[k].id;
+
+            if (!rdt3_0_gateway_link_stats(&gateway, node_id, &link)) {
+                fprintf(report, "  Node %u:\tnot heard\n", node_id);
+                continue;
+            }
+
+            fprintf(report, "  Node %u:\tRSSI %d..%d dBm (mean %.1f), SNR %d..%d dB (mean %.1f), margin %.1f dB, fastest SF%d\n", node_id,
+                link.rssi_min_dbm, link.rssi_max_dbm, link.rssi_mean_db_x10 / 10.0, link.snr_min_db, link.snr_max_db,
+                link.snr_mean_db_x10 / 10.0, link.margin_db_x10 / 10.0, link.fastest_sf);
+        }
+    }
+}
+
+static void print_usage(const char *argv0) {
+    printf("Usage: %s [--mode tx|rx|gateway] [--nodes N] [--window] [--packets N] [--interval MS] [--loss P] [--corrupt P] [--latency US] [--jitter US]\n", argv0);
+    printf("          [--snr DB] [--fading DB] [--path-loss DB] [--turnaround US] [--rx-delay US] [--seed N] [--hang-limit SECONDS] [--verbose]\n\n");
+    printf("  --mode tx|rx|gateway  Benchmark rdt3_0_transmit (default), rdt3_0_receive, or the gateway service\n");
+    printf("  --nodes N             Nodes sending to the firmware at once, up to %d (rx and gateway; default %d for gateway)\n", HOST_SIM_MAX_NODES,
+        BENCH_DEFAULT_GATEWAY_NODES);
+    printf("  --window              Send all packets as one backlog with rdt3_0_transmit_window (tx only)\n");
+    printf("  --packets N           Number of RDT operations, or packets per node (default %d)\n", BENCH_DEFAULT_PACKETS);
+    printf("  --interval MS         Gap between packets (default %d)\n", BENCH_DEFAULT_INTERVAL_MS);
+    printf("  --loss P              Probability a LoRa frame is lost, each direction (default 0)\n");
+    printf("  --corrupt P           Probability a LoRa frame arrives damaged, each direction (default 0)\n");
+    printf("  --latency US          Fixed delay added to every LoRa frame (default 0)\n");
+    printf("  --jitter US           Uniformly distributed extra delay (default 0)\n");
+    printf("  --snr DB              SNR of every LoRa frame before path loss and fading (default %d)\n", link_cfg.snr_db);
+    printf("  --fading DB           Frame-to-frame variation of RSSI and SNR, either way (default 0)\n");
+    printf("  --path-loss DB        Extra loss of the furthest node, the others spread evenly down to 0 (gateway; default 0)\n");
+    printf("  --turnaround US       Gateway delay from RX done to ACK on the air (default %d)\n", SIM_LORA_PEER_DEFAULT_TURNAROUND_US);
+    printf("  --rx-delay US         Node delay from TX done to listening for the ACK (default 0)\n");
+    printf("  --seed N              Seed of the link impairments (default %d)\n", HOST_CHANNEL_SEED);
+    printf("  --hang-limit SECONDS  Wall-clock time after which the benchmark is abandoned (default %d)\n", BENCH_DEFAULT_HANG_LIMIT_S);
+    printf("  --verbose             Show the firmware's console output\n");
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+int main(int argc, char **argv) {
+
+    for (int k = 1; k < argc; k++) {
+        if ((strcmp(argv[k], "--mode") == 0) && (k + 1 < argc)) {
+            k++;
+            mode = (strcmp(argv[k], "rx") == 0) ? BENCH_MODE_RX : (strcmp(argv[k], "gateway") == 0) ? BENCH_MODE_GATEWAY : BENCH_MODE_TX;
+        }
+        else if (strcmp(argv[k], "--window") == 0) {
+            windowed = true;
+        }
+        else if ((strcmp(argv[k], "--packets") == 0) && (k + 1 < argc)) {
+            packets = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--nodes") == 0) && (k + 1 < argc)) {
+            qty_nodes = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--interval") == 0) && (k + 1 < argc)) {
+            interval_ms = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--loss") == 0) && (k + 1 < argc)) {
+            link_cfg.loss_prob = strtod(argv[++k], NULL);
+        }
+        else if ((strcmp(argv[k], "--corrupt") == 0) && (k + 1 < argc)) {
+            link_cfg.corrupt_prob = strtod(argv[++k], NULL);
+        }
+        else if ((strcmp(argv[k], "--latency") == 0) && (k + 1 < argc)) {
+            link_cfg.latency_us = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--jitter") == 0) && (k + 1 < argc)) {
+            link_cfg.jitter_us = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--snr") == 0) && (k + 1 < argc)) {
+            link_cfg.snr_db = (int8_t)strtol(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--fading") == 0) && (k + 1 < argc)) {
+            link_cfg.fading_db = (uint8_t)strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--path-loss") == 0) && (k + 1 < argc)) {
+            path_loss_db = (uint8_t)strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--turnaround") == 0) && (k + 1 < argc)) {
+            turnaround_us = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--rx-delay") == 0) && (k + 1 < argc)) {
+            rx_delay_us = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--seed") == 0) && (k + 1 < argc)) {
+            channel_seed = strtoull(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--hang-limit") == 0) && (k + 1 < argc)) {
+            hang_limit_s = strtoul(argv[++k], NULL, 10);
+        }
+        else if (strcmp(argv[k], "--verbose") == 0) {
+            verbose = true;
+        }
+        else {
+            print_usage(argv[0]);
+            return (strcmp(argv[k], "--help") == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if ((mode == BENCH_MODE_GATEWAY) && (qty_nodes == 0)) qty_nodes = BENCH_DEFAULT_GATEWAY_NODES;
+
+    if ((windowed && (mode != BENCH_MODE_TX)) || ((qty_nodes > 0) && (mode == BENCH_MODE_TX)) || (qty_nodes > HOST_SIM_MAX_NODES)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    if (!verbose && (freopen("/dev/null", "w", stdout) == NULL)) return EXIT_FAILURE;
+
+    // Build the board and bring the MCU out of reset, with the gateway on the firmware's own LoRa settings.
+    host_board_build_world();
+
+    sim_lora_channel_init(&host_world->channel, channel_seed);
+    host_world->channel.link[SIM_LORA_DIR_UPLINK] = link_cfg;
+    host_world->channel.link[SIM_LORA_DIR_DOWNLINK] = link_cfg;
+
+    // LDRO follows from the symbol time on both ends of the link.
+    set_lora_ldro_val(&prototyping_mod_params);
+    host_board_configure_gateway(&prototyping_mod_params, &prototyping_pkt_params, LWQMS_SYNC_WORD);
+    host_world->peer.turnaround_us = turnaround_us;
+    bench_phy_setup.ack_rx_delay_us = rx_delay_us;
+
+    host_board_reset_mcu(HOST_BOOT_POWER_ON);
+    host_world->boot_time_us = host_world->now_us;
+    host_world->mcu_running = true;
+
+    signal(SIGALRM, on_hang_limit);
+    alarm(hang_limit_s);
+
+    stdio_init_all();
+
+    lwqms_post_err_codes_t post_result = power_on_self_test();
+    if (post_result != POST_OK) {
+        fprintf(report, "POST failed with code %d\n", post_result);
+        return EXIT_FAILURE;
+    }
+
+    bench_result_t result = {0};
+    run_benchmark(&result);
+
+    if (qty_nodes > 0) {
+        print_contention_report(&result);
+    }
+    else {
+        print_report(&result);
+    }
+    free(result.latency_us);
+
+    return EXIT_SUCCESS;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
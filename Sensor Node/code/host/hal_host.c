@@ -0,0 +1,760 @@
+/********************************************************************************************************************
+*
+*   @file hal_host.c
+*
+*   @brief Host build implementation of the Hardware Abstraction Layer. Stands in for lib/hal.c, routing every pin,
+*          bus transaction and power management request to the simulated board instead of the RP2350 peripherals.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "hal.h"
+#include "host_sim.h"
+
+#include <unistd.h>
+#include <sys/select.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+// Bit positions of the power domains in a powman_power_state, as on the RP2350.
+#define HOST_POWMAN_DOMAIN_SRAM_BANK1 0
+#define HOST_POWMAN_DOMAIN_SRAM_BANK0 1
+#define HOST_POWMAN_DOMAIN_XIP_CACHE 2
+#define HOST_POWMAN_DOMAIN_SWITCHED_CORE 3
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+bool host_console_attached = false;
+
+// Per-boot MCU state. Each boot cycle runs in a fresh process, so these start cleared just like the RP2350's registers.
+static bool gpio_level[HOST_SIM_QTY_GPIO];
+static bool gpio_is_output[HOST_SIM_QTY_GPIO];
+static uint32_t gpio_irq_mask[HOST_SIM_QTY_GPIO];
+
+static uint32_t spi_baud[2];
+
+// The simulated DMA moves the bytes at the start of a transfer and reports completion once its bus time has passed.
+static uint64_t spi_dma_done_us[2];
+static uint32_t spi_dma_len[2];
+static uint32_t i2c_baud[2];
+
+// Fractional bus time carried between transactions so that short transfers still add up correctly.
+static uint64_t bus_time_remainder_ps = 0;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Board Wiring
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Board Wiring
+
+static uint64_t bus_time_us(uint64_t bits, uint32_t baud) {
+    if (baud == 0) return 0;
+
+    uint64_t ps = (bits * 1000000000000ULL) / baud + bus_time_remainder_ps;
+
+    bus_time_remainder_ps = ps % 1000000;
+
+    return ps / 1000000;
+}
+
+static void charge_bus_time(uint64_t bits, uint32_t baud) {
+    host_sim_advance_us(bus_time_us(bits, baud));
+}
+
+static void drive_board_output(uint8_t pin, bool level) {
+    if (pin == context_radio_0.cs) {
+        sim_sx1262_set_nss(&host_world->radio, level);
+    }
+    else if (pin == context_radio_0.rst) {
+        sim_sx1262_set_nreset(&host_world->radio, level);
+    }
+    else if (pin == context_flash_0.cs) {
+        sim_mx25l3233f_set_cs(&host_world->flash, level);
+    }
+    else if (pin == EN_5V) {
+        host_board_set_5v_rail(level);
+    }
+    else if ((pin == context_mux_0.enable) || (pin == context_mux_0.sel0) || (pin == context_mux_0.sel1)) {
+        sim_afe_set_mux(&host_world->afe, gpio_level[context_mux_0.enable], gpio_level[context_mux_0.sel0], gpio_level[context_mux_0.sel1]);
+    }
+}
+
+void host_board_set_5v_rail(bool on) {
+    if (host_world->rail_5v_on == on) return;
+
+    host_world->rail_5v_on = on;
+    sim_afe_set_power(&host_world->afe, on);
+}
+
+void host_gpio_drive_input(uint8_t pin, bool level) {
+    if (pin >= HOST_SIM_QTY_GPIO) return;
+
+    // Peripherals only call in on a change of level, so every call is an edge.
+    gpio_level[pin] = level;
+
+    uint32_t edge = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+
+    // A dormant MCU only watches its armed wakeup pin.
+    if ((host_world->wake_pin == pin) && ((host_world->wake_source_mask & edge) > 0)) {
+        host_world->wake_pin_triggered = true;
+    }
+
+    if ((gpio_irq_mask[pin] & edge) > 0) {
+        isr_gpio_master(pin, edge);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region GPIO
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// GPIO Functions
+
+void gpio_setup_hal(const uint8_t pin, bool IsOutput) {
+    if (pin >= HOST_SIM_QTY_GPIO) return;
+
+    gpio_is_output[pin] = IsOutput;
+
+    if (IsOutput) gpio_write_hal(pin, GPIO_LOW);
+
+    return;
+}
+
+void gpio_set_pull_resistor_hal(const uint8_t pin, bool IsPullUp) {
+    if (pin >= HOST_SIM_QTY_GPIO) return;
+
+    // Pulls only matter on undriven inputs.
+    if (!gpio_is_output[pin] && (pin != context_radio_0.busy) && (pin != context_radio_0.irq_context->pin)) {
+        gpio_level[pin] = IsPullUp;
+    }
+
+    return;
+}
+
+void gpio_terminate_hal(const uint8_t pin) {
+    if (pin >= HOST_SIM_QTY_GPIO) return;
+
+    gpio_is_output[pin] = false;
+    gpio_irq_mask[pin] = 0;
+
+    return;
+}
+
+void gpio_write_hal(const uint8_t pin, bool state) {
+    if (pin >= HOST_SIM_QTY_GPIO) return;
+
+    gpio_level[pin] = state;
+
+    drive_board_output(pin, state);
+}
+
+bool gpio_read_hal(const uint8_t pin) {
+    if (pin == context_radio_0.busy) return sim_sx1262_get_busy(&host_world->radio);
+
+    if (pin == context_radio_0.irq_context->pin) return sim_sx1262_get_dio1(&host_world->radio);
+
+    return (pin < HOST_SIM_QTY_GPIO) ? gpio_level[pin] : false;
+}
+
+bool gpio_toggle_hal(const uint8_t pin) {
+
+    bool current_pin_state = gpio_read_hal(pin);
+
+    gpio_write_hal(pin, !current_pin_state);
+
+    return !current_pin_state;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region SPI
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// SPI
+
+uint spi_init_hal(const void* spi_context) {
+
+    const spi_context_t* setup = (const spi_context_t *)spi_context;
+
+    spi_baud[setup->inst->index] = setup->baud;
+
+    return setup->baud;
+}
+
+void spi_terminate_hal(const void* spi_context) {
+
+    const spi_context_t* setup = (const spi_context_t *)spi_context;
+
+    spi_baud[setup->inst->index] = 0;
+
+    return;
+}
+
+void spi_reset_hal(const void* spi_context) {
+    // The simulated SPI block holds no state worth resetting.
+    (void)spi_context;
+}
+
+static void spi_exchange_bytes(const uint8_t *txData, uint8_t *rxData, int len) {
+
+    for (int k = 0; k < len; k++) {
+        uint8_t mosi = (txData != NULL) ? txData[k] : 0x00;
+        uint8_t miso = 0x00;
+
+        // Whichever device has its chip select asserted drives MISO.
+        if (!host_world->radio.nss) {
+            miso = sim_sx1262_spi_byte(&host_world->radio, mosi);
+        }
+        else if (!host_world->flash.cs) {
+            miso = sim_mx25l3233f_spi_byte(&host_world->flash, mosi);
+        }
+
+        if (rxData != NULL) rxData[k] = miso;
+    }
+
+    host_world->stats.spi_bytes += len;
+    host_world->stats.spi_transactions++;
+}
+
+static uint spi_transfer(const spi_context_t *cxt, const uint8_t *txData, uint8_t *rxData, int len) {
+
+    if ((len <= 0) || (spi_baud[cxt->inst->index] == 0)) return 0;
+
+    spi_exchange_bytes(txData, rxData, len);
+
+    charge_bus_time((uint64_t)len * cxt->xfer_bits, spi_baud[cxt->inst->index]);
+
+    return len;
+}
+
+uint spi_write_hal(const void* spi_context, uint8_t * data, int len) {
+
+    return spi_transfer((const spi_context_t *)spi_context, data, NULL, len);
+
+}
+
+uint spi_read_hal(const void* spi_context, uint8_t * buf, int len) {
+
+    return spi_transfer((const spi_context_t *)spi_context, NULL, buf, len);
+
+}
+
+uint spi_rw_hal(const void* spi_context, uint8_t *txData, uint8_t *rxData, int len) {
+
+    return spi_transfer((const spi_context_t *)spi_context, txData, rxData, len);
+
+}
+
+bool spi_dma_start_hal(const void *spi_context, const uint8_t *txData, uint8_t *rxData, int len) {
+
+    const spi_context_t *cxt = (const spi_context_t *)spi_context;
+    uint8_t idx = cxt->inst->index;
+
+    if ((len <= 0) || (spi_baud[idx] == 0) || !spi_dma_is_done_hal(spi_context)) return false;
+
+    spi_exchange_bytes(txData, rxData, len);
+
+    spi_dma_len[idx] = len;
+    spi_dma_done_us[idx] = host_sim_now_us() + bus_time_us((uint64_t)len * cxt->xfer_bits, spi_baud[idx]);
+
+    return true;
+}
+
+bool spi_dma_is_done_hal(const void *spi_context) {
+
+    return host_sim_now_us() >= spi_dma_done_us[((const spi_context_t *)spi_context)->inst->index];
+}
+
+uint spi_dma_wait_hal(const void *spi_context) {
+
+    uint8_t idx = ((const spi_context_t *)spi_context)->inst->index;
+
+    // The completion interrupt is the only event that matters; earlier wake-ups go back to sleep.
+    while (!sleep_until_event_hal(spi_dma_done_us[idx])) {}
+
+    return spi_dma_len[idx];
+}
+
+uint spi_rw_dma_hal(const void *spi_context, const uint8_t *txData, uint8_t *rxData, int len) {
+
+    if ((len >= SPI_DMA_MIN_XFER_LEN) && spi_dma_start_hal(spi_context, txData, rxData, len)) {
+        return spi_dma_wait_hal(spi_context);
+    }
+
+    return spi_transfer((const spi_context_t *)spi_context, txData, rxData, len);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region I2C
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// I2C
+
+uint i2c_init_hal(const void* i2c_context) {
+
+    const i2c_context_t *setup = (const i2c_context_t*)i2c_context;
+
+    i2c_baud[setup->inst->index] = setup->baud;
+
+    return setup->baud;
+}
+
+void i2c_terminate_hal(const void* i2c_context) {
+
+    const i2c_context_t *setup = (const i2c_context_t*)i2c_context;
+
+    i2c_baud[setup->inst->index] = 0;
+
+    return;
+}
+
+static int i2c_transfer(const i2c_context_t *setup, uint8_t address, const uint8_t *txData, uint8_t *rxData, uint len) {
+
+    if (i2c_baud[setup->inst->index] == 0) return PICO_ERROR_GENERIC;
+
+    int retval = PICO_ERROR_GENERIC;
+
+    // Only I2C1 has devices on it.
+    if (setup->inst == context_i2c_1.inst) {
+        retval = (txData != NULL) ? sim_afe_i2c_write(&host_world->afe, address, txData, len) : sim_afe_i2c_read(&host_world->afe, address, rxData, len);
+    }
+
+    host_world->stats.i2c_transactions++;
+
+    if (retval < 0) {
+        // The transfer stops after the address byte is not acknowledged.
+        host_world->stats.i2c_naks++;
+        charge_bus_time(9, i2c_baud[setup->inst->index]);
+        return PICO_ERROR_GENERIC;
+    }
+
+    host_world->stats.i2c_bytes += len;
+    charge_bus_time((uint64_t)(len + 1) * 9, i2c_baud[setup->inst->index]);
+
+    return retval;
+}
+
+int i2c_write_hal(const void* i2c_context, uint8_t address, const uint8_t* txData, uint len) {
+
+    return i2c_transfer((const i2c_context_t*)i2c_context, address, txData, NULL, len);
+
+}
+
+int i2c_read_hal(const void* i2c_context, uint8_t address, uint8_t* rxData, uint len) {
+
+    return i2c_transfer((const i2c_context_t*)i2c_context, address, NULL, rxData, len);
+
+}
+
+int i2c_write_then_read_hal(const void* i2c_context, uint8_t address, uint8_t *txData, uint8_t *rxData, uint txLen, uint rxLen) {
+
+    bool i2c_ok = false;
+
+    int bytes_written = 0, bytes_read = 0;
+
+    do {
+        bytes_written = i2c_write_hal(i2c_context, address, txData, txLen);
+        if (bytes_written < 0) break;
+
+        bytes_read = i2c_read_hal(i2c_context, address, rxData, rxLen);
+        if (bytes_read < 0) break;
+
+        i2c_ok = true;
+    } while (0);
+
+    if (!i2c_ok) {
+        err_raise(ERR_I2C_TRANSACTION_FAIL, ERR_SEV_NONFATAL, "I2C Transaction Failure", "i2c_write_then_read");
+    }
+
+    return bytes_written < 0 ? bytes_written : bytes_read;
+}
+
+static bool reserved_i2c_addr(uint8_t addr) {
+    return (addr & 0x78) == 0 || (addr & 0x78) == 0x78;
+}
+
+void i2c_scan_hal(const i2c_context_t* i2c_context) {
+    printf("\nI2C Bus Scan\n");
+    printf("   0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F\n");
+
+    for (int addr = 0; addr < (1 << 7); ++addr) {
+        if (addr % 16 == 0) {
+            printf("%02x ", addr);
+        }
+
+        int ret;
+        uint8_t rxdata;
+        if (reserved_i2c_addr(addr))
+            ret = PICO_ERROR_GENERIC;
+        else
+            ret = i2c_read_hal(i2c_context, addr, &rxdata, 1);
+
+        printf(ret < 0 ? "." : "@");
+        printf(addr % 16 == 15 ? "\n" : "  ");
+    }
+    printf("Done.\n");
+    return;
+}
+
+int i2c_get_available_addresses_hal(const i2c_context_t* i2c_context, uint8_t* addressesBuf, uint8_t addressBufSize, uint8_t *addressesFound) {
+
+    int address_idx = 0;
+
+    for (int addr = 0; addr < (1 << 7); ++addr) {
+        int ret;
+        uint8_t rxdata;
+        if (reserved_i2c_addr(addr))
+            ret = PICO_ERROR_GENERIC;
+        else
+            ret = i2c_read_hal(i2c_context, addr, &rxdata, 1);
+
+        if (ret > -1) {
+            addressesBuf[address_idx] = addr;
+            address_idx++;
+            *addressesFound = address_idx;
+
+            // Ensure we are writing to valid memory
+            if (address_idx > (addressBufSize - 1)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Watchdog
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Watchdog & Reboot
+
+void reboot(void) {
+    #ifdef DEBUG
+    printf("Rebooting...\n");
+    #endif
+
+    host_sim_end_boot_cycle(HOST_EXIT_REBOOT);
+}
+
+bool check_if_rebooted_or_clean_boot(void) {
+    return host_world->boot_reason == HOST_BOOT_WATCHDOG;
+}
+
+bool watchdog_init_hal(uint32_t timeout_ms) {
+    if (timeout_ms > WATCHDOG_MAX_DELAY_MS) {
+        return false;
+    }
+    else {
+        host_world->watchdog_enabled = true;
+        host_world->watchdog_timeout_us = timeout_ms * 1000;
+        host_world->watchdog_deadline_us = host_sim_now_us() + host_world->watchdog_timeout_us;
+        return true;
+    }
+}
+
+void watchdog_feed_hal() {
+    host_world->watchdog_deadline_us = host_sim_now_us() + host_world->watchdog_timeout_us;
+}
+
+void watchdog_deinit_hal() {
+    host_world->watchdog_enabled = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Interrupts
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Interrupts
+
+void gpio_irq_attach_hal(const void *irq_context) {
+
+    const gpio_driven_irq_context_t * context = (const gpio_driven_irq_context_t *)irq_context;
+
+    register_gpio_isr((gpio_driven_irq_context_t *)context);
+
+    if (context->pin < HOST_SIM_QTY_GPIO) gpio_irq_mask[context->pin] |= context->source_mask;
+
+}
+
+void gpio_irq_detach_hal(const void *irq_context) {
+
+    const gpio_driven_irq_context_t * context = (const gpio_driven_irq_context_t *)irq_context;
+
+    unregister_gpio_isr((gpio_driven_irq_context_t *)context);
+
+    if (context->pin < HOST_SIM_QTY_GPIO) gpio_irq_mask[context->pin] &= ~context->source_mask;
+
+}
+
+void gpio_irq_ack_hal(const void *irq_context) {
+    // Edge events are delivered once by host_gpio_drive_input(), so there is nothing latched to clear.
+    (void)irq_context;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region USB Console
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// USB Console
+
+static bool console_input_ready(void) {
+    fd_set fds;
+    struct timeval no_wait = {0, 0};
+
+    FD_ZERO(&fds);
+    FD_SET(STDIN_FILENO, &fds);
+
+    return select(STDIN_FILENO + 1, &fds, NULL, NULL, &no_wait) > 0;
+}
+
+static int console_read_char(void) {
+    fflush(stdout);
+
+    int c = getchar();
+
+    if (c == EOF) host_sim_end_boot_cycle(HOST_EXIT_CONSOLE_EOF);
+
+    return c;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    if (host_console_attached && console_input_ready()) {
+        return console_read_char();
+    }
+
+    host_sim_advance_us(timeout_us);
+    return PICO_ERROR_TIMEOUT;
+}
+
+void init_usb_console_hal(void) {
+    stdio_init_all();
+}
+
+void deinit_usb_console_hal(void) {
+    stdio_deinit_all();
+}
+
+bool is_usb_console_connected_hal(void) {
+    return host_console_attached;
+}
+
+bool is_usb_console_available_hal(void) {
+    return host_console_attached && console_input_ready();
+}
+
+bool wait_for_usb_console_connection_hal(void) {
+    // A host with no console would wait forever.
+    if (!host_console_attached) host_sim_end_boot_cycle(HOST_EXIT_CONSOLE_EOF);
+
+    return true;
+}
+
+bool wait_for_usb_console_connection_with_timeout_hal(uint32_t timeout_ms) {
+
+    if (!host_console_attached) {
+        sleep_ms(timeout_ms);
+        return false;
+    }
+
+    return true;
+}
+
+char usb_console_getchar_hal(void) {
+    if (!host_console_attached) host_sim_end_boot_cycle(HOST_EXIT_CONSOLE_EOF);
+
+    return console_read_char();
+}
+
+int usb_console_putchar_hal(char c) {
+    return putchar(c);
+}
+
+char usb_console_getchar_timeout_us_hal(uint32_t timeout_microseconds) {
+    return getchar_timeout_us(timeout_microseconds);
+}
+
+int usb_console_write_hal(char * buf) {
+    return printf("%s", buf);
+}
+
+int usb_console_write_bytes_hal(const uint8_t * buf, size_t len) {
+    return fwrite(buf, 1, len, stdout);
+}
+
+int get_user_input_hal(char * buf, uint buflen) {
+
+    char * ptr;
+
+    for (ptr = buf; (ptr - buf) < (buflen - 1); ptr++) {
+        *ptr = usb_console_getchar_hal();
+
+        usb_console_putchar_hal(*ptr);
+
+        if (*ptr == '\r' || *ptr == '\n') {
+            printf("\n");
+            break;
+        }
+    }
+
+    // Guarantee null termination
+    *ptr = 0x00;
+
+    // Return the number of characters read.
+    return ptr - buf;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Power Management
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Power Management
+
+bool power_mgmt_init_hal(void *power_mgmt_context_dormant, void *power_mgmt_context_active, void *processed_power_context_buf) {
+
+    rp2350_power_mgmt_setting_t *off_state = (rp2350_power_mgmt_setting_t *)power_mgmt_context_dormant;
+    rp2350_power_mgmt_setting_t *on_state = (rp2350_power_mgmt_setting_t *)power_mgmt_context_active;
+
+    // Same domain order as the as_arr[] overlay
+    const uint8_t domains[] = {
+        HOST_POWMAN_DOMAIN_SWITCHED_CORE,
+        HOST_POWMAN_DOMAIN_XIP_CACHE,
+        HOST_POWMAN_DOMAIN_SRAM_BANK0,
+        HOST_POWMAN_DOMAIN_SRAM_BANK1
+    };
+
+    powman_power_state dormant_state = POWMAN_POWER_STATE_NONE;
+    powman_power_state active_state = POWMAN_POWER_STATE_NONE;
+
+    for (int k = 0; k < sizeof(domains); ++k) {
+        // The SRAM domains are brought up by the warm start, as on the RP2350.
+        if ((domains[k] == HOST_POWMAN_DOMAIN_SRAM_BANK0) || (domains[k] == HOST_POWMAN_DOMAIN_SRAM_BANK1)) continue;
+
+        dormant_state |= off_state->as_arr[k] ? (1u << domains[k]) : 0;
+        active_state |= on_state->as_arr[k] ? (1u << domains[k]) : 0;
+    }
+
+    ((rp2350_power_state_context_t *)processed_power_context_buf)->dormant_power_state = dormant_state;
+    ((rp2350_power_state_context_t *)processed_power_context_buf)->active_power_state = active_state;
+
+    return true;
+}
+
+int power_mgmt_go_dormant_hal(void *power_context) {
+
+    rp2350_power_state_context_t *power_states = (rp2350_power_state_context_t *)power_context;
+
+    // Dormant must actually switch the core off, and the active state must bring it back.
+    if ((power_states->dormant_power_state & (1u << HOST_POWMAN_DOMAIN_SWITCHED_CORE)) > 0) return PICO_ERROR_INVALID_STATE;
+    if ((power_states->active_power_state & (1u << HOST_POWMAN_DOMAIN_SWITCHED_CORE)) == 0) return PICO_ERROR_INVALID_STATE;
+
+    printf("Powering off...\n");
+    stdio_flush();
+    stdio_deinit_all();
+    watchdog_deinit_hal();  // back to the kennel
+
+    host_sim_end_boot_cycle(HOST_EXIT_DORMANT);
+
+    return PICO_ERROR_GENERIC;
+}
+
+int power_mgmt_go_dormant_for_time_ms_hal(void *power_context, uint64_t duration_ms) {
+    host_world->wake_alarm_us = host_sim_now_us() + (duration_ms * 1000);
+    return power_mgmt_go_dormant_hal(power_context);
+}
+
+int power_mgmt_go_dormant_until_irq_hal(void *power_context, gpio_driven_irq_context_t *trigger) {
+    host_world->wake_pin = trigger->pin;
+    host_world->wake_source_mask = trigger->source_mask;
+    host_world->wake_pin_triggered = false;
+    return power_mgmt_go_dormant_hal(power_context);
+}
+
+int power_mgmt_write_novo_memory_hal(uint32_t *data, size_t len) {
+    if (len > MCU_POWMAN_NOVO_ELEMENTS) return -1;
+
+    for (int k = 0; k < len; ++k) {
+        host_world->novo[k] = data[k];
+    }
+
+    return 0;
+}
+
+int power_mgmt_read_novo_memory_hal(uint32_t *data, size_t buf_len) {
+    if (buf_len < MCU_POWMAN_NOVO_ELEMENTS) return -1;
+
+    for (int k = 0; k < MCU_POWMAN_NOVO_ELEMENTS; ++k) {
+        data[k] = host_world->novo[k];
+    }
+
+    return 0;
+}
+
+bool sleep_until_event_hal(absolute_time_t wake_time) {
+    return best_effort_wfe_or_timeout(wake_time);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Random Numbers
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Random Numbers
+
+uint32_t random_u32_hal(void) {
+    return get_rand_32();
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Multicore
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Multicore
+
+bool launch_core1_hal(void (*entry)(void)) {
+    // The simulated MCU has one core; callers fall back to running everything on it.
+    (void)entry;
+    return false;
+}
+
+void signal_event_hal(void) {
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,70 @@
+/********************************************************************************************************************
+*
+*   @file host_board.h
+*
+*   @brief Assembly of the simulated sensor node board for the host-native build: the shared world state, the flash
+*          contents of a provisioned and bench-calibrated node, the gateway at the far end of the LoRa link, and the
+*          state the board is left in by an MCU reset.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_BOARD_H
+#define HOST_BOARD_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include "host_sim.h"
+#include "sx126x.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+// Provisioned node configuration
+#define HOST_NODE_ID 1
+#define HOST_GATEWAY_ID 2
+#define HOST_NODE_LATITUDE 40.2732
+#define HOST_NODE_LONGITUDE -76.8867
+#define HOST_SYNC_WORD 0x42
+
+#define HOST_RF_FREQ_HZ 915000000
+#define HOST_CHANNEL_SEED 1
+#define HOST_RAND_SEED 0x5EED5EED5EED5EEDull
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Maps the world state into shared memory, powers up the peripherals, provisions the flash, and places a gateway
+ *        in responder mode at the far end of the link.
+ */
+void host_board_build_world(void);
+
+/**
+ * @brief Sets up the gateway's radio to match the given LoRa parameters, as a gateway on the same network would be.
+ */
+void host_board_configure_gateway(const sx126x_mod_params_lora_t *mod, const sx126x_pkt_params_lora_t *pkt, uint8_t sync_word);
+
+/**
+ * @brief Puts the board in the state the RP2350 leaves it in after a reset: every GPIO is an undriven input.
+ */
+void host_board_reset_mcu(host_boot_reason_t reason);
+
+/**
+ * @brief Returns the energy drawn by the MCU and the radio since the world was built, in microjoules
+ */
+double host_board_energy_uj(void);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* HOST_BOARD_H */
+
+/* --- EOF ------------------------------------------------------------------ */
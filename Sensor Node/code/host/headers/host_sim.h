@@ -0,0 +1,225 @@
+/********************************************************************************************************************
+*
+*   @file host_sim.h
+*
+*   @brief Core of the host-native simulation of the LoRa Water Quality Management System Sensor Node. Provides the
+*          virtual clock, the device event queue, the persistent "world" state which survives MCU resets, and the
+*          controls used to end a boot cycle (dormant, reboot, watchdog).
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sim_sx1262.h"
+#include "sim_mx25l3233f.h"
+#include "sim_analog_frontend.h"
+#include "sim_lora_channel.h"
+#include "sim_lora_peer.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define HOST_SIM_MAX_EVENTS 64
+
+// Other sensor nodes sharing the channel, for gateway benchmarks
+#define HOST_SIM_MAX_NODES 16
+
+#define HOST_SIM_NOVO_ELEMENTS 8
+
+#define HOST_SIM_QTY_GPIO 30
+
+// Virtual CPU time charged for each call to get_absolute_time(), so that busy-wait loops make progress.
+#define HOST_SIM_POLL_TICK_US 2
+
+// RP2350 supply current while running (not dormant), and while its cores wait in WFE/WFI, for the energy figures
+#define HOST_SIM_MCU_ACTIVE_MA 20.0
+#define HOST_SIM_MCU_SLEEP_MA 8.0
+#define HOST_SIM_MCU_SUPPLY_V 3.3
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Enums
+
+/**
+ * @brief The reason a boot cycle of the simulated MCU came to an end. Used as the exit code of the boot cycle process.
+ */
+typedef enum host_exit_reason_e {
+    HOST_EXIT_NONE = 0,
+    HOST_EXIT_DORMANT = 10,     // Power manager took the MCU dormant; it will cold boot on the wake alarm
+    HOST_EXIT_REBOOT = 11,      // Software requested a reboot through the watchdog
+    HOST_EXIT_WATCHDOG = 12,    // Watchdog expired without being fed
+    HOST_EXIT_HANG = 13,        // The firmware stopped making progress (e.g. a FATAL error loop)
+    HOST_EXIT_CONSOLE_EOF = 14, // The simulated USB console ran out of input
+    HOST_EXIT_CRASH = 15,       // The boot cycle process died on a signal
+} host_exit_reason_t;
+
+/**
+ * @brief The boot reason the firmware can observe after a reset
+ */
+typedef enum host_boot_reason_e {
+    HOST_BOOT_POWER_ON = 0,
+    HOST_BOOT_DORMANT_WAKE = 1,
+    HOST_BOOT_WATCHDOG = 2,
+} host_boot_reason_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef void (*host_sim_event_cb_t)(void *arg);
+
+typedef struct host_sim_event_s {
+    bool pending;
+    uint64_t due_us;
+    uint32_t seq;               // Tie-breaker so events due at the same time fire in scheduling order
+    host_sim_event_cb_t callback;
+    void *arg;
+} host_sim_event_t;
+
+typedef struct host_sim_stats_s {
+    uint32_t boots;
+    uint32_t exits[16];             // Indexed by host_exit_reason_t - HOST_EXIT_DORMANT
+    uint64_t spi_bytes;
+    uint64_t spi_transactions;
+    uint64_t i2c_bytes;
+    uint64_t i2c_transactions;
+    uint64_t i2c_naks;
+    uint64_t mcu_active_us;         // Time the MCU spent powered (not dormant) in finished boot cycles
+    uint64_t mcu_sleep_us;          // Part of the powered time spent waiting for an event or timer with the core asleep
+} host_sim_stats_t;
+
+/**
+ * @brief Everything that outlives an MCU reset. The structure lives in shared memory so that each boot cycle can run in a
+ *        freshly forked process (giving the firmware truly reset RAM) while the peripherals and the clock carry on.
+ */
+typedef struct host_world_s {
+    // Virtual time
+    uint64_t now_us;
+    uint64_t boot_time_us;
+    bool mcu_running;               // Between the start and the end of a boot cycle
+    uint32_t event_seq;
+    host_sim_event_t events[HOST_SIM_MAX_EVENTS];
+    uint64_t next_due_us;           // Due time of the earliest pending event, so polling loops skip the queue scan
+
+    // Power manager
+    uint32_t novo[HOST_SIM_NOVO_ELEMENTS];
+    host_boot_reason_t boot_reason;
+    uint64_t wake_alarm_us;         // UINT64_MAX when no alarm is armed
+    int wake_pin;                   // GPIO armed as a wakeup source, or -1
+    uint32_t wake_source_mask;
+    bool wake_pin_triggered;
+
+    // Watchdog
+    bool watchdog_enabled;
+    uint64_t watchdog_deadline_us;
+    uint32_t watchdog_timeout_us;
+
+    // Board state
+    bool rail_5v_on;
+    uint64_t rand_state;            // Generator behind get_rand_32(), standing in for the RP2350's TRNG
+
+    // Peripherals
+    sim_sx1262_t radio;
+    sim_mx25l3233f_t flash;
+    sim_analog_frontend_t afe;
+
+    // The far end of the LoRa link
+    sim_lora_channel_t channel;
+    sim_lora_peer_t peer;
+
+    // Other sensor nodes, modelled as peers that send on the node radio's receive direction
+    sim_lora_peer_t nodes[HOST_SIM_MAX_NODES];
+    uint8_t qty_nodes;
+
+    host_sim_stats_t stats;
+} host_world_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+extern host_world_t *host_world;
+
+// True when the simulated USB console is attached to this process's stdin/stdout.
+extern bool host_console_attached;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Returns the current virtual time without charging any CPU time.
+ */
+uint64_t host_sim_now_us(void);
+
+/**
+ * @brief Advances virtual time, firing any device events that come due along the way, in order.
+ *
+ * @param us Number of microseconds to advance
+ */
+void host_sim_advance_us(uint64_t us);
+
+/**
+ * @brief Advances virtual time to the given absolute time. Does nothing if that time has already passed.
+ */
+void host_sim_advance_to_us(uint64_t t_us);
+
+/**
+ * @brief Schedules a device event at an absolute virtual time.
+ *
+ * @param due_us Absolute time at which the callback fires
+ * @param callback Function to call
+ * @param arg Argument handed to the callback. Must point into the world state to survive a reset.
+ *
+ * @returns Handle of the event, or -1 if the event queue is full.
+ */
+int host_sim_schedule(uint64_t due_us, host_sim_event_cb_t callback, void *arg);
+
+/**
+ * @brief Cancels a pending device event. Negative handles are ignored.
+ */
+void host_sim_cancel(int handle);
+
+/**
+ * @brief Returns the due time of the earliest pending event, or UINT64_MAX if none is pending.
+ */
+uint64_t host_sim_next_event_us(void);
+
+/**
+ * @brief Ends the current boot cycle of the simulated MCU. Does not return.
+ */
+void host_sim_end_boot_cycle(host_exit_reason_t reason);
+
+/**
+ * @brief Signals a level change on a GPIO input driven by a simulated peripheral, raising the MCU's GPIO interrupt if one is armed.
+ */
+void host_gpio_drive_input(uint8_t pin, bool level);
+
+/**
+ * @brief Powers the simulated 5V rail on or off, resetting the peripherals that depend on it.
+ */
+void host_board_set_5v_rail(bool on);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* HOST_SIM_H */
+
+/* --- EOF ------------------------------------------------------------------ */
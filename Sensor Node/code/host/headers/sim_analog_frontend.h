@@ -0,0 +1,143 @@
+/********************************************************************************************************************
+*
+*   @file sim_analog_frontend.h
+*
+*   @brief Model of the sensor node's analog front end for the host-native build: the three MCP4651 digital
+*          potentiometers of the software-defined instrumentation amplifier, the TMUX1309 input multiplexer, the MCP3425
+*          A-D converter and the voltages presented by the turbidity, pH and temperature sensors.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef SIM_ANALOG_FRONTEND_H
+#define SIM_ANALOG_FRONTEND_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define SIM_AFE_QTY_DIGIPOTS 3
+#define SIM_AFE_QTY_INPUTS 4
+
+#define SIM_AFE_DIGIPOT_MAX_WIPER 256
+#define SIM_AFE_DIGIPOT_R_AB 50000.0        // MCP4651-503
+#define SIM_AFE_DIGIPOT_R_W 75.0            // Typical wiper resistance
+#define SIM_AFE_DC_OFFSET_SUPPLY 5.0
+#define SIM_AFE_REFERENCE_CEILING 2.5       // Reference pot top wiper parked at midscale
+#define SIM_AFE_INST_AMP_R0 10000.0
+#define SIM_AFE_SUPPLY 5.0
+
+#define SIM_AFE_ADC_VREF 2.048
+
+// Default sensor outputs, chosen to read as ~13 NTU, pH 7.0 and 18 C through the firmware's sensor curves.
+#define SIM_AFE_DEFAULT_TURBIDITY_V 4.1000
+#define SIM_AFE_DEFAULT_PH_V 2.5103
+#define SIM_AFE_DEFAULT_TEMPERATURE_V 0.1112
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Enums
+
+typedef enum sim_afe_digipot_e {
+    SIM_AFE_DIGIPOT_OFFSET = 0,     // Wiper 0 = DC+ offset, wiper 1 = DC- offset
+    SIM_AFE_DIGIPOT_GAIN = 1,       // Wiper 0 = upper gain rheostat, wiper 1 = lower gain rheostat
+    SIM_AFE_DIGIPOT_REFERENCE = 2,  // Wiper 1 = output reference
+} sim_afe_digipot_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef struct sim_mcp4651_s {
+    uint8_t addr;
+    uint16_t wiper[2];
+    uint16_t tcon;
+    uint8_t last_reg;
+} sim_mcp4651_t;
+
+typedef struct sim_mcp3425_s {
+    uint8_t addr;
+    uint8_t cfg;                // Bits 6:0 of the configuration register
+    int16_t result;
+    uint64_t conversion_done_us;
+    bool conversion_pending;
+    bool new_data;
+    uint32_t conversions;
+} sim_mcp3425_t;
+
+typedef struct sim_tmux1309_s {
+    bool enable_n;
+    bool sel0;
+    bool sel1;
+} sim_tmux1309_t;
+
+typedef struct sim_analog_frontend_s {
+    bool powered;
+    sim_mcp4651_t digipot[SIM_AFE_QTY_DIGIPOTS];
+    sim_mcp3425_t adc;
+    sim_tmux1309_t mux;
+    double input_v[SIM_AFE_QTY_INPUTS];
+} sim_analog_frontend_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Wires the model to the given I2C addresses and loads the default sensor voltages. The rail starts unpowered.
+ */
+void sim_afe_init(sim_analog_frontend_t *afe, const uint8_t digipot_addrs[SIM_AFE_QTY_DIGIPOTS], uint8_t adc_addr);
+
+/**
+ * @brief Powers the 5V-supplied parts on or off. Power-up returns the potentiometers and ADC to their POR state.
+ */
+void sim_afe_set_power(sim_analog_frontend_t *afe, bool on);
+
+/**
+ * @brief Updates the multiplexer control lines.
+ */
+void sim_afe_set_mux(sim_analog_frontend_t *afe, bool enable_n, bool sel0, bool sel1);
+
+/**
+ * @brief Performs an I2C write to the front end.
+ *
+ * @returns Bytes written, or -1 if no device acknowledged the address.
+ */
+int sim_afe_i2c_write(sim_analog_frontend_t *afe, uint8_t addr, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Performs an I2C read from the front end.
+ *
+ * @returns Bytes read, or -1 if no device acknowledged the address.
+ */
+int sim_afe_i2c_read(sim_analog_frontend_t *afe, uint8_t addr, uint8_t *data, uint32_t len);
+
+/**
+ * @brief Returns the voltage at the instrumentation amplifier output (the ADC input) for the present state.
+ */
+double sim_afe_output_voltage(const sim_analog_frontend_t *afe);
+
+/**
+ * @brief Returns the calibration entry a perfect bench calibration of the given table would record at a wiper index.
+ *        Tables follow the order of sdia_potentiometer_full_calibration_t.
+ */
+double sim_afe_ideal_calibration_entry(int table, int wiper_index);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* SIM_ANALOG_FRONTEND_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,199 @@
+/********************************************************************************************************************
+*
+*   @file sim_lora_channel.h
+*
+*   @brief Model of the 915 MHz LoRa link between the simulated sensor node radio and the far end of the link. Frames are
+*          on the air for exactly the time-on-air of their modulation and packet parameters, and the link can lose,
+*          corrupt and delay them with configurable probabilities so the RDT protocol can be measured under field-like
+*          conditions.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef SIM_LORA_CHANNEL_H
+#define SIM_LORA_CHANNEL_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define SIM_LORA_MAX_PAYLOAD 255
+#define SIM_LORA_MAX_IN_FLIGHT 16
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Enums
+
+typedef enum sim_lora_dir_e {
+    SIM_LORA_DIR_UPLINK = 0,        // Sensor node radio to the far end
+    SIM_LORA_DIR_DOWNLINK = 1,      // Far end to the sensor node radio
+} sim_lora_dir_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief LoRa modulation and packet parameters, as written with SetModulationParams and SetPacketParams
+ */
+typedef struct sim_lora_cfg_s {
+    uint8_t sf;
+    uint8_t bw;
+    uint8_t cr;
+    uint8_t ldro;
+    uint16_t preamble_len;
+    uint8_t header_type;
+    uint8_t payload_len;
+    uint8_t crc_on;
+    uint8_t invert_iq;
+} sim_lora_cfg_t;
+
+/**
+ * @brief Everything a receiver must share with a transmitter to demodulate its frame
+ */
+typedef struct sim_lora_phy_s {
+    sim_lora_cfg_t lora;            // payload_len is the length actually sent
+    uint32_t rf_freq;
+    uint8_t sync_word[2];           // Registers 0x0740 and 0x0741
+} sim_lora_phy_t;
+
+typedef struct sim_lora_frame_s {
+    sim_lora_dir_t dir;
+    uint32_t seq;
+    sim_lora_phy_t phy;
+    uint8_t payload[SIM_LORA_MAX_PAYLOAD];
+    uint8_t len;
+    bool corrupted;                 // The payload was damaged on the way; a receiver with CRC enabled will flag it
+    int8_t rssi_dbm;
+    int8_t snr_db;
+    uint64_t start_us;              // Arrival of the first preamble symbol at the receiver
+    uint64_t end_us;                // Arrival of the last payload symbol at the receiver
+} sim_lora_frame_t;
+
+/**
+ * @brief Impairments applied to every frame of one direction of the link
+ */
+typedef struct sim_lora_link_cfg_s {
+    double loss_prob;               // Probability a frame never reaches the receiver
+    double corrupt_prob;            // Probability a frame arrives with a damaged payload
+    uint32_t latency_us;            // Fixed propagation and processing delay
+    uint32_t jitter_us;             // Uniformly distributed extra delay
+    int8_t rssi_dbm;
+    int8_t snr_db;
+    uint8_t fading_db;              // RSSI and SNR of each frame vary uniformly by up to this much either way
+} sim_lora_link_cfg_t;
+
+typedef struct sim_lora_link_stats_s {
+    uint32_t frames;
+    uint32_t lost;
+    uint32_t below_floor;           // Frames lost because their SNR was below what their spreading factor can demodulate
+    uint32_t corrupted;
+    uint64_t airtime_us;
+} sim_lora_link_stats_t;
+
+/**
+ * @brief The transmission most recently started in one direction. Each end of the link is half duplex, so there is at
+ *        most one per direction.
+ */
+typedef struct sim_lora_tx_state_s {
+    uint32_t seq;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint32_t aborted_seq;           // Transmission cut short by its sender, 0 if none
+    double aborted_fraction;        // Share of the frame sent before the cut
+} sim_lora_tx_state_t;
+
+typedef struct sim_lora_channel_s {
+    sim_lora_link_cfg_t link[2];                    // Indexed by sim_lora_dir_t
+    sim_lora_link_stats_t stats[2];
+    sim_lora_tx_state_t tx[2];
+    uint64_t rng_state;
+    sim_lora_frame_t in_flight[SIM_LORA_MAX_IN_FLIGHT];
+    bool in_flight_used[SIM_LORA_MAX_IN_FLIGHT];
+} sim_lora_channel_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Puts the channel in its ideal state (no loss, no corruption, no latency) and seeds its random number generator.
+ *        The generator is part of the world state, so a run is reproducible from its seed.
+ */
+void sim_lora_channel_init(sim_lora_channel_t *channel, uint64_t seed);
+
+/**
+ * @brief Returns the symbol time of a LoRa configuration in microseconds (2^SF / BW)
+ */
+double sim_lora_symbol_time_us(const sim_lora_cfg_t *cfg);
+
+/**
+ * @brief Returns the time-on-air of a LoRa frame, per section 6.1.4 of the SX1261/2 datasheet.
+ *
+ * @param cfg Modulation and packet parameters of the transmitter
+ * @param len Payload length in bytes
+ */
+uint64_t sim_lora_time_on_air_us(const sim_lora_cfg_t *cfg, uint8_t len);
+
+/**
+ * @brief Returns the time from the start of a frame until its header has been demodulated, which is when an SX126x stops
+ *        its RX timeout timer.
+ */
+uint64_t sim_lora_header_time_us(const sim_lora_cfg_t *cfg);
+
+/**
+ * @brief Returns true if a receiver configured with rx_phy can demodulate a frame sent with tx_phy
+ */
+bool sim_lora_phy_match(const sim_lora_phy_t *tx_phy, const sim_lora_phy_t *rx_phy);
+
+/**
+ * @brief Puts a frame on the air. The transmitter's first symbol leaves now; the frame reaches the other end of the link
+ *        after the configured latency, unless the link loses it.
+ *
+ * @param dir Direction of the transmission
+ * @param phy Transmitter settings
+ * @param payload Bytes sent
+ * @param len Number of bytes sent
+ * @param path_loss_db Loss on the way in addition to the link's, for a transmitter further away than the others
+ *
+ * @returns Time-on-air of the frame
+ */
+uint64_t sim_lora_channel_transmit(sim_lora_channel_t *channel, sim_lora_dir_t dir, const sim_lora_phy_t *phy, const uint8_t *payload, uint8_t len, uint8_t path_loss_db);
+
+/**
+ * @brief Cuts short the transmission in progress in the given direction, as when the sender's radio is switched to another
+ *        mode before TX_DONE. Receivers of the frame get a damaged tail.
+ */
+void sim_lora_channel_abort(sim_lora_channel_t *channel, sim_lora_dir_t dir);
+
+/**
+ * @brief Called by a receiver when the last symbol of a frame is in. Applies any damage done after the frame started to
+ *        arrive (its sender aborting the transmission).
+ *
+ * @param frame The receiver's copy of the frame
+ */
+void sim_lora_channel_finish_frame(sim_lora_channel_t *channel, sim_lora_frame_t *frame);
+
+/**
+ * @brief Returns a uniformly distributed number in [0, 1) from the channel's generator
+ */
+double sim_lora_channel_random(sim_lora_channel_t *channel);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* SIM_LORA_CHANNEL_H */
+
+/* --- EOF ------------------------------------------------------------------ */
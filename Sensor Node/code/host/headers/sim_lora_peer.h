@@ -0,0 +1,139 @@
+/********************************************************************************************************************
+*
+*   @file sim_lora_peer.h
+*
+*   @brief Model of the far end of the sensor node's LoRa link for the host-native build. In responder mode it behaves
+*          like the gateway, acknowledging every LWQMS packet addressed to it; in sender mode it delivers a stream of
+*          packets to the node with stop-and-wait retransmission, so the node's receive path can be exercised too.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef SIM_LORA_PEER_H
+#define SIM_LORA_PEER_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_lora_channel.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define SIM_LORA_PEER_DEFAULT_TURNAROUND_US 20000      // RX done to ACK on the air: IRQ service, buffer read and radio reconfiguration
+#define SIM_LORA_PEER_DEFAULT_ACK_TIMEOUT_US 2000000
+#define SIM_LORA_PEER_DEFAULT_MAX_ATTEMPTS 5
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Enums
+
+typedef enum sim_lora_peer_mode_e {
+    SIM_LORA_PEER_OFF = 0,          // Nothing is listening
+    SIM_LORA_PEER_RESPONDER = 1,    // Acknowledges packets addressed to it, like the gateway
+    SIM_LORA_PEER_SENDER = 2,       // Sends packets to the node and waits for its acknowledgements
+} sim_lora_peer_mode_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef struct sim_lora_peer_stats_s {
+    uint32_t frames_heard;          // Frames demodulated
+    uint32_t frames_missed;         // Frames that arrived while transmitting or already receiving, or on other settings
+    uint32_t crc_errors;
+    uint32_t not_addressed;         // Frames for another device, or too damaged to decode
+    uint32_t data_received;
+    uint32_t duplicates;            // Data packets received again after the ACK was lost
+    uint32_t acks_sent;
+    uint32_t nacks_sent;            // Replies to data packets that failed their CRC
+    uint32_t data_sent;             // Transmissions, including retransmissions
+    uint32_t retransmissions;
+    uint32_t nacks_received;
+    uint32_t data_acked;
+    uint32_t data_abandoned;
+    uint64_t ack_latency_total_us;  // First transmission to ACK, summed over data_acked
+} sim_lora_peer_stats_t;
+
+typedef struct sim_lora_peer_s {
+    sim_lora_peer_mode_t mode;
+    sim_lora_phy_t phy;
+    uint16_t id;
+    uint16_t remote_id;             // Destination of the packets sent in sender mode
+    uint32_t turnaround_us;
+    uint8_t path_loss_db;           // Loss on this peer's frames in addition to the link's
+
+    // Half-duplex radio
+    uint64_t tx_busy_until_us;
+    bool receiving;
+    sim_lora_frame_t rx_frame;
+    int rx_event;
+
+    // Acknowledgement waiting to go out
+    uint8_t ack[SIM_LORA_MAX_PAYLOAD];
+    uint8_t ack_len;
+    int ack_event;
+
+    // Sender
+    uint32_t send_remaining;
+    uint32_t send_interval_us;
+    uint32_t send_jitter_us;        // Random extra delay before each transmission, so independent senders do not stay in step
+    uint32_t ack_timeout_us;
+    uint32_t max_attempts;
+    uint16_t next_pkt_id;
+    uint32_t attempts;
+    bool awaiting_ack;
+    uint64_t first_sent_us;
+    uint64_t done_us;               // Time the last packet of the series was acknowledged or abandoned
+    uint8_t pending[SIM_LORA_MAX_PAYLOAD];
+    uint8_t pending_len;
+    int send_event;
+
+    sim_lora_peer_stats_t stats;
+} sim_lora_peer_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Sets up the peer with the given LWQMS ID and radio settings, in responder mode.
+ */
+void sim_lora_peer_init(sim_lora_peer_t *peer, uint16_t id, const sim_lora_phy_t *phy);
+
+/**
+ * @brief Returns the register values an SX126x holds after the firmware has written the given sync word (lora.c keeps
+ *        the low nibble of each register and writes the sync word into the high nibbles).
+ */
+void sim_lora_peer_sync_word_regs(uint8_t sync_word, uint8_t regs[2]);
+
+/**
+ * @brief Switches the peer to sender mode and schedules the first of a series of packets to the node.
+ *
+ * @param remote_id LWQMS ID of the node
+ * @param count Number of packets to deliver
+ * @param interval_us Gap between an acknowledged (or abandoned) packet and the next one
+ */
+void sim_lora_peer_start_sending(sim_lora_peer_t *peer, uint16_t remote_id, uint32_t count, uint32_t interval_us);
+
+/**
+ * @brief Called by the channel when the first symbol of an uplink frame reaches the peer.
+ */
+void sim_lora_peer_frame_arrival(sim_lora_peer_t *peer, const sim_lora_frame_t *frame);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* SIM_LORA_PEER_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,86 @@
+/********************************************************************************************************************
+*
+*   @file sim_mx25l3233f.h
+*
+*   @brief In-memory model of the Macronix MX25L3233F 32 Mbit serial NOR flash for the host-native build.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef SIM_MX25L3233F_H
+#define SIM_MX25L3233F_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define SIM_MX25L3233F_SIZE (4 * 1024 * 1024)
+#define SIM_MX25L3233F_PAGE_SIZE 256
+
+// Typical program/erase times from the datasheet
+#define SIM_MX25L3233F_PAGE_PROGRAM_US 500
+#define SIM_MX25L3233F_SECTOR_ERASE_US 30000
+#define SIM_MX25L3233F_BLOCK_32K_ERASE_US 150000
+#define SIM_MX25L3233F_BLOCK_64K_ERASE_US 250000
+#define SIM_MX25L3233F_CHIP_ERASE_US 15000000
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef struct sim_mx25l3233f_s {
+    bool cs;
+    bool write_enable_latch;
+    bool deep_power_down;
+    uint64_t busy_until_us;
+
+    uint8_t cmd[4];
+    uint32_t xfer_len;
+    uint8_t page_buf[SIM_MX25L3233F_PAGE_SIZE];
+    uint32_t page_bytes;
+
+    uint32_t reads;
+    uint32_t programs;
+    uint32_t erases;
+
+    uint8_t memory[SIM_MX25L3233F_SIZE];
+} sim_mx25l3233f_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Erases the whole array and clears the status register, as for a factory-fresh part.
+ */
+void sim_mx25l3233f_init(sim_mx25l3233f_t *flash);
+
+/**
+ * @brief Drives the chip select line of the model. A rising edge executes any write/erase command that was clocked in.
+ */
+void sim_mx25l3233f_set_cs(sim_mx25l3233f_t *flash, bool level);
+
+/**
+ * @brief Exchanges one byte on the SPI bus while CS is asserted.
+ *
+ * @returns The byte driven on MISO
+ */
+uint8_t sim_mx25l3233f_spi_byte(sim_mx25l3233f_t *flash, uint8_t mosi);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* SIM_MX25L3233F_H */
+
+/* --- EOF ------------------------------------------------------------------ */
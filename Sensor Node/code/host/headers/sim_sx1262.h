@@ -0,0 +1,202 @@
+/********************************************************************************************************************
+*
+*   @file sim_sx1262.h
+*
+*   @brief In-memory model of the Semtech SX1262 LoRa transceiver for the host-native build. The model sits behind the
+*          SPI bus and GPIO lines exactly where the real chip would, so the unmodified Semtech driver and sx126x HAL run on it.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef SIM_SX1262_H
+#define SIM_SX1262_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_lora_channel.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define SIM_SX1262_BUFFER_SIZE 256
+#define SIM_SX1262_REGISTER_SPACE 0x1000
+#define SIM_SX1262_MAX_TRANSACTION 300
+
+#define SIM_SX1262_RESET_BUSY_US 3500       // Cold start after NRESET
+#define SIM_SX1262_WAKEUP_BUSY_US 3500      // Cold start after leaving sleep
+#define SIM_SX1262_CALIBRATE_BUSY_US 3500   // Calibrate all blocks
+#define SIM_SX1262_COMMAND_BUSY_US 10       // Typical BUSY time after an ordinary command
+
+// Supply currents at 3.3 V with the DC-DC regulator (SX1261/2 datasheet, tables 3-5 and 3-6)
+#define SIM_SX1262_SUPPLY_V 3.3
+#define SIM_SX1262_SLEEP_COLD_MA 0.00016
+#define SIM_SX1262_SLEEP_WARM_MA 0.0006
+#define SIM_SX1262_STDBY_RC_MA 0.6
+#define SIM_SX1262_STDBY_XOSC_MA 0.8
+#define SIM_SX1262_FS_MA 2.1
+#define SIM_SX1262_RX_MA 4.6
+#define SIM_SX1262_TX_22DBM_MA 118.0
+#define SIM_SX1262_TX_20DBM_MA 102.0
+#define SIM_SX1262_TX_17DBM_MA 95.0
+#define SIM_SX1262_TX_14DBM_MA 90.0
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Enums
+
+typedef enum sim_sx1262_mode_e {
+    SIM_SX1262_MODE_SLEEP = 0,
+    SIM_SX1262_MODE_STDBY_RC = 2,
+    SIM_SX1262_MODE_STDBY_XOSC = 3,
+    SIM_SX1262_MODE_FS = 4,
+    SIM_SX1262_MODE_RX = 5,
+    SIM_SX1262_MODE_TX = 6,
+    SIM_SX1262_QTY_MODES = 7,
+} sim_sx1262_mode_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef struct sim_sx1262_s {
+    // Wiring
+    uint8_t dio1_pin;
+    uint8_t busy_pin;
+
+    // Pins
+    bool nreset;
+    bool nss;
+    bool dio1;
+    bool busy;                     // Level last driven onto the BUSY line
+    uint64_t busy_until_us;
+    int busy_event;                // Falling edge of BUSY once the current command is done
+
+    // Operating state
+    sim_sx1262_mode_t mode;
+    sim_sx1262_mode_t fallback_mode;    // Mode entered when a TX or single RX finishes
+    bool warm_start;
+    uint8_t pkt_type;
+    uint32_t rf_freq;              // Hz
+    int8_t tx_power;
+    uint32_t ramp_us;
+    uint8_t tx_base;
+    uint8_t rx_base;
+    uint8_t rx_payload_len;
+    uint8_t rx_start;
+    uint8_t cmd_status;
+    int8_t last_rssi_dbm;
+    int8_t last_snr_db;
+
+    // IRQ configuration
+    uint16_t irq_status;
+    uint16_t irq_mask;
+    uint16_t dio1_mask;
+
+    sim_lora_cfg_t lora;
+
+    // Pending operation
+    int op_event;
+    uint64_t op_started_us;
+    bool rx_continuous;
+
+    bool tx_on_air;
+
+    // Frame being demodulated
+    bool rx_locked;
+    int rx_event;
+    sim_lora_frame_t rx_frame;
+
+    // SPI transaction in progress
+    uint8_t xfer[SIM_SX1262_MAX_TRANSACTION];
+    uint16_t xfer_len;
+
+    // Memories
+    uint8_t buffer[SIM_SX1262_BUFFER_SIZE];
+    uint8_t regs[SIM_SX1262_REGISTER_SPACE];
+
+    // Statistics
+    uint32_t commands;
+    uint32_t tx_started;
+    uint32_t tx_done;
+    uint32_t rx_started;
+    uint32_t rx_done;
+    uint32_t rx_timeouts;
+    uint32_t rx_crc_errors;
+    uint32_t rx_missed;             // Frames that arrived while not listening, already receiving, or on other settings
+    uint32_t rx_collisions;         // Frames that arrived while another was being received, ruining it
+    uint64_t tx_done_us;
+    bool turnaround_pending;        // A TX has finished and no RX or TX has started since
+    uint64_t turnaround_total_us;   // Sum of the times from TX done to the next RX starting
+    uint32_t turnarounds;
+
+    // Energy
+    uint64_t mode_since_us;
+    uint64_t mode_time_us[SIM_SX1262_QTY_MODES];
+    double energy_uj;               // Up to mode_since_us
+} sim_sx1262_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Places the model in its power-on state
+ */
+void sim_sx1262_power_on(sim_sx1262_t *radio);
+
+/**
+ * @brief Drives the NRESET pin of the model
+ */
+void sim_sx1262_set_nreset(sim_sx1262_t *radio, bool level);
+
+/**
+ * @brief Drives the NSS (chip select) pin of the model. A falling edge wakes the chip from sleep and opens a transaction;
+ *        a rising edge executes the command that was clocked in.
+ */
+void sim_sx1262_set_nss(sim_sx1262_t *radio, bool level);
+
+/**
+ * @brief Exchanges one byte on the SPI bus while NSS is asserted.
+ *
+ * @returns The byte driven on MISO
+ */
+uint8_t sim_sx1262_spi_byte(sim_sx1262_t *radio, uint8_t mosi);
+
+/**
+ * @brief Returns the level of the BUSY pin
+ */
+bool sim_sx1262_get_busy(const sim_sx1262_t *radio);
+
+/**
+ * @brief Returns the level of the DIO1 pin
+ */
+bool sim_sx1262_get_dio1(const sim_sx1262_t *radio);
+
+/**
+ * @brief Called by the channel when the first symbol of a downlink frame reaches the radio. The frame is received if the
+ *        radio is listening with matching settings, and RX_DONE is raised once its last symbol is in.
+ */
+void sim_sx1262_frame_arrival(sim_sx1262_t *radio, const sim_lora_frame_t *frame);
+
+/**
+ * @brief Returns the energy drawn by the radio since power on, in microjoules
+ */
+double sim_sx1262_energy_uj(const sim_sx1262_t *radio);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* SIM_SX1262_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,167 @@
+/********************************************************************************************************************
+*
+*   @file host_board.c
+*
+*   @brief Assembly of the simulated sensor node board for the host-native build. Shared by every host executable, so the
+*          firmware always wakes up on the same provisioned board with a gateway listening at the far end of the link.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_board.h"
+
+#include "hardware.h"
+#include "system_config.h"
+#include "software_defined_inst_amp.h"
+#include "mxl23l3233f.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+// The gateway runs the same LoRa settings as the node's prototyping parameters in main.h.
+static const sx126x_mod_params_lora_t gateway_mod_params = {
+    .sf = SX126X_LORA_SF10,
+    .bw = SX126X_LORA_BW_125,
+    .cr = SX126X_LORA_CR_4_5,
+    .ldro = 0x00
+};
+
+static const sx126x_pkt_params_lora_t gateway_pkt_params = {
+    .preamble_len_in_symb = 8,
+    .header_type = SX126X_LORA_PKT_EXPLICIT,
+    .crc_is_on = true,
+    .invert_iq_is_on = false
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Board Setup
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Board Setup
+
+static void provision_flash(void) {
+    node_config_t config;
+
+    memset(&config, 0x00, sizeof(config));
+    config.ID = HOST_NODE_ID;
+    config.gateway_ID = HOST_GATEWAY_ID;
+    config.latitude = HOST_NODE_LATITUDE;
+    config.longitude = HOST_NODE_LONGITUDE;
+    config.sync_word = HOST_SYNC_WORD;
+
+    memcpy(&host_world->flash.memory[FLASH_ADDR_CONFIG], &config, sizeof(config));
+
+    // A calibration as the bench procedure would record it for an ideal front end.
+    static sdia_potentiometer_full_calibration_t cal;
+    sdia_potentiometer_cal_data_t *tables[] = {
+        cal.DCPos_calibration,
+        cal.DCNeg_calibration,
+        cal.GainUpper_calibration,
+        cal.GainLower_calibration,
+        cal.RefUpper_calibration,
+        cal.RefLower_calibration
+    };
+
+    for (int t = 0; t < (sizeof(tables) / sizeof(tables[0])); t++) {
+        for (int w = 0; w <= MCP4651_MAX_WIPER_INDEX; w++) {
+            tables[t][w].r_wb = sim_afe_ideal_calibration_entry(t, w);
+        }
+    }
+
+    memcpy(&host_world->flash.memory[FLASH_ADDR_SDIA_CAL_DATA_32K_BLOCK * FLASH_BLOCK_32KB_SIZE], &cal, sizeof(cal));
+}
+
+static void gateway_phy(const sx126x_mod_params_lora_t *mod, const sx126x_pkt_params_lora_t *pkt, uint8_t sync_word, sim_lora_phy_t *phy) {
+    memset(phy, 0x00, sizeof(*phy));
+    phy->lora.sf = mod->sf;
+    phy->lora.bw = mod->bw;
+    phy->lora.cr = mod->cr;
+    phy->lora.ldro = mod->ldro;
+    phy->lora.preamble_len = pkt->preamble_len_in_symb;
+    phy->lora.header_type = pkt->header_type;
+    phy->lora.crc_on = pkt->crc_is_on;
+    phy->lora.invert_iq = pkt->invert_iq_is_on;
+    phy->rf_freq = HOST_RF_FREQ_HZ;
+    sim_lora_peer_sync_word_regs(sync_word, phy->sync_word);
+}
+
+void host_board_configure_gateway(const sx126x_mod_params_lora_t *mod, const sx126x_pkt_params_lora_t *pkt, uint8_t sync_word) {
+    gateway_phy(mod, pkt, sync_word, &host_world->peer.phy);
+}
+
+void host_board_build_world(void) {
+    host_world = mmap(NULL, sizeof(host_world_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    if (host_world == MAP_FAILED) {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+
+    // Anonymous mappings arrive zeroed.
+    host_world->wake_pin = -1;
+    host_world->wake_alarm_us = UINT64_MAX;
+    host_world->next_due_us = UINT64_MAX;
+    host_world->rand_state = HOST_RAND_SEED;
+
+    host_world->radio.dio1_pin = context_radio_0.irq_context->pin;
+    host_world->radio.busy_pin = context_radio_0.busy;
+    sim_sx1262_power_on(&host_world->radio);
+
+    sim_mx25l3233f_init(&host_world->flash);
+    provision_flash();
+
+    const uint8_t digipot_addrs[SIM_AFE_QTY_DIGIPOTS] = {
+        [SIM_AFE_DIGIPOT_OFFSET] = context_digipot_offset.addr,
+        [SIM_AFE_DIGIPOT_GAIN] = context_digipot_gain.addr,
+        [SIM_AFE_DIGIPOT_REFERENCE] = context_digipot_reference.addr
+    };
+
+    sim_afe_init(&host_world->afe, digipot_addrs, context_adc_0.addr);
+
+    sim_lora_channel_init(&host_world->channel, HOST_CHANNEL_SEED);
+
+    sim_lora_phy_t phy;
+    gateway_phy(&gateway_mod_params, &gateway_pkt_params, HOST_SYNC_WORD, &phy);
+    sim_lora_peer_init(&host_world->peer, HOST_GATEWAY_ID, &phy);
+}
+
+void host_board_reset_mcu(host_boot_reason_t reason) {
+    host_world->boot_reason = reason;
+    host_world->watchdog_enabled = false;
+    host_world->wake_alarm_us = UINT64_MAX;
+    host_world->wake_pin = -1;
+    host_world->wake_pin_triggered = false;
+
+    // Pull-ups keep the chip selects and radio reset deasserted, and the pull-down on EN_5V drops the rail.
+    sim_sx1262_set_nss(&host_world->radio, true);
+    sim_sx1262_set_nreset(&host_world->radio, true);
+    sim_mx25l3233f_set_cs(&host_world->flash, true);
+    host_board_set_5v_rail(false);
+}
+
+double host_board_energy_uj(void) {
+    uint64_t mcu_active_us = host_world->stats.mcu_active_us;
+
+    if (host_world->mcu_running) mcu_active_us += host_world->now_us - host_world->boot_time_us;
+
+    uint64_t mcu_sleep_us = host_world->stats.mcu_sleep_us;
+    uint64_t mcu_run_us = (mcu_active_us > mcu_sleep_us) ? (mcu_active_us - mcu_sleep_us) : 0;
+
+    return (HOST_SIM_MCU_SUPPLY_V * ((HOST_SIM_MCU_ACTIVE_MA * mcu_run_us) + (HOST_SIM_MCU_SLEEP_MA * mcu_sleep_us)) / 1000.0) +
+        sim_sx1262_energy_uj(&host_world->radio);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,61 @@
+# Host-native build of the sensor node firmware.
+#
+# Compiles the unmodified firmware (main.c, the drivers and sys_utils) for the build machine, swapping lib/hal.c and the
+# Pico SDK for the simulated board in host/. The resulting LWQMS_Firmware_host executable runs the real boot flow and
+# FSM against models of the SX1262, MX25L3233F, MCP4651, MCP3425 and TMUX1309, with a simulated gateway at the far end
+# of an airtime-accurate LoRa link. LWQMS_rdt_bench drives the RDT 3.0 layer over the same link and reports its
+# throughput, latency and energy.
+
+file(GLOB SX126X_DRIVER_SOURCES "${CMAKE_CURRENT_SOURCE_DIR}/lib/sx126x/*.c")
+file(GLOB LIB "${CMAKE_CURRENT_SOURCE_DIR}/lib/*.c")
+file(GLOB SYS_UTILS "${CMAKE_CURRENT_SOURCE_DIR}/sys_utils/*.c")
+file(GLOB HOST_SIM "${CMAKE_CURRENT_SOURCE_DIR}/host/*.c" "${CMAKE_CURRENT_SOURCE_DIR}/host/sim/*.c")
+
+# The HAL is the one piece of firmware that talks to the RP2350 directly.
+list(REMOVE_ITEM LIB "${CMAKE_CURRENT_SOURCE_DIR}/lib/hal.c")
+
+# Entry points live with their executables.
+list(REMOVE_ITEM HOST_SIM "${CMAKE_CURRENT_SOURCE_DIR}/host/host_main.c")
+
+# Everything but main(): firmware libraries and the simulated board, shared by the host executables.
+add_library(lwqms_host_sim STATIC
+    ${SX126X_DRIVER_SOURCES}
+    ${LIB}
+    ${SYS_UTILS}
+    ${HOST_SIM}
+)
+
+# Link the way the Pico SDK does, discarding unreferenced functions (isrs.c has handlers for GPIOs this board lacks).
+target_compile_options(lwqms_host_sim PUBLIC -ffunction-sections -fdata-sections -Wno-format-security)
+target_link_options(lwqms_host_sim PUBLIC -Wl,--gc-sections)
+
+target_link_libraries(lwqms_host_sim PUBLIC m)
+
+# The SDK stand-ins must be found before any system header of the same name.
+target_include_directories(lwqms_host_sim PUBLIC
+        ${CMAKE_CURRENT_SOURCE_DIR}/host/pico_shim
+        ${CMAKE_CURRENT_SOURCE_DIR}/host/headers
+        ${CMAKE_CURRENT_SOURCE_DIR}
+        ${CMAKE_CURRENT_SOURCE_DIR}/sys_utils
+        ${CMAKE_CURRENT_SOURCE_DIR}/sys_utils/headers
+        ${CMAKE_CURRENT_SOURCE_DIR}/lib
+        ${CMAKE_CURRENT_SOURCE_DIR}/lib/headers
+        ${CMAKE_CURRENT_SOURCE_DIR}/lib/sx126x
+        ${CMAKE_CURRENT_SOURCE_DIR}/lib/sx126x/headers
+)
+
+add_executable(LWQMS_Firmware_host
+    main.c
+    host/host_main.c
+)
+
+# The firmware's main() becomes a function the simulation calls once per boot cycle.
+set_source_files_properties(main.c PROPERTIES COMPILE_DEFINITIONS "main=lwqms_node_main")
+
+target_link_libraries(LWQMS_Firmware_host lwqms_host_sim)
+
+add_executable(LWQMS_rdt_bench
+    host/bench/rdt_bench.c
+)
+
+target_link_libraries(LWQMS_rdt_bench lwqms_host_sim)
@@ -0,0 +1,282 @@
+/********************************************************************************************************************
+*
+*   @file host_main.c
+*
+*   @brief Entry point of the host-native build of the LoRa Water Quality Management System Sensor Node Firmware. Builds
+*          the simulated board, provisions its flash as a bench-calibrated node would be, and then runs the unmodified
+*          firmware main() through a series of boot cycles (power on, dormant wake, reboot, watchdog).
+*
+*          Each boot cycle runs in a forked process so the firmware starts with freshly reset RAM, while the board state
+*          and the virtual clock live in shared memory and carry on across resets like the real hardware does.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+#include "host_board.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define HOST_DEFAULT_BOOT_CYCLES 3
+#define HOST_DEFAULT_HANG_LIMIT_S 10
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+// The firmware's main(), renamed by the build.
+extern int lwqms_node_main(void);
+
+static bool quiet = false;
+static bool gateway_present = true;
+static uint32_t boot_cycles = HOST_DEFAULT_BOOT_CYCLES;
+static uint32_t hang_limit_s = HOST_DEFAULT_HANG_LIMIT_S;
+static uint64_t channel_seed = HOST_CHANNEL_SEED;
+static sim_lora_link_cfg_t link_cfg = {.rssi_dbm = -60, .snr_db = 8};
+
+static const char *exit_reason_names[] = {
+    [HOST_EXIT_DORMANT - HOST_EXIT_DORMANT] = "dormant",
+    [HOST_EXIT_REBOOT - HOST_EXIT_DORMANT] = "reboot",
+    [HOST_EXIT_WATCHDOG - HOST_EXIT_DORMANT] = "watchdog",
+    [HOST_EXIT_HANG - HOST_EXIT_DORMANT] = "hang",
+    [HOST_EXIT_CONSOLE_EOF - HOST_EXIT_DORMANT] = "console eof",
+    [HOST_EXIT_CRASH - HOST_EXIT_DORMANT] = "crash",
+};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Boot Cycle
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Boot Cycle
+
+void host_sim_end_boot_cycle(host_exit_reason_t reason) {
+    fflush(stdout);
+
+    host_world->stats.mcu_active_us += host_world->now_us - host_world->boot_time_us;
+    host_world->mcu_running = false;
+
+    _exit(reason);
+}
+
+static void on_hang_limit(int signum) {
+    (void)signum;
+    host_sim_end_boot_cycle(HOST_EXIT_HANG);
+}
+
+static void run_boot_cycle(void) {
+    if (quiet) {
+        if (freopen("/dev/null", "w", stdout) == NULL) _exit(HOST_EXIT_CRASH);
+    }
+
+    // A firmware stuck in a loop that spends no virtual time would never trip the simulated watchdog.
+    signal(SIGALRM, on_hang_limit);
+    alarm(hang_limit_s);
+
+    lwqms_node_main();
+
+    host_sim_end_boot_cycle(HOST_EXIT_NONE);
+}
+
+/**
+ * @brief Lets the board run on while the MCU is dormant, until the wake alarm or the wakeup pin brings it back.
+ *
+ * @returns False if nothing will ever wake the MCU.
+ */
+static bool sleep_until_wake(void) {
+    while (!host_world->wake_pin_triggered) {
+        uint64_t next_event_us = host_sim_next_event_us();
+
+        if ((next_event_us == UINT64_MAX) || (next_event_us > host_world->wake_alarm_us)) {
+            if (host_world->wake_alarm_us == UINT64_MAX) return false;
+
+            host_sim_advance_to_us(host_world->wake_alarm_us);
+            return true;
+        }
+
+        host_sim_advance_to_us(next_event_us);
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Report
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Report
+
+static void print_report(void) {
+    const host_sim_stats_t *stats = &host_world->stats;
+
+    printf("\n\n-- Host Simulation Summary --\n");
+    printf("Boot cycles:\t\t%u\n", stats->boots);
+
+    for (int k = 0; k < (sizeof(exit_reason_names) / sizeof(exit_reason_names[0])); k++) {
+        if (stats->exits[k] > 0) printf("  ended by %s:\t%u\n", exit_reason_names[k], stats->exits[k]);
+    }
+
+    printf("Virtual time:\t\t%.3f s\n", host_world->now_us / 1e6);
+    printf("MCU active time:\t%.3f s (%.3f s asleep in WFE)\n", stats->mcu_active_us / 1e6, stats->mcu_sleep_us / 1e6);
+    printf("SPI:\t\t\t%llu transactions, %llu bytes\n", (unsigned long long)stats->spi_transactions, (unsigned long long)stats->spi_bytes);
+    printf("I2C:\t\t\t%llu transactions, %llu bytes, %llu NAKs\n", (unsigned long long)stats->i2c_transactions, (unsigned long long)stats->i2c_bytes, (unsigned long long)stats->i2c_naks);
+    printf("Radio:\t\t\t%u commands, %u/%u TX done, %u/%u RX done, %u RX timeouts, %u CRC errors\n", host_world->radio.commands,
+        host_world->radio.tx_done, host_world->radio.tx_started, host_world->radio.rx_done, host_world->radio.rx_started, host_world->radio.rx_timeouts,
+        host_world->radio.rx_crc_errors);
+    printf("Radio time:\t\t%.3f s TX, %.3f s RX\n", host_world->radio.mode_time_us[SIM_SX1262_MODE_TX] / 1e6, host_world->radio.mode_time_us[SIM_SX1262_MODE_RX] / 1e6);
+    printf("Energy:\t\t\t%.3f mJ radio, %.3f mJ total\n", sim_sx1262_energy_uj(&host_world->radio) / 1000.0, host_board_energy_uj() / 1000.0);
+
+    for (int dir = SIM_LORA_DIR_UPLINK; dir <= SIM_LORA_DIR_DOWNLINK; dir++) {
+        const sim_lora_link_stats_t *link = &host_world->channel.stats[dir];
+        printf("%s:\t\t%u frames, %u lost, %u corrupted, %.3f s airtime\n", (dir == SIM_LORA_DIR_UPLINK) ? "Uplink" : "Downlink",
+            link->frames, link->lost, link->corrupted, link->airtime_us / 1e6);
+    }
+
+    const sim_lora_peer_stats_t *gateway = &host_world->peer.stats;
+    printf("Gateway:\t\t%u packets received (%u duplicates), %u ACKs sent, %u NACKs sent, %u frames missed\n", gateway->data_received, gateway->duplicates,
+        gateway->acks_sent, gateway->nacks_sent, gateway->frames_missed);
+    printf("Flash:\t\t\t%u reads, %u page programs, %u erases\n", host_world->flash.reads, host_world->flash.programs, host_world->flash.erases);
+    printf("ADC conversions:\t%u\n", host_world->afe.adc.conversions);
+}
+
+static void print_usage(const char *argv0) {
+    printf("Usage: %s [--cycles N] [--hang-limit SECONDS] [--console] [--quiet] [--loss P] [--corrupt P] [--latency US] [--jitter US] [--seed N] [--no-gateway]\n\n", argv0);
+    printf("  --cycles N            Number of MCU boot cycles to run (default %d)\n", HOST_DEFAULT_BOOT_CYCLES);
+    printf("  --hang-limit SECONDS  Wall-clock time after which a boot cycle counts as hung (default %d)\n", HOST_DEFAULT_HANG_LIMIT_S);
+    printf("  --console             Attach stdin/stdout as the USB console\n");
+    printf("  --quiet               Suppress firmware output, print only the summary\n");
+    printf("  --loss P              Probability a LoRa frame is lost, each direction (default 0)\n");
+    printf("  --corrupt P           Probability a LoRa frame arrives damaged, each direction (default 0)\n");
+    printf("  --latency US          Fixed delay added to every LoRa frame (default 0)\n");
+    printf("  --jitter US           Uniformly distributed extra delay (default 0)\n");
+    printf("  --seed N              Seed of the link impairments (default %d)\n", HOST_CHANNEL_SEED);
+    printf("  --no-gateway          Leave the far end of the link silent\n");
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+int main(int argc, char **argv) {
+
+    for (int k = 1; k < argc; k++) {
+        if ((strcmp(argv[k], "--cycles") == 0) && (k + 1 < argc)) {
+            boot_cycles = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--hang-limit") == 0) && (k + 1 < argc)) {
+            hang_limit_s = strtoul(argv[++k], NULL, 10);
+        }
+        else if (strcmp(argv[k], "--console") == 0) {
+            host_console_attached = true;
+        }
+        else if (strcmp(argv[k], "--quiet") == 0) {
+            quiet = true;
+        }
+        else if ((strcmp(argv[k], "--loss") == 0) && (k + 1 < argc)) {
+            link_cfg.loss_prob = strtod(argv[++k], NULL);
+        }
+        else if ((strcmp(argv[k], "--corrupt") == 0) && (k + 1 < argc)) {
+            link_cfg.corrupt_prob = strtod(argv[++k], NULL);
+        }
+        else if ((strcmp(argv[k], "--latency") == 0) && (k + 1 < argc)) {
+            link_cfg.latency_us = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--jitter") == 0) && (k + 1 < argc)) {
+            link_cfg.jitter_us = strtoul(argv[++k], NULL, 10);
+        }
+        else if ((strcmp(argv[k], "--seed") == 0) && (k + 1 < argc)) {
+            channel_seed = strtoull(argv[++k], NULL, 10);
+        }
+        else if (strcmp(argv[k], "--no-gateway") == 0) {
+            gateway_present = false;
+        }
+        else {
+            print_usage(argv[0]);
+            return (strcmp(argv[k], "--help") == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    host_board_build_world();
+
+    sim_lora_channel_init(&host_world->channel, channel_seed);
+    host_world->channel.link[SIM_LORA_DIR_UPLINK] = link_cfg;
+    host_world->channel.link[SIM_LORA_DIR_DOWNLINK] = link_cfg;
+
+    if (!gateway_present) host_world->peer.mode = SIM_LORA_PEER_OFF;
+
+    host_boot_reason_t boot_reason = HOST_BOOT_POWER_ON;
+
+    for (uint32_t cycle = 0; cycle < boot_cycles; cycle++) {
+
+        host_board_reset_mcu(boot_reason);
+        host_world->boot_time_us = host_world->now_us;
+        host_world->mcu_running = true;
+        host_world->stats.boots++;
+
+        fflush(stdout);
+
+        pid_t pid = fork();
+
+        if (pid < 0) {
+            perror("fork");
+            return EXIT_FAILURE;
+        }
+
+        if (pid == 0) run_boot_cycle();
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+
+        host_exit_reason_t reason = WIFEXITED(status) ? (host_exit_reason_t)WEXITSTATUS(status) : HOST_EXIT_CRASH;
+
+        if ((reason >= HOST_EXIT_DORMANT) && (reason <= HOST_EXIT_CRASH)) {
+            host_world->stats.exits[reason - HOST_EXIT_DORMANT]++;
+        }
+
+        bool keep_running = true;
+
+        switch (reason) {
+            case HOST_EXIT_DORMANT:
+                keep_running = sleep_until_wake();
+                boot_reason = HOST_BOOT_DORMANT_WAKE;
+                break;
+            case HOST_EXIT_REBOOT:
+            case HOST_EXIT_WATCHDOG:
+                boot_reason = HOST_BOOT_WATCHDOG;
+                break;
+            case HOST_EXIT_HANG:
+                // On the board the watchdog catches a hang, if it is running.
+                keep_running = host_world->watchdog_enabled;
+                host_world->watchdog_enabled = false;
+                if (keep_running) host_sim_advance_to_us(host_world->watchdog_deadline_us);
+                boot_reason = HOST_BOOT_WATCHDOG;
+                break;
+            default:
+                keep_running = false;
+                break;
+        }
+
+        if (!keep_running) break;
+    }
+
+    print_report();
+
+    return EXIT_SUCCESS;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
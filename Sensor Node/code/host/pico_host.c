@@ -0,0 +1,162 @@
+/********************************************************************************************************************
+*
+*   @file pico_host.c
+*
+*   @brief Host build implementation of the handful of Pico SDK functions the firmware calls outside of the HAL: the
+*          time functions, the random number generator, the bus instance handles and stdio.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "pico/stdlib.h"
+#include "pico/stdio.h"
+#include "pico/rand.h"
+#include "hardware/spi.h"
+#include "hardware/i2c.h"
+
+#include "host_sim.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Bus Instances
+
+spi_inst_t host_spi_instances[2] = {{.index = 0}, {.index = 1}};
+
+i2c_inst_t host_i2c_instances[2] = {{.index = 0}, {.index = 1}};
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Time
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Time
+
+static void sleep_until_us(uint64_t t_us) {
+    uint64_t from_us = host_sim_now_us();
+
+    // The SDK sleeps wait in WFE between timer alarms, so they draw sleep current rather than run current.
+    host_world->stats.mcu_sleep_us += (t_us > from_us) ? (t_us - from_us) : 0;
+    host_sim_advance_to_us(t_us);
+}
+
+absolute_time_t get_absolute_time(void) {
+    host_sim_advance_us(HOST_SIM_POLL_TICK_US);
+    return host_sim_now_us();
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return host_sim_now_us() + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return host_sim_now_us() + ((uint64_t)ms * 1000);
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+bool time_reached(absolute_time_t t) {
+    return get_absolute_time() >= t;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)((t - host_world->boot_time_us) / 1000);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t - host_world->boot_time_us;
+}
+
+uint64_t time_us_64(void) {
+    return host_sim_now_us() - host_world->boot_time_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+void sleep_us(uint64_t us) {
+    sleep_until_us(host_sim_now_us() + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_until_us(host_sim_now_us() + ((uint64_t)ms * 1000));
+}
+
+void sleep_until(absolute_time_t t) {
+    sleep_until_us(t);
+}
+
+void busy_wait_us(uint64_t us) {
+    host_sim_advance_us(us);
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    uint64_t now_us = host_sim_now_us();
+
+    if (now_us >= timeout_timestamp) return true;
+
+    // Any device event can raise an interrupt, and every interrupt sets the event register.
+    uint64_t wake_us = (host_world->next_due_us < timeout_timestamp) ? host_world->next_due_us : timeout_timestamp;
+    if (wake_us <= now_us) wake_us = now_us + HOST_SIM_POLL_TICK_US;
+
+    sleep_until_us(wake_us);
+
+    return host_sim_now_us() >= timeout_timestamp;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Random
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Random
+
+uint64_t get_rand_64(void) {
+    // xorshift64*, as the channel model uses
+    uint64_t x = host_world->rand_state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    host_world->rand_state = x;
+
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+uint32_t get_rand_32(void) {
+    return (uint32_t)(get_rand_64() >> 32);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Stdio
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Stdio
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+bool stdio_deinit_all(void) {
+    fflush(stdout);
+    return true;
+}
+
+void stdio_flush(void) {
+    fflush(stdout);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,20 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/dma.h
+*
+*   @brief Host build stand-in for the Pico SDK DMA header. The host HAL provides the behaviour; nothing is declared here.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_DMA_H
+#define HOST_HARDWARE_DMA_H
+
+#include "pico/types.h"
+
+#endif /* HOST_HARDWARE_DMA_H */
+
+/* --- EOF ------------------------------------------------------------------ */
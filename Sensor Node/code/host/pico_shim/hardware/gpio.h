@@ -0,0 +1,31 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/gpio.h
+*
+*   @brief Host build stand-in for the Pico SDK GPIO header. Only the constants referenced by the firmware are provided;
+*          pin behaviour is implemented by the host HAL (host/hal_host.c).
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+#define NUM_BANK0_GPIOS 30
+
+#define GPIO_IRQ_LEVEL_LOW  0x1u
+#define GPIO_IRQ_LEVEL_HIGH 0x2u
+#define GPIO_IRQ_EDGE_FALL  0x4u
+#define GPIO_IRQ_EDGE_RISE  0x8u
+
+#define GPIO_OUT 1
+#define GPIO_IN  0
+
+#endif /* HOST_HARDWARE_GPIO_H */
+
+/* --- EOF ------------------------------------------------------------------ */
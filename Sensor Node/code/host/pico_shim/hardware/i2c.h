@@ -0,0 +1,29 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/i2c.h
+*
+*   @brief Host build stand-in for the Pico SDK I2C header. Transfers are dispatched to simulated targets by address.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/types.h"
+
+typedef struct i2c_inst {
+    uint8_t index;
+} i2c_inst_t;
+
+extern i2c_inst_t host_i2c_instances[2];
+
+#define i2c0 (&host_i2c_instances[0])
+#define i2c1 (&host_i2c_instances[1])
+
+#endif /* HOST_HARDWARE_I2C_H */
+
+/* --- EOF ------------------------------------------------------------------ */
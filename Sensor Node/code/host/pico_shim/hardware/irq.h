@@ -0,0 +1,20 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/irq.h
+*
+*   @brief Host build stand-in for the Pico SDK irq header. The host HAL provides the behaviour; nothing is declared here.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+#endif /* HOST_HARDWARE_IRQ_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,24 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/powman.h
+*
+*   @brief Host build stand-in for the RP2350 power manager header.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_POWMAN_H
+#define HOST_HARDWARE_POWMAN_H
+
+#include "pico/types.h"
+
+typedef uint32_t powman_power_state;
+
+#define POWMAN_POWER_STATE_NONE 0u
+
+#endif /* HOST_HARDWARE_POWMAN_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,45 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/spi.h
+*
+*   @brief Host build stand-in for the Pico SDK SPI header. The SPI instances are plain tags; byte traffic is routed to
+*          the simulated peripheral selected by its chip select line.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_SPI_H
+#define HOST_HARDWARE_SPI_H
+
+#include "pico/types.h"
+
+typedef struct spi_inst {
+    uint8_t index;
+} spi_inst_t;
+
+extern spi_inst_t host_spi_instances[2];
+
+#define spi0 (&host_spi_instances[0])
+#define spi1 (&host_spi_instances[1])
+
+typedef enum {
+    SPI_CPHA_0 = 0,
+    SPI_CPHA_1 = 1
+} spi_cpha_t;
+
+typedef enum {
+    SPI_CPOL_0 = 0,
+    SPI_CPOL_1 = 1
+} spi_cpol_t;
+
+typedef enum {
+    SPI_LSB_FIRST = 0,
+    SPI_MSB_FIRST = 1
+} spi_order_t;
+
+#endif /* HOST_HARDWARE_SPI_H */
+
+/* --- EOF ------------------------------------------------------------------ */
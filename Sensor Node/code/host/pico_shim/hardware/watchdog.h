@@ -0,0 +1,20 @@
+/******************************************************************************************************************** 
+*   
+*   @file hardware/watchdog.h
+*
+*   @brief Host build stand-in for the Pico SDK watchdog header. The host HAL provides the behaviour; nothing is declared here.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+
+#include "pico/types.h"
+
+#endif /* HOST_HARDWARE_WATCHDOG_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,25 @@
+/******************************************************************************************************************** 
+*   
+*   @file pico/rand.h
+*
+*   @brief Host build stand-in for the Pico SDK random number generator. Numbers come from a seeded generator kept in the
+*          shared world state, so runs are repeatable and successive boot cycles do not replay the same sequence.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_PICO_RAND_H
+#define HOST_PICO_RAND_H
+
+#include "pico/types.h"
+
+uint32_t get_rand_32(void);
+
+uint64_t get_rand_64(void);
+
+#endif /* HOST_PICO_RAND_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,30 @@
+/******************************************************************************************************************** 
+*   
+*   @file pico/stdio.h
+*
+*   @brief Host build stand-in for the Pico SDK stdio driver. Console output goes straight to the host's stdout.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_PICO_STDIO_H
+#define HOST_PICO_STDIO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+bool stdio_init_all(void);
+
+bool stdio_deinit_all(void);
+
+void stdio_flush(void);
+
+int getchar_timeout_us(uint32_t timeout_us);
+
+#endif /* HOST_PICO_STDIO_H */
+
+/* --- EOF ------------------------------------------------------------------ */
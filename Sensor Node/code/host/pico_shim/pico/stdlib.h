@@ -0,0 +1,62 @@
+/******************************************************************************************************************** 
+*   
+*   @file pico/stdlib.h
+*
+*   @brief Host build stand-in for the Pico SDK standard library header. Provides only the types, constants and calls
+*          used by the LoRa Water Quality Management System Sensor Node Firmware, backed by the simulated hardware.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// C Standard Library Includes
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pico SDK Stand-ins
+
+#include "pico/types.h"
+#include "pico/time.h"
+#include "pico/stdio.h"
+#include "hardware/gpio.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Error Codes (values match pico/error.h)
+
+#define PICO_OK                     0
+#define PICO_ERROR_NONE             0
+#define PICO_ERROR_GENERIC          -1
+#define PICO_ERROR_TIMEOUT          -2
+#define PICO_ERROR_NO_DATA          -3
+#define PICO_ERROR_INVALID_ARG      -5
+#define PICO_ERROR_IO               -6
+#define PICO_ERROR_INVALID_STATE    -12
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// newlib Extensions Missing From glibc
+
+#define atoff(str) ((float)atof(str))
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* HOST_PICO_STDLIB_H */
+
+/* --- EOF ------------------------------------------------------------------ */
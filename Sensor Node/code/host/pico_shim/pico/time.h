@@ -0,0 +1,60 @@
+/******************************************************************************************************************** 
+*   
+*   @file pico/time.h
+*
+*   @brief Host build stand-in for the Pico SDK time functions. All time is virtual and is kept by the simulation clock,
+*          so sleeps and timeouts complete instantly in wall-clock time while still ordering device events correctly.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_PICO_TIME_H
+#define HOST_PICO_TIME_H
+
+#include "pico/types.h"
+
+/**
+ * @brief Returns the current virtual time. Each call charges a small amount of virtual CPU time so busy-wait loops terminate.
+ */
+absolute_time_t get_absolute_time(void);
+
+absolute_time_t make_timeout_time_us(uint64_t us);
+
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+
+bool time_reached(absolute_time_t t);
+
+uint32_t to_ms_since_boot(absolute_time_t t);
+
+uint64_t to_us_since_boot(absolute_time_t t);
+
+uint64_t time_us_64(void);
+
+uint32_t time_us_32(void);
+
+void sleep_us(uint64_t us);
+
+void sleep_ms(uint32_t ms);
+
+void sleep_until(absolute_time_t t);
+
+void busy_wait_us(uint64_t us);
+
+/**
+ * @brief Sleeps the core until the next simulated device event or the timeout, whichever comes first. As on the RP2350,
+ *        the wake-up may be for an unrelated event, so callers re-check their condition.
+ *
+ * @returns true once the timeout has passed
+ */
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+
+static inline void tight_loop_contents(void) {}
+
+#endif /* HOST_PICO_TIME_H */
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,27 @@
+/******************************************************************************************************************** 
+*   
+*   @file pico/types.h
+*
+*   @brief Host build stand-in for the Pico SDK base types.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_PICO_TYPES_H
+#define HOST_PICO_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+typedef unsigned int uint;
+
+// The firmware compares absolute times directly, which matches the SDK with PICO_OPAQUE_ABSOLUTE_TIME_T disabled.
+typedef uint64_t absolute_time_t;
+
+#endif /* HOST_PICO_TYPES_H */
+
+/* --- EOF ------------------------------------------------------------------ */
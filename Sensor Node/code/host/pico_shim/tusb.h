@@ -0,0 +1,20 @@
+/******************************************************************************************************************** 
+*   
+*   @file tusb.h
+*
+*   @brief Host build stand-in for the TinyUSB header. USB console state is simulated by the host HAL.
+*
+*   @author Matthew Sharp
+*   
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#ifndef HOST_TUSB_H
+#define HOST_TUSB_H
+
+#include "pico/types.h"
+
+#endif /* HOST_TUSB_H */
+
+/* --- EOF ------------------------------------------------------------------ */
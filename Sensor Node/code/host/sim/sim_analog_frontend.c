@@ -0,0 +1,341 @@
+/********************************************************************************************************************
+*
+*   @file sim_analog_frontend.c
+*
+*   @brief Model of the sensor node's analog front end. The instrumentation amplifier follows the same transfer function
+*          the firmware assumes, Vout = (Vin + Vdc+ - Vdc-) * G + Vref, with G = 1 + 2 R0 / Rg, but is computed from the
+*          physical potentiometer values (including wiper resistance) rather than from the calibration tables.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+#include <string.h>
+#include <math.h>
+
+#pragma region Definitions
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define MCP4651_REG_WIPER0  0x0
+#define MCP4651_REG_WIPER1  0x1
+#define MCP4651_REG_TCON    0x4
+#define MCP4651_REG_STATUS  0x5
+
+#define MCP4651_OP_WRITE    0x0
+#define MCP4651_OP_INC      0x1
+#define MCP4651_OP_DEC      0x2
+#define MCP4651_OP_READ     0x3
+
+#define MCP3425_RDY         (1 << 7)
+#define MCP3425_OC          (1 << 4)
+#define MCP3425_POR_CFG     0x10        // Continuous, 240 SPS, PGA x1
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Analog Model
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Analog Model
+
+static double wiper_fraction(uint16_t wiper) {
+    return (double)wiper / SIM_AFE_DIGIPOT_MAX_WIPER;
+}
+
+static double rheostat_aw(uint16_t wiper) {
+    return SIM_AFE_DIGIPOT_R_AB * (1.0 - wiper_fraction(wiper)) + SIM_AFE_DIGIPOT_R_W;
+}
+
+double sim_afe_output_voltage(const sim_analog_frontend_t *afe) {
+    if (!afe->powered) return 0.0;
+
+    const sim_mcp4651_t *offset = &afe->digipot[SIM_AFE_DIGIPOT_OFFSET];
+    const sim_mcp4651_t *gain = &afe->digipot[SIM_AFE_DIGIPOT_GAIN];
+    const sim_mcp4651_t *reference = &afe->digipot[SIM_AFE_DIGIPOT_REFERENCE];
+
+    double v_in = 0.0;
+    if (!afe->mux.enable_n) {
+        v_in = afe->input_v[(afe->mux.sel1 ? 2 : 0) | (afe->mux.sel0 ? 1 : 0)];
+    }
+
+    double v_dc_pos = SIM_AFE_DC_OFFSET_SUPPLY * wiper_fraction(offset->wiper[0]);
+    double v_dc_neg = SIM_AFE_DC_OFFSET_SUPPLY * wiper_fraction(offset->wiper[1]);
+    double r_gain = rheostat_aw(gain->wiper[0]) + rheostat_aw(gain->wiper[1]);
+    double g = 1.0 + (2.0 * SIM_AFE_INST_AMP_R0) / r_gain;
+    double v_ref = SIM_AFE_REFERENCE_CEILING * wiper_fraction(reference->wiper[1]);
+
+    double v_out = (v_in + v_dc_pos - v_dc_neg) * g + v_ref;
+
+    // The amplifier output saturates at its rails.
+    if (v_out < 0.0) v_out = 0.0;
+    if (v_out > SIM_AFE_SUPPLY) v_out = SIM_AFE_SUPPLY;
+
+    return v_out;
+}
+
+double sim_afe_ideal_calibration_entry(int table, int wiper_index) {
+    double fraction = wiper_fraction(wiper_index);
+
+    switch (table) {
+        case 0:     // DC+ offset wiper voltage
+        case 1:     // DC- offset wiper voltage
+            return SIM_AFE_DC_OFFSET_SUPPLY * fraction;
+        case 2:     // Upper gain rheostat, W-B resistance
+        case 3:     // Lower gain rheostat, W-B resistance
+            return SIM_AFE_DIGIPOT_R_AB * fraction;
+        case 4:     // Reference top wiper voltage
+            return SIM_AFE_DC_OFFSET_SUPPLY * fraction;
+        case 5:     // Reference output wiper voltage
+            return SIM_AFE_REFERENCE_CEILING * fraction;
+        default:
+            return 0.0;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region MCP3425
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// MCP3425
+
+static uint64_t adc_conversion_time_us(uint8_t cfg) {
+    switch ((cfg >> 2) & 0x3) {
+        case 0:  return 1000000 / 240;
+        case 1:  return 1000000 / 60;
+        default: return 1000000 / 15;
+    }
+}
+
+static int16_t adc_convert(const sim_analog_frontend_t *afe, uint8_t cfg) {
+    int bits = 12 + 2 * (((cfg >> 2) & 0x3) > 2 ? 2 : ((cfg >> 2) & 0x3));
+    int pga = 1 << (cfg & 0x3);
+    double full_scale = (double)(1 << (bits - 1));
+    double code = round(sim_afe_output_voltage(afe) * pga / SIM_AFE_ADC_VREF * full_scale);
+
+    if (code > full_scale - 1) code = full_scale - 1;
+    if (code < -full_scale) code = -full_scale;
+
+    return (int16_t)code;
+}
+
+static void adc_start_conversion(sim_analog_frontend_t *afe) {
+    sim_mcp3425_t *adc = &afe->adc;
+
+    adc->conversion_done_us = host_sim_now_us() + adc_conversion_time_us(adc->cfg);
+    adc->conversion_pending = true;
+}
+
+static void adc_update(sim_analog_frontend_t *afe) {
+    sim_mcp3425_t *adc = &afe->adc;
+
+    if (adc->conversion_pending && (host_sim_now_us() >= adc->conversion_done_us)) {
+        adc->result = adc_convert(afe, adc->cfg);
+        adc->conversion_pending = false;
+        adc->new_data = true;
+        adc->conversions++;
+
+        // In continuous mode the next conversion starts straight away.
+        if (adc->cfg & MCP3425_OC) adc_start_conversion(afe);
+    }
+}
+
+static int adc_write(sim_analog_frontend_t *afe, const uint8_t *data, uint32_t len) {
+    sim_mcp3425_t *adc = &afe->adc;
+
+    if (len == 0) return 0;
+
+    uint8_t cfg = data[len - 1];
+    adc->cfg = cfg & 0x7F;
+
+    // A write in continuous mode, or a write with RDY set in one-shot mode, starts a new conversion.
+    if ((adc->cfg & MCP3425_OC) || (cfg & MCP3425_RDY)) {
+        adc_start_conversion(afe);
+    }
+
+    return len;
+}
+
+static int adc_read(sim_analog_frontend_t *afe, uint8_t *data, uint32_t len) {
+    sim_mcp3425_t *adc = &afe->adc;
+
+    adc_update(afe);
+
+    // RDY reads back as 0 only for the first read of a fresh result.
+    uint8_t cfg = adc->cfg | (adc->new_data ? 0 : MCP3425_RDY);
+    uint8_t frame[3] = {(uint8_t)((uint16_t)adc->result >> 8), (uint8_t)(adc->result & 0xff), cfg};
+
+    for (uint32_t k = 0; k < len; k++) {
+        data[k] = (k < 3) ? frame[k] : cfg;     // The configuration byte repeats for longer reads
+    }
+
+    if (len >= 3) adc->new_data = false;
+
+    return len;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region MCP4651
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// MCP4651
+
+static void digipot_step(sim_mcp4651_t *pot, uint8_t reg, int delta) {
+    if (reg > MCP4651_REG_WIPER1) return;
+
+    int position = (int)pot->wiper[reg] + delta;
+    if (position < 0) position = 0;
+    if (position > SIM_AFE_DIGIPOT_MAX_WIPER) position = SIM_AFE_DIGIPOT_MAX_WIPER;
+
+    pot->wiper[reg] = (uint16_t)position;
+}
+
+static int digipot_write(sim_mcp4651_t *pot, const uint8_t *data, uint32_t len) {
+    uint32_t k = 0;
+
+    while (k < len) {
+        uint8_t reg = (data[k] >> 4) & 0xF;
+        uint8_t op = (data[k] >> 2) & 0x3;
+        uint16_t high_bits = data[k] & 0x3;
+
+        pot->last_reg = reg;
+
+        switch (op) {
+            case MCP4651_OP_WRITE:
+                if (k + 1 >= len) return -1;    // Incomplete write command - the device NAKs
+                uint16_t value = (high_bits << 8) | data[k + 1];
+                if (reg <= MCP4651_REG_WIPER1) {
+                    pot->wiper[reg] = value > SIM_AFE_DIGIPOT_MAX_WIPER ? SIM_AFE_DIGIPOT_MAX_WIPER : value;
+                }
+                else if (reg == MCP4651_REG_TCON) {
+                    pot->tcon = value;
+                }
+                k += 2;
+                break;
+            case MCP4651_OP_INC:
+                digipot_step(pot, reg, 1);
+                k += 1;
+                break;
+            case MCP4651_OP_DEC:
+                digipot_step(pot, reg, -1);
+                k += 1;
+                break;
+            default:
+                k += 1;
+                break;
+        }
+    }
+
+    return len;
+}
+
+static int digipot_read(sim_mcp4651_t *pot, uint8_t *data, uint32_t len) {
+    uint16_t value = 0;
+
+    if (pot->last_reg <= MCP4651_REG_WIPER1) value = pot->wiper[pot->last_reg];
+    else if (pot->last_reg == MCP4651_REG_TCON) value = pot->tcon;
+
+    for (uint32_t k = 0; k < len; k++) {
+        data[k] = (k & 1) ? (value & 0xff) : ((value >> 8) & 0x1);
+    }
+
+    return len;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Bus & Power
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Bus & Power
+
+static sim_mcp4651_t *find_digipot(sim_analog_frontend_t *afe, uint8_t addr) {
+    for (int k = 0; k < SIM_AFE_QTY_DIGIPOTS; k++) {
+        if (afe->digipot[k].addr == addr) return &afe->digipot[k];
+    }
+
+    return NULL;
+}
+
+void sim_afe_init(sim_analog_frontend_t *afe, const uint8_t digipot_addrs[SIM_AFE_QTY_DIGIPOTS], uint8_t adc_addr) {
+    memset(afe, 0, sizeof(*afe));
+
+    for (int k = 0; k < SIM_AFE_QTY_DIGIPOTS; k++) {
+        afe->digipot[k].addr = digipot_addrs[k];
+    }
+    afe->adc.addr = adc_addr;
+
+    afe->mux.enable_n = true;
+
+    afe->input_v[0] = SIM_AFE_DEFAULT_TURBIDITY_V;
+    afe->input_v[1] = SIM_AFE_DEFAULT_PH_V;
+    afe->input_v[2] = SIM_AFE_DEFAULT_TEMPERATURE_V;
+    afe->input_v[3] = 0.0;
+}
+
+void sim_afe_set_power(sim_analog_frontend_t *afe, bool on) {
+    if (on == afe->powered) return;
+
+    afe->powered = on;
+
+    if (on) {
+        for (int k = 0; k < SIM_AFE_QTY_DIGIPOTS; k++) {
+            afe->digipot[k].wiper[0] = SIM_AFE_DIGIPOT_MAX_WIPER / 2;
+            afe->digipot[k].wiper[1] = SIM_AFE_DIGIPOT_MAX_WIPER / 2;
+            afe->digipot[k].tcon = 0x1FF;
+            afe->digipot[k].last_reg = MCP4651_REG_WIPER0;
+        }
+
+        afe->adc.cfg = MCP3425_POR_CFG;
+        afe->adc.result = 0;
+        afe->adc.new_data = false;
+        adc_start_conversion(afe);
+    }
+}
+
+void sim_afe_set_mux(sim_analog_frontend_t *afe, bool enable_n, bool sel0, bool sel1) {
+    afe->mux.enable_n = enable_n;
+    afe->mux.sel0 = sel0;
+    afe->mux.sel1 = sel1;
+}
+
+int sim_afe_i2c_write(sim_analog_frontend_t *afe, uint8_t addr, const uint8_t *data, uint32_t len) {
+    if (!afe->powered) return -1;
+
+    if (addr == afe->adc.addr) return adc_write(afe, data, len);
+
+    sim_mcp4651_t *pot = find_digipot(afe, addr);
+    if (pot != NULL) return digipot_write(pot, data, len);
+
+    return -1;
+}
+
+int sim_afe_i2c_read(sim_analog_frontend_t *afe, uint8_t addr, uint8_t *data, uint32_t len) {
+    if (!afe->powered) return -1;
+
+    if (addr == afe->adc.addr) return adc_read(afe, data, len);
+
+    sim_mcp4651_t *pot = find_digipot(afe, addr);
+    if (pot != NULL) return digipot_read(pot, data, len);
+
+    return -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,131 @@
+/********************************************************************************************************************
+*
+*   @file sim_clock.c
+*
+*   @brief Virtual clock and device event queue of the host-native simulation. Time only moves when the firmware spends
+*          it (sleeping, polling, clocking bytes on a bus), and device events fire in time order as it does.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+host_world_t *host_world = NULL;
+
+// Set while device events are being dispatched. Firmware code reached from an event (an ISR) takes no virtual time.
+static bool dispatching = false;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Event Queue
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Event Queue
+
+int host_sim_schedule(uint64_t due_us, host_sim_event_cb_t callback, void *arg) {
+    for (int k = 0; k < HOST_SIM_MAX_EVENTS; k++) {
+        host_sim_event_t *ev = &host_world->events[k];
+
+        if (!ev->pending) {
+            ev->pending = true;
+            ev->due_us = due_us;
+            ev->seq = host_world->event_seq++;
+            ev->callback = callback;
+            ev->arg = arg;
+
+            if (due_us < host_world->next_due_us) host_world->next_due_us = due_us;
+
+            return k;
+        }
+    }
+
+    return -1;
+}
+
+void host_sim_cancel(int handle) {
+    if ((handle < 0) || (handle >= HOST_SIM_MAX_EVENTS)) return;
+
+    host_world->events[handle].pending = false;
+    host_world->next_due_us = host_sim_next_event_us();
+}
+
+static int next_event(void) {
+    int best = -1;
+
+    for (int k = 0; k < HOST_SIM_MAX_EVENTS; k++) {
+        const host_sim_event_t *ev = &host_world->events[k];
+
+        if (!ev->pending) continue;
+
+        if ((best < 0) ||
+            (ev->due_us < host_world->events[best].due_us) ||
+            ((ev->due_us == host_world->events[best].due_us) && (ev->seq < host_world->events[best].seq))) {
+            best = k;
+        }
+    }
+
+    return best;
+}
+
+uint64_t host_sim_next_event_us(void) {
+    int k = next_event();
+
+    return (k < 0) ? UINT64_MAX : host_world->events[k].due_us;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Clock
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Clock
+
+uint64_t host_sim_now_us(void) {
+    return host_world->now_us;
+}
+
+void host_sim_advance_to_us(uint64_t t_us) {
+    if (dispatching || (t_us <= host_world->now_us)) return;
+
+    dispatching = true;
+
+    while (host_world->next_due_us <= t_us) {
+        int k = next_event();
+
+        if (k < 0) break;
+
+        host_sim_event_t *ev = &host_world->events[k];
+
+        if (ev->due_us > host_world->now_us) host_world->now_us = ev->due_us;
+        ev->pending = false;
+        host_world->next_due_us = host_sim_next_event_us();
+        ev->callback(ev->arg);
+    }
+
+    host_world->now_us = t_us;
+
+    dispatching = false;
+
+    // A watchdog that was not fed in time resets the chip.
+    if (host_world->watchdog_enabled && (host_world->now_us >= host_world->watchdog_deadline_us)) {
+        host_sim_end_boot_cycle(HOST_EXIT_WATCHDOG);
+    }
+}
+
+void host_sim_advance_us(uint64_t us) {
+    host_sim_advance_to_us(host_world->now_us + us);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,265 @@
+/********************************************************************************************************************
+*
+*   @file sim_lora_channel.c
+*
+*   @brief Model of the LoRa link between the simulated sensor node radio and the far end of the link. Computes the
+*          time-on-air of each frame from the transmitter's modulation and packet parameters, applies the configured
+*          loss, corruption and latency, and hands the frame to the receiver when its first symbol arrives.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define HEADER_TYPE_EXPLICIT 0x00   // SetPacketParams HeaderType, 0x01 = implicit
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma region Time On Air
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Time On Air
+
+// Bandwidths in Hz, indexed by the SetModulationParams BW code
+static const double bandwidth_hz[] = {
+    [0x00] = 7810.0,
+    [0x01] = 15630.0,
+    [0x02] = 31250.0,
+    [0x03] = 62500.0,
+    [0x04] = 125000.0,
+    [0x05] = 250000.0,
+    [0x06] = 500000.0,
+    [0x08] = 10420.0,
+    [0x09] = 20830.0,
+    [0x0A] = 41670.0,
+};
+
+double sim_lora_symbol_time_us(const sim_lora_cfg_t *cfg) {
+    double bw = (cfg->bw < (sizeof(bandwidth_hz) / sizeof(bandwidth_hz[0]))) ? bandwidth_hz[cfg->bw] : 0.0;
+
+    if (bw == 0.0) bw = bandwidth_hz[0x04];
+
+    return ((double)(1u << cfg->sf) / bw) * 1e6;
+}
+
+/**
+ * @brief Returns the number of symbols from the start of the preamble to the end of the sync word.
+ */
+static double preamble_symbols(const sim_lora_cfg_t *cfg) {
+    // SF5 and SF6 carry two extra sync symbols (datasheet 6.1.4)
+    return cfg->preamble_len + ((cfg->sf < 7) ? 6.25 : 4.25);
+}
+
+uint64_t sim_lora_time_on_air_us(const sim_lora_cfg_t *cfg, uint8_t len) {
+    int sf = cfg->sf;
+    int explicit_header = (cfg->header_type == HEADER_TYPE_EXPLICIT) ? 1 : 0;
+    int crc = cfg->crc_on ? 1 : 0;
+    int ldro = cfg->ldro ? 1 : 0;
+    int cr = ((cfg->cr >= 1) && (cfg->cr <= 4)) ? cfg->cr : 1;     // 4/5 .. 4/8
+
+    double numerator;
+    double denominator;
+
+    if (sf < 7) {
+        numerator = (8.0 * len) + (16.0 * crc) - (4.0 * sf) + (20.0 * explicit_header);
+        denominator = 4.0 * sf;
+    }
+    else {
+        numerator = (8.0 * len) + (16.0 * crc) - (4.0 * sf) + 8.0 + (20.0 * explicit_header);
+        denominator = 4.0 * (sf - (2 * ldro));
+    }
+
+    if (numerator < 0.0) numerator = 0.0;
+
+    double symbols = preamble_symbols(cfg) + 8.0 + (ceil(numerator / denominator) * (cr + 4));
+
+    return (uint64_t)ceil(symbols * sim_lora_symbol_time_us(cfg));
+}
+
+uint64_t sim_lora_header_time_us(const sim_lora_cfg_t *cfg) {
+    // The explicit header is carried in the first eight payload symbols.
+    return (uint64_t)ceil((preamble_symbols(cfg) + 8.0) * sim_lora_symbol_time_us(cfg));
+}
+
+bool sim_lora_phy_match(const sim_lora_phy_t *tx_phy, const sim_lora_phy_t *rx_phy) {
+    // Coding rate and CRC are announced in the explicit header, so only the rest has to agree.
+    return (tx_phy->rf_freq == rx_phy->rf_freq) &&
+           (tx_phy->lora.sf == rx_phy->lora.sf) &&
+           (tx_phy->lora.bw == rx_phy->lora.bw) &&
+           (tx_phy->lora.ldro == rx_phy->lora.ldro) &&
+           (tx_phy->lora.header_type == rx_phy->lora.header_type) &&
+           (tx_phy->lora.invert_iq == rx_phy->lora.invert_iq) &&
+           ((tx_phy->sync_word[0] & 0xF0) == (rx_phy->sync_word[0] & 0xF0)) &&
+           ((tx_phy->sync_word[1] & 0xF0) == (rx_phy->sync_word[1] & 0xF0));
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Link
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Link
+
+void sim_lora_channel_init(sim_lora_channel_t *channel, uint64_t seed) {
+    memset(channel, 0, sizeof(*channel));
+
+    for (int dir = SIM_LORA_DIR_UPLINK; dir <= SIM_LORA_DIR_DOWNLINK; dir++) {
+        channel->link[dir].rssi_dbm = -60;
+        channel->link[dir].snr_db = 8;
+    }
+
+    // xorshift64* must not start from zero
+    channel->rng_state = seed ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+double sim_lora_channel_random(sim_lora_channel_t *channel) {
+    uint64_t x = channel->rng_state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    channel->rng_state = x;
+
+    return (double)((x * 0x2545F4914F6CDD1Dull) >> 11) / (double)(1ull << 53);
+}
+
+static void on_frame_arrival(void *arg) {
+    sim_lora_frame_t *frame = (sim_lora_frame_t *)arg;
+    sim_lora_channel_t *channel = &host_world->channel;
+
+    // Receivers take a copy, so the slot is free again as soon as they have seen the frame.
+    if (frame->dir == SIM_LORA_DIR_UPLINK) {
+        sim_lora_peer_frame_arrival(&host_world->peer, frame);
+
+        for (int k = 0; k < host_world->qty_nodes; k++) sim_lora_peer_frame_arrival(&host_world->nodes[k], frame);
+    }
+    else {
+        sim_sx1262_frame_arrival(&host_world->radio, frame);
+    }
+
+    channel->in_flight_used[frame - channel->in_flight] = false;
+}
+
+uint64_t sim_lora_channel_transmit(sim_lora_channel_t *channel, sim_lora_dir_t dir, const sim_lora_phy_t *phy, const uint8_t *payload, uint8_t len, uint8_t path_loss_db) {
+    const sim_lora_link_cfg_t *link = &channel->link[dir];
+    sim_lora_link_stats_t *stats = &channel->stats[dir];
+    uint64_t toa_us = sim_lora_time_on_air_us(&phy->lora, len);
+
+    sim_lora_tx_state_t *tx = &channel->tx[dir];
+
+    stats->frames++;
+    stats->airtime_us += toa_us;
+
+    tx->seq++;
+    tx->start_us = host_sim_now_us();
+    tx->end_us = tx->start_us + toa_us;
+
+    if (sim_lora_channel_random(channel) < link->loss_prob) {
+        stats->lost++;
+        return toa_us;
+    }
+
+    int rssi_dbm = link->rssi_dbm - path_loss_db;
+    int snr_db = link->snr_db - path_loss_db;
+
+    if (link->fading_db > 0) {
+        int fade_db = (int)(sim_lora_channel_random(channel) * ((2 * link->fading_db) + 1)) - link->fading_db;
+        rssi_dbm += fade_db;
+        snr_db += fade_db;
+    }
+
+    // Each step up in spreading factor lets the receiver demodulate 2.5 dB further below the noise, from -2.5 dB at SF5.
+    if ((snr_db * 10) < (-25 * ((int)phy->lora.sf - 4))) {
+        stats->lost++;
+        stats->below_floor++;
+        return toa_us;
+    }
+
+    int slot = -1;
+    for (int k = 0; k < SIM_LORA_MAX_IN_FLIGHT; k++) {
+        if (!channel->in_flight_used[k]) {
+            slot = k;
+            break;
+        }
+    }
+
+    // More frames in the air than the model tracks can only be a collision; treat it as a loss.
+    if (slot < 0) {
+        stats->lost++;
+        return toa_us;
+    }
+
+    sim_lora_frame_t *frame = &channel->in_flight[slot];
+
+    frame->dir = dir;
+    frame->seq = tx->seq;
+    frame->phy = *phy;
+    frame->phy.lora.payload_len = len;
+    memcpy(frame->payload, payload, len);
+    frame->len = len;
+    frame->rssi_dbm = (int8_t)rssi_dbm;
+    frame->snr_db = (int8_t)snr_db;
+    frame->corrupted = false;
+
+    if ((len > 0) && (sim_lora_channel_random(channel) < link->corrupt_prob)) {
+        // A burst of interference flips one bit of the payload.
+        uint32_t bit = (uint32_t)(sim_lora_channel_random(channel) * len * 8);
+        frame->payload[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        frame->corrupted = true;
+        stats->corrupted++;
+    }
+
+    uint64_t latency_us = link->latency_us;
+    if (link->jitter_us > 0) latency_us += (uint64_t)(sim_lora_channel_random(channel) * link->jitter_us);
+
+    frame->start_us = host_sim_now_us() + latency_us;
+    frame->end_us = frame->start_us + toa_us;
+
+    if (host_sim_schedule(frame->start_us, on_frame_arrival, frame) >= 0) {
+        channel->in_flight_used[slot] = true;
+    }
+    else {
+        stats->lost++;
+    }
+
+    return toa_us;
+}
+
+void sim_lora_channel_abort(sim_lora_channel_t *channel, sim_lora_dir_t dir) {
+    sim_lora_tx_state_t *tx = &channel->tx[dir];
+    uint64_t now = host_sim_now_us();
+
+    if ((tx->seq == 0) || (now >= tx->end_us)) return;
+
+    tx->aborted_seq = tx->seq;
+    tx->aborted_fraction = (double)(now - tx->start_us) / (double)(tx->end_us - tx->start_us);
+}
+
+void sim_lora_channel_finish_frame(sim_lora_channel_t *channel, sim_lora_frame_t *frame) {
+    const sim_lora_tx_state_t *tx = &channel->tx[frame->dir];
+
+    if ((frame->seq == 0) || (frame->seq != tx->aborted_seq)) return;
+
+    // Whatever the receiver demodulates after the carrier dropped is noise.
+    for (uint32_t k = (uint32_t)(tx->aborted_fraction * frame->len); k < frame->len; k++) {
+        frame->payload[k] = (uint8_t)(sim_lora_channel_random(channel) * 256);
+    }
+
+    frame->corrupted = true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,291 @@
+/********************************************************************************************************************
+*
+*   @file sim_lora_peer.c
+*
+*   @brief Model of the far end of the sensor node's LoRa link. Frames are encoded and decoded with the firmware's own
+*          LWQMS packet functions, so the peer speaks exactly the protocol the gateway does.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+#include "lwqms_pkt.h"
+#include "rdt3_hal.h"
+#include "system_config.h"
+
+#include <string.h>
+
+#pragma region Helpers
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Helpers
+
+static void peer_transmit(sim_lora_peer_t *peer, const uint8_t *buf, uint8_t len) {
+    uint8_t frame[SIM_LORA_MAX_PAYLOAD];
+
+    // Half duplex: keying up abandons any frame being received.
+    if (peer->receiving) {
+        host_sim_cancel(peer->rx_event);
+        peer->rx_event = -1;
+        peer->receiving = false;
+        peer->stats.frames_missed++;
+    }
+
+    // Every packet on the air carries the CRC-16 trailer, as the firmware's radio HAL sends it.
+    memcpy(frame, buf, len);
+    len = lwqms_pkt_crc_append(frame, len);
+
+    uint64_t toa_us = sim_lora_channel_transmit(&host_world->channel, SIM_LORA_DIR_DOWNLINK, &peer->phy, frame, len, peer->path_loss_db);
+    peer->tx_busy_until_us = host_sim_now_us() + toa_us;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Responder
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Responder
+
+static void on_ack_due(void *arg) {
+    sim_lora_peer_t *peer = (sim_lora_peer_t *)arg;
+
+    peer->ack_event = -1;
+    peer_transmit(peer, peer->ack, peer->ack_len);
+    peer->stats.acks_sent++;
+}
+
+static void respond_to_data(sim_lora_peer_t *peer, sim_lora_frame_t *frame, uint8_t len, bool corrupted) {
+    // The gateway runs the firmware's own receive path, so ACK generation, NACKs and duplicate suppression are the real ones.
+    node_config_t gateway_config = {.ID = peer->id};
+    lora_setup_t gateway_setup = {.node_config = &gateway_config};
+    lora_pkt_t received = {.len = len, .corrupted = corrupted};
+    lora_pkt_t ack;
+
+    memcpy(received.buf, frame->payload, len);
+
+    if (!corrupted) peer->stats.data_received++;
+
+    rdt3_0_ack_t status = rdt3_0_process_data_packet_hal(&received, &ack, &gateway_setup);
+
+    // A packet received before means our ACK never made it back.
+    if ((status == RDT3_0_ACK_DUPLICATE) || (status == RDT3_0_ACK_DUPLICATE_DEFERRED)) peer->stats.duplicates++;
+
+    if (status == RDT3_0_NACK) peer->stats.nacks_sent++;
+    else if ((status != RDT3_0_ACK) && (status != RDT3_0_ACK_DUPLICATE)) return;
+
+    memcpy(peer->ack, ack.buf, ack.len);
+    peer->ack_len = ack.len;
+
+    host_sim_cancel(peer->ack_event);
+    peer->ack_event = host_sim_schedule(host_sim_now_us() + peer->turnaround_us, on_ack_due, peer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Sender
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Sender
+
+static void on_send_timer(void *arg);
+
+static uint64_t send_jitter_us(sim_lora_peer_t *peer) {
+    if (peer->send_jitter_us == 0) return 0;
+
+    return (uint64_t)(sim_lora_channel_random(&host_world->channel) * peer->send_jitter_us);
+}
+
+static void finish_packet(sim_lora_peer_t *peer) {
+    peer->awaiting_ack = false;
+    peer->attempts = 0;
+
+    if (peer->send_remaining > 0) peer->send_remaining--;
+
+    if (peer->send_remaining == 0) peer->done_us = host_sim_now_us();
+
+    if (peer->send_remaining > 0) {
+        peer->send_event = host_sim_schedule(host_sim_now_us() + peer->send_interval_us + send_jitter_us(peer), on_send_timer, peer);
+    }
+}
+
+static void on_send_timer(void *arg) {
+    sim_lora_peer_t *peer = (sim_lora_peer_t *)arg;
+
+    peer->send_event = -1;
+
+    if (peer->awaiting_ack && (peer->attempts >= peer->max_attempts)) {
+        peer->stats.data_abandoned++;
+        finish_packet(peer);
+        return;
+    }
+
+    if (peer->attempts == 0) {
+        lwqms_pkt_t pkt = {
+            .pkt_id = peer->next_pkt_id++,
+            .dest_id = peer->remote_id,
+            .src_id = peer->id,
+            .packet_type = LWQMS_PACKET_TYPE_TELEMETRY,
+            .payload = {
+                .telemetry = {
+                    .turbidity_measurement = 13.0f,
+                    .temperature_measurement = 18.0f,
+                    .pH_measurement = 7.0f
+                }
+            }
+        };
+
+        lwqms_pkt_encode(&pkt, peer->pending, sizeof(peer->pending));
+        peer->pending_len = LWQMS_PKT_LEN_MAX;
+        peer->first_sent_us = host_sim_now_us();
+    }
+    else {
+        peer->stats.retransmissions++;
+    }
+
+    peer_transmit(peer, peer->pending, peer->pending_len);
+    peer->attempts++;
+    peer->awaiting_ack = true;
+    peer->stats.data_sent++;
+
+    peer->send_event = host_sim_schedule(peer->tx_busy_until_us + peer->ack_timeout_us + send_jitter_us(peer), on_send_timer, peer);
+}
+
+static void accept_ack(sim_lora_peer_t *peer, lwqms_pkt_t *pkt) {
+    uint16_t acked_id;
+    lwqms_pkt_t pending_pkt;
+
+    if (!peer->awaiting_ack) return;
+
+    lwqms_pkt_ack_status_t ack_status = lwqms_pkt_check_ack(pkt, &acked_id);
+
+    lwqms_pkt_decode(peer->pending, peer->pending_len, &pending_pkt);
+    if (acked_id != pending_pkt.pkt_id) return;
+
+    if (ack_status == LWQMS_PKT_ACK_STATUS_NACK) {
+        // Damaged on the way: send it again without waiting out the ACK timeout.
+        peer->stats.nacks_received++;
+        host_sim_cancel(peer->send_event);
+        peer->send_event = host_sim_schedule(host_sim_now_us() + peer->turnaround_us, on_send_timer, peer);
+        return;
+    }
+
+    if (ack_status != LWQMS_PKT_ACK_STATUS_ACK) return;
+
+    peer->stats.data_acked++;
+    peer->stats.ack_latency_total_us += host_sim_now_us() - peer->first_sent_us;
+
+    host_sim_cancel(peer->send_event);
+    peer->send_event = -1;
+    finish_packet(peer);
+}
+
+void sim_lora_peer_start_sending(sim_lora_peer_t *peer, uint16_t remote_id, uint32_t count, uint32_t interval_us) {
+    peer->mode = SIM_LORA_PEER_SENDER;
+    peer->remote_id = remote_id;
+    peer->send_remaining = count;
+    peer->send_interval_us = interval_us;
+    peer->attempts = 0;
+    peer->awaiting_ack = false;
+
+    host_sim_cancel(peer->send_event);
+    peer->send_event = (count > 0) ? host_sim_schedule(host_sim_now_us() + interval_us + send_jitter_us(peer), on_send_timer, peer) : -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Receiver
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Receiver
+
+static void on_frame_end(void *arg) {
+    sim_lora_peer_t *peer = (sim_lora_peer_t *)arg;
+    sim_lora_frame_t *frame = &peer->rx_frame;
+    lwqms_pkt_t pkt;
+
+    peer->rx_event = -1;
+    peer->receiving = false;
+    peer->stats.frames_heard++;
+
+    sim_lora_channel_finish_frame(&host_world->channel, frame);
+
+    // The radio's CRC, when on, and the packet's own trailer must both pass.
+    bool corrupted = (frame->corrupted && frame->phy.lora.crc_on) || !lwqms_pkt_crc_check(frame->payload, frame->len);
+    uint8_t len = corrupted ? frame->len : (frame->len - LWQMS_PKT_CRC_LEN);
+
+    if (corrupted) {
+        peer->stats.crc_errors++;
+        if (peer->mode == SIM_LORA_PEER_RESPONDER) respond_to_data(peer, frame, len, true);
+        return;
+    }
+
+    if (!lwqms_pkt_decode(frame->payload, len, &pkt) || (pkt.dest_id != peer->id)) {
+        peer->stats.not_addressed++;
+        return;
+    }
+
+    uint16_t acked_id;
+    if (lwqms_pkt_check_ack(&pkt, &acked_id) != LWQMS_PKT_ACK_STATUS_NONE) {
+        if (peer->mode == SIM_LORA_PEER_SENDER) accept_ack(peer, &pkt);
+        return;
+    }
+
+    if (peer->mode == SIM_LORA_PEER_RESPONDER) respond_to_data(peer, frame, len, false);
+}
+
+void sim_lora_peer_frame_arrival(sim_lora_peer_t *peer, const sim_lora_frame_t *frame) {
+    if ((peer->mode == SIM_LORA_PEER_OFF) || peer->receiving || (host_sim_now_us() < peer->tx_busy_until_us) ||
+        !sim_lora_phy_match(&frame->phy, &peer->phy)) {
+        peer->stats.frames_missed++;
+        return;
+    }
+
+    peer->rx_frame = *frame;
+    peer->receiving = true;
+    peer->rx_event = host_sim_schedule(frame->end_us, on_frame_end, peer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Setup
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Setup
+
+void sim_lora_peer_sync_word_regs(uint8_t sync_word, uint8_t regs[2]) {
+    // Power-on values of 0x0740/0x0741 are 0x14/0x24
+    regs[0] = (sync_word & 0xF0) | 0x04;
+    regs[1] = ((sync_word & 0x0F) << 4) | 0x04;
+}
+
+void sim_lora_peer_init(sim_lora_peer_t *peer, uint16_t id, const sim_lora_phy_t *phy) {
+    memset(peer, 0, sizeof(*peer));
+
+    peer->mode = SIM_LORA_PEER_RESPONDER;
+    peer->id = id;
+    peer->phy = *phy;
+    peer->turnaround_us = SIM_LORA_PEER_DEFAULT_TURNAROUND_US;
+    peer->ack_timeout_us = SIM_LORA_PEER_DEFAULT_ACK_TIMEOUT_US;
+    peer->max_attempts = SIM_LORA_PEER_DEFAULT_MAX_ATTEMPTS;
+    peer->next_pkt_id = 1;
+    peer->rx_event = -1;
+    peer->ack_event = -1;
+    peer->send_event = -1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
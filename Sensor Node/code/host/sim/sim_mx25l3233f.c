@@ -0,0 +1,227 @@
+/********************************************************************************************************************
+*
+*   @file sim_mx25l3233f.c
+*
+*   @brief In-memory model of the Macronix MX25L3233F serial NOR flash. Supports the command subset used by the
+*          mxl23l3233f driver: READ, RDSR, WREN/WRDI, page program, sector/block/chip erase, deep power down and ID reads.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+#include <string.h>
+
+#pragma region Definitions
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Commands
+
+#define CMD_READ            0x03
+#define CMD_WREN            0x06
+#define CMD_WRDI            0x04
+#define CMD_RDSR            0x05
+#define CMD_PP              0x02
+#define CMD_SE              0x20
+#define CMD_BE32K           0x52
+#define CMD_BE64K           0xD8
+#define CMD_CE              0xC7
+#define CMD_CE_ALT          0x60
+#define CMD_DP              0xB9
+#define CMD_RDP_RES         0xAB
+#define CMD_RDID            0x9F
+
+#define STATUS_WIP          (1 << 0)
+#define STATUS_WEL          (1 << 1)
+
+#define JEDEC_MFG_ID        0xC2
+#define JEDEC_MEMORY_TYPE   0x20
+#define JEDEC_DENSITY       0x16
+#define ELECTRONIC_ID       0x15
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Helpers
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Helpers
+
+static bool is_busy(const sim_mx25l3233f_t *flash) {
+    return host_sim_now_us() < flash->busy_until_us;
+}
+
+static uint8_t status_register(const sim_mx25l3233f_t *flash) {
+    return (is_busy(flash) ? STATUS_WIP : 0) | (flash->write_enable_latch ? STATUS_WEL : 0);
+}
+
+static uint32_t command_address(const sim_mx25l3233f_t *flash) {
+    return (((uint32_t)flash->cmd[1] << 16) | ((uint32_t)flash->cmd[2] << 8) | flash->cmd[3]) % SIM_MX25L3233F_SIZE;
+}
+
+static void erase(sim_mx25l3233f_t *flash, uint32_t size, uint64_t duration_us) {
+    uint32_t start = command_address(flash) & ~(size - 1);
+
+    memset(&flash->memory[start], 0xFF, size);
+
+    flash->erases++;
+    flash->busy_until_us = host_sim_now_us() + duration_us;
+}
+
+static void page_program(sim_mx25l3233f_t *flash) {
+    uint32_t address = command_address(flash);
+    uint32_t page_start = address & ~(SIM_MX25L3233F_PAGE_SIZE - 1);
+    uint32_t count = flash->page_bytes > SIM_MX25L3233F_PAGE_SIZE ? SIM_MX25L3233F_PAGE_SIZE : flash->page_bytes;
+
+    // Data wraps to the start of the page, and programming can only clear bits.
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t target = page_start + ((address + k) & (SIM_MX25L3233F_PAGE_SIZE - 1));
+        flash->memory[target] &= flash->page_buf[k];
+    }
+
+    flash->programs++;
+    flash->busy_until_us = host_sim_now_us() + SIM_MX25L3233F_PAGE_PROGRAM_US;
+}
+
+static void execute_command(sim_mx25l3233f_t *flash) {
+    uint8_t op = flash->cmd[0];
+
+    if (flash->deep_power_down) {
+        if (op == CMD_RDP_RES) flash->deep_power_down = false;
+        return;
+    }
+
+    // Write and erase commands are ignored while an operation is in progress or without the write enable latch.
+    bool writable = flash->write_enable_latch && !is_busy(flash) && (flash->xfer_len >= 4);
+
+    switch (op) {
+        case CMD_WREN:
+            if (!is_busy(flash)) flash->write_enable_latch = true;
+            break;
+        case CMD_WRDI:
+            if (!is_busy(flash)) flash->write_enable_latch = false;
+            break;
+        case CMD_PP:
+            if (writable) {
+                page_program(flash);
+                flash->write_enable_latch = false;
+            }
+            break;
+        case CMD_SE:
+            if (writable) {
+                erase(flash, 0x1000, SIM_MX25L3233F_SECTOR_ERASE_US);
+                flash->write_enable_latch = false;
+            }
+            break;
+        case CMD_BE32K:
+            if (writable) {
+                erase(flash, 0x8000, SIM_MX25L3233F_BLOCK_32K_ERASE_US);
+                flash->write_enable_latch = false;
+            }
+            break;
+        case CMD_BE64K:
+            if (writable) {
+                erase(flash, 0x10000, SIM_MX25L3233F_BLOCK_64K_ERASE_US);
+                flash->write_enable_latch = false;
+            }
+            break;
+        case CMD_CE:
+        case CMD_CE_ALT:
+            if (flash->write_enable_latch && !is_busy(flash)) {
+                memset(flash->memory, 0xFF, SIM_MX25L3233F_SIZE);
+                flash->erases++;
+                flash->busy_until_us = host_sim_now_us() + SIM_MX25L3233F_CHIP_ERASE_US;
+                flash->write_enable_latch = false;
+            }
+            break;
+        case CMD_DP:
+            if (!is_busy(flash)) flash->deep_power_down = true;
+            break;
+        case CMD_READ:
+            flash->reads++;
+            break;
+        default:
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Pins & Bus
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pins & Bus
+
+void sim_mx25l3233f_init(sim_mx25l3233f_t *flash) {
+    memset(flash, 0, sizeof(*flash) - sizeof(flash->memory));
+    memset(flash->memory, 0xFF, sizeof(flash->memory));
+    flash->cs = true;
+}
+
+void sim_mx25l3233f_set_cs(sim_mx25l3233f_t *flash, bool level) {
+    if (level == flash->cs) return;
+
+    flash->cs = level;
+
+    if (!level) {
+        flash->xfer_len = 0;
+        flash->page_bytes = 0;
+    }
+    else if (flash->xfer_len > 0) {
+        execute_command(flash);
+    }
+}
+
+uint8_t sim_mx25l3233f_spi_byte(sim_mx25l3233f_t *flash, uint8_t mosi) {
+    if (flash->cs) return 0x00;
+
+    uint32_t idx = flash->xfer_len++;
+
+    if (idx < sizeof(flash->cmd)) flash->cmd[idx] = mosi;
+
+    uint8_t op = flash->cmd[0];
+
+    // In deep power down the chip only listens for the release command.
+    if (flash->deep_power_down) {
+        return ((op == CMD_RDP_RES) && (idx >= 4)) ? ELECTRONIC_ID : 0x00;
+    }
+
+    switch (op) {
+        case CMD_READ:
+            if (idx >= 4) return is_busy(flash) ? 0xFF : flash->memory[(command_address(flash) + idx - 4) % SIM_MX25L3233F_SIZE];
+            break;
+        case CMD_RDSR:
+            if (idx >= 1) return status_register(flash);
+            break;
+        case CMD_RDID:
+            if (idx == 1) return JEDEC_MFG_ID;
+            if (idx == 2) return JEDEC_MEMORY_TYPE;
+            if (idx == 3) return JEDEC_DENSITY;
+            break;
+        case CMD_RDP_RES:
+            if (idx >= 4) return ELECTRONIC_ID;
+            break;
+        case CMD_PP:
+            if (idx >= 4) {
+                // Only the last page worth of data is retained by the chip.
+                flash->page_buf[flash->page_bytes % SIM_MX25L3233F_PAGE_SIZE] = mosi;
+                flash->page_bytes++;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return 0x00;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
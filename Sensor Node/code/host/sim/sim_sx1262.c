@@ -0,0 +1,669 @@
+/********************************************************************************************************************
+*
+*   @file sim_sx1262.c
+*
+*   @brief In-memory model of the Semtech SX1262 LoRa transceiver. Commands are decoded from the SPI byte stream using the
+*          opcodes and frame layouts of the SX1261/2 datasheet, BUSY and DIO1 are driven from the model state, and radio
+*          operations complete through the simulation event queue.
+*
+*   @author Matthew Sharp
+*
+*   @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+*
+*********************************************************************************************************************/
+
+#include "host_sim.h"
+#include <string.h>
+
+#pragma region Definitions
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Opcodes (SX1261/2 datasheet, section 11)
+
+#define OP_SET_SLEEP                0x84
+#define OP_SET_STANDBY              0x80
+#define OP_SET_FS                   0xC1
+#define OP_SET_TX                   0x83
+#define OP_SET_RX                   0x82
+#define OP_SET_REGULATOR_MODE       0x96
+#define OP_CALIBRATE                0x89
+#define OP_CALIBRATE_IMAGE          0x98
+#define OP_SET_PA_CFG               0x95
+#define OP_SET_RX_TX_FALLBACK_MODE  0x93
+#define OP_WRITE_REGISTER           0x0D
+#define OP_READ_REGISTER            0x1D
+#define OP_WRITE_BUFFER             0x0E
+#define OP_READ_BUFFER              0x1E
+#define OP_SET_DIO_IRQ_PARAMS       0x08
+#define OP_GET_IRQ_STATUS           0x12
+#define OP_CLR_IRQ_STATUS           0x02
+#define OP_SET_DIO2_AS_RF_SW_CTRL   0x9D
+#define OP_SET_DIO3_AS_TCXO_CTRL    0x97
+#define OP_SET_RF_FREQUENCY         0x86
+#define OP_SET_PKT_TYPE             0x8A
+#define OP_GET_PKT_TYPE             0x11
+#define OP_SET_TX_PARAMS            0x8E
+#define OP_SET_MODULATION_PARAMS    0x8B
+#define OP_SET_PKT_PARAMS           0x8C
+#define OP_SET_BUFFER_BASE_ADDRESS  0x8F
+#define OP_GET_STATUS               0xC0
+#define OP_GET_RX_BUFFER_STATUS     0x13
+#define OP_GET_PKT_STATUS           0x14
+#define OP_GET_RSSI_INST            0x15
+#define OP_GET_STATS                0x10
+#define OP_GET_DEVICE_ERRORS        0x17
+
+#define IRQ_TX_DONE             (1 << 0)
+#define IRQ_RX_DONE             (1 << 1)
+#define IRQ_PREAMBLE_DETECTED   (1 << 2)
+#define IRQ_SYNC_WORD_VALID     (1 << 3)
+#define IRQ_HEADER_VALID        (1 << 4)
+#define IRQ_CRC_ERROR           (1 << 6)
+#define IRQ_TIMEOUT             (1 << 9)
+
+#define PKT_TYPE_LORA   0x01
+
+#define RTC_STEP_NS     15625   // 1 / 64 kHz
+#define RX_CONTINUOUS   0xFFFFFF
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Helpers
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Helpers
+
+static uint8_t status_byte(const sim_sx1262_t *radio) {
+    return (uint8_t)(((radio->mode & 0x07) << 4) | ((radio->cmd_status & 0x07) << 1));
+}
+
+static void on_busy_end(void *arg);
+
+/**
+ * @brief Drives the BUSY line to its current level, and schedules its falling edge for when the radio will be done.
+ */
+static void update_busy(sim_sx1262_t *radio) {
+    bool level = sim_sx1262_get_busy(radio);
+
+    if (level != radio->busy) {
+        radio->busy = level;
+        host_gpio_drive_input(radio->busy_pin, level);
+    }
+
+    host_sim_cancel(radio->busy_event);
+    radio->busy_event = (level && (host_sim_now_us() < radio->busy_until_us)) ? host_sim_schedule(radio->busy_until_us, on_busy_end, radio) : -1;
+}
+
+static void on_busy_end(void *arg) {
+    sim_sx1262_t *radio = (sim_sx1262_t *)arg;
+
+    radio->busy_event = -1;
+    update_busy(radio);
+}
+
+static void extend_busy(sim_sx1262_t *radio, uint64_t duration_us) {
+    uint64_t until = host_sim_now_us() + duration_us;
+    if (until > radio->busy_until_us) radio->busy_until_us = until;
+
+    update_busy(radio);
+}
+
+static void update_dio1(sim_sx1262_t *radio) {
+    bool level = (radio->irq_status & radio->dio1_mask) != 0;
+
+    if (level != radio->dio1) {
+        radio->dio1 = level;
+        host_gpio_drive_input(radio->dio1_pin, level);
+    }
+}
+
+static double mode_current_ma(const sim_sx1262_t *radio, sim_sx1262_mode_t mode) {
+    switch (mode) {
+        case SIM_SX1262_MODE_SLEEP:
+            return radio->warm_start ? SIM_SX1262_SLEEP_WARM_MA : SIM_SX1262_SLEEP_COLD_MA;
+        case SIM_SX1262_MODE_STDBY_RC:
+            return SIM_SX1262_STDBY_RC_MA;
+        case SIM_SX1262_MODE_STDBY_XOSC:
+            return SIM_SX1262_STDBY_XOSC_MA;
+        case SIM_SX1262_MODE_FS:
+            return SIM_SX1262_FS_MA;
+        case SIM_SX1262_MODE_RX:
+            return SIM_SX1262_RX_MA;
+        case SIM_SX1262_MODE_TX:
+            if (radio->tx_power >= 22) return SIM_SX1262_TX_22DBM_MA;
+            if (radio->tx_power >= 20) return SIM_SX1262_TX_20DBM_MA;
+            if (radio->tx_power >= 17) return SIM_SX1262_TX_17DBM_MA;
+            return SIM_SX1262_TX_14DBM_MA;
+        default:
+            return 0.0;
+    }
+}
+
+/**
+ * @brief Changes the operating mode, charging the time spent in the old one to the energy account.
+ */
+static void set_mode(sim_sx1262_t *radio, sim_sx1262_mode_t mode) {
+    uint64_t now = host_sim_now_us();
+    uint64_t elapsed_us = now - radio->mode_since_us;
+
+    radio->mode_time_us[radio->mode] += elapsed_us;
+    radio->energy_uj += mode_current_ma(radio, radio->mode) * SIM_SX1262_SUPPLY_V * elapsed_us / 1000.0;    // mW x us = nJ
+
+    radio->mode = mode;
+    radio->mode_since_us = now;
+}
+
+static void current_phy(const sim_sx1262_t *radio, sim_lora_phy_t *phy) {
+    phy->lora = radio->lora;
+    phy->rf_freq = radio->rf_freq;
+    phy->sync_word[0] = radio->regs[0x0740];
+    phy->sync_word[1] = radio->regs[0x0741];
+}
+
+static void raise_irq(sim_sx1262_t *radio, uint16_t irq) {
+    radio->irq_status |= (irq & radio->irq_mask);
+    update_dio1(radio);
+}
+
+static void cancel_operation(sim_sx1262_t *radio) {
+    // Leaving TX before TX_DONE drops the carrier in the middle of the frame.
+    if (radio->tx_on_air) {
+        sim_lora_channel_abort(&host_world->channel, SIM_LORA_DIR_UPLINK);
+        radio->tx_on_air = false;
+    }
+
+    host_sim_cancel(radio->op_event);
+    radio->op_event = -1;
+
+    host_sim_cancel(radio->rx_event);
+    radio->rx_event = -1;
+    radio->rx_locked = false;
+}
+
+static void load_default_registers(sim_sx1262_t *radio) {
+    memset(radio->regs, 0x00, sizeof(radio->regs));
+    radio->regs[0x0740] = 0x14;     // LoRa sync word (private network)
+    radio->regs[0x0741] = 0x24;
+    radio->regs[0x0736] = 0x0D;     // IQ polarity
+    radio->regs[0x0889] = 0x04;     // TX modulation
+    radio->regs[0x08D8] = 0x1E;     // TX clamp
+    radio->regs[0x08E7] = 0x18;     // OCP
+}
+
+static void cold_start(sim_sx1262_t *radio) {
+    cancel_operation(radio);
+
+    set_mode(radio, SIM_SX1262_MODE_STDBY_RC);
+    radio->fallback_mode = SIM_SX1262_MODE_STDBY_RC;
+    radio->pkt_type = 0;
+    radio->irq_status = 0;
+    radio->irq_mask = 0;
+    radio->dio1_mask = 0;
+    radio->tx_base = 0;
+    radio->rx_base = 0;
+    radio->ramp_us = 10;
+    radio->cmd_status = 0;
+    memset(&radio->lora, 0, sizeof(radio->lora));
+    memset(radio->buffer, 0, sizeof(radio->buffer));
+    load_default_registers(radio);
+
+    update_dio1(radio);
+}
+
+static uint32_t be24(const uint8_t *p) {
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Radio Operations
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Radio Operations
+
+static void on_tx_complete(void *arg) {
+    sim_sx1262_t *radio = (sim_sx1262_t *)arg;
+
+    radio->op_event = -1;
+    radio->tx_on_air = false;
+    set_mode(radio, radio->fallback_mode);
+    radio->tx_done++;
+    radio->tx_done_us = host_sim_now_us();
+    radio->turnaround_pending = true;
+    raise_irq(radio, IRQ_TX_DONE);
+}
+
+static void on_tx_ramped(void *arg) {
+    sim_sx1262_t *radio = (sim_sx1262_t *)arg;
+    sim_lora_phy_t phy;
+    uint8_t payload[SIM_SX1262_BUFFER_SIZE];
+
+    current_phy(radio, &phy);
+
+    // The payload is read from the data buffer starting at the TX base address, wrapping at the end.
+    for (int k = 0; k < radio->lora.payload_len; k++) {
+        payload[k] = radio->buffer[(uint8_t)(radio->tx_base + k)];
+    }
+
+    uint64_t toa_us = sim_lora_channel_transmit(&host_world->channel, SIM_LORA_DIR_UPLINK, &phy, payload, radio->lora.payload_len, 0);
+    radio->tx_on_air = true;
+
+    radio->op_event = host_sim_schedule(host_sim_now_us() + toa_us, on_tx_complete, radio);
+}
+
+static void on_rx_timeout(void *arg) {
+    sim_sx1262_t *radio = (sim_sx1262_t *)arg;
+
+    radio->op_event = -1;
+
+    // A frame whose header had not been demodulated yet is lost with the timeout.
+    host_sim_cancel(radio->rx_event);
+    radio->rx_event = -1;
+    radio->rx_locked = false;
+
+    set_mode(radio, radio->fallback_mode);
+    radio->rx_timeouts++;
+    raise_irq(radio, IRQ_TIMEOUT);
+}
+
+static void on_rx_frame_end(void *arg) {
+    sim_sx1262_t *radio = (sim_sx1262_t *)arg;
+    sim_lora_frame_t *frame = &radio->rx_frame;
+
+    radio->rx_event = -1;
+    radio->rx_locked = false;
+
+    sim_lora_channel_finish_frame(&host_world->channel, frame);
+
+    for (int k = 0; k < frame->len; k++) {
+        radio->buffer[(uint8_t)(radio->rx_base + k)] = frame->payload[k];
+    }
+
+    radio->rx_payload_len = frame->len;
+    radio->rx_start = radio->rx_base;
+    radio->last_rssi_dbm = frame->rssi_dbm;
+    radio->last_snr_db = frame->snr_db;
+    radio->rx_done++;
+
+    // Without a CRC the radio has no way of telling a damaged payload from a good one.
+    uint16_t irq = IRQ_RX_DONE;
+    if (frame->corrupted && frame->phy.lora.crc_on) {
+        irq |= IRQ_CRC_ERROR;
+        radio->rx_crc_errors++;
+    }
+
+    // Single mode drops back to standby; continuous mode keeps listening.
+    if (!radio->rx_continuous) set_mode(radio, radio->fallback_mode);
+
+    raise_irq(radio, irq);
+}
+
+static void on_rx_header(void *arg) {
+    sim_sx1262_t *radio = (sim_sx1262_t *)arg;
+
+    // A valid header stops the RX timeout timer; the rest of the frame is received regardless.
+    host_sim_cancel(radio->op_event);
+    radio->op_event = -1;
+
+    raise_irq(radio, IRQ_PREAMBLE_DETECTED | IRQ_SYNC_WORD_VALID | IRQ_HEADER_VALID);
+
+    radio->rx_event = host_sim_schedule(radio->rx_frame.end_us, on_rx_frame_end, radio);
+}
+
+static void start_tx(sim_sx1262_t *radio, uint32_t timeout_steps) {
+    cancel_operation(radio);
+
+    set_mode(radio, SIM_SX1262_MODE_TX);
+    radio->op_started_us = host_sim_now_us();
+    radio->tx_started++;
+    radio->turnaround_pending = false;
+
+    // The first symbol leaves once the PA has ramped up.
+    radio->op_event = host_sim_schedule(radio->op_started_us + radio->ramp_us, on_tx_ramped, radio);
+    (void)timeout_steps;    // The TX timeout is a safety net only; a modelled transmission always completes.
+}
+
+static void start_rx(sim_sx1262_t *radio, uint32_t timeout_steps) {
+    cancel_operation(radio);
+
+    set_mode(radio, SIM_SX1262_MODE_RX);
+    radio->op_started_us = host_sim_now_us();
+    radio->rx_continuous = (timeout_steps == RX_CONTINUOUS);
+    radio->rx_started++;
+
+    // Time from the end of a transmission until the receiver is listening for the reply
+    if (radio->turnaround_pending) {
+        radio->turnaround_total_us += radio->op_started_us - radio->tx_done_us;
+        radio->turnarounds++;
+        radio->turnaround_pending = false;
+    }
+
+    // A timeout of zero listens until a frame arrives, continuous mode listens until told otherwise.
+    if ((timeout_steps != 0) && (timeout_steps != RX_CONTINUOUS)) {
+        uint64_t timeout_us = ((uint64_t)timeout_steps * RTC_STEP_NS) / 1000;
+        radio->op_event = host_sim_schedule(radio->op_started_us + timeout_us, on_rx_timeout, radio);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Command Decoder
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Command Decoder
+
+static void execute_command(sim_sx1262_t *radio, const uint8_t *cmd, uint16_t len) {
+    uint64_t busy_us = SIM_SX1262_COMMAND_BUSY_US;
+
+    radio->commands++;
+
+    switch (cmd[0]) {
+        case OP_SET_SLEEP:
+            cancel_operation(radio);
+            radio->warm_start = (len > 1) && ((cmd[1] & 0x04) != 0);
+            set_mode(radio, SIM_SX1262_MODE_SLEEP);
+            break;
+        case OP_SET_STANDBY:
+            cancel_operation(radio);
+            set_mode(radio, ((len > 1) && cmd[1]) ? SIM_SX1262_MODE_STDBY_XOSC : SIM_SX1262_MODE_STDBY_RC);
+            break;
+        case OP_SET_FS:
+            cancel_operation(radio);
+            set_mode(radio, SIM_SX1262_MODE_FS);
+            break;
+        case OP_SET_TX:
+            if (len >= 4) start_tx(radio, be24(&cmd[1]));
+            break;
+        case OP_SET_RX:
+            if (len >= 4) start_rx(radio, be24(&cmd[1]));
+            break;
+        case OP_SET_RX_TX_FALLBACK_MODE:
+            if (len >= 2) {
+                radio->fallback_mode = (cmd[1] == 0x30) ? SIM_SX1262_MODE_STDBY_XOSC :
+                                       (cmd[1] == 0x40) ? SIM_SX1262_MODE_FS : SIM_SX1262_MODE_STDBY_RC;
+            }
+            break;
+        case OP_CALIBRATE:
+            busy_us = SIM_SX1262_CALIBRATE_BUSY_US;
+            break;
+        case OP_CALIBRATE_IMAGE:
+            busy_us = SIM_SX1262_CALIBRATE_BUSY_US;
+            break;
+        case OP_WRITE_REGISTER:
+            if (len >= 3) {
+                uint16_t addr = ((uint16_t)cmd[1] << 8) | cmd[2];
+                for (uint16_t k = 3; k < len; k++) {
+                    radio->regs[(addr + k - 3) % SIM_SX1262_REGISTER_SPACE] = cmd[k];
+                }
+            }
+            break;
+        case OP_WRITE_BUFFER:
+            if (len >= 2) {
+                for (uint16_t k = 2; k < len; k++) {
+                    radio->buffer[(uint8_t)(cmd[1] + k - 2)] = cmd[k];
+                }
+            }
+            break;
+        case OP_SET_DIO_IRQ_PARAMS:
+            if (len >= 5) {
+                radio->irq_mask = ((uint16_t)cmd[1] << 8) | cmd[2];
+                radio->dio1_mask = ((uint16_t)cmd[3] << 8) | cmd[4];
+                update_dio1(radio);
+            }
+            break;
+        case OP_CLR_IRQ_STATUS:
+            if (len >= 3) {
+                radio->irq_status &= ~(((uint16_t)cmd[1] << 8) | cmd[2]);
+                update_dio1(radio);
+            }
+            break;
+        case OP_SET_RF_FREQUENCY:
+            if (len >= 5) {
+                // The frequency arrives in PLL steps of 32 MHz / 2^25
+                uint64_t steps = ((uint32_t)cmd[1] << 24) | be24(&cmd[2]);
+                radio->rf_freq = (uint32_t)(((steps * 32000000) + (1u << 24)) >> 25);
+            }
+            break;
+        case OP_SET_PKT_TYPE:
+            if (len >= 2) radio->pkt_type = cmd[1];
+            break;
+        case OP_SET_TX_PARAMS:
+            if (len >= 3) {
+                static const uint16_t ramp_times_us[] = {10, 20, 40, 80, 200, 800, 1700, 3400};
+                radio->tx_power = (int8_t)cmd[1];
+                radio->ramp_us = ramp_times_us[cmd[2] & 0x07];
+            }
+            break;
+        case OP_SET_MODULATION_PARAMS:
+            if (len >= 5) {
+                radio->lora.sf = cmd[1];
+                radio->lora.bw = cmd[2];
+                radio->lora.cr = cmd[3];
+                radio->lora.ldro = cmd[4];
+            }
+            break;
+        case OP_SET_PKT_PARAMS:
+            if (len >= 7) {
+                radio->lora.preamble_len = ((uint16_t)cmd[1] << 8) | cmd[2];
+                radio->lora.header_type = cmd[3];
+                radio->lora.payload_len = cmd[4];
+                radio->lora.crc_on = cmd[5];
+                radio->lora.invert_iq = cmd[6];
+            }
+            break;
+        case OP_SET_BUFFER_BASE_ADDRESS:
+            if (len >= 3) {
+                radio->tx_base = cmd[1];
+                radio->rx_base = cmd[2];
+            }
+            break;
+        default:
+            // Configuration commands with no observable effect on the model (regulator, PA, DIO2/DIO3 control, etc.)
+            // and read commands, whose responses were produced while the bytes were clocked.
+            break;
+    }
+
+    extend_busy(radio, busy_us);
+}
+
+static uint8_t response_byte(const sim_sx1262_t *radio, uint16_t idx) {
+    const uint8_t *cmd = radio->xfer;
+
+    switch (cmd[0]) {
+        case OP_READ_REGISTER:
+            if (idx >= 4) {
+                uint16_t addr = ((uint16_t)cmd[1] << 8) | cmd[2];
+                return radio->regs[(addr + idx - 4) % SIM_SX1262_REGISTER_SPACE];
+            }
+            break;
+        case OP_READ_BUFFER:
+            if (idx >= 3) return radio->buffer[(uint8_t)(cmd[1] + idx - 3)];
+            break;
+        case OP_GET_IRQ_STATUS:
+            if (idx == 2) return radio->irq_status >> 8;
+            if (idx == 3) return radio->irq_status & 0xff;
+            break;
+        case OP_GET_PKT_TYPE:
+            if (idx == 2) return radio->pkt_type;
+            break;
+        case OP_GET_STATUS:
+            break;
+        case OP_GET_RX_BUFFER_STATUS:
+            if (idx == 2) return radio->rx_payload_len;
+            if (idx == 3) return radio->rx_start;
+            break;
+        case OP_GET_PKT_STATUS:
+            if (idx == 2) return (uint8_t)(-2 * radio->last_rssi_dbm);
+            if (idx == 3) return (uint8_t)(int8_t)(4 * radio->last_snr_db);
+            if (idx == 4) return (uint8_t)(-2 * radio->last_rssi_dbm);
+            break;
+        case OP_GET_RSSI_INST:
+            if (idx == 2) return (uint8_t)(-2 * radio->last_rssi_dbm);
+            break;
+        case OP_GET_STATS:
+            if (idx == 2) return (radio->rx_done >> 8) & 0xff;
+            if (idx == 3) return radio->rx_done & 0xff;
+            if (idx >= 4 && idx <= 7) return 0;
+            break;
+        case OP_GET_DEVICE_ERRORS:
+            if (idx == 2 || idx == 3) return 0;
+            break;
+        default:
+            break;
+    }
+
+    return status_byte(radio);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Pins & Bus
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Pins & Bus
+
+void sim_sx1262_power_on(sim_sx1262_t *radio) {
+    uint8_t dio1_pin = radio->dio1_pin;
+    uint8_t busy_pin = radio->busy_pin;
+
+    memset(radio, 0, sizeof(*radio));
+
+    radio->dio1_pin = dio1_pin;
+    radio->busy_pin = busy_pin;
+    radio->busy_event = -1;
+    radio->op_event = -1;
+    radio->rx_event = -1;
+    radio->nreset = true;
+    radio->nss = true;
+    radio->last_rssi_dbm = -60;
+    radio->last_snr_db = 8;
+
+    cold_start(radio);
+    extend_busy(radio, SIM_SX1262_RESET_BUSY_US);
+}
+
+void sim_sx1262_set_nreset(sim_sx1262_t *radio, bool level) {
+    if (level == radio->nreset) return;
+
+    radio->nreset = level;
+
+    if (!level) {
+        cancel_operation(radio);
+        update_busy(radio);
+    }
+    else {
+        // Releasing NRESET starts the chip from scratch.
+        cold_start(radio);
+        radio->busy_until_us = 0;
+        extend_busy(radio, SIM_SX1262_RESET_BUSY_US);
+    }
+}
+
+void sim_sx1262_set_nss(sim_sx1262_t *radio, bool level) {
+    if (level == radio->nss) return;
+
+    radio->nss = level;
+
+    if (!radio->nreset) return;
+
+    if (!level) {
+        // Falling edge: a sleeping chip wakes up, anything else opens a new command frame.
+        if (radio->mode == SIM_SX1262_MODE_SLEEP) {
+            if (radio->warm_start) {
+                set_mode(radio, SIM_SX1262_MODE_STDBY_RC);
+            }
+            else {
+                cold_start(radio);
+            }
+            radio->busy_until_us = 0;
+            extend_busy(radio, SIM_SX1262_WAKEUP_BUSY_US);
+        }
+        radio->xfer_len = 0;
+    }
+    else {
+        // Rising edge: the command that was clocked in is executed.
+        if (radio->xfer_len > 0) {
+            execute_command(radio, radio->xfer, radio->xfer_len);
+        }
+        radio->xfer_len = 0;
+    }
+}
+
+uint8_t sim_sx1262_spi_byte(sim_sx1262_t *radio, uint8_t mosi) {
+    if (radio->nss || !radio->nreset || (radio->mode == SIM_SX1262_MODE_SLEEP)) return 0xFF;
+
+    uint16_t idx = radio->xfer_len;
+
+    if (idx < SIM_SX1262_MAX_TRANSACTION) {
+        radio->xfer[idx] = mosi;
+        radio->xfer_len++;
+    }
+
+    return (idx == 0) ? status_byte(radio) : response_byte(radio, idx);
+}
+
+bool sim_sx1262_get_busy(const sim_sx1262_t *radio) {
+    if (!radio->nreset) return true;
+    if (radio->mode == SIM_SX1262_MODE_SLEEP) return true;
+
+    return host_sim_now_us() < radio->busy_until_us;
+}
+
+bool sim_sx1262_get_dio1(const sim_sx1262_t *radio) {
+    return radio->dio1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Medium
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Medium
+
+void sim_sx1262_frame_arrival(sim_sx1262_t *radio, const sim_lora_frame_t *frame) {
+    sim_lora_phy_t phy;
+
+    current_phy(radio, &phy);
+
+    if (!radio->nreset || (radio->mode != SIM_SX1262_MODE_RX) || radio->rx_locked ||
+        (radio->pkt_type != PKT_TYPE_LORA) || !sim_lora_phy_match(&frame->phy, &phy)) {
+        radio->rx_missed++;
+
+        // Two frames on the same settings at the same strength: neither survives the overlap.
+        if (radio->rx_locked && sim_lora_phy_match(&frame->phy, &phy) && (radio->rx_frame.len > 0)) {
+            uint32_t bit = (uint32_t)(sim_lora_channel_random(&host_world->channel) * radio->rx_frame.len * 8);
+            radio->rx_frame.payload[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            radio->rx_frame.corrupted = true;
+            radio->rx_collisions++;
+        }
+
+        return;
+    }
+
+    radio->rx_frame = *frame;
+    radio->rx_locked = true;
+
+    radio->rx_event = host_sim_schedule(frame->start_us + sim_lora_header_time_us(&frame->phy.lora), on_rx_header, radio);
+}
+
+double sim_sx1262_energy_uj(const sim_sx1262_t *radio) {
+    uint64_t elapsed_us = host_sim_now_us() - radio->mode_since_us;
+
+    return radio->energy_uj + (mode_current_ma(radio, radio->mode) * SIM_SX1262_SUPPLY_V * elapsed_us / 1000.0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -12,6 +12,8 @@
 
 #include "hal.h"
 
+#include "pico/multicore.h"
+
 #pragma region GPIO
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -60,6 +62,99 @@ bool gpio_toggle_hal(const uint8_t pin) {
 
 #pragma region SPI
 
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// SPI DMA State
+
+#define SPI_QTY_INSTANCES 2
+
+// Extra time allowed past the transfer's bus time before a DMA transfer is given up on
+#define SPI_DMA_TIMEOUT_MARGIN_US 1000
+
+/**
+ * @brief DMA channel pair and completion state for each SPI instance. The RX channel finishes last, since it only completes
+ * once the final byte has been clocked back in, so its interrupt marks the end of the transfer.
+ */
+typedef struct spi_dma_state_s {
+    int tx_chan;
+    int rx_chan;
+    uint baud;
+    uint32_t len;
+    volatile bool busy;
+} spi_dma_state_t;
+
+static spi_dma_state_t spi_dma_states[SPI_QTY_INSTANCES] = {
+    {.tx_chan = -1, .rx_chan = -1},
+    {.tx_chan = -1, .rx_chan = -1}
+};
+
+// Source and sink for the side of a transfer the caller has no buffer for
+static const uint8_t spi_dma_zero_byte = 0x00;
+static uint8_t spi_dma_discard_byte;
+
+static bool spi_dma_irq_installed = false;
+
+static void isr_spi_dma_complete(void) {
+    for (int k = 0; k < SPI_QTY_INSTANCES; k++) {
+        spi_dma_state_t *state = &spi_dma_states[k];
+
+        if ((state->rx_chan >= 0) && dma_channel_get_irq0_status(state->rx_chan)) {
+            dma_channel_acknowledge_irq0(state->rx_chan);
+            state->busy = false;
+        }
+    }
+}
+
+static spi_dma_state_t *spi_dma_state_for(const spi_context_t *cxt) {
+    return &spi_dma_states[spi_get_index(cxt->inst)];
+}
+
+static void spi_dma_claim_channels(const spi_context_t *cxt, uint baud) {
+    spi_dma_state_t *state = spi_dma_state_for(cxt);
+
+    state->baud = baud;
+    state->busy = false;
+
+    if (state->rx_chan >= 0) return;
+
+    state->tx_chan = dma_claim_unused_channel(false);
+    state->rx_chan = dma_claim_unused_channel(false);
+
+    // Without both channels the instance simply keeps using blocking transfers.
+    if ((state->tx_chan < 0) || (state->rx_chan < 0)) {
+        if (state->tx_chan >= 0) dma_channel_unclaim(state->tx_chan);
+        if (state->rx_chan >= 0) dma_channel_unclaim(state->rx_chan);
+        state->tx_chan = -1;
+        state->rx_chan = -1;
+        return;
+    }
+
+    if (!spi_dma_irq_installed) {
+        irq_add_shared_handler(DMA_IRQ_0, isr_spi_dma_complete, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        spi_dma_irq_installed = true;
+    }
+
+    dma_channel_set_irq0_enabled(state->rx_chan, true);
+}
+
+static void spi_dma_release_channels(const spi_context_t *cxt) {
+    spi_dma_state_t *state = spi_dma_state_for(cxt);
+
+    if (state->rx_chan < 0) return;
+
+    dma_channel_set_irq0_enabled(state->rx_chan, false);
+    dma_channel_abort(state->tx_chan);
+    dma_channel_abort(state->rx_chan);
+    dma_channel_unclaim(state->tx_chan);
+    dma_channel_unclaim(state->rx_chan);
+
+    state->tx_chan = -1;
+    state->rx_chan = -1;
+    state->busy = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // SPI
 
@@ -74,6 +169,8 @@ uint spi_init_hal(const void* spi_context) {
     gpio_set_function(setup->miso, GPIO_FUNC_SPI);
     gpio_set_function(setup->mosi, GPIO_FUNC_SPI);
     gpio_set_function(setup->sck, GPIO_FUNC_SPI);
+
+    spi_dma_claim_channels(setup, baud);
     
     return baud;
 }
@@ -81,6 +178,8 @@ uint spi_init_hal(const void* spi_context) {
 void spi_terminate_hal(const void* spi_context) {
     
     const spi_context_t* setup = (const spi_context_t *)spi_context;
+
+    spi_dma_release_channels(setup);
     
     spi_deinit(setup->inst);
     
@@ -137,6 +236,79 @@ uint spi_rw_hal(const void* spi_context, uint8_t *txData, uint8_t *rxData, int l
     return bytes;
 }
 
+bool spi_dma_start_hal(const void *spi_context, const uint8_t *txData, uint8_t *rxData, int len) {
+
+    const spi_context_t *cxt = (const spi_context_t *)spi_context;
+    spi_dma_state_t *state = spi_dma_state_for(cxt);
+
+    if ((len <= 0) || (state->rx_chan < 0) || state->busy) return false;
+
+    dma_channel_config tx_config = dma_channel_get_default_config(state->tx_chan);
+    channel_config_set_transfer_data_size(&tx_config, DMA_SIZE_8);
+    channel_config_set_dreq(&tx_config, spi_get_dreq(cxt->inst, true));
+    channel_config_set_read_increment(&tx_config, txData != NULL);
+    channel_config_set_write_increment(&tx_config, false);
+
+    dma_channel_config rx_config = dma_channel_get_default_config(state->rx_chan);
+    channel_config_set_transfer_data_size(&rx_config, DMA_SIZE_8);
+    channel_config_set_dreq(&rx_config, spi_get_dreq(cxt->inst, false));
+    channel_config_set_read_increment(&rx_config, false);
+    channel_config_set_write_increment(&rx_config, rxData != NULL);
+
+    state->len = len;
+    state->busy = true;
+
+    // Arm the receiver first so the first byte clocked in is never missed, then start both together.
+    dma_channel_configure(state->rx_chan, &rx_config, (rxData != NULL) ? rxData : &spi_dma_discard_byte, &spi_get_hw(cxt->inst)->dr, len, false);
+    dma_channel_configure(state->tx_chan, &tx_config, &spi_get_hw(cxt->inst)->dr, (txData != NULL) ? txData : &spi_dma_zero_byte, len, false);
+    dma_start_channel_mask((1u << state->tx_chan) | (1u << state->rx_chan));
+
+    return true;
+}
+
+bool spi_dma_is_done_hal(const void *spi_context) {
+
+    return !spi_dma_state_for((const spi_context_t *)spi_context)->busy;
+}
+
+uint spi_dma_wait_hal(const void *spi_context) {
+
+    const spi_context_t *cxt = (const spi_context_t *)spi_context;
+    spi_dma_state_t *state = spi_dma_state_for(cxt);
+
+    uint64_t xfer_us = ((uint64_t)state->len * cxt->xfer_bits * 1000000) / ((state->baud > 0) ? state->baud : 1);
+    absolute_time_t timeout_time = make_timeout_time_us(xfer_us + SPI_DMA_TIMEOUT_MARGIN_US);
+
+    while (state->busy) {
+        if (sleep_until_event_hal(timeout_time) && state->busy) {
+            dma_channel_abort(state->tx_chan);
+            dma_channel_abort(state->rx_chan);
+            dma_channel_acknowledge_irq0(state->rx_chan);
+            state->busy = false;
+
+            err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_NONFATAL, "SPI DMA transfer did not complete in time", "spi_dma_wait_hal");
+            return 0;
+        }
+    }
+
+    return state->len;
+}
+
+uint spi_rw_dma_hal(const void *spi_context, const uint8_t *txData, uint8_t *rxData, int len) {
+
+    const spi_context_t *cxt = (const spi_context_t *)spi_context;
+
+    if ((len >= SPI_DMA_MIN_XFER_LEN) && spi_dma_start_hal(spi_context, txData, rxData, len)) {
+        return spi_dma_wait_hal(spi_context);
+    }
+
+    if (rxData == NULL) return spi_write_blocking(cxt->inst, txData, len);
+
+    if (txData == NULL) return spi_read_blocking(cxt->inst, 0x00, rxData, len);
+
+    return spi_write_read_blocking(cxt->inst, txData, rxData, len);
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #pragma endregion
@@ -429,6 +601,14 @@ int usb_console_write_hal(char * buf) {
     return printf("%s", buf);
 }
 
+int usb_console_write_bytes_hal(const uint8_t * buf, size_t len) {
+    for (size_t k = 0; k < len; k++) {
+        putchar_raw(buf[k]);
+    }
+
+    return len;
+}
+
 int get_user_input_hal(char * buf, uint buflen) {    
     
     char * ptr;
@@ -564,9 +744,48 @@ int power_mgmt_read_novo_memory_hal(uint32_t *data, size_t buf_len) {
 
     return 0;
 }
+
+bool sleep_until_event_hal(absolute_time_t wake_time) {
+    // WFE until the next interrupt or the SDK timer alarm. An IRQ that fires just before the WFE still sets the event
+    // register on exception return, so the wake-up cannot be lost between the caller's check and the sleep.
+    return best_effort_wfe_or_timeout(wake_time);
+}
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 
+#pragma endregion
+
+#pragma region Random Numbers
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Random Numbers
+
+uint32_t random_u32_hal(void) {
+    return get_rand_32();
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Multicore
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Multicore
+
+bool launch_core1_hal(void (*entry)(void)) {
+    multicore_launch_core1(entry);
+    return true;
+}
+
+void signal_event_hal(void) {
+    // Make everything written so far visible to the other core before it wakes.
+    __dmb();
+    __sev();
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 #pragma endregion
 
 /* --- EOF ------------------------------------------------------------------ */
\ No newline at end of file
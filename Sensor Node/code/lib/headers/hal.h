@@ -37,16 +37,26 @@
 
 #include "pico/stdio.h"
 #include "pico/stdlib.h"
+#include "pico/rand.h"
 #include "hardware/spi.h"
 #include "hardware/gpio.h"
 #include "hardware/watchdog.h"
 #include "hardware/irq.h"
 #include "hardware/resets.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 #include "tusb.h"
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+// Transfers shorter than this go through the FIFO directly; below it, setting up the DMA channels costs more than it saves.
+#define SPI_DMA_MIN_XFER_LEN 16
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // External Dependencies
 
@@ -206,6 +216,58 @@ uint spi_read_hal(const void *spi_context, uint8_t * buf, int len);
  */
 uint spi_rw_hal(const void *spi_context, uint8_t *txData, uint8_t *rxData, int len);
 
+/**
+ * 
+ * @brief Starts a DMA transfer on the SPI bus using the HAL and returns without waiting for it to finish. The buffers must
+ *          remain valid until the transfer is complete.
+ * 
+ * @param spi_context: (spi_context_t) Implementation Information for the desired SPI instance to use
+ * @param txData:      Buffer containing bytes to write to the SPI bus, or NULL to clock out zeroes
+ * @param rxData:      Buffer to contain read in bytes, or NULL to discard them
+ * @param len:         The number of bytes to be written/read
+ * 
+ * @returns True if the transfer was started, false if the SPI instance has no DMA channels or a transfer is already running
+ * 
+ */
+bool spi_dma_start_hal(const void *spi_context, const uint8_t *txData, uint8_t *rxData, int len);
+
+/**
+ * 
+ * @brief Checks if the DMA transfer on the given SPI instance has completed
+ * 
+ * @param spi_context: (spi_context_t) Implementation Information for the desired SPI instance to use
+ * 
+ * @returns True if no transfer is running
+ * 
+ */
+bool spi_dma_is_done_hal(const void *spi_context);
+
+/**
+ * 
+ * @brief Sleeps the core until the DMA transfer on the given SPI instance raises its completion interrupt
+ * 
+ * @param spi_context: (spi_context_t) Implementation Information for the desired SPI instance to use
+ * 
+ * @returns The number of bytes transferred, or 0 if the transfer did not complete in time and was aborted
+ * 
+ */
+uint spi_dma_wait_hal(const void *spi_context);
+
+/**
+ * 
+ * @brief Performs a transfer like `spi_rw_hal`, moving the bytes by DMA while the core sleeps when the transfer is long enough
+ *          to benefit. Falls back to the blocking transfer for short transfers or when no DMA channels are available.
+ * 
+ * @param spi_context: (spi_context_t) Implementation Information for the desired SPI instance to use
+ * @param txData:      Buffer containing bytes to write to the SPI bus, or NULL to clock out zeroes
+ * @param rxData:      Buffer to contain read in bytes, or NULL to discard them
+ * @param len:         The number of bytes to be written/read
+ * 
+ * @returns The number of bytes written/read
+ * 
+ */
+uint spi_rw_dma_hal(const void *spi_context, const uint8_t *txData, uint8_t *rxData, int len);
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #pragma endregion
@@ -464,6 +526,16 @@ char usb_console_getchar_timeout_us_hal(uint32_t timeout_microseconds);
  */
 int usb_console_write_hal(char * buf);
 
+/**
+ * @brief Write binary data to the usb console, byte for byte. Unlike the text functions, no newline is ever expanded to CRLF.
+ * 
+ * @param buf The data to be written
+ * @param len The number of bytes to write
+ * 
+ * @returns The number of bytes written
+ */
+int usb_console_write_bytes_hal(const uint8_t * buf, size_t len);
+
 /**
  * @brief Gets user input from the USB console connection, guaranteeing null-termination.
  * 
@@ -551,6 +623,56 @@ int power_mgmt_write_novo_memory_hal(uint32_t *data, size_t len);
  */
 int power_mgmt_read_novo_memory_hal(uint32_t *data, size_t buf_len);
 
+/**
+ * @brief Sleeps the core until an interrupt arrives or the wake time passes, whichever comes first. The core may also wake
+ *      for an unrelated event, so the caller re-checks whatever it is waiting on.
+ * 
+ * @param wake_time Absolute time at which to stop waiting
+ * 
+ * @returns True once the wake time has passed, false if woken early
+ */
+bool sleep_until_event_hal(absolute_time_t wake_time);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Random Numbers
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Random Numbers
+
+/**
+ * @brief Returns a random number from the MCU's hardware entropy sources. Unlike rand(), no two nodes share a sequence.
+ * 
+ * @returns 32 random bits
+ */
+uint32_t random_u32_hal(void);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+#pragma region Multicore
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Multicore
+
+/**
+ * @brief Starts the second core running the given function. Interrupts attached from that function are serviced on the
+ *      second core, so whatever it owns (the radio, say) must be set up from there.
+ * 
+ * @param entry Function for the second core to run. Should not return.
+ * 
+ * @returns True if the second core was started, false if the MCU has none
+ */
+bool launch_core1_hal(void (*entry)(void));
+
+/**
+ * @brief Wakes the other core if it is sleeping in `sleep_until_event_hal`, after handing it something to work on.
+ */
+void signal_event_hal(void);
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #pragma endregion
@@ -62,8 +62,8 @@ static int mxl23l3233f_spi_transaction(mxl23l3233f_context_t *context, uint8_t *
     // Assert chip select low
     gpio_write_hal(context->cs, GPIO_LOW);
 
-    // Perform the transaction
-    int bytes = spi_rw_hal(context->spi_context, txBuf, rxBuf, txLen);
+    // Perform the transaction. Page programs and reads are moved by DMA while the core sleeps.
+    int bytes = spi_rw_dma_hal(context->spi_context, txBuf, rxBuf, txLen);
 
     // Assert chip select high
     gpio_write_hal(context->cs, GPIO_HIGH);
@@ -79,6 +79,16 @@ sx126x_irq_mask_t sx126x_manual_isr(sx126x_context_t *radio_context);
  */
 bool sx126x_check_for_interrupt(void);
 
+/**
+ * @brief Sleeps the core until a registered sx126x instance raises an interrupt, instead of polling `sx126x_check_for_interrupt`.
+ *        The master ISR wakes the core, so the wait costs no CPU time.
+ * 
+ * @param timeout_ms Maximum time to wait
+ * 
+ * @returns True for a pending interrupt, false if the timeout passed first.
+ */
+bool sx126x_wait_for_interrupt(uint32_t timeout_ms);
+
 /**
  * @brief Services an interrupt on the most recently interrupting sx126x radio instance.
  * 
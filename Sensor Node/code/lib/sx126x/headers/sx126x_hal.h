@@ -77,6 +77,12 @@ extern "C" {
 #define SX126X_MICROSECONDS_PER_TCXO_DELAY 15.625
 #define SX126X_TCXO_TIMEOUT 320   // -----> 5 ms delay * 1000 us/ms * (1 delay unit / 15.625 us) = 320 delay units
 
+/**
+ * @brief Capacity of a command sequence: the number of commands, and the bytes of all their frames together
+ */
+#define SX126X_HAL_SEQ_MAX_CMDS 16
+#define SX126X_HAL_SEQ_BUF_LEN 128
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC TYPES ------------------------------------------------------------
@@ -88,6 +94,21 @@ typedef enum sx126x_hal_status_e
     SX126X_HAL_STATUS_ERROR = 3,
 } sx126x_hal_status_t;
 
+/**
+ * @brief A sequence of commands recorded for one radio, to be streamed to it back to back
+ */
+typedef struct sx126x_hal_seq_s
+{
+    const void* context;                            // The radio the sequence is recorded for
+    uint8_t     buf[SX126X_HAL_SEQ_BUF_LEN];       // Command frames (opcode, parameters and data), back to back
+    uint16_t    buf_len;
+    uint16_t    frame_len[SX126X_HAL_SEQ_MAX_CMDS];
+    uint8_t     qty_cmds;                           // Commands waiting to be sent
+    uint8_t     qty_sent;                           // Commands sent since the sequence began, including any flushed early
+    uint8_t     opcode[SX126X_HAL_SEQ_MAX_CMDS];    // Opcode of each command sent, up to the capacity
+    uint32_t    busy_us[SX126X_HAL_SEQ_MAX_CMDS];   // Time from the end of each command's frame until BUSY fell, i.e. the radio executing it
+} sx126x_hal_seq_t;
+
 /*
  * -----------------------------------------------------------------------------
  * --- PUBLIC FUNCTIONS PROTOTYPES ---------------------------------------------
@@ -161,6 +182,53 @@ sx126x_hal_status_t sx126x_hal_wakeup( const void* context );
  */
 sx126x_hal_status_t poll_radio_busy(const void* context, bool target_state);
 
+/**
+ * 
+ * @brief Starts recording a command sequence. Until `sx126x_hal_seq_run` is called, `sx126x_hal_write` queues each command
+ * for the radio instead of sending it, and reports success. A read, or a command that does not fit, sends the queue first.
+ * 
+ * @param [in] context: Radio implementation parameters
+ * @param [in] seq: Sequence to record into
+ * 
+ * @returns None
+ * 
+ */
+void sx126x_hal_seq_begin(const void* context, sx126x_hal_seq_t* seq);
+
+/**
+ * 
+ * @brief Ends the recording and streams every queued command to the radio, one frame per chip select, sleeping on the falling
+ * edge of BUSY between them. The time the radio spent busy with each command is recorded in the sequence.
+ * 
+ * @param [in] seq: The sequence begun with `sx126x_hal_seq_begin`
+ * 
+ * @returns Operation Status. Commands queued after one that failed are not sent.
+ * 
+ */
+sx126x_hal_status_t sx126x_hal_seq_run(sx126x_hal_seq_t* seq);
+
+/**
+ * 
+ * @brief Ends the recording of a sequence without sending the commands still queued. Used when a sequence is abandoned part-way.
+ * 
+ * @param [in] seq: The sequence begun with `sx126x_hal_seq_begin`
+ * 
+ * @returns None
+ * 
+ */
+void sx126x_hal_seq_discard(sx126x_hal_seq_t* seq);
+
+/**
+ * 
+ * @brief Prints the per-command BUSY latency of a sequence that has run
+ * 
+ * @param [in] seq: The sequence
+ * 
+ * @returns None
+ * 
+ */
+void sx126x_hal_seq_print(const sx126x_hal_seq_t* seq);
+
 /**
  * 
  * @brief Initialize all GPIO pins affiliated with the given radio context - DOES NOT INITIALIZE SPI!!
@@ -187,6 +255,18 @@ void sx126x_hal_init(const void* context);
  */
 void sx126x_hal_setup_interrupts(const void* context);
 
+/**
+ * 
+ * @brief Interrupt service routine for the falling edge of a radio's BUSY line. Records when the radio became ready; the
+ * interrupt itself wakes a core waiting for it.
+ * 
+ * @param [in] context: The interrupt that fired
+ * 
+ * @returns None
+ * 
+ */
+void sx126x_hal_busy_isr(gpio_driven_irq_context_t* context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -137,6 +137,17 @@ void sx126x_master_isr(gpio_driven_irq_context_t *context) {
 bool sx126x_check_for_interrupt(void) {
     return sx126x_radio_interrupt_triggered;
 }
+
+bool sx126x_wait_for_interrupt(uint32_t timeout_ms) {
+    absolute_time_t timeout_time = make_timeout_time_ms(timeout_ms);
+
+    // Any interrupt wakes the core, so re-check the flag after every wake-up.
+    while (!sx126x_radio_interrupt_triggered) {
+        if (sleep_until_event_hal(timeout_time)) return sx126x_radio_interrupt_triggered;
+    }
+
+    return true;
+}
     
 sx126x_irq_mask_t sx126x_manual_isr(sx126x_context_t *radio_context) {
 
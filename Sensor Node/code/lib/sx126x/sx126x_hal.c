@@ -16,7 +16,27 @@
 #include "sx126x_hal.h"
 #include "mxl23l3233f.h"
 
-#define CHECK_RADIO_BUSY(CONTEXT) if (poll_radio_busy(CONTEXT, GPIO_LOW) == SX126X_HAL_STATUS_ERROR) return SX126X_HAL_STATUS_ERROR
+#define CHECK_RADIO_BUSY(CONTEXT) if (wait_radio_ready(CONTEXT) == SX126X_HAL_STATUS_ERROR) return SX126X_HAL_STATUS_ERROR
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Globals
+
+// BUSY lines whose falling edge interrupt is attached, indexed by GPIO pin. Until then, the line is polled.
+static bool busy_edge_armed[QTY_GPIO_PINS] = {false};
+
+// Time of the most recent falling edge of a BUSY line, from the ISR
+static volatile uint64_t busy_fall_us = 0;
+
+// The sequence being recorded, if any
+static sx126x_hal_seq_t* open_seq = NULL;
+
+static sx126x_hal_status_t wait_radio_ready(const void* context);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static sx126x_hal_status_t seq_queue(sx126x_hal_seq_t* seq, const uint8_t* command, uint16_t command_length, const uint8_t* data, uint16_t data_length, bool* queued);
+
+static sx126x_hal_status_t seq_flush(sx126x_hal_seq_t* seq);
 
 #pragma region SPI
 
@@ -30,6 +50,15 @@ sx126x_hal_status_t sx126x_hal_write(   const void* context,
     // Cast the void pointer context to the sx126x context type
     const sx126x_context_t* radio_inst = (const sx126x_context_t*)context;
 
+    // While a sequence is being recorded, the command is queued instead. One too long to queue is sent directly, after the
+    // commands queued before it.
+    if ((open_seq != NULL) && (open_seq->context == context)) {
+        bool queued = false;
+
+        if (seq_queue(open_seq, command, command_length, data, data_length, &queued) != SX126X_HAL_STATUS_OK) return SX126X_HAL_STATUS_ERROR;
+        if (queued) return SX126X_HAL_STATUS_OK;
+    }
+
     // Check if the radio is busy
     CHECK_RADIO_BUSY(context);
 
@@ -41,9 +70,9 @@ sx126x_hal_status_t sx126x_hal_write(   const void* context,
         spi_write_hal(radio_inst->spi_context, command, command_length);
     }
 
-    // Write the data
+    // Write the data. Buffer writes are long enough to move by DMA while the core sleeps.
     if (data_length > 0) {
-        spi_write_hal(radio_inst->spi_context, data, data_length);
+        spi_rw_dma_hal(radio_inst->spi_context, data, NULL, data_length);
     }
 
     // De-Assert Chip Select
@@ -63,6 +92,11 @@ sx126x_hal_status_t sx126x_hal_read(const void* context,
     // Cast the void pointer context to the sx126x context type
     const sx126x_context_t* radio_inst = (const sx126x_context_t*)context;
 
+    // A read needs its answer now, so everything queued before it goes first
+    if ((open_seq != NULL) && (open_seq->context == context)) {
+        if (seq_flush(open_seq) != SX126X_HAL_STATUS_OK) return SX126X_HAL_STATUS_ERROR;
+    }
+
     // Check if the radio is busy
     CHECK_RADIO_BUSY(context);
 
@@ -76,7 +110,7 @@ sx126x_hal_status_t sx126x_hal_read(const void* context,
 
     // Read back data (data will not be shifted out until posedge SCK)
     if (data_length > 0) {
-        spi_read_hal(radio_inst->spi_context, data, data_length);
+        spi_rw_dma_hal(radio_inst->spi_context, NULL, data, data_length);
     }
 
     // De-Assert Chip Select
@@ -88,6 +122,121 @@ sx126x_hal_status_t sx126x_hal_read(const void* context,
 
 #pragma endregion
 
+#pragma region Command Sequences
+
+/**
+ * @brief Adds a command frame to the sequence, sending the queue first if the frame does not fit.
+ * 
+ * @param queued Set false if the frame is too long to queue at all. The queue has then been sent, and the frame is to be
+ * sent directly.
+ * 
+ * @returns Error if sending the queue failed, in which case the frame is not to be sent at all.
+ */
+static sx126x_hal_status_t seq_queue(sx126x_hal_seq_t* seq, const uint8_t* command, uint16_t command_length, const uint8_t* data, uint16_t data_length, bool* queued) {
+    uint16_t frame_len = command_length + data_length;
+
+    *queued = false;
+
+    if ((frame_len == 0) || (frame_len > SX126X_HAL_SEQ_BUF_LEN)) return seq_flush(seq);
+
+    if ((seq->qty_cmds == SX126X_HAL_SEQ_MAX_CMDS) || (seq->buf_len + frame_len > SX126X_HAL_SEQ_BUF_LEN)) {
+        if (seq_flush(seq) != SX126X_HAL_STATUS_OK) return SX126X_HAL_STATUS_ERROR;
+    }
+
+    memcpy(&seq->buf[seq->buf_len], command, command_length);
+    if (data_length > 0) memcpy(&seq->buf[seq->buf_len + command_length], data, data_length);
+
+    seq->frame_len[seq->qty_cmds++] = frame_len;
+    seq->buf_len += frame_len;
+    *queued = true;
+
+    return SX126X_HAL_STATUS_OK;
+}
+
+/**
+ * @brief Sends every queued frame. Each waits for the radio to finish the one before, and the time it took is recorded.
+ */
+static sx126x_hal_status_t seq_flush(sx126x_hal_seq_t* seq) {
+    const sx126x_context_t* radio_inst = (const sx126x_context_t*)seq->context;
+
+    sx126x_hal_status_t status = SX126X_HAL_STATUS_OK;
+    uint16_t offset = 0;
+
+    for (uint8_t k = 0; k < seq->qty_cmds; k++) {
+        const uint8_t* frame = &seq->buf[offset];
+        uint16_t frame_len = seq->frame_len[k];
+
+        if (wait_radio_ready(radio_inst) != SX126X_HAL_STATUS_OK) {
+            status = SX126X_HAL_STATUS_ERROR;
+            break;
+        }
+
+        gpio_write_hal(radio_inst->cs, GPIO_LOW);
+        spi_rw_dma_hal(radio_inst->spi_context, frame, NULL, frame_len);
+        gpio_write_hal(radio_inst->cs, GPIO_HIGH);
+
+        uint64_t frame_end_us = time_us_64();
+
+        // The radio raises BUSY as the frame ends, and drops it once the command has been executed.
+        if (wait_radio_ready(radio_inst) != SX126X_HAL_STATUS_OK) {
+            status = SX126X_HAL_STATUS_ERROR;
+            break;
+        }
+
+        uint64_t ready_us = (busy_fall_us >= frame_end_us) ? busy_fall_us : time_us_64();
+
+        // Only the first SX126X_HAL_SEQ_MAX_CMDS commands of a long sequence are timed
+        if (seq->qty_sent < SX126X_HAL_SEQ_MAX_CMDS) {
+            seq->opcode[seq->qty_sent] = frame[0];
+            seq->busy_us[seq->qty_sent] = (uint32_t)(ready_us - frame_end_us);
+        }
+        seq->qty_sent++;
+
+        offset += frame_len;
+    }
+
+    seq->qty_cmds = 0;
+    seq->buf_len = 0;
+
+    return status;
+}
+
+void sx126x_hal_seq_begin(const void* context, sx126x_hal_seq_t* seq) {
+    seq->context = context;
+    seq->buf_len = 0;
+    seq->qty_cmds = 0;
+    seq->qty_sent = 0;
+
+    open_seq = seq;
+}
+
+sx126x_hal_status_t sx126x_hal_seq_run(sx126x_hal_seq_t* seq) {
+    // Stop recording first, so the commands actually go to the radio
+    if (open_seq == seq) open_seq = NULL;
+
+    return seq_flush(seq);
+}
+
+void sx126x_hal_seq_discard(sx126x_hal_seq_t* seq) {
+    if (open_seq == seq) open_seq = NULL;
+
+    seq->qty_cmds = 0;
+    seq->buf_len = 0;
+}
+
+void sx126x_hal_seq_print(const sx126x_hal_seq_t* seq) {
+    uint32_t total_us = 0;
+
+    for (uint8_t k = 0; (k < seq->qty_sent) && (k < SX126X_HAL_SEQ_MAX_CMDS); k++) {
+        printf("\tCommand 0x%02X: busy %u us\n", seq->opcode[k], (unsigned)seq->busy_us[k]);
+        total_us += seq->busy_us[k];
+    }
+
+    printf("\t%u commands, %u us busy in total\n", seq->qty_sent, (unsigned)total_us);
+}
+
+#pragma endregion
+
 #pragma region GENERAL OPS
 
 sx126x_hal_status_t sx126x_hal_reset( const void* context ) {
@@ -160,6 +309,32 @@ sx126x_hal_status_t poll_radio_busy(const void* context, bool target_state) {
     return SX126X_HAL_STATUS_OK;
 }
 
+/**
+ * @brief Waits for BUSY to go LOW. Once its falling edge interrupt is attached, the core sleeps until the edge instead of
+ * polling the line.
+ */
+static sx126x_hal_status_t wait_radio_ready(const void* context) {
+
+    const sx126x_context_t* radio_inst = (const sx126x_context_t *)context;
+
+    if (!busy_edge_armed[radio_inst->busy]) return poll_radio_busy(context, GPIO_LOW);
+
+    absolute_time_t tout = make_timeout_time_us(radio_inst->radio_operation_timeout_us);
+
+    // Any interrupt wakes the core, so re-check the line after every wake-up.
+    while (gpio_read_hal(radio_inst->busy) != GPIO_LOW) {
+        if (sleep_until_event_hal(tout)) {
+            return (gpio_read_hal(radio_inst->busy) == GPIO_LOW) ? SX126X_HAL_STATUS_OK : SX126X_HAL_STATUS_ERROR;
+        }
+    }
+
+    return SX126X_HAL_STATUS_OK;
+}
+
+void sx126x_hal_busy_isr(gpio_driven_irq_context_t* context) {
+    busy_fall_us = time_us_64();
+}
+
 void sx126x_hal_init(const void* context) {
 
     // First, cast the void pointer context to a radio context
@@ -190,6 +365,12 @@ void sx126x_hal_setup_interrupts(const void* context) {
 
     // Register the radio DIO1 Pin with the global IRQ dispatch table
     gpio_irq_attach_hal(radio_inst->irq_context);
+
+    // Wake on the BUSY line falling rather than polling it
+    if (radio_inst->busy_irq_context != NULL) {
+        gpio_irq_attach_hal(radio_inst->busy_irq_context);
+        busy_edge_armed[radio_inst->busy] = true;
+    }
 }
 
 #pragma endregion
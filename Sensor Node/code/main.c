@@ -16,13 +16,19 @@
 
 #define POWER_5V_COOLDOWN_DURATION_MS 10000
 #define NODE_SLEEP_INTERVAL_MINS 11
+#define NODE_SAMPLES_PER_TRANSMIT 1         // Samples per telemetry batch: the radio wakes every NODE_SAMPLES_PER_TRANSMIT x NODE_SLEEP_INTERVAL_MINS
+#define NODE_TELEMETRY_KEYFRAME_INTERVAL 16  // Every this many packets, compact telemetry is sent whole, not coded against the last one
+
+#if (NODE_SAMPLES_PER_TRANSMIT < 1) || (NODE_SAMPLES_PER_TRANSMIT > LWQMS_PKT_BATCH_MAX_SAMPLES)
+#error "NODE_SAMPLES_PER_TRANSMIT must fit in a single telemetry batch"
+#endif
 
 #define SET_5V_RAIL_STATUS(is_enabled)                                \
     do {                                                              \
         /* Check if the EN_5V pin is already in the desired state */   \
         if (gpio_read_hal(EN_5V) != (is_enabled ? GPIO_HIGH : GPIO_LOW)) { \
             printf("Waiting for power cooldown...");                  \
-            while (get_absolute_time() < power_5v_cooldown_time) {}   \
+            sleep_until(power_5v_cooldown_time);                      \
             printf("DONE\n");                                          \
                                                                   \
             printf("Setting 5V Rail %s...", (is_enabled ? "ON" : "OFF")); \
@@ -39,7 +45,15 @@
     } while (0)
 
 
-static uint8_t packet_id;
+static uint16_t packet_id;            // Same width as the packet ID field, so the gateway sees it wrap where it does
+static bool sequence_start;             // No packet since power-up has been acknowledged yet, so they carry LWQMS_PKT_FLAG_SYNC
+static uint8_t samples_logged;          // Samples waiting in the flash telemetry backlog for the next transmission
+static lwqms_telemetry_ref_t telemetry_ref;     // Last sample the gateway acknowledged, which compact telemetry is coded against
+
+// NOVO memory: {packet ID, RTT estimate, node flags, backlog count, compact telemetry reference x 2}
+#define NOVO_FLAG_SEQUENCE_START 0x01
+#define NOVO_FLAG_TELEMETRY_REF 0x02
+#define NOVO_LEN 6
 
 void print_banner(void) {
     printf("\n\n-- LoRa Water Quality Management System Sensor Node --\n");
@@ -58,7 +72,7 @@ void blink_status_ok()
 lora_setup_t lora_phy_setup = {
     .hw = &context_radio_0,
     .mod_setting = &prototyping_mod_params,
-    .operation_timeout_ms = 10000,
+    .operation_timeout_ms = LORA_TIMEOUT_MS,
     .pa_setting = &sx1262_22dBm_pa_params,
     .pkt_setting = &prototyping_pkt_params,
     .ramp_time = SX126X_RAMP_200_US,
@@ -68,6 +82,10 @@ lora_setup_t lora_phy_setup = {
     .node_config = &sys_configuration,
 };
 
+// Scratch space for the ACKs the transport receives, kept off the heap and out of the FSM's stack frame.
+static lora_pkt_t rdt_scratch_pkt;
+static rdt3_0_ctx_t rdt_ctx = RDT3_0_CTX_INIT(&rdt_scratch_pkt, &lora_phy_setup);
+
 sensor_acquisition_settings_t sen_acq_settings = {
     .analog_characteristic_turb = {
         .dc_offset_pos = 0,
@@ -208,11 +226,11 @@ void startup_menu() {
                 break;
             case 't':
                 lwqms_pkt_t packet = get_custom_packet();
-                lora_pkt_t tx_pkt;                
+                lora_pkt_t tx_pkt;
                 tx_pkt.len = LWQMS_PKT_LEN_MAX;
                 lwqms_pkt_encode(&packet, tx_pkt.buf, tx_pkt.len);
                 printf("Sending packet...\n\n");
-                rdt3_0_transmit(&tx_pkt, sizeof(lora_pkt_t), &lora_phy_setup);
+                rdt3_0_transmit_ctx(&rdt_ctx, &tx_pkt);
                 printf("\n\n-- Transmit Operation Complete --\n");
                 break;
             case 'a':
@@ -298,6 +316,14 @@ void system_setup() {
     if (check_for_power_saving_mode_boot(novo_contents, MCU_POWMAN_NOVO_ELEMENTS, &novo_contents_len)) {
         printf("Dormant state boot detected!\n");
         packet_id = novo_contents[0];
+        rdt3_0_rtt_restore(&rdt_ctx, novo_contents[1]);     // Pick up the link's round trip time where the last cycle left it
+        sequence_start = (novo_contents[2] & NOVO_FLAG_SEQUENCE_START) > 0;
+        samples_logged = novo_contents[3];
+        telemetry_ref.valid = (novo_contents[2] & NOVO_FLAG_TELEMETRY_REF) > 0;
+        telemetry_ref.pkt_id = packet_id - 1;      // Only kept while the last packet was acknowledged
+        telemetry_ref.turbidity = (int32_t)novo_contents[4];
+        telemetry_ref.temperature = (int16_t)(novo_contents[5] >> 16);
+        telemetry_ref.pH = (int16_t)(novo_contents[5] & 0xFFFF);
         for (int status = 1; status <= 0; --status) {
             for (uint8_t k = ERR_LED; k <= STATUS_LED; --k) {
                 gpio_write_hal(k, status);
@@ -307,10 +333,11 @@ void system_setup() {
     } else {
         printf("Power cycle boot detected!\n");
         packet_id = 1;
+        sequence_start = true;  // Tell the gateway the packet IDs have started over
+        samples_logged = 0;     // Without the count, an old backlog cannot be trusted
+        telemetry_ref.valid = false;
     }
 
-    packet_id = check_for_power_saving_mode_boot(novo_contents, MCU_POWMAN_NOVO_ELEMENTS, &novo_contents_len) ? novo_contents[0] : 1;
-
     switch (post_result) {
         case POST_BYPASS:
             printf("POST Bypassed due to previous pass before dormant state.\n\n");
@@ -373,6 +400,19 @@ static rp2350_power_mgmt_setting_t mcu_all_on = {
     }
 };
 
+/**
+ * @brief Converts a sensor reading to the packet's telemetry format
+ */
+static lwqms_telemetry_t telemetry_from_sensor_data(sensor_telemetry_t *sensor_data) {
+    lwqms_telemetry_t telemetry = {
+        .turbidity_measurement = sensor_data->turbidity_NTU,
+        .temperature_measurement = sensor_data->temperature_C,
+        .pH_measurement = sensor_data->pH
+    };
+
+    return telemetry;
+}
+
 int main()
 {
     system_setup();
@@ -398,6 +438,18 @@ int main()
                 sensors_acquire_data(&context_sdia_0, &sdia_calibration, &sen_acq_settings, &sensor_data);
                 printf("Telemetry: Turbidity = %f NTU, Temperature = %f C, pH = %f\n\n", sensor_data.turbidity_NTU, sensor_data.temperature_C, sensor_data.pH);
                 gpio_write_hal(EN_5V, GPIO_LOW);
+
+                if (samples_logged + 1 < NODE_SAMPLES_PER_TRANSMIT) {
+                    // Not enough for a batch yet: keep the sample through the dormant state and leave the radio asleep.
+                    lwqms_telemetry_t sample = telemetry_from_sensor_data(&sensor_data);
+
+                    if (telemetry_backlog_append(&context_flash_0, samples_logged, &sample) == 0) samples_logged++;
+
+                    printf("Sample %u of %u saved for the next transmission.\n", samples_logged, NODE_SAMPLES_PER_TRANSMIT);
+                    state = LWQMS_FSM_STATE_DORMANT;
+                    break;
+                }
+
                 state = LWQMS_FSM_STATE_TRANSMIT;
                 break;
             case LWQMS_FSM_STATE_TRANSMIT:
@@ -408,25 +460,74 @@ int main()
                 lwqms_pkt_t telem_packet = {
                     .src_id = sys_configuration.ID,
                     .dest_id = sys_configuration.gateway_ID,
-                    .packet_type = LWQMS_PACKET_TYPE_TELEMETRY,
+                    .packet_type = LWQMS_PACKET_TYPE_TELEMETRY | (sequence_start ? LWQMS_PKT_FLAG_SYNC : 0),
                     .pkt_id = packet_id,
                     .payload = {    // Payload is a union type that spans both a char[12] and 3 x floats (4 bytes)
-                        .telemetry = {
-                            .turbidity_measurement = sensor_data.turbidity_NTU,
-                            .temperature_measurement = sensor_data.temperature_C,
-                            .pH_measurement = sensor_data.pH
-                        }
+                        .telemetry = telemetry_from_sensor_data(&sensor_data)
                     }
                 };
 
-                lora_pkt_t tx_pkt = {
-                    .len = LWQMS_PKT_LEN_MAX
-                };
+                // Only the header and the encoded packet are written; the rest of the radio buffer is left as it lies.
+                lora_pkt_t tx_pkt;
+                tx_pkt.len = LWQMS_PKT_LEN_MAX;
+
+                // The backlog, oldest first, followed by the sample just taken. Samples are taken once per wake-up.
+                lwqms_telemetry_batch_t batch = {.qty_samples = 0};
+                lwqms_telemetry_t backlog[LWQMS_PKT_BATCH_MAX_SAMPLES - 1];
 
-                lwqms_pkt_encode(&telem_packet, tx_pkt.buf, tx_pkt.len);
+                if ((samples_logged > 0) && (telemetry_backlog_read(&context_flash_0, backlog, samples_logged) == 0)) {
+                    for (int k = 0; k < samples_logged; k++) {
+                        uint32_t age_s = (uint32_t)(samples_logged - k) * NODE_SLEEP_INTERVAL_MINS * 60;
 
-                printf("Transmitting packet...\n\n");
-                rdt3_0_transmit(&tx_pkt, sizeof(lora_pkt_t), &lora_phy_setup);  // Feeding the dog built into this method
+                        batch.samples[k].age_s = (age_s > LWQMS_PKT_BATCH_AGE_MAX_S) ? LWQMS_PKT_BATCH_AGE_MAX_S : age_s;
+                        batch.samples[k].telemetry = backlog[k];
+                    }
+
+                    batch.qty_samples = samples_logged;
+                }
+                else if (samples_logged > 0) {
+                    // The backlog cannot be sent, and a failed transmission starts a new one over it, so say it is gone.
+                    err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_NONFATAL, "Failed to read the telemetry backlog! Its samples are dropped.", "telemetry_backlog_read");
+                    samples_logged = 0;
+                }
+
+                batch.samples[batch.qty_samples].age_s = 0;
+                batch.samples[batch.qty_samples].telemetry = telem_packet.payload.telemetry;
+                batch.qty_samples++;
+
+                // Compact telemetry, coded against the last sample the gateway acknowledged. Now and then, and whenever the gateway
+                // is told the sequence started over, it goes without: a gateway that lost the sample cannot acknowledge deltas.
+                size_t compact_len;
+                bool keyframe = sequence_start || ((packet_id % NODE_TELEMETRY_KEYFRAME_INTERVAL) == 0);
+                bool compact = lwqms_pkt_encode_compact(&telem_packet, &batch, keyframe ? NULL : &telemetry_ref, tx_pkt.buf, sizeof(tx_pkt.buf), &compact_len);
+
+                if (compact) {
+                    tx_pkt.len = compact_len;
+                }
+                else {
+                    telem_packet.packet_type = (telem_packet.packet_type & ~LWQMS_PKT_TYPE_MASK) | LWQMS_PACKET_TYPE_TELEMETRY;
+                    lwqms_pkt_encode(&telem_packet, tx_pkt.buf, tx_pkt.len);
+                }
+
+                printf("Transmitting packet with %u sample(s) in %u bytes...\n\n", batch.qty_samples, tx_pkt.len);
+                if (rdt3_0_transmit_ctx(&rdt_ctx, &tx_pkt) == RDT3_0_RESULT_CODES_OK) {   // Feeding the dog built into this method
+                    sequence_start = false;
+                    samples_logged = 0;
+                    lwqms_telemetry_ref_update(&telemetry_ref, packet_id, &batch.samples[batch.qty_samples - 1].telemetry);
+                    telemetry_ref.valid &= compact;     // The gateway only keeps the sample of compact telemetry
+                }
+                else if (batch.qty_samples < LWQMS_PKT_BATCH_MAX_SAMPLES) {
+                    // Hold on to the new sample too; the next wake-up retries with the whole backlog.
+                    if (telemetry_backlog_append(&context_flash_0, batch.qty_samples - 1, &telem_packet.payload.telemetry) == 0) samples_logged = batch.qty_samples;
+                }
+                else {
+                    // The backlog is as big as a batch gets, so the oldest sample makes room for the newest.
+                    samples_logged = 0;
+                    for (int k = 1; k < batch.qty_samples; k++) {
+                        if (telemetry_backlog_append(&context_flash_0, k - 1, &batch.samples[k].telemetry) < 0) break;
+                        samples_logged++;
+                    }
+                }
                 printf("\n\n-- Transmit Operation Complete --\n");
                 packet_id++;
                 state = LWQMS_FSM_STATE_DORMANT;
@@ -438,8 +539,18 @@ int main()
                  * state. After waking up, the MCU will have a cold reset, making the next state the SAMPLE state.
                  */
                 watchdog_feed_hal();    // Feed the dog - beware of bites!
-                uint32_t novo_mem_contents[1] = {packet_id};
-                enter_power_saving_mode(&power_mgmt_dormant_state, &context_radio_0, 60 * 1000 * NODE_SLEEP_INTERVAL_MINS, novo_mem_contents, 1);
+                // The reference is only any use to the packet right after the one that set it.
+                bool telemetry_ref_current = telemetry_ref.valid && (telemetry_ref.pkt_id == (uint16_t)(packet_id - 1));
+
+                uint32_t novo_mem_contents[NOVO_LEN] = {
+                    packet_id,
+                    rdt3_0_rtt_save(&rdt_ctx),
+                    (sequence_start ? NOVO_FLAG_SEQUENCE_START : 0) | (telemetry_ref_current ? NOVO_FLAG_TELEMETRY_REF : 0),
+                    samples_logged,
+                    (uint32_t)telemetry_ref.turbidity,
+                    ((uint32_t)(uint16_t)telemetry_ref.temperature << 16) | (uint16_t)telemetry_ref.pH
+                };
+                enter_power_saving_mode(&power_mgmt_dormant_state, &context_radio_0, 60 * 1000 * NODE_SLEEP_INTERVAL_MINS, novo_mem_contents, NOVO_LEN);
                 state = LWQMS_FSM_STATE_RESET;
                 break;
             default:
@@ -46,6 +46,7 @@
 #include "sx126x.h"
 
 #include "rdt3.h"
+#include "rdt3_gateway.h"
 #include "lwqms_pkt.h"
 #include "sensors.h"
 #include "power_states.h"
@@ -59,7 +60,7 @@
 
 #define LWQMS_SYNC_WORD 0x42    // The meaning of life, the universe, and everything
 
-#define LORA_TIMEOUT_MS 10000
+#define LORA_TIMEOUT_MS 10000  // How long to listen for a packet that could arrive at any time. ACK and TX windows come from the airtime instead.
 
 typedef enum lwqms_fsm_e {
     LWQMS_FSM_STATE_RESET    = 0x1BADDEED,
@@ -78,7 +79,7 @@ sx126x_mod_params_lora_t prototyping_mod_params = {
 sx126x_pkt_params_lora_t prototyping_pkt_params = {
     .preamble_len_in_symb = 8,
     .header_type = SX126X_LORA_PKT_EXPLICIT,
-    .crc_is_on = false,
+    .crc_is_on = true,
     .invert_iq_is_on = false   // Do not invert the IQ unless needed to make network invisible to other LoRa devices - typically involved with LoRaWAN
 };
 
@@ -11,8 +11,10 @@
 *********************************************************************************************************************/
 
 #include "hardware.h"
+#include "lora.h"
 
 extern void sx126x_master_isr(gpio_driven_irq_context_t *context);
+extern void sx126x_hal_busy_isr(gpio_driven_irq_context_t *context);
 
 spi_context_t context_spi_0 = {
     .inst = spi0,
@@ -46,8 +48,17 @@ const gpio_driven_irq_context_t irq_context_radio_0 = {
     .callback = &sx126x_master_isr
 };
 
+const gpio_driven_irq_context_t irq_context_radio_0_busy = {
+    .pin = GP9,
+    .source_mask = GPIO_IRQ_EDGE_FALL,
+    .callback = &sx126x_hal_busy_isr
+};
+
+static sx126x_config_cache_t config_cache_radio_0;
+
 sx126x_context_t context_radio_0 = {
     .busy = GP9,
+    .busy_irq_context = &irq_context_radio_0_busy,
     .irq_context = &irq_context_radio_0,
     .rst =  GP10,
     .cs =   GP11,
@@ -55,7 +66,8 @@ sx126x_context_t context_radio_0 = {
     .radio_operation_timeout_us = RADIO_TIMEOUT_GLOBAL_US,
     .designator = "RADIO 0",
     .tx_buf_start = 0x00,
-    .rx_buf_start = 0x00
+    .rx_buf_start = 0x00,
+    .config_cache = &config_cache_radio_0
 };
 
 mcp4651_context_t context_digipot_offset = {
@@ -146,6 +146,8 @@ typedef void (*gpio_isr_handler_t)(gpio_driven_irq_context_t*);  // A function p
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Hardware Types
 
+typedef struct sx126x_config_cache_s sx126x_config_cache_t;  // Defined with the LoRa layer that maintains it, in lora.h
+
 /**
  * @brief sx126x Radio Configuration Data
  */
@@ -154,11 +156,13 @@ typedef struct sx126x_context_s {
     const spi_context_t* spi_context;                 // The SPI bus of the radio module
     const uint8_t        rst;                         // Reset - Pull LOW for 100us to initiate a reset.
     const uint8_t        busy;                        // Busy Indicator - HIGH indicates that sx126x is busy and can not be written to
+    const gpio_driven_irq_context_t * busy_irq_context;  // Falling edge of the busy indicator, or NULL to poll it
     const uint32_t       radio_operation_timeout_us;  // Timeout to wait for radio to leave busy state
     const uint8_t        cs;                          // Chip select GPIO Pin.
     const char *         designator;                  // Radio designator string
     const uint8_t        tx_buf_start;
     const uint8_t        rx_buf_start;
+    sx126x_config_cache_t * const config_cache;      // Settings last written to the radio, or NULL to write every setting every time
 } sx126x_context_t;
 
 /**
@@ -269,6 +273,8 @@ extern i2c_context_t context_i2c_1;
 
 const extern gpio_driven_irq_context_t irq_context_radio_0;
 
+const extern gpio_driven_irq_context_t irq_context_radio_0_busy;
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
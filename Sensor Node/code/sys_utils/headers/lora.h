@@ -46,12 +46,29 @@
 #define LORA_LDRO_ON 0x01
 #define LORA_LDRO_OFF 0x00
 
+#define LORA_LDRO_SYMBOL_TIME_THRESHOLD_US 16380    // LDRO is required at and above a 16.38 ms symbol time
+
 #define LORA_FREQ_NORTH_AMERICA 915000000   // 915 MHz
 
 #define LORA_MAX_PKT_LEN 0x100
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Configuration Cache Fields
+
+#define LORA_CACHE_PKT_TYPE     (1u << 0)
+#define LORA_CACHE_RF_FREQ      (1u << 1)
+#define LORA_CACHE_PA_CFG       (1u << 2)
+#define LORA_CACHE_TX_PARAMS    (1u << 3)
+#define LORA_CACHE_BUFFER_BASE  (1u << 4)
+#define LORA_CACHE_MOD_PARAMS   (1u << 5)
+#define LORA_CACHE_PKT_PARAMS   (1u << 6)
+#define LORA_CACHE_SYNC_WORD    (1u << 7)
+#define LORA_CACHE_DIO_IRQ      (1u << 8)
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Types
 
@@ -62,6 +79,24 @@ typedef struct sx126x_dio_irq_masks_s {
     uint16_t dio3_mask;
 } sx126x_dio_irq_masks_t;
 
+/**
+ * @brief Shadow copy of the settings last written to an sx126x, so that setting up each TX and RX only sends the commands whose
+ * settings changed. Only the fields flagged in `valid` are known to match the radio; a reset or sleep clears them all.
+ */
+typedef struct sx126x_config_cache_s {
+    uint32_t valid;                         // LORA_CACHE_* flags of the fields below that hold the radio's current settings
+    uint32_t rf_freq_hz;
+    sx126x_pa_cfg_params_t pa_cfg;
+    int8_t tx_power;
+    sx126x_ramp_time_t ramp_time;
+    uint8_t tx_base_address;
+    uint8_t rx_base_address;
+    sx126x_mod_params_lora_t mod_params;
+    sx126x_pkt_params_lora_t pkt_params;
+    uint8_t sync_word;
+    sx126x_dio_irq_masks_t irq_masks;
+} sx126x_config_cache_t;
+
 typedef struct lora_setup_s {
     sx126x_context_t* hw;
     sx126x_pa_cfg_params_t* pa_setting;
@@ -72,12 +107,16 @@ typedef struct lora_setup_s {
     sx126x_pkt_params_lora_t *pkt_setting;
     int8_t txPower;
     uint32_t operation_timeout_ms;
+    uint32_t ack_rx_delay_us;       // Time from the end of a transmission until the window for its ACK opens
     void *node_config;
 } lora_setup_t;
 
 typedef struct lora_pkt_s {
     uint8_t buf[LORA_MAX_PKT_LEN];
     uint8_t len;
+    bool corrupted;     // Received with a bad CRC. Only its header is worth reading, and that only as a hint.
+    bool link_valid;    // The radio's packet status was read for this packet
+    sx126x_pkt_status_lora_t link;
 } lora_pkt_t;
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -104,6 +143,12 @@ sx126x_status_t sx126x_radio_setup(const void* context);
  */
 bool lora_enter_sleep_mode(const sx126x_context_t* radio_context, bool use_warm_start);
 
+/**
+ * @brief Forgets every cached radio setting, so the next TX or RX setup writes them all. Called whenever the radio may have lost
+ * its configuration (reset, sleep, or a failed command).
+ */
+void lora_invalidate_config_cache(const sx126x_context_t* radio_context);
+
 /**
  * @brief Initialize the sx126x in transmit mode
  * 
@@ -131,6 +176,7 @@ bool lora_init_tx(  const sx126x_context_t* radio_context,
  * @param lora_packet_parameters        `sx126x_pkt_params_lora_s` LoRa packet configuration data struct. Can be passed with or without the payload length.
  * @param buf                           Pointer to data to be sent
  * @param len                           Length of data to transmit
+ * @param timeout_ms                    TX Timeout in milliseconds. Should exceed the time-on-air of the packet, see `lora_time_on_air_us`
  * 
  * @returns Radio Transmit Status
  */
@@ -138,7 +184,8 @@ bool lora_tx(   const sx126x_context_t* radio_context,
                 sx126x_dio_irq_masks_t* radio_interrupt_cfg,
                 sx126x_pkt_params_lora_t* lora_packet_parameters,
                 uint8_t *buf, 
-                uint8_t len);
+                uint8_t len,
+                uint32_t timeout_ms);
 
 /**
  * @brief Initialize the sx126x in receive mode
@@ -170,10 +217,45 @@ bool lora_rx(   sx126x_context_t* radio_context,
                 uint8_t sync_word,
                 uint32_t timeout_ms);
 
+/**
+ * @brief Calculates the duration of a single LoRa symbol, 2^SF / BW.
+ * 
+ * @param modulation_params `sx126x_mod_params_lora_t` LoRa Modulation configuration data struct
+ * 
+ * @returns Symbol time in microseconds, or 0 for an invalid bandwidth
+ */
+uint32_t lora_symbol_time_us(const sx126x_mod_params_lora_t* modulation_params);
+
+/**
+ * @brief Calculates the time-on-air of a LoRa packet, from the start of the preamble to the end of the payload CRC.
+ * 
+ * @param modulation_params `sx126x_mod_params_lora_t` LoRa Modulation configuration data struct. LDRO is derived, not read.
+ * @param packet_params     `sx126x_pkt_params_lora_t` LoRa packet configuration data struct. The payload length is ignored.
+ * @param len               Payload length in bytes
+ * 
+ * @returns Time-on-air in microseconds, rounded up
+ */
+uint32_t lora_time_on_air_us(   const sx126x_mod_params_lora_t* modulation_params,
+                                const sx126x_pkt_params_lora_t* packet_params,
+                                uint8_t len);
+
+/**
+ * @brief Calculates the time from the start of a packet's preamble until a receiver has validated its header. The sx126x
+ * stops its RX timeout timer at this point, so an RX timeout only needs to cover the wait for a packet to begin plus this time.
+ * 
+ * @param modulation_params `sx126x_mod_params_lora_t` LoRa Modulation configuration data struct
+ * @param packet_params     `sx126x_pkt_params_lora_t` LoRa packet configuration data struct
+ * 
+ * @returns Header time in microseconds, rounded up
+ */
+uint32_t lora_header_time_us(   const sx126x_mod_params_lora_t* modulation_params,
+                                const sx126x_pkt_params_lora_t* packet_params);
+
 /**
  * @brief Chooses whether to turn on the LoRa Low Data Rate Optimization based on the selected LoRa Modulation Params.
+ * LDRO is turned on when the symbol time is at or above 16.38 ms.
  * 
- * @remark Requires that spreading factor (SF), bandwidth (BW), and coding rate (CR) are already set
+ * @remark Requires that spreading factor (SF) and bandwidth (BW) are already set
  * 
  * @param modulation_params pointer to `sx126x_mod_params_lora_t` struct to be edited in-place 
  * 
@@ -189,6 +271,27 @@ void set_lora_ldro_val(sx126x_mod_params_lora_t* modulation_params);
  * @param rxLen Received packet length
  */
 bool lora_get_rx_data(sx126x_context_t* radio_context, uint8_t * rxBuf, uint8_t * rxLen);
+
+/**
+ * @brief Retrieves the link quality of the last packet received: its RSSI, SNR and RSSI after despreading. Must be read
+ * before the next packet arrives, which overwrites it.
+ * 
+ * @param radio_context sx126x hardware implementation info
+ * @param pkt Received packet, whose `link` and `link_valid` are set
+ * 
+ * @returns True if the packet status was read
+ */
+bool lora_get_rx_link_quality(sx126x_context_t* radio_context, lora_pkt_t* pkt);
+
+/**
+ * @brief Returns the lowest SNR at which the sx126x can still demodulate a packet at the given spreading factor, from -2.5 dB
+ * at SF5 down to -20 dB at SF12. The SNR of a received packet less this is its link margin.
+ * 
+ * @param sf Spreading factor
+ * 
+ * @returns Demodulation floor in tenths of a dB
+ */
+int16_t lora_snr_floor_db_x10(sx126x_lora_sf_t sf);
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #endif
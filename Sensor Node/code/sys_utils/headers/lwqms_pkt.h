@@ -26,9 +26,39 @@
 // Definitions
 
 #define LWQMS_PKT_LEN_MAX 19    // Works out to 370ms of on air time.
+#define LWQMS_PKT_HEADER_LEN 7  // IDs and packet type, at the front of every packet
+#define LWQMS_PKT_CRC_LEN 2     // CRC-16 trailer after every packet on the air
+
+// A telemetry batch is a regular packet header followed by its samples, so everything that handles a regular packet
+// (ACKs, flags, duplicate suppression) handles a batch unchanged.
+#define LWQMS_PKT_BATCH_SAMPLE_LEN 14                                                       // 2 byte age + 3 x 4 byte float
+#define LWQMS_PKT_BATCH_MAX_SAMPLES 16                                                      // 243 bytes, inside the 255 byte LoRa payload
+#define LWQMS_PKT_BATCH_LEN(qty_samples) (LWQMS_PKT_LEN_MAX + ((qty_samples) * LWQMS_PKT_BATCH_SAMPLE_LEN))
+#define LWQMS_PKT_BATCH_AGE_MAX_S 0xFFFF                                                    // Older samples report this age
+
+// Compact telemetry carries fixed-point samples, each field in steps of 1 / scale.
+#define LWQMS_COMPACT_TURBIDITY_SCALE 10        // 0.1 NTU
+#define LWQMS_COMPACT_TEMPERATURE_SCALE 100     // 0.01 C
+#define LWQMS_COMPACT_PH_SCALE 100              // 0.01 pH
+
+// First byte after the header of a compact telemetry packet: the sample count, less one, and how the samples are coded
+#define LWQMS_COMPACT_QTY_MASK 0x0F
+#define LWQMS_COMPACT_FLAG_DELTA 0x10           // The first sample is a delta against the last sample of the previous packet
+#define LWQMS_COMPACT_FLAG_RAW 0x20             // Samples are raw floats: a field would not fit its fixed-point range
+#define LWQMS_PKT_COMPACT_LEN_MAX (LWQMS_PKT_HEADER_LEN + 1 + (LWQMS_PKT_BATCH_MAX_SAMPLES * 15))  // 3 byte age + 12 bytes of raw floats per sample
+
+// Longest frame any LWQMS packet puts on the air: a compact packet of raw samples, which outgrows a full batch
+#define LWQMS_PKT_FRAME_LEN_MAX (LWQMS_PKT_COMPACT_LEN_MAX + LWQMS_PKT_CRC_LEN)
 
 #define ACK_INDICATOR "ACK_"
 #define NACK_INDICATOR "NACK"
+#define SACK_INDICATOR "SR"     // Marks an ACK that also carries a cumulative ACK and a bitmap for selective repeat
+
+// The packet type byte carries the type in its low bits and selective repeat flags in its high bits.
+#define LWQMS_PKT_TYPE_MASK 0x1F
+#define LWQMS_PKT_FLAG_SYNC 0x20            // First packet of a sequence (a windowed transfer, or a node's first after power-up); the receiver anchors its sequence numbers here
+#define LWQMS_PKT_FLAG_WINDOWED 0x40        // Part of a selective repeat transfer; the packet ID is its sequence number
+#define LWQMS_PKT_FLAG_ACK_REQUEST 0x80     // Last packet the sender will send before waiting for a selective ACK
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -40,7 +70,9 @@
  */
 typedef enum lwqms_packet_types_e {
     LWQMS_PACKET_TYPE_TELEMETRY = 0,
-    LWQMS_PACKET_TYPE_MESSAGE = 1
+    LWQMS_PACKET_TYPE_MESSAGE = 1,
+    LWQMS_PACKET_TYPE_TELEMETRY_BATCH = 2,
+    LWQMS_PACKET_TYPE_TELEMETRY_COMPACT = 3
 } lwqms_packet_types_t;
 
 /**
@@ -53,6 +85,35 @@ typedef struct lwqms_telemetry_s {
     float pH_measurement;
 } lwqms_telemetry_t;
 
+/**
+ * @brief One sample of a telemetry batch, timestamped by its age: how long before the batch was sent it was taken.
+ * The node has no clock that survives the dormant state, so the gateway places each sample in time by its own clock.
+ */
+typedef struct lwqms_telemetry_sample_s {
+    uint16_t age_s;
+    lwqms_telemetry_t telemetry;
+} lwqms_telemetry_sample_t;
+
+/**
+ * @brief Samples carried by a `LWQMS_PACKET_TYPE_TELEMETRY_BATCH` packet, oldest first
+ */
+typedef struct lwqms_telemetry_batch_s {
+    uint8_t qty_samples;
+    lwqms_telemetry_sample_t samples[LWQMS_PKT_BATCH_MAX_SAMPLES];
+} lwqms_telemetry_batch_t;
+
+/**
+ * @brief The sample compact telemetry is coded against: the last sample of the previous packet, in fixed point.
+ * The sender keeps the last one the receiver acknowledged, and the receiver keeps the last one it decoded from each node.
+ */
+typedef struct lwqms_telemetry_ref_s {
+    bool valid;
+    uint16_t pkt_id;        // Packet the sample was the last of
+    int32_t turbidity;
+    int32_t temperature;
+    int32_t pH;
+} lwqms_telemetry_ref_t;
+
 /**
  * @brief Defines the ultimate payload contained in the packet. By using a union type, we can represent both
  * payload types using the same C type and same memory locations.
@@ -65,7 +126,7 @@ typedef union lwqms_pkt_payload_u {
 // The packet will occupy 19 bytes, and the payload will either be a 12 byte telemetry data payload, or a 12 byte string message!!
 
 /**
- * Packet Structure:
+ * Packet Structure (in order on air):
  * 
  * 2 byte packet ID
  * 2 byte destination ID
@@ -74,14 +135,30 @@ typedef union lwqms_pkt_payload_u {
  * 4 byte raw float x 3 (turb, temp, pH)
  * 
  * = 19 bytes total
+ * 
+ * A telemetry batch uses the first byte of the payload for its sample count, and is followed by the samples:
+ * 
+ * 2 byte age in seconds
+ * 4 byte raw float x 3 (turb, temp, pH)
+ * 
+ * = 14 bytes per sample
+ * 
+ * Compact telemetry replaces the payload of a telemetry batch, and is as long as its samples need:
+ * 
+ * 1 byte sample count and coding (LWQMS_COMPACT_*)
+ * Per sample, oldest first:
+ *   varint age in seconds (first sample), or zig-zag varint change in age from the previous sample
+ *   zig-zag varint x 3 (turb, temp, pH) in fixed point, each the change from the previous sample, or 4 byte raw float x 3
+ * 
+ * The first sample is absolute unless LWQMS_COMPACT_FLAG_DELTA is set.
  */
 
 typedef struct lwqms_pkt_s {
     uint16_t pkt_id;
     uint16_t dest_id;
     uint16_t src_id;
-    lwqms_pkt_payload_t payload;
     uint8_t packet_type;   // Will be explicitly cast to uint8_t to ensure we have only 1 byte taken up here
+    lwqms_pkt_payload_t payload;
 } lwqms_pkt_t; 
 
 typedef enum lwqms_pkt_ack_status_e {
@@ -110,11 +187,118 @@ bool lwqms_pkt_encode(lwqms_pkt_t *pkt_data, uint8_t *buf, size_t buflen);
  * @brief Takes a raw input buffer and writes it to an organized data structure
  * 
  * @param buf: Buffer containing raw packet data
- * @param buflen: Sanity check to ensure the incoming buffer is appropriately sized (>= LWQMS_PKT_LEN_MAX)
+ * @param buflen: Sanity check to ensure the incoming buffer holds at least a header (>= LWQMS_PKT_HEADER_LEN). The payload
+ * of a shorter packet than LWQMS_PKT_LEN_MAX is filled out with zeroes.
  * @param pkt_out: Output data structure containing 
  */
 bool lwqms_pkt_decode(uint8_t *buf, size_t buflen, lwqms_pkt_t *pkt_out);
 
+/**
+ * @brief Encodes a telemetry batch: the packet header, followed by every sample in the batch
+ * 
+ * @param pkt_header Packet IDs and flags to send the batch with. Its type is set to `LWQMS_PACKET_TYPE_TELEMETRY_BATCH`.
+ * @param batch Samples to send, between 1 and `LWQMS_PKT_BATCH_MAX_SAMPLES`
+ * @param buf Buffer to which the converted packet will be stored
+ * @param buflen Sanity check to ensure the destination buffer can hold the whole batch (>= `LWQMS_PKT_BATCH_LEN(qty_samples)`)
+ * @param pkt_len Set to the length of the encoded packet
+ * 
+ * @returns Operation Status
+ */
+bool lwqms_pkt_encode_batch(lwqms_pkt_t *pkt_header, lwqms_telemetry_batch_t *batch, uint8_t *buf, size_t buflen, size_t *pkt_len);
+
+/**
+ * @brief Decodes a telemetry batch
+ * 
+ * @param buf Buffer containing raw packet data
+ * @param buflen Length of the received packet
+ * @param pkt_out Output data structure for the packet header
+ * @param batch_out Output data structure for the samples
+ * 
+ * @returns True for a well-formed telemetry batch, false for a truncated batch or any other packet type
+ */
+bool lwqms_pkt_decode_batch(uint8_t *buf, size_t buflen, lwqms_pkt_t *pkt_out, lwqms_telemetry_batch_t *batch_out);
+
+/**
+ * @brief Encodes telemetry in the compact format: fixed point, delta coded and packed into varints
+ * 
+ * @param pkt_header Packet IDs and flags to send the telemetry with. Its type is set to `LWQMS_PACKET_TYPE_TELEMETRY_COMPACT`.
+ * @param batch Samples to send, between 1 and `LWQMS_PKT_BATCH_MAX_SAMPLES`
+ * @param ref Last sample the receiver acknowledged. Only used when it came in the packet just before this one, as only
+ * then is it sure to be the last sample the receiver decoded. May be NULL.
+ * @param buf Buffer to which the converted packet will be stored
+ * @param buflen Size of the destination buffer. `LWQMS_PKT_COMPACT_LEN_MAX` always fits.
+ * @param pkt_len Set to the length of the encoded packet
+ * 
+ * @returns Operation Status
+ */
+bool lwqms_pkt_encode_compact(lwqms_pkt_t *pkt_header, lwqms_telemetry_batch_t *batch, const lwqms_telemetry_ref_t *ref, uint8_t *buf, size_t buflen, size_t *pkt_len);
+
+/**
+ * @brief Decodes compact telemetry
+ * 
+ * @param buf Buffer containing raw packet data
+ * @param buflen Length of the received packet
+ * @param ref Last sample decoded from the sending node. Updated to the last sample of this packet.
+ * @param pkt_out Output data structure for the packet header
+ * @param batch_out Output data structure for the samples
+ * 
+ * @returns True for well-formed compact telemetry, false for a truncated packet, any other packet type, or a delta coded
+ * packet that does not follow the reference
+ */
+bool lwqms_pkt_decode_compact(uint8_t *buf, size_t buflen, lwqms_telemetry_ref_t *ref, lwqms_pkt_t *pkt_out, lwqms_telemetry_batch_t *batch_out);
+
+/**
+ * @brief Makes the given sample the reference for compact telemetry, as the last sample of the given packet
+ * 
+ * @param ref Reference to update. Left invalid if a field of the sample does not fit its fixed-point range.
+ * @param pkt_id Packet the sample was the last of
+ * @param telemetry Sample
+ */
+void lwqms_telemetry_ref_update(lwqms_telemetry_ref_t *ref, uint16_t pkt_id, const lwqms_telemetry_t *telemetry);
+
+/**
+ * @brief Reads the packet ID straight out of an encoded packet, without decoding the rest of it
+ * 
+ * @param buf Buffer containing raw packet data, at least LWQMS_PKT_HEADER_LEN bytes
+ * 
+ * @returns Packet ID
+ */
+uint16_t lwqms_pkt_peek_id(const uint8_t *buf);
+
+/**
+ * @brief Replaces the flag bits of the packet type in an encoded packet, in place
+ * 
+ * @param buf Buffer containing raw packet data, at least LWQMS_PKT_HEADER_LEN bytes
+ * @param flags Any combination of the LWQMS_PKT_FLAG_* values
+ */
+void lwqms_pkt_set_flags(uint8_t *buf, uint8_t flags);
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE used for the packet trailer and for the gateway's records to the host.
+ */
+uint16_t lwqms_pkt_crc16(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Appends the CRC-16 trailer to an encoded packet. Every packet carries one on the air, so that a packet damaged
+ * anywhere between the two ends is never taken for a good one.
+ * 
+ * @param buf Encoded packet, with room for `LWQMS_PKT_CRC_LEN` more bytes
+ * @param len Length of the encoded packet
+ * 
+ * @returns Length of the packet with its trailer
+ */
+size_t lwqms_pkt_crc_append(uint8_t *buf, size_t len);
+
+/**
+ * @brief Checks the CRC-16 trailer of a received packet
+ * 
+ * @param buf Received packet
+ * @param len Length of the received packet, trailer included
+ * 
+ * @returns True if the trailer matches the rest of the packet
+ */
+bool lwqms_pkt_crc_check(const uint8_t *buf, size_t len);
+
 /**
  * @brief Checks if the packet received is an ACK or NACK
  * 
@@ -136,6 +320,30 @@ lwqms_pkt_ack_status_t lwqms_pkt_check_ack(lwqms_pkt_t *pkt, uint16_t *packet_ID
  */
 bool lwqms_generate_ack_packet(lwqms_pkt_t *pkt_to_ack, lwqms_pkt_ack_status_t ack_status, lwqms_pkt_t *pkt);
 
+/**
+ * @brief Produces an ACK packet for the given packet which also reports the receiver's selective repeat window: every
+ * packet ID up to and including `cumulative_ID`, plus `cumulative_ID + 1 + k` for each bit k set in `bitmap`.
+ * 
+ * @param pkt_to_ack The packet that asked for the ACK
+ * @param cumulative_ID Highest packet ID up to which every packet has been received
+ * @param bitmap Packets received beyond the cumulative ID
+ * @param pkt Buffer to write the output packet
+ * 
+ * @returns True for a successful packet creation.
+ */
+bool lwqms_generate_sack_packet(lwqms_pkt_t *pkt_to_ack, uint16_t cumulative_ID, uint16_t bitmap, lwqms_pkt_t *pkt);
+
+/**
+ * @brief Retrieves the selective repeat window from an ACK packet.
+ * 
+ * @param pkt ACK packet to check
+ * @param cumulative_ID Buffer to write the cumulative ACK
+ * @param bitmap Buffer to write the bitmap of packets received beyond the cumulative ACK
+ * 
+ * @returns True if the ACK carried a selective repeat window, false for a plain ACK or any other packet.
+ */
+bool lwqms_pkt_get_sack_window(lwqms_pkt_t *pkt, uint16_t *cumulative_ID, uint16_t *bitmap);
+
 /**
  * @brief Displays the contents of a packet.
  * 
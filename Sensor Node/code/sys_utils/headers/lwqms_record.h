@@ -0,0 +1,126 @@
+/*************************************************************************************
+ *
+ * @file lwqms_record.h
+ *
+ * @brief Binary records from the gateway to its host. Each record is protected by a CRC-16 and sent as a COBS frame, so
+ * the host finds record boundaries by the zero byte that ends every frame and never parses text.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef LWQMS_RECORD_H
+#define LWQMS_RECORD_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include "lwqms_pkt.h"
+#include "lora.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * Every record starts with the same four bytes, and every field is little-endian:
+ *
+ *   0  u8   version             LWQMS_RECORD_VERSION
+ *   1  u8   record type         lwqms_record_type_t
+ *   2  u8   flags               LWQMS_RECORD_FLAG_*
+ *   3  u8   packet type         Packet records: the LWQMS packet type byte, flags included. Status records: 0.
+ *
+ * Packet record, one per packet the gateway delivers:
+ *
+ *   4  u16  src_id
+ *   6  u16  dest_id
+ *   8  u16  pkt_id
+ *  10  u64  rx_time_us          RX Done, in microseconds since the gateway booted
+ *  18  i8   rssi_pkt_dbm        Link quality, valid with LWQMS_RECORD_FLAG_LINK
+ *  19  i8   snr_pkt_db
+ *  20  i8   signal_rssi_pkt_dbm
+ *  21  u8   payload_len         Bytes of the packet after its 7 byte header, as they came off the air
+ *  22  ...  payload
+ *      u8   qty_samples         Telemetry the gateway decoded from the payload, valid with LWQMS_RECORD_FLAG_SAMPLES
+ *      ...  samples             14 bytes each: u16 age_s, f32 turbidity, f32 temperature, f32 pH
+ *
+ * Status record, when a host attaches and whenever the gateway falls behind:
+ *
+ *   4  u64  time_us             Microseconds since the gateway booted
+ *  12  u32  ring_overflows      Times the radio core waited for the console core
+ *  16  u32  queue_overflows     Packets left unacknowledged because the console core was too far behind
+ *
+ * Both end in a u16 CRC-16/CCITT-FALSE over everything before it.
+ */
+
+#define LWQMS_RECORD_VERSION 1
+
+#define LWQMS_RECORD_FLAG_LINK 0x01         // RSSI and SNR were read for this packet
+#define LWQMS_RECORD_FLAG_SAMPLES 0x02      // The payload was telemetry, and the gateway decoded its samples
+
+#define LWQMS_RECORD_PREFIX_LEN 4
+#define LWQMS_RECORD_PACKET_FIXED_LEN 22
+#define LWQMS_RECORD_SAMPLE_LEN 14
+#define LWQMS_RECORD_STATUS_LEN 20
+#define LWQMS_RECORD_CRC_LEN 2
+
+#define LWQMS_RECORD_LEN_MAX (LWQMS_RECORD_PACKET_FIXED_LEN + (LORA_MAX_PKT_LEN - LWQMS_PKT_HEADER_LEN) + 1 + (LWQMS_PKT_BATCH_MAX_SAMPLES * LWQMS_RECORD_SAMPLE_LEN) + LWQMS_RECORD_CRC_LEN)
+
+// COBS adds one byte per 254 and the frame ends in a zero byte.
+#define LWQMS_COBS_FRAME_LEN_MAX(record_len) ((record_len) + ((record_len) / 254) + 2)
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+typedef enum lwqms_record_type_e {
+    LWQMS_RECORD_PACKET = 1,
+    LWQMS_RECORD_STATUS = 2
+} lwqms_record_type_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Writes the record of a received packet, CRC included.
+ *
+ * @param pkt Received packet, without its CRC trailer
+ * @param pkt_len Length of the packet
+ * @param rx_time_us Time of RX Done, in microseconds since boot
+ * @param link Link quality of the packet, or NULL if it was not read
+ * @param samples Telemetry decoded from the packet, or NULL if it carried none or could not be decoded
+ * @param buf Buffer to which the record will be written
+ * @param buflen Size of the buffer. `LWQMS_RECORD_LEN_MAX` always fits.
+ *
+ * @returns Length of the record, or 0 if the packet has no header or the record does not fit
+ */
+size_t lwqms_record_encode_packet(const uint8_t *pkt, size_t pkt_len, uint64_t rx_time_us, const sx126x_pkt_status_lora_t *link, const lwqms_telemetry_batch_t *samples, uint8_t *buf, size_t buflen);
+
+/**
+ * @brief Writes a status record, CRC included.
+ *
+ * @returns Length of the record, or 0 if it does not fit
+ */
+size_t lwqms_record_encode_status(uint64_t time_us, uint32_t ring_overflows, uint32_t queue_overflows, uint8_t *buf, size_t buflen);
+
+/**
+ * @brief Frames a record with Consistent Overhead Byte Stuffing: the frame holds no zero byte except the one that ends it.
+ *
+ * @param record Record to frame
+ * @param len Length of the record
+ * @param frame Buffer to which the frame will be written
+ * @param framelen Size of the buffer. `LWQMS_COBS_FRAME_LEN_MAX(len)` always fits.
+ *
+ * @returns Length of the frame, its closing zero included, or 0 if it does not fit
+ */
+size_t lwqms_cobs_encode(const uint8_t *record, size_t len, uint8_t *frame, size_t framelen);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* LWQMS_RECORD_H */
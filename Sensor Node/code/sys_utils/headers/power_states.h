@@ -45,7 +45,7 @@
  * 
  * @param novo_mem_contents_buf Buffer to store the contents of the nonvolatile memory.
  * @param buf_len Length of destination buffer. Must be a minimum of `MCU_POWMAN_NOVO_ELEMENTS - 1` long, as the first element is reserved
- * @param data_len Number of data bytes retrieved before empty memory was found.
+ * @param data_len Number of 32-bit data elements retrieved before empty (zero or erased) memory was found.
  * 
  * @returns True for boot due to power saving mode enable, false for complete power cycle boot.
  */
@@ -60,7 +60,7 @@ bool check_for_power_saving_mode_boot(uint32_t *novo_mem_contents_buf, size_t bu
  * @param power_saving_duration_ms Time to stay in the power-saving mode, in milliseconds
  * @param novo_mem_contents User-defined contents to write to non-volatile (novo) memory when the MCU enters power saving mode. 
  *          Can be retrieved by calling `check_for_power_saving_mode_boot` upon re-entry into the entry point of the program.
- * @param novo_contents_len The number of bytes to write to the non-volatile memory. Maximum length of `MCU_POWMAN_NOVO_ELEMENTS - 1`, 
+ * @param novo_contents_len The number of 32-bit elements to write to the non-volatile memory. Maximum length of `MCU_POWMAN_NOVO_ELEMENTS - 1`, 
  *          as the first element is reserved.
  * 
  * @returns Ideally, nothing. The MCU enters the power saving mode and thus no code is executed.
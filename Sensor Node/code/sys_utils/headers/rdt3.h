@@ -25,6 +25,19 @@
 
 #define RDT_RETRIES 5
 
+#define RDT3_0_SR_WINDOW_SIZE (RDT3_0_SR_BITMAP_WIDTH / 2)  // Packets in flight per selective ACK. Half the bitmap, so a receiver that missed the first packet can still report the window.
+
+// Retransmission timeout, after RFC 6298. The RTO bounds how long to listen for an ACK's header after a transmission.
+#define RDT3_0_RTO_MIN_MS 100               // Floor for the RTO, however steady the link
+#define RDT3_0_RTO_MAX_MS 4000              // Ceiling for the RTO, however erratic the link
+// Least margin kept above the smoothed RTT. A gateway may hold an ACK back for a while as another node's frame comes in,
+// however steady the link has been.
+#define RDT3_0_RTO_VARIATION_MIN_MS RDT3_0_GW_ACK_DEFER_MAX_MS
+
+// Backoff between attempts: a random wait of up to BASE * 2^(attempt - 1), capped, so nodes that collided once spread out.
+#define RDT3_0_BACKOFF_BASE_MS 500
+#define RDT3_0_BACKOFF_MAX_MS 8000          // Keep well below WATCHDOG_MAX_DELAY_MS
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -41,15 +54,111 @@ typedef enum rdt3_0_result_codes_e {
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Types
 
+/**
+ * @brief Round trip time estimate for one peer: how long after a transmission its ACK's header arrives. Both fields are
+ * zero until the first sample, in which case the HAL's default ACK timeout is used.
+ */
+typedef struct rdt3_0_rtt_estimator_s {
+    uint16_t srtt_ms;       // Smoothed round trip time
+    uint16_t rttvar_ms;     // Smoothed mean deviation of the round trip time
+} rdt3_0_rtt_estimator_t;
+
+/**
+ * @brief Everything an RDT 3.0 endpoint needs besides the packets it moves: scratch space for the ACK it receives while
+ * sending, or the ACK it builds while receiving, and the hardware it sends them with. Allocate one statically per radio so
+ * that no transfer touches the heap. The context also learns the round trip time to the peer it sends to.
+ * 
+ * @remark Not safe to share between transfers that may run at the same time.
+ */
+typedef struct rdt3_0_ctx_s {
+    rdt_packet_t scratch_pkt;
+    size_t pkt_obj_size;
+    void *physical_layer_setup;
+    rdt3_0_rtt_estimator_t rtt;
+} rdt3_0_ctx_t;
+
+/**
+ * @brief Static initializer for an `rdt3_0_ctx_t`, given a pointer to the scratch packet object and the physical layer setup.
+ */
+#define RDT3_0_CTX_INIT(scratch_pkt_ptr, physical_layer_setup_ptr) {   \
+    .scratch_pkt = (scratch_pkt_ptr),                                   \
+    .pkt_obj_size = sizeof(*(scratch_pkt_ptr)),                         \
+    .physical_layer_setup = (physical_layer_setup_ptr)                  \
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Function Declarations
 
+/**
+ * @brief Sends a packet and waits for its ACK, stop-and-wait. The wait for the ACK follows the context's retransmission
+ * timeout, and attempts after the first are delayed by a random, exponentially growing backoff.
+ * 
+ * @param ctx Endpoint context. Its scratch packet receives the ACK.
+ * @param pkt The packet to send. Sent from where it lies; it is not copied.
+ * 
+ * @returns `RDT3_0_RESULT_CODES_OK` once the packet is acknowledged
+ */
+rdt3_0_result_codes_t rdt3_0_transmit_ctx(rdt3_0_ctx_t *ctx, rdt_packet_t pkt);
+
+/**
+ * @brief Receives a packet intended for this device and acknowledges it.
+ * 
+ * @param ctx Endpoint context. Its scratch packet holds the outgoing ACK.
+ * @param pkt Buffer to which the received packet is written by the radio
+ * 
+ * @returns `RDT3_0_RESULT_CODES_OK` once a packet is received
+ */
+rdt3_0_result_codes_t rdt3_0_receive_ctx(rdt3_0_ctx_t *ctx, rdt_packet_t pkt);
+
+/**
+ * @brief Sends a backlog of packets using selective repeat. Up to `RDT3_0_SR_WINDOW_SIZE` packets are sent back to back before
+ * the receiver is asked for a selective ACK, and only the packets it reports missing are sent again.
+ * 
+ * @param ctx Endpoint context. Its scratch packet receives the selective ACKs, and its object size is that of each packet.
+ * @param pkts Contiguous array of packets to send, in sequence number order
+ * @param qty_pkts Number of packets in the array
+ * @param qty_delivered Optional. Number of packets from the start of the array which were acknowledged.
+ * 
+ * @returns `RDT3_0_RESULT_CODES_OK` once every packet is acknowledged, or an error after `RDT_RETRIES` rounds in a row without progress.
+ */
+rdt3_0_result_codes_t rdt3_0_transmit_window_ctx(rdt3_0_ctx_t *ctx, rdt_packet_t pkts, size_t qty_pkts, size_t *qty_delivered);
+
+/**
+ * @brief Retransmission timeout currently in use by a context.
+ * 
+ * @returns RTO in milliseconds, or 0 before the first round trip time sample (the HAL's default ACK timeout applies)
+ */
+uint32_t rdt3_0_rto_ms(const rdt3_0_ctx_t *ctx);
+
+/**
+ * @brief Packs a context's round trip time estimate into one word, to be kept in novo memory across the dormant state.
+ * 
+ * @returns The packed estimate. 0 if there is no estimate yet.
+ */
+uint32_t rdt3_0_rtt_save(const rdt3_0_ctx_t *ctx);
+
+/**
+ * @brief Restores a round trip time estimate packed by `rdt3_0_rtt_save`.
+ */
+void rdt3_0_rtt_restore(rdt3_0_ctx_t *ctx, uint32_t saved_rtt);
+
+/**
+ * @brief As `rdt3_0_transmit_ctx`, with a scratch packet of `pkt_obj_size` bytes allocated from the heap for the call.
+ */
 rdt3_0_result_codes_t rdt3_0_transmit(rdt_packet_t pkt, size_t pkt_obj_size, void *physical_layer_setup);
 
+/**
+ * @brief As `rdt3_0_receive_ctx`, with a scratch packet of `pkt_obj_size` bytes allocated from the heap for the call.
+ */
 rdt3_0_result_codes_t rdt3_0_receive(rdt_packet_t pkt, size_t pkt_obj_size, void *physical_layer_setup);
 
+/**
+ * @brief As `rdt3_0_transmit_window_ctx`, with a scratch packet of `pkt_obj_size` bytes allocated from the heap for the call.
+ */
+rdt3_0_result_codes_t rdt3_0_transmit_window(rdt_packet_t pkts, size_t qty_pkts, size_t pkt_obj_size, void *physical_layer_setup, size_t *qty_delivered);
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #endif /* RDT3_0_H */
\ No newline at end of file
@@ -0,0 +1,198 @@
+/*************************************************************************************
+ *
+ * @file rdt3_gateway.h
+ *
+ * @brief Multi-node gateway service for the Reliable Data Transfer 3.0 Transport Layer. The radio stays in continuous
+ * receive, frames are taken off it as they arrive, and each node's ACK is scheduled around the frames of the others.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef RDT3_0_GATEWAY_H
+#define RDT3_0_GATEWAY_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include "rdt3_hal.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Definitions
+
+#define RDT3_0_GW_QUEUE_LEN 8                       // Packets received and acknowledged, waiting for the application
+#define RDT3_0_GW_MAX_NODES RDT3_0_SR_MAX_PEERS     // Nodes with a session at once; the one heard from least recently is dropped first
+#define RDT3_0_GW_LINK_WINDOW 32                    // Packets each node's rolling link statistics cover
+#define RDT3_0_GW_LINK_MARGIN_DB 6                  // SNR to keep in hand above the demodulation floor when suggesting a faster SF
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief RSSI and SNR of the last `RDT3_0_GW_LINK_WINDOW` packets heard from one node, damaged ones included.
+ */
+typedef struct rdt3_0_gw_link_history_s {
+    int8_t rssi_dbm[RDT3_0_GW_LINK_WINDOW];
+    int8_t snr_db[RDT3_0_GW_LINK_WINDOW];
+    uint8_t next;
+    uint8_t count;
+    uint32_t measured;                  // Packets measured since the session began
+} rdt3_0_gw_link_history_t;
+
+/**
+ * @brief Summary of a node's link over its rolling window, as `rdt3_0_gateway_link_stats` works it out.
+ */
+typedef struct rdt3_0_gw_link_stats_s {
+    uint8_t window;                     // Packets the summary covers
+    int8_t rssi_min_dbm;
+    int8_t rssi_max_dbm;
+    int16_t rssi_mean_db_x10;
+    int8_t snr_min_db;
+    int8_t snr_max_db;
+    int16_t snr_mean_db_x10;
+    int16_t margin_db_x10;              // Worst SNR in the window above the demodulation floor of the gateway's SF
+    sx126x_lora_sf_t fastest_sf;        // Fastest SF whose floor the worst SNR still clears by RDT3_0_GW_LINK_MARGIN_DB
+} rdt3_0_gw_link_stats_t;
+
+/**
+ * @brief What the gateway knows about one node, and the ACK it still owes it.
+ */
+typedef struct rdt3_0_gw_session_s {
+    uint16_t node_id;                   // 0 for a free slot; node IDs start at 1
+    uint32_t last_heard_ms;
+
+    uint32_t frames;                    // Intact frames addressed to the gateway
+    uint32_t delivered;                 // New packets queued for the application
+    uint32_t duplicates;                // Packets received again after their ACK was lost
+    uint32_t acks_sent;                 // Including NACKs
+    uint32_t acks_expired;              // ACKs that could not go out before the node stopped listening
+
+    rdt3_0_gw_link_history_t link;
+    lwqms_telemetry_ref_t telemetry_ref;    // Last sample decoded from the node, which its compact telemetry is coded against
+
+    bool ack_pending;
+    bool ack_held;                      // Waiting for a frame being received to end
+    absolute_time_t ack_deadline;       // The node stops listening for the ACK soon after this
+    lora_pkt_t ack;
+} rdt3_0_gw_session_t;
+
+/**
+ * @brief What the gateway observed about a packet as it came off the radio.
+ */
+typedef struct rdt3_0_gw_rx_info_s {
+    uint64_t rx_time_us;                // RX Done, in microseconds since the gateway booted
+    lwqms_telemetry_ref_t telemetry_ref;    // Compact telemetry: the sample the packet was coded against, to decode it with
+} rdt3_0_gw_rx_info_t;
+
+// A received packet waiting in the queue
+typedef struct rdt3_0_gw_rx_s {
+    lora_pkt_t pkt;
+    rdt3_0_gw_rx_info_t info;
+} rdt3_0_gw_rx_t;
+
+typedef struct rdt3_0_gw_stats_s {
+    uint32_t frames;                    // Every RX Done, including damaged frames and frames for other devices
+    uint32_t crc_errors;
+    uint32_t not_addressed;
+    uint32_t header_errors;
+    uint32_t queue_overflows;           // Packets dropped unacknowledged because the application had not caught up
+    uint32_t acks_deferred;             // ACKs held back until a frame being received had ended
+    uint32_t acks_preempting;           // ACKs sent over a frame being received, which could not end in time
+    uint32_t acks_expired;
+    uint32_t rx_restarts;               // Times the radio had to be put back in continuous receive after an ACK
+    uint32_t telemetry_unreferenced;    // Delta coded telemetry left unacknowledged: the sample it was coded against is not known here
+} rdt3_0_gw_stats_t;
+
+/**
+ * @brief Gateway service state. Sessions are created as nodes are heard from, so a zeroed object only needs
+ * `rdt3_0_gateway_start`.
+ */
+typedef struct rdt3_0_gateway_s {
+    lora_setup_t phy;                   // Copy of the caller's setup, pointed at the gateway's own interrupt configuration
+    sx126x_dio_irq_masks_t irq_masks;
+    bool listening;
+
+    // A frame is on its way in: ACKs wait for it unless it would make them late.
+    bool rx_in_progress;
+    absolute_time_t rx_busy_until;
+
+    // Received packets not yet returned to the application
+    rdt3_0_gw_rx_t queue[RDT3_0_GW_QUEUE_LEN];
+    uint8_t queue_head;
+    uint8_t queue_len;
+
+    rdt3_0_gw_session_t sessions[RDT3_0_GW_MAX_NODES];
+    rdt3_0_gw_stats_t stats;
+
+    lwqms_telemetry_batch_t telemetry_scratch;  // Samples of compact telemetry decoded to move its node's reference on
+} rdt3_0_gateway_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Sets up the gateway service and puts the radio in continuous receive.
+ *
+ * @param gw Gateway service state
+ * @param setup LoRa setup of the gateway. Copied, so its interrupt settings are left untouched.
+ *
+ * @returns True if the radio is listening
+ */
+bool rdt3_0_gateway_start(rdt3_0_gateway_t *gw, lora_setup_t *setup);
+
+/**
+ * @brief Services the radio until a new packet has been received and acknowledged, or the timeout expires. ACKs are sent
+ * from in here, so the service must be called again promptly after each packet.
+ *
+ * @param gw Gateway service state
+ * @param pkt Buffer to which the received packet will be written, without its CRC trailer
+ * @param info Where to write what the gateway observed about the packet. May be NULL.
+ * @param timeout_ms Time to wait for a packet
+ *
+ * @remark Duplicates are acknowledged but never returned, so each packet is returned once. A packet that arrives while the
+ * queue is full is not acknowledged, and its node sends it again. Nor is compact telemetry coded against a sample the node's
+ * session does not hold, as after the gateway restarted or dropped the session: once the node gives up on it, its next
+ * packet is sent without a reference. Compact telemetry is returned with the reference it decodes against in `info`.
+ *
+ * @returns True if a packet was returned, false on timeout
+ */
+bool rdt3_0_gateway_receive(rdt3_0_gateway_t *gw, lora_pkt_t *pkt, rdt3_0_gw_rx_info_t *info, uint32_t timeout_ms);
+
+/**
+ * @brief Services the radio and sends ACKs for the given time without returning any packet, for when the application has
+ * nowhere to put one. Received packets collect in the queue, and once it is full they are left unacknowledged.
+ *
+ * @param gw Gateway service state
+ * @param timeout_ms Time to keep servicing
+ */
+void rdt3_0_gateway_service(rdt3_0_gateway_t *gw, uint32_t timeout_ms);
+
+/**
+ * @brief Returns the session of the given node, or NULL if the gateway has none.
+ */
+const rdt3_0_gw_session_t *rdt3_0_gateway_session(const rdt3_0_gateway_t *gw, uint16_t node_id);
+
+/**
+ * @brief Summarizes the link of one node over its last `RDT3_0_GW_LINK_WINDOW` packets. The SNR a packet is received with
+ * does not depend on the spreading factor it was sent with, so the worst SNR in the window says how far the node's SF could
+ * come down: every step down gives up 2.5 dB of the margin above the demodulation floor.
+ *
+ * @param gw Gateway service state
+ * @param node_id Node to summarize
+ * @param stats Where to write the summary
+ *
+ * @returns False if the gateway has no session with the node, or has not measured any of its packets
+ */
+bool rdt3_0_gateway_link_stats(const rdt3_0_gateway_t *gw, uint16_t node_id, rdt3_0_gw_link_stats_t *stats);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* RDT3_0_GATEWAY_H */
@@ -24,6 +24,15 @@
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 // Definitions 
 
+#define RDT3_0_TX_DONE_MARGIN_MS 50         // Allowance beyond the time-on-air for the PA ramp and the radio to raise TX Done
+#define RDT3_0_ACK_TURNAROUND_MS 250        // Allowance for the receiver to process a packet and key up its transmitter with the ACK
+#define RDT3_0_GW_ACK_DEFER_MAX_MS 50       // Longest a gateway holds an ACK back for another node's frame still coming in
+#define RDT3_0_IRQ_MARGIN_MS 20             // Extra wait beyond the radio's own timeout, so that the radio always reports the outcome
+
+#define RDT3_0_SR_BITMAP_WIDTH 16           // Packets beyond the cumulative ACK that a selective ACK can report
+#define RDT3_0_SR_MAX_PEERS 16              // Senders a receiver can track sequence numbers for at once
+#define RDT3_0_SR_STATE_EXPIRY_MS 60000     // A sender silent this long has finished its transfer; its sequence numbers are forgotten
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -34,6 +43,10 @@ typedef enum rdt3_0_ack_e {
     RDT3_0_NACK = -1,
     RDT3_0_ACK_ERR = -2,
     RDT3_0_ACK_BAD_ID = -3,
+    RDT3_0_ACK_DEFERRED = -4,               // New packet of a window. The sender has not asked for an ACK yet.
+    RDT3_0_ACK_DUPLICATE = -5,              // Packet was already received. The ACK must still be sent, but the packet not delivered again.
+    RDT3_0_ACK_DUPLICATE_DEFERRED = -6,     // Packet was already received and the sender has not asked for an ACK.
+    RDT3_0_ACK_NONE = -7,                   // Nothing usable was heard while waiting for the ACK. Handled as a timeout.
 } rdt3_0_ack_t;
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -68,6 +81,36 @@ bool rdt3_0_tx_hal(rdt_packet_t pkt, void* physical_context);
  */
 bool rdt3_0_rx_hal(rdt_packet_t pkt, void* physical_context);
 
+/**
+ * @brief Receives the ACK for a packet just sent by `rdt3_0_tx_hal`. Listens only as long as the ACK could take to begin,
+ * rather than the full operation timeout.
+ * 
+ * @param pkt Empty buffer to which the received packet will be written
+ * @param ack_timeout_ms Time from now within which the ACK's header must have arrived, or 0 for a default derived from the
+ * receiver turnaround and the LoRa airtime
+ * @param ack_delay_ms Optional. Set to the time from now until the ACK's header arrived, for round trip time estimation.
+ * @param physical_context Object containing data about the hardware which will be sending the packet
+ * 
+ * @returns Operation Result Code
+ */
+bool rdt3_0_rx_ack_hal(rdt_packet_t pkt, uint32_t ack_timeout_ms, uint32_t *ack_delay_ms, void* physical_context);
+
+/**
+ * @brief Sends a packet and receives its ACK as one operation. The receiver is armed straight from the TX Done interrupt,
+ * `ack_rx_delay_us` of the LoRa setup after the end of the transmission, reusing the modulation the packet was sent with, so
+ * a receiver that answers quickly is not missed.
+ * 
+ * @param pkt The packet to send
+ * @param ack_pkt Empty buffer to which the received packet will be written
+ * @param ack_timeout_ms Time from the opening of the window within which the ACK's header must have arrived, or 0 for the
+ * default of `rdt3_0_rx_ack_hal`
+ * @param ack_delay_ms Optional. Set to the time from the opening of the window until the ACK's header arrived.
+ * @param physical_context Object containing data about the hardware which will be sending the packet
+ * 
+ * @returns True if the packet was sent and a packet was received in the window
+ */
+bool rdt3_0_tx_then_rx_ack_hal(rdt_packet_t pkt, rdt_packet_t ack_pkt, uint32_t ack_timeout_ms, uint32_t *ack_delay_ms, void* physical_context);
+
 /**
  * @brief Checks the ACK status of the received ACK packet to determine if the package was received without error.
  * 
@@ -75,10 +118,37 @@ bool rdt3_0_rx_hal(rdt_packet_t pkt, void* physical_context);
  * @param sent_pkt The packet that was sent that the ACK packet corresponds to
  * @param phy_setup Hardware configuration data.
  * 
- * @returns ACK status
+ * @returns ACK status. `RDT3_0_ACK_NONE` for a damaged frame or one too short to be a packet.
  */
 rdt3_0_ack_t rdt3_0_process_ack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t sent_pkt, void *phy_setup);
 
+/**
+ * @brief Flags a packet of a selective repeat transfer before it is sent.
+ * 
+ * @param pkt The packet to flag
+ * @param first_in_transfer True for the first packet of the transfer, which anchors the receiver's sequence numbers
+ * @param ack_request True for the last packet sent before waiting for a selective ACK
+ * @param phy_setup Hardware configuration data
+ * 
+ * @returns Operation Status
+ */
+bool rdt3_0_mark_window_pkt_hal(rdt_packet_t pkt, bool first_in_transfer, bool ack_request, void *phy_setup);
+
+/**
+ * @brief Checks a selective ACK against a window of sent packets, marking every packet it acknowledges.
+ * 
+ * @param ack_pkt The packet received containing the selective ACK
+ * @param window_pkts Contiguous array of the packets in the window
+ * @param qty_pkts Number of packets in the window
+ * @param pkt_obj_size Size of each packet object in the array
+ * @param acked_mask Bit k is set for each acknowledged packet k of the window
+ * @param phy_setup Hardware configuration data
+ * 
+ * @returns ACK status. `RDT3_0_ACK_BAD_ID` for an ACK intended for another device or not answering this window, and
+ * `RDT3_0_ACK_NONE` for a damaged frame or one too short to be a packet.
+ */
+rdt3_0_ack_t rdt3_0_process_sack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t window_pkts, size_t qty_pkts, size_t pkt_obj_size, uint16_t *acked_mask, void *phy_setup);
+
 /**
  * @brief Checks the received packet for error and generates a corresponding ACK/NACK packet
  * 
@@ -86,6 +156,11 @@ rdt3_0_ack_t rdt3_0_process_ack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t sent_
  * @param ack_pkt Buffer to which the resulting ACK packet will be written.
  * @param phy_setup Hardware configuration data
  * 
+ * @remark Packet IDs are tracked per sender, and a packet received before is acknowledged again but reported as a duplicate
+ * so that it is not delivered twice. A packet flagged `LWQMS_PKT_FLAG_SYNC` restarts the sender's sequence, as after a reboot.
+ * Packets of a selective repeat transfer only produce an ACK packet when they ask for one, and it reports every packet of the
+ * transfer received so far.
+ * 
  * @returns Packet generation status.
  */
 rdt3_0_ack_t rdt3_0_process_data_packet_hal(rdt_packet_t received_pkt, rdt_packet_t ack_pkt, void *phy_setup);
@@ -0,0 +1,89 @@
+/*************************************************************************************
+ *
+ * @file spsc_ring.h
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer, for handing objects from one core to the other
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Dependencies
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Types
+
+/**
+ * @brief Ring of fixed-size objects in caller-provided storage. The producer only ever writes `head` and the consumer only
+ * ever writes `tail`, each publishing with release ordering what the other reads with acquire ordering, so neither core
+ * takes a lock or disables interrupts. The indices run freely and wrap modulo 2^32; a slot is chosen by masking.
+ */
+typedef struct spsc_ring_s {
+    uint8_t *storage;
+    size_t obj_size;
+    uint32_t mask;                  // Capacity - 1; the capacity is a power of two
+
+    _Atomic uint32_t head;          // Objects pushed so far. Written by the producer only.
+    _Atomic uint32_t tail;          // Objects popped so far. Written by the consumer only.
+
+    _Atomic uint32_t overflows;     // Pushes refused because the ring was full. Written by the producer only.
+    _Atomic uint32_t high_water;    // Most objects ever waiting at once. Written by the producer only.
+} spsc_ring_t;
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Function Declarations
+
+/**
+ * @brief Sets up an empty ring. Must be done before either core uses it.
+ *
+ * @param ring Ring to set up
+ * @param storage Space for `capacity` objects
+ * @param obj_size Size of each object
+ * @param capacity Number of objects the ring holds. Must be a power of two.
+ *
+ * @returns False if the capacity is not a power of two
+ */
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, size_t obj_size, uint32_t capacity);
+
+/**
+ * @brief Copies an object into the ring. Producer only.
+ *
+ * @returns False, and counts an overflow, if the ring is full
+ */
+bool spsc_ring_push(spsc_ring_t *ring, const void *obj);
+
+/**
+ * @brief Copies the oldest object out of the ring. Consumer only.
+ *
+ * @returns False if the ring is empty
+ */
+bool spsc_ring_pop(spsc_ring_t *ring, void *obj);
+
+/**
+ * @brief Returns the number of objects waiting. Exact from either side for its own index; the other side may have moved on.
+ */
+uint32_t spsc_ring_count(spsc_ring_t *ring);
+
+/**
+ * @brief Returns the number of pushes refused because the ring was full.
+ */
+uint32_t spsc_ring_overflows(spsc_ring_t *ring);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* SPSC_RING_H */
@@ -72,6 +72,7 @@ typedef enum lwqms_post_err_codes_e {
 #define FLASH_ADDR_CONFIG 0x00
 #define FLASH_ADDR_SDIA_CAL_DATA_32K_BLOCK 1 // Need 13K of free space dedicated for this.
 #define FLASH_ADDR_BULK_DATA 0x10000
+#define FLASH_ADDR_TELEMETRY_BACKLOG FLASH_ADDR_BULK_DATA  // Samples waiting on the next batched transmission. One sector.
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -86,6 +87,29 @@ int read_system_config_data(mxl23l3233f_context_t * flash_context, node_config_t
 
 int write_system_config_data(mxl23l3233f_context_t * flash_context, node_config_t * config);
 
+/**
+ * @brief Saves a sample to the telemetry backlog in SPI flash, where it waits out the dormant state until the next transmission.
+ * Appending the first sample of a backlog erases the previous one.
+ * 
+ * @param flash_context SPI flash chip holding the backlog
+ * @param index Position of the sample in the backlog, counting from zero
+ * @param sample Sample to save
+ * 
+ * @returns 0 on success, -1 for a sample that does not fit in the backlog, -2 if the sample could not be written
+ */
+int telemetry_backlog_append(mxl23l3233f_context_t * flash_context, uint8_t index, lwqms_telemetry_t * sample);
+
+/**
+ * @brief Reads back the samples saved in the telemetry backlog, oldest first
+ * 
+ * @param flash_context SPI flash chip holding the backlog
+ * @param samples Destination for the samples
+ * @param qty_samples Number of samples to read
+ * 
+ * @returns 0 on success, -1 for more samples than the backlog holds, -2 for an SPI failure
+ */
+int telemetry_backlog_read(mxl23l3233f_context_t * flash_context, lwqms_telemetry_t * samples, uint8_t qty_samples);
+
 node_config_t get_setup_data();
 
 lwqms_post_err_codes_t power_on_self_test();
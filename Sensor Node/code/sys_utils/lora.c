@@ -14,27 +14,244 @@
 
 #pragma region Helper Methods
 
+uint32_t lora_symbol_time_us(const sx126x_mod_params_lora_t* modulation_params) {
+
+    // Tsym = 2^SF / BW
+    uint32_t bw_hz = sx126x_get_lora_bw_in_hz(modulation_params->bw);
+
+    if (bw_hz == 0) return 0;
+
+    return (uint32_t)((((uint64_t)1 << modulation_params->sf) * 1000000ULL) / bw_hz);
+}
+
+uint32_t lora_time_on_air_us(   const sx126x_mod_params_lora_t* modulation_params,
+                                const sx126x_pkt_params_lora_t* packet_params,
+                                uint8_t len
+) {
+    // The airtime depends on LDRO, so compute it with the value the radio will actually be configured with.
+    sx126x_mod_params_lora_t mod = *modulation_params;
+    sx126x_pkt_params_lora_t pkt = *packet_params;
+
+    set_lora_ldro_val(&mod);
+    pkt.pld_len_in_bytes = len;
+
+    uint32_t bw_hz = sx126x_get_lora_bw_in_hz(mod.bw);
+
+    if (bw_hz == 0) return 0;
+
+    // The driver returns the airtime in units of 1 / BW seconds. Round up so that a window built from this never comes up short.
+    uint64_t numerator = (uint64_t)sx126x_get_lora_time_on_air_numerator(&pkt, &mod) * 1000000ULL;
+
+    return (uint32_t)((numerator + bw_hz - 1) / bw_hz);
+}
+
+uint32_t lora_header_time_us(   const sx126x_mod_params_lora_t* modulation_params,
+                                const sx126x_pkt_params_lora_t* packet_params
+) {
+    // Preamble, plus 4.25 symbols of sync word and start-of-frame delimiter, plus the 8 symbols carrying the explicit header.
+    // In implicit header mode the radio locks onto the frame at the end of the sync word instead.
+    uint32_t quarter_symbols = (4 * packet_params->preamble_len_in_symb) + 17;
+
+    if (packet_params->header_type == SX126X_LORA_PKT_EXPLICIT) quarter_symbols += 4 * 8;
+
+    return (uint32_t)(((uint64_t)quarter_symbols * lora_symbol_time_us(modulation_params) + 3) / 4);
+}
+
 void set_lora_ldro_val(sx126x_mod_params_lora_t* modulation_params) {
     
-    // Temporary function definition to select the value of LDRO. Ideally, the LoRa symbol time should be calculated
-    // and compared to the threshold time of 16.38 ms. If greater, set this bit to one.
+    // Semtech recommends Low Data Rate Optimization whenever the symbol time reaches 16.38 ms, where the receiver can no
+    // longer track the drift of the carrier over a symbol (SF11 & SF12 at 125 kHz, SF12 at 250 kHz, and slower).
+    modulation_params->ldro = (lora_symbol_time_us(modulation_params) >= LORA_LDRO_SYMBOL_TIME_THRESHOLD_US) ? LORA_LDRO_ON : LORA_LDRO_OFF;
+
+}
+
+#pragma endregion
+
+#pragma region Command Sequences
+
+// Configuration commands are queued here and streamed to the radio back to back, the core sleeping while it executes each.
+static sx126x_hal_seq_t radio_cmd_seq;
+
+#pragma endregion
+
+#pragma region Configuration Cache
+
+void lora_invalidate_config_cache(const sx126x_context_t* radio_context) {
+    if (radio_context->config_cache != NULL) radio_context->config_cache->valid = 0;
+}
+
+static bool cache_holds(const sx126x_context_t* radio_context, uint32_t field) {
+    return (radio_context->config_cache != NULL) && ((radio_context->config_cache->valid & field) > 0);
+}
+
+/**
+ * @brief Clears the field before its command is sent, so a command that fails part-way is never mistaken for a setting the
+ * radio holds. Returns the cache to record into on success, or NULL if the radio has none.
+ */
+static sx126x_config_cache_t* cache_begin_write(const sx126x_context_t* radio_context, uint32_t field) {
+    sx126x_config_cache_t *cache = radio_context->config_cache;
+
+    if (cache != NULL) cache->valid &= ~field;
+
+    return cache;
+}
+
+static sx126x_status_t set_pkt_type_cached(const sx126x_context_t* radio_context) {
+    if (cache_holds(radio_context, LORA_CACHE_PKT_TYPE)) return SX126X_STATUS_OK;
+
+    // SetPacketType resets the modulation and packet parameters, so nothing else cached survives it.
+    lora_invalidate_config_cache(radio_context);
+
+    sx126x_status_t status = sx126x_set_pkt_type(radio_context, SX126X_PKT_TYPE_LORA);
+
+    if ((status == SX126X_STATUS_OK) && (radio_context->config_cache != NULL)) radio_context->config_cache->valid |= LORA_CACHE_PKT_TYPE;
+
+    return status;
+}
+
+static sx126x_status_t set_rf_freq_cached(const sx126x_context_t* radio_context, uint32_t freq_hz) {
+    if (cache_holds(radio_context, LORA_CACHE_RF_FREQ) && (radio_context->config_cache->rf_freq_hz == freq_hz)) return SX126X_STATUS_OK;
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_RF_FREQ);
+
+    sx126x_status_t status = sx126x_set_rf_freq(radio_context, freq_hz);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->rf_freq_hz = freq_hz;
+        cache->valid |= LORA_CACHE_RF_FREQ;
+    }
+
+    return status;
+}
+
+static sx126x_status_t set_pa_cfg_cached(const sx126x_context_t* radio_context, const sx126x_pa_cfg_params_t* pa_cfg) {
+    if (cache_holds(radio_context, LORA_CACHE_PA_CFG)) {
+        const sx126x_pa_cfg_params_t *cached = &radio_context->config_cache->pa_cfg;
+
+        if ((cached->pa_duty_cycle == pa_cfg->pa_duty_cycle) && (cached->hp_max == pa_cfg->hp_max) &&
+            (cached->device_sel == pa_cfg->device_sel) && (cached->pa_lut == pa_cfg->pa_lut)) return SX126X_STATUS_OK;
+    }
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_PA_CFG);
+
+    sx126x_status_t status = sx126x_set_pa_cfg(radio_context, pa_cfg);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->pa_cfg = *pa_cfg;
+        cache->valid |= LORA_CACHE_PA_CFG;
+    }
+
+    return status;
+}
+
+static sx126x_status_t set_tx_params_cached(const sx126x_context_t* radio_context, int8_t tx_power, sx126x_ramp_time_t ramp_time) {
+    if (cache_holds(radio_context, LORA_CACHE_TX_PARAMS) && (radio_context->config_cache->tx_power == tx_power) &&
+        (radio_context->config_cache->ramp_time == ramp_time)) return SX126X_STATUS_OK;
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_TX_PARAMS);
+
+    sx126x_status_t status = sx126x_set_tx_params(radio_context, tx_power, ramp_time);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->tx_power = tx_power;
+        cache->ramp_time = ramp_time;
+        cache->valid |= LORA_CACHE_TX_PARAMS;
+    }
+
+    return status;
+}
+
+static sx126x_status_t set_buffer_base_address_cached(const sx126x_context_t* radio_context, uint8_t tx_base_address, uint8_t rx_base_address) {
+    if (cache_holds(radio_context, LORA_CACHE_BUFFER_BASE) && (radio_context->config_cache->tx_base_address == tx_base_address) &&
+        (radio_context->config_cache->rx_base_address == rx_base_address)) return SX126X_STATUS_OK;
 
-    // TODO: Perform LoRa symbol time calculation
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_BUFFER_BASE);
 
-    uint8_t ldro;
+    sx126x_status_t status = sx126x_set_buffer_base_address(radio_context, tx_base_address, rx_base_address);
 
-    switch (modulation_params->sf) {
-        case SX126X_LORA_SF11:
-            ldro = (modulation_params->bw == SX126X_LORA_BW_125) ? LORA_LDRO_ON : LORA_LDRO_OFF;
-            break;
-        case SX126X_LORA_SF12:
-            ldro = (modulation_params->bw == SX126X_LORA_BW_125 || modulation_params->bw == SX126X_LORA_BW_250) ? LORA_LDRO_ON : LORA_LDRO_OFF;
-        default:
-            ldro = LORA_LDRO_OFF;
-    };
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->tx_base_address = tx_base_address;
+        cache->rx_base_address = rx_base_address;
+        cache->valid |= LORA_CACHE_BUFFER_BASE;
+    }
+
+    return status;
+}
 
-    modulation_params->ldro = ldro;
+static sx126x_status_t set_lora_mod_params_cached(const sx126x_context_t* radio_context, const sx126x_mod_params_lora_t* mod_params) {
+    if (cache_holds(radio_context, LORA_CACHE_MOD_PARAMS)) {
+        const sx126x_mod_params_lora_t *cached = &radio_context->config_cache->mod_params;
+
+        if ((cached->sf == mod_params->sf) && (cached->bw == mod_params->bw) && (cached->cr == mod_params->cr) &&
+            (cached->ldro == mod_params->ldro)) return SX126X_STATUS_OK;
+    }
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_MOD_PARAMS);
+
+    sx126x_status_t status = sx126x_set_lora_mod_params(radio_context, mod_params);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->mod_params = *mod_params;
+        cache->valid |= LORA_CACHE_MOD_PARAMS;
+    }
 
+    return status;
+}
+
+static sx126x_status_t set_lora_pkt_params_cached(const sx126x_context_t* radio_context, const sx126x_pkt_params_lora_t* pkt_params) {
+    if (cache_holds(radio_context, LORA_CACHE_PKT_PARAMS)) {
+        const sx126x_pkt_params_lora_t *cached = &radio_context->config_cache->pkt_params;
+
+        if ((cached->preamble_len_in_symb == pkt_params->preamble_len_in_symb) && (cached->header_type == pkt_params->header_type) &&
+            (cached->pld_len_in_bytes == pkt_params->pld_len_in_bytes) && (cached->crc_is_on == pkt_params->crc_is_on) &&
+            (cached->invert_iq_is_on == pkt_params->invert_iq_is_on)) return SX126X_STATUS_OK;
+    }
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_PKT_PARAMS);
+
+    sx126x_status_t status = sx126x_set_lora_pkt_params(radio_context, pkt_params);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->pkt_params = *pkt_params;
+        cache->valid |= LORA_CACHE_PKT_PARAMS;
+    }
+
+    return status;
+}
+
+static sx126x_status_t set_lora_sync_word_cached(const sx126x_context_t* radio_context, uint8_t sync_word) {
+    if (cache_holds(radio_context, LORA_CACHE_SYNC_WORD) && (radio_context->config_cache->sync_word == sync_word)) return SX126X_STATUS_OK;
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_SYNC_WORD);
+
+    sx126x_status_t status = sx126x_set_lora_sync_word(radio_context, sync_word);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->sync_word = sync_word;
+        cache->valid |= LORA_CACHE_SYNC_WORD;
+    }
+
+    return status;
+}
+
+static sx126x_status_t set_dio_irq_params_cached(const sx126x_context_t* radio_context, const sx126x_dio_irq_masks_t* irq_masks) {
+    if (cache_holds(radio_context, LORA_CACHE_DIO_IRQ)) {
+        const sx126x_dio_irq_masks_t *cached = &radio_context->config_cache->irq_masks;
+
+        if ((cached->system_mask == irq_masks->system_mask) && (cached->dio1_mask == irq_masks->dio1_mask) &&
+            (cached->dio2_mask == irq_masks->dio2_mask) && (cached->dio3_mask == irq_masks->dio3_mask)) return SX126X_STATUS_OK;
+    }
+
+    sx126x_config_cache_t *cache = cache_begin_write(radio_context, LORA_CACHE_DIO_IRQ);
+
+    sx126x_status_t status = sx126x_set_dio_irq_params(radio_context, irq_masks->system_mask, irq_masks->dio1_mask, irq_masks->dio2_mask, irq_masks->dio3_mask);
+
+    if ((status == SX126X_STATUS_OK) && (cache != NULL)) {
+        cache->irq_masks = *irq_masks;
+        cache->valid |= LORA_CACHE_DIO_IRQ;
+    }
+
+    return status;
 }
 
 #pragma endregion
@@ -48,7 +265,8 @@ sx126x_status_t sx126x_radio_setup(const void* context) {
     for (int k = 0; k < COMMS_RETRIES; k++) {
 
         do {
-            // 1. Perform a reset of the radio module
+            // 1. Perform a reset of the radio module, which returns every setting to its power-on value
+            lora_invalidate_config_cache((const sx126x_context_t *)context);
             if (sx126x_hal_reset(context) != SX126X_STATUS_OK)                          break;
         
             //printf("1");
@@ -58,6 +276,9 @@ sx126x_status_t sx126x_radio_setup(const void* context) {
         
             //printf("2");
 
+            // Steps 3 to 7 are only written, so they go to the radio as one sequence.
+            sx126x_hal_seq_begin(context, &radio_cmd_seq);
+
             // 3. Set the regulator mode
             if (sx126x_set_reg_mode(context, SX126X_REG_MODE_DCDC) != SX126X_STATUS_OK) break;
         
@@ -78,6 +299,16 @@ sx126x_status_t sx126x_radio_setup(const void* context) {
 
             //printf("6");
 
+            // 7. Keep the crystal running after each TX and RX, so the radio can turn straight around to receive the reply
+            if (sx126x_set_rx_tx_fallback_mode(context, SX126X_FALLBACK_STDBY_XOSC) != SX126X_STATUS_OK)   break;
+
+            if (sx126x_hal_seq_run(&radio_cmd_seq) != SX126X_HAL_STATUS_OK)            break;
+
+            #ifdef DEBUG
+                printf("Radio setup commands:\n");
+                sx126x_hal_seq_print(&radio_cmd_seq);
+            #endif
+
             init_ok = true;
 
         } while (0);
@@ -85,6 +316,8 @@ sx126x_status_t sx126x_radio_setup(const void* context) {
         if (init_ok) {
             return SX126X_STATUS_OK;
         }
+
+        sx126x_hal_seq_discard(&radio_cmd_seq);
     }
 
     err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_REBOOT, "SPI Communications failure with SX126X module during radio initialization", "sx126x_hal_initialize_radio");
@@ -100,6 +333,9 @@ sx126x_status_t sx126x_radio_setup(const void* context) {
 bool lora_enter_sleep_mode(const sx126x_context_t* radio_context, bool use_warm_start) {
     
     sx126x_sleep_cfgs_t sleep_mode = use_warm_start ? SX126X_SLEEP_CFG_WARM_START : SX126X_SLEEP_CFG_COLD_START;
+
+    // Even a warm start only retains part of the register space, so the radio is fully reconfigured after any sleep.
+    lora_invalidate_config_cache(radio_context);
     
     for (int k = 0; k < COMMS_RETRIES; k++) {
         bool sleep_ok = false;
@@ -140,42 +376,50 @@ bool lora_init_tx(  const sx126x_context_t* radio_context,
 ) {
     set_lora_ldro_val(lora_modulation_parameters);  // Set the Low Data Rate Optimization value by editing the given struct in-place.
     
-    // Write all the configuration data
+    // Write the configuration data, skipping any setting the radio already holds
     for (int k = 0; k < COMMS_RETRIES; k++) {
         
         bool init_ok = false;
-        sx126x_pkt_type_t readback_pkt_type;
+        sx126x_pkt_type_t readback_pkt_type = 0;   // sx126x_get_pkt_type() only fills the low byte of the enum
+        bool verify_pkt_type = !cache_holds(radio_context, LORA_CACHE_PKT_TYPE);
         
         do {    // The DO-WHILE(0) structure gives the program a block of code that can be exited upon error.
 
+            // The settings the radio does not hold yet are queued, then streamed to it as one sequence.
+            sx126x_hal_seq_begin(radio_context, &radio_cmd_seq);
+
             // 1. Put the radio into XTAL Oscillator Standby mode
             if (sx126x_set_standby(radio_context, SX126X_STANDBY_CFG_XOSC) != SX126X_STATUS_OK)                             break; // The WaveShare LoRa module uses a 32MHz TXCO
             
             // 2. Configure the packet type to LoRa
-            if (sx126x_set_pkt_type(radio_context, SX126X_PKT_TYPE_LORA) != SX126X_STATUS_OK)                               break; // Use LoRa packets
+            if (set_pkt_type_cached(radio_context) != SX126X_STATUS_OK)                               break; // Use LoRa packets
             
             // 3. Set the RF frequency of the radio to the legal band within the USA
-            if (sx126x_set_rf_freq(radio_context, LORA_FREQ_NORTH_AMERICA) != SX126X_STATUS_OK)                             break; // Use the North American Standard LoRa Frequency (915 MHz)
+            if (set_rf_freq_cached(radio_context, LORA_FREQ_NORTH_AMERICA) != SX126X_STATUS_OK)                             break; // Use the North American Standard LoRa Frequency (915 MHz)
             
             // 4. Configure the Power Amplifier
-            if (sx126x_set_pa_cfg(radio_context, power_amplifier_config) != SX126X_STATUS_OK)                               break;
+            if (set_pa_cfg_cached(radio_context, power_amplifier_config) != SX126X_STATUS_OK)                               break;
             
             // 5. Configure the transmission parameters
-            if (sx126x_set_tx_params(radio_context, txPower, ramp_time) != SX126X_STATUS_OK)                                break; // Set to use a 200 us Ramp Time
+            if (set_tx_params_cached(radio_context, txPower, ramp_time) != SX126X_STATUS_OK)                                break; // Set to use a 200 us Ramp Time
             
             // 6. Initialize the radio r/w buffers
-            if (sx126x_set_buffer_base_address(radio_context, radio_context->tx_buf_start, radio_context->rx_buf_start) != SX126X_STATUS_OK)      break; // The lower half of the buffer will be tx data and the upper half of the buffer will be rx data
+            if (set_buffer_base_address_cached(radio_context, radio_context->tx_buf_start, radio_context->rx_buf_start) != SX126X_STATUS_OK)      break; // The lower half of the buffer will be tx data and the upper half of the buffer will be rx data
 
             // 7. Configure the LoRa modulation parameters (spreading factor, bandwidth, error correction)
-            if (sx126x_set_lora_mod_params(radio_context, lora_modulation_parameters) != SX126X_STATUS_OK)                  break;
+            if (set_lora_mod_params_cached(radio_context, lora_modulation_parameters) != SX126X_STATUS_OK)                  break;
 
             // 8. Set the SYNC word - helps all devices in dedicated LoRa network understand the message may be for them
-            if (sx126x_set_lora_sync_word(radio_context, sync_word) != SX126X_STATUS_OK)                                    break;
+            if (set_lora_sync_word_cached(radio_context, sync_word) != SX126X_STATUS_OK)                                    break;
 
-            // Read back packet type
-            if (sx126x_get_pkt_type(radio_context, &readback_pkt_type) != SX126X_STATUS_OK)                                 break;
+            if (sx126x_hal_seq_run(&radio_cmd_seq) != SX126X_HAL_STATUS_OK)                                                break;
 
-            if (readback_pkt_type != SX126X_PKT_TYPE_LORA) break;         
+            // Read back packet type, once per time it is actually written
+            if (verify_pkt_type) {
+                if (sx126x_get_pkt_type(radio_context, &readback_pkt_type) != SX126X_STATUS_OK)                             break;
+
+                if (readback_pkt_type != SX126X_PKT_TYPE_LORA) break;
+            }
 
             init_ok = true; // Only once everything is confirmed to be set up correctly will the init_ok flag be set to true.
 
@@ -184,6 +428,10 @@ bool lora_init_tx(  const sx126x_context_t* radio_context,
         if (init_ok) {
             return true;
         }
+
+        // Whatever was written before the failure is no longer known.
+        sx126x_hal_seq_discard(&radio_cmd_seq);
+        lora_invalidate_config_cache(radio_context);
     }
 
     err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_REBOOT, "SPI Communications failure with SX126X module during TX setup", "lora_tx_init");
@@ -199,7 +447,8 @@ bool lora_tx(   const sx126x_context_t* radio_context,
                 sx126x_dio_irq_masks_t* radio_interrupt_cfg,
                 sx126x_pkt_params_lora_t* lora_packet_parameters,
                 uint8_t *buf, 
-                uint8_t len
+                uint8_t len,
+                uint32_t timeout_ms
 ) {
     for (int k = 0; k < COMMS_RETRIES; k++) {
 
@@ -208,20 +457,18 @@ bool lora_tx(   const sx126x_context_t* radio_context,
         do {
             // 1. Configure the LoRa packet
             lora_packet_parameters->pld_len_in_bytes = len;
-            if (sx126x_set_lora_pkt_params(radio_context, lora_packet_parameters) != SX126X_STATUS_OK) break;
+            if (set_lora_pkt_params_cached(radio_context, lora_packet_parameters) != SX126X_STATUS_OK) break;
 
             // 2. Write the data to be transmitted into the TX buffer
             if (sx126x_write_buffer(radio_context, 0x00, buf, len) != SX126X_STATUS_OK) break;
 
-            // 3. Configure the interrupts
-            if (sx126x_set_dio_irq_params(  radio_context, 
-                                            radio_interrupt_cfg->system_mask, 
-                                            radio_interrupt_cfg->dio1_mask, 
-                                            radio_interrupt_cfg->dio2_mask, 
-                                            radio_interrupt_cfg->dio3_mask  ) != SX126X_STATUS_OK) break;
+            // 3. Configure the interrupts, dropping any left latched by a previous operation so DIO1 can rise again
+            if (set_dio_irq_params_cached(radio_context, radio_interrupt_cfg) != SX126X_STATUS_OK)       break;
+
+            if (sx126x_clear_irq_status(radio_context, SX126X_IRQ_ALL) != SX126X_STATUS_OK) break;
             
             // 4. Transmit the data
-            if (sx126x_set_tx(radio_context, 10000) != SX126X_STATUS_OK) break;
+            if (sx126x_set_tx(radio_context, timeout_ms) != SX126X_STATUS_OK) break;
 
             tx_ok = true;
 
@@ -230,8 +477,13 @@ bool lora_tx(   const sx126x_context_t* radio_context,
         if (tx_ok) {
             return true;
         }
+
+        // Whatever was written before the failure is no longer known.
+        lora_invalidate_config_cache(radio_context);
     }
     err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_REBOOT, "SPI Communications failure with SX126X during packet transmission", "lora_tx");
+
+    return false;
 }
 
 #pragma endregion
@@ -254,36 +506,44 @@ bool lora_init_rx(sx126x_context_t* radio_context,
 
     set_lora_ldro_val(lora_modulation_parameters);  // Set the Low Data Rate Optimization value by editing the given struct in-place.
 
-    sx126x_pkt_type_t readback_pkt_type;
+    sx126x_pkt_type_t readback_pkt_type = 0;   // sx126x_get_pkt_type() only fills the low byte of the enum
 
     for (int k = 0; k < COMMS_RETRIES; k++) {
 
         bool init_ok = false;
+        bool verify_pkt_type = !cache_holds(radio_context, LORA_CACHE_PKT_TYPE);
 
         do {
 
+            // The settings the radio does not hold yet are queued, then streamed to it as one sequence.
+            sx126x_hal_seq_begin(radio_context, &radio_cmd_seq);
+
             // 1. Put the radio into XTAL Oscillator Standby mode
             if (sx126x_set_standby(radio_context, SX126X_STANDBY_CFG_XOSC) != SX126X_STATUS_OK)                             break; // The WaveShare LoRa module uses a 32MHz TXCO
             
             // 2. Configure the packet type to LoRa
-            if (sx126x_set_pkt_type(radio_context, SX126X_PKT_TYPE_LORA) != SX126X_STATUS_OK)                               break; // Use LoRa packets
+            if (set_pkt_type_cached(radio_context) != SX126X_STATUS_OK)                               break; // Use LoRa packets
             
             // 3. Set the RF frequency of the radio to the legal band within the USA
-            if (sx126x_set_rf_freq(radio_context, LORA_FREQ_NORTH_AMERICA) != SX126X_STATUS_OK)                             break; // Use the North American Standard LoRa Frequency (915 MHz)
+            if (set_rf_freq_cached(radio_context, LORA_FREQ_NORTH_AMERICA) != SX126X_STATUS_OK)                             break; // Use the North American Standard LoRa Frequency (915 MHz)
             
             // 4. Initialize the radio r/w buffers
-            if (sx126x_set_buffer_base_address(radio_context, LORA_TX_BUF_BASE, LORA_RX_BUF_BASE) != SX126X_STATUS_OK)      break; // The lower half of the buffer will be tx data and the upper half of the buffer will be rx data
+            if (set_buffer_base_address_cached(radio_context, LORA_TX_BUF_BASE, LORA_RX_BUF_BASE) != SX126X_STATUS_OK)      break; // The lower half of the buffer will be tx data and the upper half of the buffer will be rx data
 
             // 5. Configure the LoRa modulation parameters (spreading factor, bandwidth, error correction)
-            if (sx126x_set_lora_mod_params(radio_context, lora_modulation_parameters) != SX126X_STATUS_OK)                  break;
+            if (set_lora_mod_params_cached(radio_context, lora_modulation_parameters) != SX126X_STATUS_OK)                  break;
 
             // 6. Configure the LoRa packet
-            if (sx126x_set_lora_pkt_params(radio_context, lora_packet_parameters) != SX126X_STATUS_OK)                      break;
+            if (set_lora_pkt_params_cached(radio_context, lora_packet_parameters) != SX126X_STATUS_OK)                      break;
 
-            // Read back packet type
-            if (sx126x_get_pkt_type(radio_context, &readback_pkt_type) != SX126X_STATUS_OK)                                 break;
+            if (sx126x_hal_seq_run(&radio_cmd_seq) != SX126X_HAL_STATUS_OK)                                                break;
 
-            if (readback_pkt_type != SX126X_PKT_TYPE_LORA) break;       
+            // Read back packet type, once per time it is actually written
+            if (verify_pkt_type) {
+                if (sx126x_get_pkt_type(radio_context, &readback_pkt_type) != SX126X_STATUS_OK)                             break;
+
+                if (readback_pkt_type != SX126X_PKT_TYPE_LORA) break;
+            }
 
             init_ok = true;
 
@@ -293,6 +553,9 @@ bool lora_init_rx(sx126x_context_t* radio_context,
             return true;
         }
 
+        // Whatever was written before the failure is no longer known.
+        sx126x_hal_seq_discard(&radio_cmd_seq);
+        lora_invalidate_config_cache(radio_context);
     }
 
     err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_REBOOT, "SPI transaction failure with SX126X during RX initialization", "lora_init_rx");
@@ -327,15 +590,13 @@ bool lora_rx(   sx126x_context_t* radio_context,
 
         do {
 
-            // 1. Configure the interrupts
-            if (sx126x_set_dio_irq_params(  radio_context, 
-                                            radio_interrupt_cfg->system_mask, 
-                                            radio_interrupt_cfg->dio1_mask, 
-                                            radio_interrupt_cfg->dio2_mask, 
-                                            radio_interrupt_cfg->dio3_mask) != SX126X_STATUS_OK)                  break;
+            // 1. Configure the interrupts, dropping any left latched by a previous operation so DIO1 can rise again
+            if (set_dio_irq_params_cached(radio_context, radio_interrupt_cfg) != SX126X_STATUS_OK)       break;
+
+            if (sx126x_clear_irq_status(radio_context, SX126X_IRQ_ALL) != SX126X_STATUS_OK)               break;
 
             // 2. Set the SYNC word - helps all devices in dedicated LoRa network understand the message may be for them
-            if (sx126x_set_lora_sync_word(radio_context, sync_word) != SX126X_STATUS_OK)              break;
+            if (set_lora_sync_word_cached(radio_context, sync_word) != SX126X_STATUS_OK)              break;
 
             // 3. Set the radio in Receive mode
             if (sx126x_set_rx(radio_context, timeout_ms) != SX126X_STATUS_OK)                          break;
@@ -347,6 +608,9 @@ bool lora_rx(   sx126x_context_t* radio_context,
         if (rx_ok) {
             return true;
         }
+
+        // Whatever was written before the failure is no longer known.
+        lora_invalidate_config_cache(radio_context);
     }
 
     err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_REBOOT, "SPI Communications failure with SX126X during packet reception", "lora_rx");
@@ -382,4 +646,25 @@ bool lora_get_rx_data(sx126x_context_t* radio_context, uint8_t * rxBuf, uint8_t
     return false;
 }
 
+bool lora_get_rx_link_quality(sx126x_context_t* radio_context, lora_pkt_t* pkt) {
+
+    pkt->link_valid = false;
+
+    for (int k = 0; k < COMMS_RETRIES; k++) {
+        if (sx126x_get_lora_pkt_status(radio_context, &(pkt->link)) == SX126X_STATUS_OK) {
+            pkt->link_valid = true;
+            return true;
+        }
+    }
+
+    err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_NONFATAL, "SPI Communications failure with SX126X during packet status retrieval", "lora_get_rx_link_quality");
+
+    return false;
+}
+
+int16_t lora_snr_floor_db_x10(sx126x_lora_sf_t sf) {
+    // Each step up in spreading factor buys 2.5 dB of processing gain.
+    return -25 * ((int16_t)sf - 4);
+}
+
 #pragma endregion
\ No newline at end of file
@@ -13,6 +13,8 @@
 #include "lwqms_pkt.h"
 #include "hal.h"
 
+#include <math.h>
+
 /**
  * Use macros to keep byte-important copies portable.
  */
@@ -25,6 +27,15 @@
     memcpy((buf) + (offset), &(src_struct)->field, sizeof((src_struct)->field)); \
     (offset) += sizeof((src_struct)->field)
 
+// Positions of the fields that can be read or patched without a full decode/encode round trip.
+#define PKT_ID_OFFSET 0
+#define PKT_TYPE_OFFSET (LWQMS_PKT_HEADER_LEN - 1)
+
+// Fixed-point ranges of the compact telemetry fields. Temperature and pH also fit the sender's 16 bit reference storage.
+#define COMPACT_TURBIDITY_LIMIT (1 << 24)
+#define COMPACT_TEMPERATURE_LIMIT INT16_MAX
+#define COMPACT_PH_LIMIT INT16_MAX
+
 
 bool lwqms_pkt_encode(lwqms_pkt_t *pkt_in, uint8_t *buf, size_t buflen) {
     if (buflen < LWQMS_PKT_LEN_MAX) return false;
@@ -37,38 +48,339 @@ bool lwqms_pkt_encode(lwqms_pkt_t *pkt_in, uint8_t *buf, size_t buflen) {
         uint16_t pkt_id;
         uint16_t dest_id;
         uint16_t src_id;
-        lwqms_pkt_payload_t payload;
         uint8_t packet_type;   // Will be explicitly cast to uint8_t to ensure we have only 1 byte taken up here
+        lwqms_pkt_payload_t payload;
     } lwqms_pkt_t; 
     */
 
-    uint offset;
+    uint offset = 0;
 
     COPY_TO_BUF(buf, offset, pkt_in, pkt_id);
     COPY_TO_BUF(buf, offset, pkt_in, dest_id);
     COPY_TO_BUF(buf, offset, pkt_in, src_id);
-    COPY_TO_BUF(buf, offset, pkt_in, payload);
     COPY_TO_BUF(buf, offset, pkt_in, packet_type);
+    COPY_TO_BUF(buf, offset, pkt_in, payload);
 
     return true;
 }
 
 bool lwqms_pkt_decode(uint8_t *buf, size_t buflen, lwqms_pkt_t *pkt_out) {
-    if (buflen < LWQMS_PKT_LEN_MAX) return false;
+    if (buflen < LWQMS_PKT_HEADER_LEN) return false;
 
     uint offset = 0;
 
     COPY_FROM_BUF(pkt_out, pkt_id, buf, offset);
     COPY_FROM_BUF(pkt_out, dest_id, buf, offset);
     COPY_FROM_BUF(pkt_out, src_id, buf, offset);
-    COPY_FROM_BUF(pkt_out, payload, buf, offset);
     COPY_FROM_BUF(pkt_out, packet_type, buf, offset);
 
+    // Compact packets can end before a full payload does.
+    size_t payload_len = buflen - offset;
+    if (payload_len > sizeof(lwqms_pkt_payload_t)) payload_len = sizeof(lwqms_pkt_payload_t);
+
+    memset(&pkt_out->payload, 0x00, sizeof(lwqms_pkt_payload_t));
+    memcpy(&pkt_out->payload, buf + offset, payload_len);
+
+    return true;
+}
+
+bool lwqms_pkt_encode_batch(lwqms_pkt_t *pkt_header, lwqms_telemetry_batch_t *batch, uint8_t *buf, size_t buflen, size_t *pkt_len) {
+    if ((batch->qty_samples == 0) || (batch->qty_samples > LWQMS_PKT_BATCH_MAX_SAMPLES)) return false;
+    if (buflen < LWQMS_PKT_BATCH_LEN(batch->qty_samples)) return false;
+
+    // The header is a regular packet whose payload holds the sample count.
+    pkt_header->packet_type = (pkt_header->packet_type & ~LWQMS_PKT_TYPE_MASK) | LWQMS_PACKET_TYPE_TELEMETRY_BATCH;
+    memset(&pkt_header->payload, 0x00, sizeof(lwqms_pkt_payload_t));
+    pkt_header->payload.message[0] = batch->qty_samples;
+
+    lwqms_pkt_encode(pkt_header, buf, buflen);
+
+    uint offset = LWQMS_PKT_LEN_MAX;
+
+    for (int k = 0; k < batch->qty_samples; k++) {
+        lwqms_telemetry_sample_t *sample = &batch->samples[k];
+
+        COPY_TO_BUF(buf, offset, sample, age_s);
+        COPY_TO_BUF(buf, offset, sample, telemetry);
+    }
+
+    *pkt_len = offset;
+
     return true;
 }
 
+bool lwqms_pkt_decode_batch(uint8_t *buf, size_t buflen, lwqms_pkt_t *pkt_out, lwqms_telemetry_batch_t *batch_out) {
+    if (!lwqms_pkt_decode(buf, buflen, pkt_out)) return false;
+
+    if ((pkt_out->packet_type & LWQMS_PKT_TYPE_MASK) != LWQMS_PACKET_TYPE_TELEMETRY_BATCH) return false;
+
+    batch_out->qty_samples = (uint8_t)pkt_out->payload.message[0];
+
+    if ((batch_out->qty_samples == 0) || (batch_out->qty_samples > LWQMS_PKT_BATCH_MAX_SAMPLES)) return false;
+    if (buflen < LWQMS_PKT_BATCH_LEN(batch_out->qty_samples)) return false;
+
+    uint offset = LWQMS_PKT_LEN_MAX;
+
+    for (int k = 0; k < batch_out->qty_samples; k++) {
+        lwqms_telemetry_sample_t *sample = &batch_out->samples[k];
+
+        COPY_FROM_BUF(sample, age_s, buf, offset);
+        COPY_FROM_BUF(sample, telemetry, buf, offset);
+    }
+
+    return true;
+}
+
+#pragma region Compact Telemetry
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Compact Telemetry
+
+static bool compact_put_varint(uint8_t *buf, size_t buflen, uint *offset, uint32_t value) {
+    do {
+        if (*offset >= buflen) return false;
+
+        buf[(*offset)++] = (value & 0x7F) | ((value > 0x7F) ? 0x80 : 0x00);
+        value >>= 7;
+    } while (value > 0);
+
+    return true;
+}
+
+static bool compact_get_varint(const uint8_t *buf, size_t buflen, uint *offset, uint32_t *value) {
+    *value = 0;
+
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (*offset >= buflen) return false;
+
+        uint8_t byte = buf[(*offset)++];
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) return true;
+    }
+
+    return false;
+}
+
+// Zig-zag coding folds signed values onto unsigned ones, so small changes either way take a single varint byte.
+static uint32_t zigzag_encode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static bool compact_quantize_field(float value, int32_t scale, int32_t limit, int32_t *fixed) {
+    float scaled = value * scale;
+
+    if (!isfinite(scaled) || (scaled > limit) || (scaled < -limit)) return false;
+
+    *fixed = (int32_t)lroundf(scaled);
+
+    return true;
+}
+
+static bool compact_quantize(const lwqms_telemetry_t *telemetry, int32_t fixed[3]) {
+    return compact_quantize_field(telemetry->turbidity_measurement, LWQMS_COMPACT_TURBIDITY_SCALE, COMPACT_TURBIDITY_LIMIT, &fixed[0]) &&
+           compact_quantize_field(telemetry->temperature_measurement, LWQMS_COMPACT_TEMPERATURE_SCALE, COMPACT_TEMPERATURE_LIMIT, &fixed[1]) &&
+           compact_quantize_field(telemetry->pH_measurement, LWQMS_COMPACT_PH_SCALE, COMPACT_PH_LIMIT, &fixed[2]);
+}
+
+static void compact_dequantize(const int32_t fixed[3], lwqms_telemetry_t *telemetry) {
+    telemetry->turbidity_measurement = (float)fixed[0] / LWQMS_COMPACT_TURBIDITY_SCALE;
+    telemetry->temperature_measurement = (float)fixed[1] / LWQMS_COMPACT_TEMPERATURE_SCALE;
+    telemetry->pH_measurement = (float)fixed[2] / LWQMS_COMPACT_PH_SCALE;
+}
+
+void lwqms_telemetry_ref_update(lwqms_telemetry_ref_t *ref, uint16_t pkt_id, const lwqms_telemetry_t *telemetry) {
+    int32_t fixed[3];
+
+    ref->valid = compact_quantize(telemetry, fixed);
+    ref->pkt_id = pkt_id;
+    ref->turbidity = fixed[0];
+    ref->temperature = fixed[1];
+    ref->pH = fixed[2];
+}
+
+bool lwqms_pkt_encode_compact(lwqms_pkt_t *pkt_header, lwqms_telemetry_batch_t *batch, const lwqms_telemetry_ref_t *ref, uint8_t *buf, size_t buflen, size_t *pkt_len) {
+    if ((batch->qty_samples == 0) || (batch->qty_samples > LWQMS_PKT_BATCH_MAX_SAMPLES)) return false;
+    if (buflen < LWQMS_PKT_HEADER_LEN + 1) return false;
+
+    int32_t fixed[LWQMS_PKT_BATCH_MAX_SAMPLES][3];
+    bool raw = false;
+
+    for (int k = 0; k < batch->qty_samples; k++) {
+        if (!compact_quantize(&batch->samples[k].telemetry, fixed[k])) raw = true;
+    }
+
+    // The receiver holds the previous packet's last sample only if that packet is the one acknowledged.
+    bool delta = !raw && (ref != NULL) && ref->valid && (ref->pkt_id == (uint16_t)(pkt_header->pkt_id - 1));
+    int32_t previous[3] = {0, 0, 0};
+
+    if (delta) {
+        previous[0] = ref->turbidity;
+        previous[1] = ref->temperature;
+        previous[2] = ref->pH;
+    }
+
+    pkt_header->packet_type = (pkt_header->packet_type & ~LWQMS_PKT_TYPE_MASK) | LWQMS_PACKET_TYPE_TELEMETRY_COMPACT;
+
+    uint offset = 0;
+
+    COPY_TO_BUF(buf, offset, pkt_header, pkt_id);
+    COPY_TO_BUF(buf, offset, pkt_header, dest_id);
+    COPY_TO_BUF(buf, offset, pkt_header, src_id);
+    COPY_TO_BUF(buf, offset, pkt_header, packet_type);
+
+    buf[offset++] = (batch->qty_samples - 1) | (delta ? LWQMS_COMPACT_FLAG_DELTA : 0) | (raw ? LWQMS_COMPACT_FLAG_RAW : 0);
+
+    for (int k = 0; k < batch->qty_samples; k++) {
+        lwqms_telemetry_sample_t *sample = &batch->samples[k];
+
+        uint32_t age = (k == 0) ? sample->age_s : zigzag_encode((int32_t)sample->age_s - batch->samples[k - 1].age_s);
+        if (!compact_put_varint(buf, buflen, &offset, age)) return false;
+
+        if (raw) {
+            if (offset + sizeof(lwqms_telemetry_t) > buflen) return false;
+
+            COPY_TO_BUF(buf, offset, sample, telemetry);
+            continue;
+        }
+
+        for (int f = 0; f < 3; f++) {
+            if (!compact_put_varint(buf, buflen, &offset, zigzag_encode(fixed[k][f] - previous[f]))) return false;
+            previous[f] = fixed[k][f];
+        }
+    }
+
+    *pkt_len = offset;
+
+    return true;
+}
+
+bool lwqms_pkt_decode_compact(uint8_t *buf, size_t buflen, lwqms_telemetry_ref_t *ref, lwqms_pkt_t *pkt_out, lwqms_telemetry_batch_t *batch_out) {
+    if (buflen < LWQMS_PKT_HEADER_LEN + 1) return false;
+
+    lwqms_pkt_decode(buf, buflen, pkt_out);
+
+    if ((pkt_out->packet_type & LWQMS_PKT_TYPE_MASK) != LWQMS_PACKET_TYPE_TELEMETRY_COMPACT) return false;
+
+    uint offset = LWQMS_PKT_HEADER_LEN;
+    uint8_t coding = buf[offset++];
+    bool raw = (coding & LWQMS_COMPACT_FLAG_RAW) > 0;
+    int32_t previous[3] = {0, 0, 0};
+
+    if (coding & LWQMS_COMPACT_FLAG_DELTA) {
+        // Coded against a packet this receiver never decoded: the samples cannot be recovered.
+        if (!ref->valid || (ref->pkt_id != (uint16_t)(pkt_out->pkt_id - 1))) return false;
+
+        previous[0] = ref->turbidity;
+        previous[1] = ref->temperature;
+        previous[2] = ref->pH;
+    }
+
+    batch_out->qty_samples = (coding & LWQMS_COMPACT_QTY_MASK) + 1;
+
+    for (int k = 0; k < batch_out->qty_samples; k++) {
+        lwqms_telemetry_sample_t *sample = &batch_out->samples[k];
+        uint32_t age;
+
+        if (!compact_get_varint(buf, buflen, &offset, &age)) return false;
+        sample->age_s = (k == 0) ? age : (uint16_t)(batch_out->samples[k - 1].age_s + zigzag_decode(age));
+
+        if (raw) {
+            if (offset + sizeof(lwqms_telemetry_t) > buflen) return false;
+
+            COPY_FROM_BUF(sample, telemetry, buf, offset);
+            continue;
+        }
+
+        for (int f = 0; f < 3; f++) {
+            uint32_t zigzag;
+
+            if (!compact_get_varint(buf, buflen, &offset, &zigzag)) return false;
+            previous[f] += zigzag_decode(zigzag);
+        }
+
+        compact_dequantize(previous, &sample->telemetry);
+    }
+
+    // The sender quantizes its copy of the last sample the same way, so both ends hold the same reference.
+    if (raw) {
+        lwqms_telemetry_ref_update(ref, pkt_out->pkt_id, &batch_out->samples[batch_out->qty_samples - 1].telemetry);
+    }
+    else {
+        ref->valid = true;
+        ref->pkt_id = pkt_out->pkt_id;
+        ref->turbidity = previous[0];
+        ref->temperature = previous[1];
+        ref->pH = previous[2];
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
+uint16_t lwqms_pkt_peek_id(const uint8_t *buf) {
+    uint16_t pkt_id;
+
+    memcpy(&pkt_id, buf + PKT_ID_OFFSET, sizeof(pkt_id));
+
+    return pkt_id;
+}
+
+void lwqms_pkt_set_flags(uint8_t *buf, uint8_t flags) {
+    buf[PKT_TYPE_OFFSET] = (buf[PKT_TYPE_OFFSET] & LWQMS_PKT_TYPE_MASK) | (flags & ~LWQMS_PKT_TYPE_MASK);
+}
+
+#pragma region Frame Integrity
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+// Frame Integrity
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF
+uint16_t lwqms_pkt_crc16(const uint8_t *buf, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    for (size_t k = 0; k < len; k++) {
+        crc ^= (uint16_t)buf[k] << 8;
+
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+size_t lwqms_pkt_crc_append(uint8_t *buf, size_t len) {
+    uint16_t crc = lwqms_pkt_crc16(buf, len);
+
+    memcpy(buf + len, &crc, LWQMS_PKT_CRC_LEN);
+
+    return len + LWQMS_PKT_CRC_LEN;
+}
+
+bool lwqms_pkt_crc_check(const uint8_t *buf, size_t len) {
+    uint16_t crc;
+
+    if (len < LWQMS_PKT_HEADER_LEN + LWQMS_PKT_CRC_LEN) return false;
+
+    memcpy(&crc, buf + len - LWQMS_PKT_CRC_LEN, LWQMS_PKT_CRC_LEN);
+
+    return crc == lwqms_pkt_crc16(buf, len - LWQMS_PKT_CRC_LEN);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#pragma endregion
+
 lwqms_pkt_ack_status_t lwqms_pkt_check_ack(lwqms_pkt_t *pkt, uint16_t* packet_ID) {
-    if (pkt->packet_type != LWQMS_PACKET_TYPE_MESSAGE) return LWQMS_PKT_ACK_STATUS_NONE;
+    if ((pkt->packet_type & LWQMS_PKT_TYPE_MASK) != LWQMS_PACKET_TYPE_MESSAGE) return LWQMS_PKT_ACK_STATUS_NONE;
 
     // Extract the corresponding packet ID
     memcpy(packet_ID, pkt->payload.message + 4, 2);     
@@ -99,13 +411,50 @@ bool lwqms_generate_ack_packet(lwqms_pkt_t *packet_to_ack, lwqms_pkt_ack_status_
     return true;
 }
 
+bool lwqms_generate_sack_packet(lwqms_pkt_t *pkt_to_ack, uint16_t cumulative_ID, uint16_t bitmap, lwqms_pkt_t *pkt) {
+    lwqms_generate_ack_packet(pkt_to_ack, LWQMS_PKT_ACK_STATUS_ACK, pkt);
+
+    // Bytes 0-5 are the plain ACK, so a stop-and-wait sender still recognizes its packet ID.
+    memcpy(pkt->payload.message + 6, &cumulative_ID, 2);
+    memcpy(pkt->payload.message + 8, &bitmap, 2);
+    memcpy(pkt->payload.message + 10, SACK_INDICATOR, 2);
+
+    return true;
+}
+
+bool lwqms_pkt_get_sack_window(lwqms_pkt_t *pkt, uint16_t *cumulative_ID, uint16_t *bitmap) {
+    uint16_t packet_ID;
+
+    if (lwqms_pkt_check_ack(pkt, &packet_ID) != LWQMS_PKT_ACK_STATUS_ACK) return false;
+
+    if (strncmp(pkt->payload.message + 10, SACK_INDICATOR, 2) != 0) return false;
+
+    memcpy(cumulative_ID, pkt->payload.message + 6, 2);
+    memcpy(bitmap, pkt->payload.message + 8, 2);
+
+    return true;
+}
+
 extern void hexdump(const uint8_t *data, size_t length, size_t start_offset);
 
 void lwqms_packet_display(lwqms_pkt_t *pkt) {
     printf("-->Packet ID: %d\n", pkt->pkt_id);
     printf("-->Destination ID: %d\n", pkt->dest_id);
     printf("-->Source ID: %d\n", pkt->src_id);
-    printf("-->Packet Type: %s\n", pkt->packet_type == LWQMS_PACKET_TYPE_TELEMETRY ? "Telemetry" : "Message");
+    switch (pkt->packet_type & LWQMS_PKT_TYPE_MASK) {
+        case LWQMS_PACKET_TYPE_TELEMETRY:
+            printf("-->Packet Type: Telemetry\n");
+            break;
+        case LWQMS_PACKET_TYPE_TELEMETRY_BATCH:
+            printf("-->Packet Type: Telemetry Batch (%u samples)\n", (uint8_t)pkt->payload.message[0]);
+            break;
+        case LWQMS_PACKET_TYPE_TELEMETRY_COMPACT:
+            printf("-->Packet Type: Compact Telemetry (%u samples)\n", (pkt->payload.message[0] & LWQMS_COMPACT_QTY_MASK) + 1);
+            break;
+        default:
+            printf("-->Packet Type: Message\n");
+            break;
+    }
     
     printf("Payload:\n");
     hexdump(pkt->payload.message, sizeof(lwqms_pkt_payload_t), 0x00);
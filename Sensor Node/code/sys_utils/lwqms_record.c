@@ -0,0 +1,131 @@
+/*************************************************************************************
+ *
+ * @file lwqms_record.c
+ *
+ * @brief Binary records from the gateway to its host. Each record is protected by a CRC-16 and sent as a COBS frame, so
+ * the host finds record boundaries by the zero byte that ends every frame and never parses text.
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "lwqms_record.h"
+
+// The record is little-endian, as is the RP2040, so fields are copied straight in.
+#define PUT_FIELD(buf, offset, value) \
+    memcpy((buf) + (offset), &(value), sizeof(value)); \
+    (offset) += sizeof(value)
+
+static size_t put_prefix(uint8_t *buf, lwqms_record_type_t type, uint8_t flags, uint8_t packet_type) {
+    buf[0] = LWQMS_RECORD_VERSION;
+    buf[1] = (uint8_t)type;
+    buf[2] = flags;
+    buf[3] = packet_type;
+
+    return LWQMS_RECORD_PREFIX_LEN;
+}
+
+static size_t put_crc(uint8_t *buf, size_t len) {
+    uint16_t crc = lwqms_pkt_crc16(buf, len);
+
+    PUT_FIELD(buf, len, crc);
+
+    return len;
+}
+
+size_t lwqms_record_encode_packet(const uint8_t *pkt, size_t pkt_len, uint64_t rx_time_us, const sx126x_pkt_status_lora_t *link, const lwqms_telemetry_batch_t *samples, uint8_t *buf, size_t buflen) {
+    if ((pkt_len < LWQMS_PKT_HEADER_LEN) || (pkt_len - LWQMS_PKT_HEADER_LEN > UINT8_MAX)) return 0;
+
+    uint8_t payload_len = (uint8_t)(pkt_len - LWQMS_PKT_HEADER_LEN);
+    uint8_t qty_samples = (samples != NULL) ? samples->qty_samples : 0;
+
+    size_t len = LWQMS_RECORD_PACKET_FIXED_LEN + payload_len + 1 + (qty_samples * LWQMS_RECORD_SAMPLE_LEN) + LWQMS_RECORD_CRC_LEN;
+    if (len > buflen) return 0;
+
+    uint8_t flags = 0;
+    if (link != NULL) flags |= LWQMS_RECORD_FLAG_LINK;
+    if (samples != NULL) flags |= LWQMS_RECORD_FLAG_SAMPLES;
+
+    sx126x_pkt_status_lora_t no_link = {0, 0, 0};
+    if (link == NULL) link = &no_link;
+
+    // The packet header is already little-endian: pkt_id, dest_id and src_id, then the type byte.
+    uint16_t pkt_id, dest_id, src_id;
+    memcpy(&pkt_id, pkt + 0, sizeof(pkt_id));
+    memcpy(&dest_id, pkt + 2, sizeof(dest_id));
+    memcpy(&src_id, pkt + 4, sizeof(src_id));
+
+    size_t offset = put_prefix(buf, LWQMS_RECORD_PACKET, flags, pkt[6]);
+
+    PUT_FIELD(buf, offset, src_id);
+    PUT_FIELD(buf, offset, dest_id);
+    PUT_FIELD(buf, offset, pkt_id);
+    PUT_FIELD(buf, offset, rx_time_us);
+    PUT_FIELD(buf, offset, link->rssi_pkt_in_dbm);
+    PUT_FIELD(buf, offset, link->snr_pkt_in_db);
+    PUT_FIELD(buf, offset, link->signal_rssi_pkt_in_dbm);
+    PUT_FIELD(buf, offset, payload_len);
+
+    memcpy(buf + offset, pkt + LWQMS_PKT_HEADER_LEN, payload_len);
+    offset += payload_len;
+
+    PUT_FIELD(buf, offset, qty_samples);
+
+    for (int k = 0; k < qty_samples; k++) {
+        const lwqms_telemetry_sample_t *sample = &samples->samples[k];
+
+        PUT_FIELD(buf, offset, sample->age_s);
+        PUT_FIELD(buf, offset, sample->telemetry.turbidity_measurement);
+        PUT_FIELD(buf, offset, sample->telemetry.temperature_measurement);
+        PUT_FIELD(buf, offset, sample->telemetry.pH_measurement);
+    }
+
+    return put_crc(buf, offset);
+}
+
+size_t lwqms_record_encode_status(uint64_t time_us, uint32_t ring_overflows, uint32_t queue_overflows, uint8_t *buf, size_t buflen) {
+    if (buflen < LWQMS_RECORD_STATUS_LEN + LWQMS_RECORD_CRC_LEN) return 0;
+
+    size_t offset = put_prefix(buf, LWQMS_RECORD_STATUS, 0, 0);
+
+    PUT_FIELD(buf, offset, time_us);
+    PUT_FIELD(buf, offset, ring_overflows);
+    PUT_FIELD(buf, offset, queue_overflows);
+
+    return put_crc(buf, offset);
+}
+
+size_t lwqms_cobs_encode(const uint8_t *record, size_t len, uint8_t *frame, size_t framelen) {
+    if (framelen < LWQMS_COBS_FRAME_LEN_MAX(len)) return 0;
+
+    // Each block starts with a code byte: the distance to the next zero, or 0xFF for 254 bytes with no zero after them.
+    size_t code_pos = 0;
+    size_t out = 1;
+    uint8_t code = 1;
+
+    for (size_t k = 0; k < len; k++) {
+        if (record[k] == 0x00) {
+            frame[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+            continue;
+        }
+
+        frame[out++] = record[k];
+
+        if (++code == 0xFF) {
+            frame[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+
+    frame[code_pos] = code;
+    frame[out++] = 0x00;
+
+    return out;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -31,10 +31,12 @@ bool check_for_power_saving_mode_boot(uint32_t *novo_mem_contents_buf, size_t bu
     power_mgmt_read_novo_memory_hal(rxBuf, MCU_POWMAN_NOVO_ELEMENTS);
     
     // Clear out the incoming buffer
-    memset(novo_mem_contents_buf, 0x00, buf_len);
+    memset(novo_mem_contents_buf, 0x00, buf_len * sizeof(uint32_t));
 
-    memcpy(novo_mem_contents_buf, rxBuf + sizeof(uint32_t), MCU_POWMAN_NOVO_ELEMENTS - 1);
+    // Everything after the magic number is user data
+    memcpy(novo_mem_contents_buf, rxBuf + 1, (MCU_POWMAN_NOVO_ELEMENTS - 1) * sizeof(uint32_t));
 
+    *data_len = buf_len;
     for (int k = 0; k < buf_len; ++k) {
         if ((novo_mem_contents_buf[k] == 0) || (novo_mem_contents_buf[k] == 0xffffffff)) {
             *data_len = k;
@@ -70,11 +72,11 @@ bool enter_power_saving_mode(rp2350_power_mgmt_setting_t *mcu_power_saving_setti
     // Write the power saving flag to the novo memory of the chip to indicate the MCU is waking up from a power management triggered cold start - no POST required
     // Initialize a buffer
     uint32_t novo_buf[MCU_POWMAN_NOVO_ELEMENTS];
-    memset(novo_buf, 0x00, (sizeof(novo_buf) / sizeof(uint32_t)));
+    memset(novo_buf, 0x00, sizeof(novo_buf));
     
     // Write the wake magic number to the novo buffer, followed by the user-defined contents.
     novo_buf[0] = POWER_SAVING_WAKE_MAGIC_NUMBER;
-    memcpy(novo_buf + sizeof(uint32_t), novo_mem_contents, novo_contents_len);
+    memcpy(novo_buf + 1, novo_mem_contents, novo_contents_len * sizeof(uint32_t));
     power_mgmt_write_novo_memory_hal(novo_buf, MCU_POWMAN_NOVO_ELEMENTS);
     
     // Set the MCU in dormant mode
@@ -12,42 +12,138 @@
 
 #include "rdt3.h"
 
-// In this implementation, rdt_context_t aliases a packet of type lora_packet_t.
+// In this implementation, rdt_packet_t aliases a packet of type lora_pkt_t.
 
-rdt3_0_result_codes_t rdt3_0_transmit(rdt_packet_t pkt, size_t pkt_obj_size, void *physical_layer_setup) {
+#pragma region Retransmission Timeout
+
+/**
+ * @brief Folds one round trip time sample into the estimate, as RFC 6298 does. Only samples from packets sent once may be
+ * used (Karn's rule): the ACK for a retransmitted packet could be answering any of its copies.
+ */
+static void rtt_sample(rdt3_0_rtt_estimator_t *rtt, uint32_t sample_ms) {
+    if (sample_ms > RDT3_0_RTO_MAX_MS) sample_ms = RDT3_0_RTO_MAX_MS;
+    if (sample_ms == 0) sample_ms = 1;      // An SRTT of 0 means no estimate
+
+    if (rtt->srtt_ms == 0) {
+        rtt->srtt_ms = sample_ms;
+        rtt->rttvar_ms = sample_ms / 2;
+    }
+    else {
+        uint32_t deviation_ms = (rtt->srtt_ms > sample_ms) ? (rtt->srtt_ms - sample_ms) : (sample_ms - rtt->srtt_ms);
+
+        rtt->rttvar_ms = ((3 * rtt->rttvar_ms) + deviation_ms) / 4;
+        rtt->srtt_ms = ((7 * rtt->srtt_ms) + sample_ms + 4) / 8;
+    }
+}
+
+/**
+ * @brief Waits before another attempt. The wait is random, up to a limit that doubles with every attempt, so that nodes
+ * whose packets collided do not collide again on each retry.
+ * 
+ * @param attempt Number of attempts made so far, from 1
+ */
+static void retransmission_backoff(int attempt) {
+    uint32_t limit_ms = RDT3_0_BACKOFF_MAX_MS;
+
+    if ((attempt - 1) < 16) {
+        uint32_t doubled_ms = (uint32_t)RDT3_0_BACKOFF_BASE_MS << (attempt - 1);
+        if (doubled_ms < limit_ms) limit_ms = doubled_ms;
+    }
+
+    uint32_t backoff_ms = random_u32_hal() % (limit_ms + 1);
+
+    printf("Backing off for %u ms before trying again...\n", (unsigned)backoff_ms);
+
+    watchdog_feed_hal();
+    sleep_ms(backoff_ms);
+}
+
+uint32_t rdt3_0_rto_ms(const rdt3_0_ctx_t *ctx) {
+    if (ctx->rtt.srtt_ms == 0) return 0;
+
+    // However steady the round trip has been, a gateway busy receiving another node's frame may send the ACK later than usual.
+    uint32_t variation_ms = 4 * ctx->rtt.rttvar_ms;
+    if (variation_ms < RDT3_0_RTO_VARIATION_MIN_MS) variation_ms = RDT3_0_RTO_VARIATION_MIN_MS;
+
+    uint32_t rto_ms = ctx->rtt.srtt_ms + variation_ms;
+
+    if (rto_ms < RDT3_0_RTO_MIN_MS) rto_ms = RDT3_0_RTO_MIN_MS;
+    if (rto_ms > RDT3_0_RTO_MAX_MS) rto_ms = RDT3_0_RTO_MAX_MS;
+
+    return rto_ms;
+}
+
+uint32_t rdt3_0_rtt_save(const rdt3_0_ctx_t *ctx) {
+    return ((uint32_t)ctx->rtt.srtt_ms << 16) | ctx->rtt.rttvar_ms;
+}
+
+void rdt3_0_rtt_restore(rdt3_0_ctx_t *ctx, uint32_t saved_rtt) {
+    ctx->rtt.srtt_ms = (uint16_t)(saved_rtt >> 16);
+    ctx->rtt.rttvar_ms = (uint16_t)(saved_rtt & 0xFFFF);
+}
+
+#pragma endregion
+
+#pragma region Context API
+
+rdt3_0_result_codes_t rdt3_0_transmit_ctx(rdt3_0_ctx_t *ctx, rdt_packet_t pkt) {
     
     bool tx_ok = false;
 
     rdt3_0_result_codes_t exit_code = RDT3_0_RESULT_CODES_ERR;
 
-    rdt_packet_t rx_pkt = malloc(pkt_obj_size); // sorry, not sure how to get around this!
+    void *physical_layer_setup = ctx->physical_layer_setup;
+    rdt_packet_t rx_pkt = ctx->scratch_pkt;     // The ACK lands in the context's scratch packet
+
+    bool nacked = false;
 
     for (int k = 0; k < RDT_RETRIES; k++) {
         do {
+            // A NACK means the channel was clear enough for the receiver to answer, so there is no collision to back off from.
+            if ((k > 0) && !nacked) retransmission_backoff(k);
+
+            nacked = false;
+
             watchdog_feed_hal();    // Feed the dog - beware of bites!
 
-            // 1. Transmit the packet
-            if (!rdt3_0_tx_hal(pkt, physical_layer_setup)) break;
-            
-            // 2. Wait for an ACK from the receiver
+            // Karn's rule: only the first copy of a packet gives an unambiguous round trip time, and only if the ACK
+            // wait was not restarted by someone else's packet.
+            bool rtt_sample_valid = (k == 0);
+            uint32_t ack_delay_ms;
+            bool pkt_sent = false;
+
+            // 1. Transmit the packet, and 2. wait for an ACK from the receiver, listening as soon as the packet has left.
+            // Once sent, a packet that was not our ACK only needs the listening repeated.
             receive_start:
-            printf("Waiting for an acknowledge from the receiver...\n");
-            if (!rdt3_0_rx_hal(rx_pkt, physical_layer_setup)) break;
+            if (!pkt_sent) {
+                if (!rdt3_0_tx_then_rx_ack_hal(pkt, rx_pkt, rdt3_0_rto_ms(ctx), &ack_delay_ms, physical_layer_setup)) break;
+                pkt_sent = true;
+            }
+            else {
+                printf("Waiting for an acknowledge from the receiver...\n");
+                if (!rdt3_0_rx_ack_hal(rx_pkt, rdt3_0_rto_ms(ctx), &ack_delay_ms, physical_layer_setup)) break;
+            }
             
             // 3. If an ACK is not received before the timeout, or a NACK is received, then we need to repeat.
             rdt3_0_ack_t retval = rdt3_0_process_ack_pkt_hal(rx_pkt, pkt, physical_layer_setup);
             switch (retval) {
                 case RDT3_0_ACK:
                     printf("Packet Acknowledged by Receiver!\n");
+                    if (rtt_sample_valid) rtt_sample(&ctx->rtt, ack_delay_ms);
                     tx_ok = true;
                     break;
                 case RDT3_0_ACK_BAD_ID:
+                    rtt_sample_valid = false;
                     goto receive_start; // This could be thrown by the packet either having a bad packet ID or being for the wrong device.
                 case RDT3_0_ACK_ERR:
                     err_raise(ERR_RDT3_0, ERR_SEV_NONFATAL, "Failed to process ACK/NACK packet!", "rdt3_0_transmit");
                     break;
                 case RDT3_0_NACK:
+                    printf("Packet NACKed by Receiver, sending again...\n");
+                    nacked = true;
                     break;
+                default:
+                    break;      // RDT3_0_ACK_NONE: nothing usable heard, as if the ACK timed out
             }
 
             if (tx_ok) {
@@ -66,18 +162,17 @@ rdt3_0_result_codes_t rdt3_0_transmit(rdt_packet_t pkt, size_t pkt_obj_size, voi
         }
     }
 
-    free(rx_pkt);
-
     return exit_code;
 }
 
-rdt3_0_result_codes_t rdt3_0_receive(rdt_packet_t pkt, size_t pkt_obj_size, void *physical_layer_setup) {
+rdt3_0_result_codes_t rdt3_0_receive_ctx(rdt3_0_ctx_t *ctx, rdt_packet_t pkt) {
 
     bool rx_ok = false;
 
     rdt3_0_result_codes_t exit_code = RDT3_0_RESULT_CODES_ERR;
 
-    rdt_packet_t ack_pkt = malloc(pkt_obj_size);
+    void *physical_layer_setup = ctx->physical_layer_setup;
+    rdt_packet_t ack_pkt = ctx->scratch_pkt;    // The outgoing ACK is built in the context's scratch packet
 
     for (int k = 0; k < RDT_RETRIES; k++) {
 
@@ -95,6 +190,11 @@ rdt3_0_result_codes_t rdt3_0_receive(rdt_packet_t pkt, size_t pkt_obj_size, void
             switch (packet_status) {
                 case RDT3_0_ACK_BAD_ID:
                     goto begin_receive; // The packet is not intended for this receiver. Do not do anything
+                case RDT3_0_ACK_DUPLICATE_DEFERRED:
+                    goto begin_receive; // Already delivered, and the sender is not waiting on an ACK yet
+                case RDT3_0_NACK:
+                    rdt3_0_tx_hal(ack_pkt, physical_layer_setup);
+                    goto begin_receive; // Damaged in transit. The NACK asks for it again, and nothing is delivered.
                 default:
                     /**
                      * switch-case structure set up for future implementation that might require multiple other branches.
@@ -104,9 +204,17 @@ rdt3_0_result_codes_t rdt3_0_receive(rdt_packet_t pkt, size_t pkt_obj_size, void
                     break;
             }
 
+            // Part of a window: the ACK goes out when the sender asks for it
+            if (packet_status == RDT3_0_ACK_DEFERRED) {
+                rx_ok = true;
+                break;
+            }
+
             // Send the packet
             if (!rdt3_0_tx_hal(ack_pkt, physical_layer_setup)) break;
 
+            if (packet_status == RDT3_0_ACK_DUPLICATE) goto begin_receive;  // Re-acknowledged, but already delivered
+
             rx_ok = true;
         } while (0);
 
@@ -116,8 +224,145 @@ rdt3_0_result_codes_t rdt3_0_receive(rdt_packet_t pkt, size_t pkt_obj_size, void
         }
     }
 
-    free(ack_pkt);
+    return exit_code;
+
+}
+
+rdt3_0_result_codes_t rdt3_0_transmit_window_ctx(rdt3_0_ctx_t *ctx, rdt_packet_t pkts, size_t qty_pkts, size_t *qty_delivered) {
+
+    size_t base = 0;                // Index of the oldest packet not yet acknowledged
+    uint16_t acked_mask = 0;        // Bit k is set once packet base + k has been acknowledged
+    uint16_t sent_mask = 0;         // Bit k is set once packet base + k has been sent at least once
+    int rounds_without_progress = 0;
+
+    size_t pkt_obj_size = ctx->pkt_obj_size;
+    void *physical_layer_setup = ctx->physical_layer_setup;
+    rdt_packet_t rx_pkt = ctx->scratch_pkt;
+
+    while ((base < qty_pkts) && (rounds_without_progress < RDT_RETRIES)) {
+        
+        watchdog_feed_hal();    // Feed the dog - beware of bites!
+
+        size_t window_len = ((qty_pkts - base) < RDT3_0_SR_WINDOW_SIZE) ? (qty_pkts - base) : RDT3_0_SR_WINDOW_SIZE;
+        uint8_t *window = (uint8_t *)pkts + (base * pkt_obj_size);
+        uint16_t acked_before = acked_mask;
+        
+        size_t last_unacked = 0;
+        for (size_t k = 0; k < window_len; k++) {
+            if (!(acked_mask & (1 << k))) last_unacked = k;
+        }
+
+        // A round that sends nothing but new packets times the round trip. Any other is a retry, and backs off first.
+        uint16_t round_mask = ~acked_mask & (uint16_t)((1 << window_len) - 1);
+        bool rtt_sample_valid = !(sent_mask & round_mask);
+
+        if (!rtt_sample_valid) retransmission_backoff(rounds_without_progress + 1);
+
+        sent_mask |= round_mask;
+
+        do {
+            // 1. Send every packet in the window the receiver has not acknowledged, back to back. The last one asks for the ACK,
+            // 2. and the selective ACK, which reports every packet of the window received so far, is listened for as soon as
+            // it has left. Once sent, a packet that was not the selective ACK only needs the listening repeated.
+            uint32_t ack_delay_ms;
+            bool window_sent = false;
+
+            receive_start:
+            if (!window_sent) {
+                bool tx_ok = true;
+
+                for (size_t k = 0; (k < window_len) && tx_ok; k++) {
+                    if (acked_mask & (1 << k)) continue;
+
+                    rdt_packet_t pkt = window + (k * pkt_obj_size);
+
+                    tx_ok = rdt3_0_mark_window_pkt_hal(pkt, (base + k) == 0, k == last_unacked, physical_layer_setup) &&
+                            ((k == last_unacked) ? rdt3_0_tx_then_rx_ack_hal(pkt, rx_pkt, rdt3_0_rto_ms(ctx), &ack_delay_ms, physical_layer_setup)
+                                                 : rdt3_0_tx_hal(pkt, physical_layer_setup));
+                }
+
+                if (!tx_ok) break;
+                window_sent = true;
+            }
+            else {
+                printf("Waiting for a selective acknowledge from the receiver...\n");
+                if (!rdt3_0_rx_ack_hal(rx_pkt, rdt3_0_rto_ms(ctx), &ack_delay_ms, physical_layer_setup)) break;
+            }
+
+            rdt3_0_ack_t retval = rdt3_0_process_sack_pkt_hal(rx_pkt, window, window_len, pkt_obj_size, &acked_mask, physical_layer_setup);
+            switch (retval) {
+                case RDT3_0_ACK:
+                    if (rtt_sample_valid) rtt_sample(&ctx->rtt, ack_delay_ms);
+                    break;
+                case RDT3_0_ACK_BAD_ID:
+                    rtt_sample_valid = false;
+                    goto receive_start; // Either for another device, or a late ACK for an earlier round.
+                case RDT3_0_ACK_ERR:
+                    err_raise(ERR_RDT3_0, ERR_SEV_NONFATAL, "Failed to process selective ACK packet!", "rdt3_0_transmit_window");
+                    break;
+                default:
+                    break;
+            }
+
+        } while (0);
+
+        rounds_without_progress = (acked_mask != acked_before) ? 0 : rounds_without_progress + 1;
+
+        // 3. Slide the window past every packet acknowledged in order
+        while ((base < qty_pkts) && (acked_mask & 0x01)) {
+            base++;
+            acked_mask >>= 1;
+            sent_mask >>= 1;
+        }
+
+        printf("%u of %u packets acknowledged\n", (unsigned)base, (unsigned)qty_pkts);
+    }
+
+    if (qty_delivered != NULL) *qty_delivered = base;
+
+    return (base == qty_pkts) ? RDT3_0_RESULT_CODES_OK : RDT3_0_RESULT_CODES_ERR;
+}
+
+#pragma endregion
+
+#pragma region Heap API
+
+// The original API, kept for existing callers. Each call borrows a scratch packet from the heap.
+
+rdt3_0_result_codes_t rdt3_0_transmit(rdt_packet_t pkt, size_t pkt_obj_size, void *physical_layer_setup) {
+    rdt3_0_ctx_t ctx = {.scratch_pkt = malloc(pkt_obj_size), .pkt_obj_size = pkt_obj_size, .physical_layer_setup = physical_layer_setup};
+
+    if (ctx.scratch_pkt == NULL) return RDT3_0_RESULT_CODES_ERR;
+
+    rdt3_0_result_codes_t exit_code = rdt3_0_transmit_ctx(&ctx, pkt);
+
+    free(ctx.scratch_pkt);
 
     return exit_code;
+}
+
+rdt3_0_result_codes_t rdt3_0_receive(rdt_packet_t pkt, size_t pkt_obj_size, void *physical_layer_setup) {
+    rdt3_0_ctx_t ctx = {.scratch_pkt = malloc(pkt_obj_size), .pkt_obj_size = pkt_obj_size, .physical_layer_setup = physical_layer_setup};
+
+    if (ctx.scratch_pkt == NULL) return RDT3_0_RESULT_CODES_ERR;
+
+    rdt3_0_result_codes_t exit_code = rdt3_0_receive_ctx(&ctx, pkt);
+
+    free(ctx.scratch_pkt);
+
+    return exit_code;
+}
+
+rdt3_0_result_codes_t rdt3_0_transmit_window(rdt_packet_t pkts, size_t qty_pkts, size_t pkt_obj_size, void *physical_layer_setup, size_t *qty_delivered) {
+    rdt3_0_ctx_t ctx = {.scratch_pkt = malloc(pkt_obj_size), .pkt_obj_size = pkt_obj_size, .physical_layer_setup = physical_layer_setup};
+
+    if (ctx.scratch_pkt == NULL) return RDT3_0_RESULT_CODES_ERR;
+
+    rdt3_0_result_codes_t exit_code = rdt3_0_transmit_window_ctx(&ctx, pkts, qty_pkts, qty_delivered);
+
+    free(ctx.scratch_pkt);
+
+    return exit_code;
+}
 
-}
\ No newline at end of file
+#pragma endregion
@@ -0,0 +1,446 @@
+/*************************************************************************************
+ *
+ * @file rdt3_gateway.c
+ *
+ * @brief Multi-node gateway service for the Reliable Data Transfer 3.0 Transport Layer
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "rdt3_gateway.h"
+
+#pragma region Helpers
+
+static uint32_t us_to_ms_ceil(uint32_t time_us) {
+    return (time_us + 999) / 1000;
+}
+
+/**
+ * @brief Puts the radio (back) in continuous receive. The RX configuration is cached, so after an ACK only the commands
+ * the transmission changed are sent again.
+ */
+static bool listen(rdt3_0_gateway_t *gw) {
+    lora_setup_t *setup = &gw->phy;
+
+    gw->listening = lora_init_rx(setup->hw, setup->mod_setting, setup->pkt_setting) &&
+        lora_rx(setup->hw, setup->rx_interrupt_setting, ((node_config_t *)(setup->node_config))->sync_word, SX126X_RX_CONTINUOUS);
+
+    gw->rx_in_progress = false;
+
+    if (!gw->listening) err_raise(ERR_LORA_FAIL, ERR_SEV_NONFATAL, "Could not put the radio in continuous receive", "rdt3_0_gateway");
+
+    return gw->listening;
+}
+
+static rdt3_0_gw_session_t *session_for(rdt3_0_gateway_t *gw, uint16_t node_id, bool create, uint32_t now_ms) {
+    rdt3_0_gw_session_t *oldest = &gw->sessions[0];
+
+    for (int k = 0; k < RDT3_0_GW_MAX_NODES; k++) {
+        rdt3_0_gw_session_t *session = &gw->sessions[k];
+
+        if (session->node_id == node_id) return session;
+
+        if ((session->node_id == 0) || ((oldest->node_id != 0) && (session->last_heard_ms < oldest->last_heard_ms))) oldest = session;
+    }
+
+    if (!create) return NULL;
+
+    memset(oldest, 0x00, sizeof(*oldest));
+    oldest->node_id = node_id;
+    oldest->last_heard_ms = now_ms;
+
+    return oldest;
+}
+
+static void record_link(rdt3_0_gw_link_history_t *link, const lora_pkt_t *frame) {
+    if (!frame->link_valid) return;
+
+    link->rssi_dbm[link->next] = frame->link.rssi_pkt_in_dbm;
+    link->snr_db[link->next] = frame->link.snr_pkt_in_db;
+    link->next = (link->next + 1) % RDT3_0_GW_LINK_WINDOW;
+    link->measured++;
+
+    if (link->count < RDT3_0_GW_LINK_WINDOW) link->count++;
+}
+
+/**
+ * @returns True for compact telemetry delta coded against a sample the node's session does not hold. Its samples could not be
+ * recovered, so it must not be acknowledged: the node would go on coding against it.
+ */
+static bool telemetry_unreferenced(rdt3_0_gateway_t *gw, const lora_pkt_t *frame) {
+    lwqms_pkt_t header;
+
+    if (frame->corrupted || (frame->len <= LWQMS_PKT_HEADER_LEN)) return false;
+    if (!lwqms_pkt_decode((uint8_t *)frame->buf, frame->len, &header)) return false;
+    if ((header.packet_type & LWQMS_PKT_TYPE_MASK) != LWQMS_PACKET_TYPE_TELEMETRY_COMPACT) return false;
+    if (!(frame->buf[LWQMS_PKT_HEADER_LEN] & LWQMS_COMPACT_FLAG_DELTA)) return false;
+    if (header.dest_id != ((node_config_t *)(gw->phy.node_config))->ID) return false;
+
+    const rdt3_0_gw_session_t *session = rdt3_0_gateway_session(gw, header.src_id);
+
+    if ((session == NULL) || !session->telemetry_ref.valid) return true;
+
+    // A copy resent after a lost ACK was decoded the first time, and the reference has already moved on to it.
+    return (session->telemetry_ref.pkt_id != (uint16_t)(header.pkt_id - 1)) && (session->telemetry_ref.pkt_id != header.pkt_id);
+}
+
+#pragma endregion
+
+#pragma region Receive
+
+/**
+ * @brief Runs a frame through the RDT receive path, queues it if it is new, and schedules its ACK.
+ */
+static void accept_frame(rdt3_0_gateway_t *gw, lora_pkt_t *frame, const rdt3_0_gw_rx_info_t *info) {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    lwqms_pkt_t header;
+    lora_pkt_t ack;
+
+    // A packet that could not be queued must not be acknowledged, or it would be lost for good. Left unanswered, it is resent.
+    if (gw->queue_len >= RDT3_0_GW_QUEUE_LEN) {
+        gw->stats.queue_overflows++;
+        return;
+    }
+
+    // Checked before the packet is noted in its sender's sequence, or a resent copy would be acknowledged as a duplicate.
+    if (telemetry_unreferenced(gw, frame)) {
+        gw->stats.telemetry_unreferenced++;
+        return;
+    }
+
+    rdt3_0_ack_t status = rdt3_0_process_data_packet_hal(frame, &ack, &gw->phy);
+
+    if (status == RDT3_0_ACK_BAD_ID) {
+        gw->stats.not_addressed++;
+        return;
+    }
+
+    // A damaged header cannot be trusted to name a node, so it may only reach a session that already exists.
+    lwqms_pkt_decode(frame->buf, frame->len, &header);
+    rdt3_0_gw_session_t *session = session_for(gw, header.src_id, !frame->corrupted, now_ms);
+
+    if (session == NULL) return;
+
+    // Nor does it say whose link it was heard over, or that the node is still there.
+    if (!frame->corrupted) {
+        session->frames++;
+        session->last_heard_ms = now_ms;
+        record_link(&session->link, frame);
+    }
+
+    switch (status) {
+        case RDT3_0_ACK:
+        case RDT3_0_ACK_DEFERRED:
+            rdt3_0_gw_rx_t *rx = &gw->queue[(gw->queue_head + gw->queue_len) % RDT3_0_GW_QUEUE_LEN];
+            rx->pkt = *frame;
+            rx->info = *info;
+            rx->info.telemetry_ref = session->telemetry_ref;
+            gw->queue_len++;
+
+            // Each new packet from the node moves its reference on, as the node's own moves on with each ACK.
+            if ((header.packet_type & LWQMS_PKT_TYPE_MASK) == LWQMS_PACKET_TYPE_TELEMETRY_COMPACT) {
+                lwqms_pkt_decode_compact(frame->buf, frame->len, &session->telemetry_ref, &header, &gw->telemetry_scratch);
+            }
+            else {
+                session->telemetry_ref.valid = false;
+            }
+            session->delivered++;
+            break;
+
+        case RDT3_0_ACK_DUPLICATE:
+        case RDT3_0_ACK_DUPLICATE_DEFERRED:
+            session->duplicates++;
+            break;
+
+        default:
+            break;
+    }
+
+    if ((status == RDT3_0_ACK_DEFERRED) || (status == RDT3_0_ACK_DUPLICATE_DEFERRED)) return;
+
+    // A damaged frame may only seem to come from the node, so its NACK never displaces an ACK the node is waiting for.
+    if ((status == RDT3_0_NACK) && session->ack_pending) return;
+
+    // The node only ever waits for the ACK of its latest packet, so a newer ACK replaces one still pending.
+    session->ack = ack;
+    session->ack_pending = true;
+    session->ack_held = false;
+    session->ack_deadline = make_timeout_time_ms(RDT3_0_GW_ACK_DEFER_MAX_MS);
+}
+
+/**
+ * @brief Handles the radio's interrupts. The radio keeps listening through all of them, so nothing needs restarting.
+ */
+static void service_radio(rdt3_0_gateway_t *gw) {
+    lora_setup_t *setup = &gw->phy;
+    sx126x_irq_mask_t serviced_interrupts = sx126x_service_interrupts();
+
+    if ((serviced_interrupts & SX126X_IRQ_HEADER_VALID) > 0) {
+        // The header has just arrived, and the rest of the frame takes at most as long as the longest LWQMS frame would after
+        // its header.
+        uint32_t frame_us = lora_time_on_air_us(setup->mod_setting, setup->pkt_setting, LWQMS_PKT_FRAME_LEN_MAX);
+
+        gw->rx_in_progress = true;
+        gw->rx_busy_until = make_timeout_time_us(frame_us - lora_header_time_us(setup->mod_setting, setup->pkt_setting));
+    }
+
+    if ((serviced_interrupts & SX126X_IRQ_HEADER_ERROR) > 0) {
+        gw->stats.header_errors++;
+        gw->rx_in_progress = false;
+    }
+
+    if ((serviced_interrupts & SX126X_IRQ_RX_DONE) > 0) {
+        lora_pkt_t frame;
+        rdt3_0_gw_rx_info_t info = { .rx_time_us = to_us_since_boot(get_absolute_time()) };
+
+        gw->rx_in_progress = false;
+        gw->stats.frames++;
+
+        if (!lora_get_rx_data(setup->hw, frame.buf, &(frame.len))) return;
+        lora_get_rx_link_quality(setup->hw, &frame);
+
+        // The radio's CRC covers the air; the trailer also catches a packet its own CRC could not (or had switched off).
+        frame.corrupted = ((serviced_interrupts & SX126X_IRQ_CRC_ERROR) > 0) || !lwqms_pkt_crc_check(frame.buf, frame.len);
+
+        if (frame.corrupted) {
+            gw->stats.crc_errors++;
+        }
+        else {
+            frame.len -= LWQMS_PKT_CRC_LEN;
+        }
+
+        accept_frame(gw, &frame, &info);
+    }
+
+    // Continuous receive has no timeout of its own, so this only happens if the radio was knocked out of it.
+    if ((serviced_interrupts & SX126X_IRQ_TIMEOUT) > 0) listen(gw);
+}
+
+#pragma endregion
+
+#pragma region ACK Scheduling
+
+/**
+ * @brief Sends one ACK and waits for TX Done. Unlike `rdt3_0_tx_hal` this prints nothing: the console may be slow or not
+ * attached, and an ACK must never wait on it.
+ */
+static bool transmit_ack(rdt3_0_gateway_t *gw, lora_pkt_t *ack) {
+    lora_setup_t *setup = &gw->phy;
+
+    // The trailer goes just past the end of the packet, which keeps its own length.
+    uint8_t air_len = lwqms_pkt_crc_append(ack->buf, ack->len);
+    uint32_t radio_timeout_ms = us_to_ms_ceil(lora_time_on_air_us(setup->mod_setting, setup->pkt_setting, air_len)) + RDT3_0_TX_DONE_MARGIN_MS;
+
+    gpio_write_hal(TX_LED, GPIO_HIGH);
+
+    bool tx_ok = false;
+
+    if (lora_init_tx(setup->hw, setup->pa_setting, setup->mod_setting, setup->txPower, setup->ramp_time, ((node_config_t *)(setup->node_config))->sync_word) &&
+        lora_tx(setup->hw, setup->tx_interrupt_setting, setup->pkt_setting, ack->buf, air_len, radio_timeout_ms)) {
+        absolute_time_t tx_timeout = make_timeout_time_ms(radio_timeout_ms + RDT3_0_IRQ_MARGIN_MS);
+
+        // A receive interrupt that slipped in just before keying up is stale now; keep waiting for TX Done.
+        while (!tx_ok && !time_reached(tx_timeout)) {
+            if (!sx126x_wait_for_interrupt(us_to_ms_ceil((uint32_t)absolute_time_diff_us(get_absolute_time(), tx_timeout)))) break;
+            tx_ok = (sx126x_service_interrupts() & SX126X_IRQ_TX_DONE) > 0;
+        }
+    }
+
+    gpio_write_hal(TX_LED, GPIO_LOW);
+
+    return tx_ok;
+}
+
+/**
+ * @brief Returns the pending ACK due soonest, dropping any whose node has stopped listening.
+ */
+static rdt3_0_gw_session_t *next_ack(rdt3_0_gateway_t *gw) {
+    rdt3_0_gw_session_t *next = NULL;
+
+    for (int k = 0; k < RDT3_0_GW_MAX_NODES; k++) {
+        rdt3_0_gw_session_t *session = &gw->sessions[k];
+
+        if (!session->ack_pending) continue;
+
+        if (time_reached(session->ack_deadline)) {
+            session->ack_pending = false;
+            session->ack_held = false;
+            session->acks_expired++;
+            gw->stats.acks_expired++;
+            continue;
+        }
+
+        if ((next == NULL) || (absolute_time_diff_us(session->ack_deadline, next->ack_deadline) > 0)) next = session;
+    }
+
+    return next;
+}
+
+/**
+ * @brief Sends the pending ACKs, soonest deadline first. An ACK waits for a frame being received if that frame ends before the
+ * ACK is due; otherwise it goes out over the frame, which would have cost the ACK's node a retransmission anyway.
+ *
+ * @param wake_time Set to the time the ACK held back has to be looked at again
+ *
+ * @returns True if an ACK is being held back
+ */
+static bool send_acks(rdt3_0_gateway_t *gw, absolute_time_t *wake_time) {
+    bool sent = false;
+    bool held = false;
+    rdt3_0_gw_session_t *session;
+
+    while ((session = next_ack(gw)) != NULL) {
+        // A frame may have ended, or begun, since the radio was last serviced.
+        if (sx126x_check_for_interrupt()) {
+            service_radio(gw);
+            continue;
+        }
+
+        if (gw->rx_in_progress && time_reached(gw->rx_busy_until)) gw->rx_in_progress = false;
+
+        if (gw->rx_in_progress) {
+            if (absolute_time_diff_us(gw->rx_busy_until, session->ack_deadline) > 0) {
+                if (!session->ack_held) gw->stats.acks_deferred++;
+                session->ack_held = true;
+                *wake_time = gw->rx_busy_until;
+                held = true;
+                break;
+            }
+
+            gw->stats.acks_preempting++;
+            gw->rx_in_progress = false;
+        }
+
+        session->ack_pending = false;
+        session->ack_held = false;
+
+        if (transmit_ack(gw, &session->ack)) session->acks_sent++;
+        sent = true;
+    }
+
+    if (sent) {
+        gw->stats.rx_restarts++;
+        listen(gw);
+    }
+
+    return held;
+}
+
+#pragma endregion
+
+bool rdt3_0_gateway_start(rdt3_0_gateway_t *gw, lora_setup_t *setup) {
+    memset(gw, 0x00, sizeof(*gw));
+
+    // Both directions share one interrupt configuration, so switching between an ACK and listening does not rewrite it.
+    gw->irq_masks.system_mask = SX126X_IRQ_TX_DONE | SX126X_IRQ_RX_DONE | SX126X_IRQ_HEADER_VALID | SX126X_IRQ_HEADER_ERROR |
+                                SX126X_IRQ_CRC_ERROR | SX126X_IRQ_TIMEOUT;
+    gw->irq_masks.dio1_mask = gw->irq_masks.system_mask;
+
+    gw->phy = *setup;
+    gw->phy.rx_interrupt_setting = &gw->irq_masks;
+    gw->phy.tx_interrupt_setting = &gw->irq_masks;
+
+    if (sx126x_check_for_interrupt()) sx126x_service_interrupts();
+
+    return listen(gw);
+}
+
+/**
+ * @brief Services the radio and the ACKs until the timeout, or until a packet can be returned if `pkt` is given.
+ */
+static bool run_service(rdt3_0_gateway_t *gw, lora_pkt_t *pkt, rdt3_0_gw_rx_info_t *info, uint32_t timeout_ms) {
+    absolute_time_t timeout_time = make_timeout_time_ms(timeout_ms);
+
+    while (true) {
+        if (!gw->listening && !listen(gw)) return false;
+
+        if (sx126x_check_for_interrupt()) service_radio(gw);
+
+        absolute_time_t ack_wake;
+        bool ack_waiting = send_acks(gw, &ack_wake);
+
+        if ((pkt != NULL) && (gw->queue_len > 0)) {
+            *pkt = gw->queue[gw->queue_head].pkt;
+            if (info != NULL) *info = gw->queue[gw->queue_head].info;
+            gw->queue_head = (gw->queue_head + 1) % RDT3_0_GW_QUEUE_LEN;
+            gw->queue_len--;
+            return true;
+        }
+
+        if (time_reached(timeout_time)) return false;
+
+        // Sleep until the radio has something, or a deferred ACK has to be looked at again.
+        absolute_time_t wake_time = timeout_time;
+        if (ack_waiting && (absolute_time_diff_us(ack_wake, wake_time) > 0)) wake_time = ack_wake;
+
+        while (!sx126x_check_for_interrupt()) {
+            if (sleep_until_event_hal(wake_time)) break;
+        }
+    }
+}
+
+bool rdt3_0_gateway_receive(rdt3_0_gateway_t *gw, lora_pkt_t *pkt, rdt3_0_gw_rx_info_t *info, uint32_t timeout_ms) {
+    return run_service(gw, pkt, info, timeout_ms);
+}
+
+void rdt3_0_gateway_service(rdt3_0_gateway_t *gw, uint32_t timeout_ms) {
+    run_service(gw, NULL, NULL, timeout_ms);
+}
+
+const rdt3_0_gw_session_t *rdt3_0_gateway_session(const rdt3_0_gateway_t *gw, uint16_t node_id) {
+    for (int k = 0; k < RDT3_0_GW_MAX_NODES; k++) {
+        if (gw->sessions[k].node_id == node_id) return &gw->sessions[k];
+    }
+
+    return NULL;
+}
+
+bool rdt3_0_gateway_link_stats(const rdt3_0_gateway_t *gw, uint16_t node_id, rdt3_0_gw_link_stats_t *stats) {
+    const rdt3_0_gw_session_t *session = rdt3_0_gateway_session(gw, node_id);
+
+    if ((session == NULL) || (session->link.count == 0)) return false;
+
+    const rdt3_0_gw_link_history_t *link = &session->link;
+    int32_t rssi_total = 0;
+    int32_t snr_total = 0;
+
+    stats->window = link->count;
+    stats->rssi_min_dbm = INT8_MAX;
+    stats->rssi_max_dbm = INT8_MIN;
+    stats->snr_min_db = INT8_MAX;
+    stats->snr_max_db = INT8_MIN;
+
+    for (int k = 0; k < link->count; k++) {
+        int8_t rssi = link->rssi_dbm[k];
+        int8_t snr = link->snr_db[k];
+
+        rssi_total += rssi;
+        snr_total += snr;
+
+        if (rssi < stats->rssi_min_dbm) stats->rssi_min_dbm = rssi;
+        if (rssi > stats->rssi_max_dbm) stats->rssi_max_dbm = rssi;
+        if (snr < stats->snr_min_db) stats->snr_min_db = snr;
+        if (snr > stats->snr_max_db) stats->snr_max_db = snr;
+    }
+
+    stats->rssi_mean_db_x10 = (int16_t)((rssi_total * 10) / link->count);
+    stats->snr_mean_db_x10 = (int16_t)((snr_total * 10) / link->count);
+
+    // Plan on the worst packet of the window, not the mean: the node has to get through its fades as well.
+    int16_t worst_snr_db_x10 = stats->snr_min_db * 10;
+
+    stats->margin_db_x10 = worst_snr_db_x10 - lora_snr_floor_db_x10(gw->phy.mod_setting->sf);
+    stats->fastest_sf = SX126X_LORA_SF12;
+
+    for (sx126x_lora_sf_t sf = SX126X_LORA_SF5; sf <= SX126X_LORA_SF12; sf++) {
+        if (worst_snr_db_x10 - lora_snr_floor_db_x10(sf) >= RDT3_0_GW_LINK_MARGIN_DB * 10) {
+            stats->fastest_sf = sf;
+            break;
+        }
+    }
+
+    return true;
+}
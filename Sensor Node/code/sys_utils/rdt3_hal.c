@@ -12,6 +12,299 @@
 
 #include "rdt3_hal.h"
 
+#pragma region Helpers
+
+static uint32_t us_to_ms_ceil(uint32_t time_us) {
+    return (time_us + 999) / 1000;
+}
+
+static void discard_stale_interrupt(void) {
+    // An IRQ that landed after its operation was given up on must not be mistaken for the outcome of the next one.
+    if (sx126x_check_for_interrupt()) {
+        sx126x_irq_mask_t stale_interrupts = sx126x_service_interrupts();
+        printf("Discarded stale radio interrupt (IRQ Mask = %u)\n", stale_interrupts);
+    }
+}
+
+static bool wait_for_interrupt(uint32_t wait_ms) {
+    printf("Waiting for interrupt...");
+    if (sx126x_wait_for_interrupt(wait_ms)) {
+        printf("DONE\n");
+        return true;
+    }
+
+    printf("FAIL\n");
+    return false;
+}
+
+/**
+ * @brief Starts a receive operation from scratch: configures the radio for RX, then puts it in receive mode.
+ */
+static bool start_receive(lora_setup_t *setup, uint32_t radio_timeout_ms) {
+    // Initialize a receive operation
+    printf("Initializing a receive operation...");
+    if (!lora_init_rx(setup->hw, setup->mod_setting, setup->pkt_setting)) return false;
+    printf("DONE\n");
+
+    // Ensure the RX Done interrupt is set
+    setup->rx_interrupt_setting->dio1_mask |= SX126X_IRQ_RX_DONE;
+
+    discard_stale_interrupt();
+
+    // Set the radio in receive mode
+    printf("Putting the radio in receive mode...");
+    if (!lora_rx(setup->hw, setup->rx_interrupt_setting, ((node_config_t *)(setup->node_config))->sync_word, radio_timeout_ms)) return false;
+    printf("DONE\n");
+
+    return true;
+}
+
+/**
+ * @brief Waits for the receive operation in progress to end and retrieves its packet. The radio's own RX timeout ends the
+ * listening period, and the wait for its interrupt is longer by the airtime of a packet whose header arrived just before the
+ * timeout, so the radio always reports first.
+ */
+static bool finish_receive(lora_setup_t *setup, lora_pkt_t *lora_pkt, uint32_t radio_timeout_ms) {
+    bool rx_ok = false;
+
+    do {
+        // Wait for the RX Done Interrupt
+        uint32_t longest_pkt_ms = us_to_ms_ceil(lora_time_on_air_us(setup->mod_setting, setup->pkt_setting, LORA_MAX_PKT_LEN - 1));
+
+        if (!wait_for_interrupt(radio_timeout_ms + longest_pkt_ms + RDT3_0_IRQ_MARGIN_MS)) break;
+
+        sx126x_irq_mask_t serviced_interrupts = sx126x_service_interrupts();
+
+        if ((serviced_interrupts & SX126X_IRQ_RX_DONE) > 0) {
+            printf("RX Operation Successful!\n");
+            rx_ok = true;
+
+            // Retrieve the packet data from the radio
+            if (!lora_get_rx_data(setup->hw, lora_pkt->buf, &(lora_pkt->len))) break;  
+            lora_get_rx_link_quality(setup->hw, lora_pkt);
+
+            printf("Received Packet: \n");
+            hexdump(lora_pkt->buf, lora_pkt->len, 0x00);
+            if (lora_pkt->link_valid) printf("RSSI %d dBm, SNR %d dB\n", lora_pkt->link.rssi_pkt_in_dbm, lora_pkt->link.snr_pkt_in_db);
+            printf("\n\n");
+
+            // The radio's CRC covers the air; the trailer also catches a packet its own CRC could not (or had switched off).
+            lora_pkt->corrupted = ((serviced_interrupts & SX126X_IRQ_CRC_ERROR) > 0) || !lwqms_pkt_crc_check(lora_pkt->buf, lora_pkt->len);
+
+            if (lora_pkt->corrupted) {
+                printf("Received packet failed its CRC!\n");
+            }
+            else {
+                lora_pkt->len -= LWQMS_PKT_CRC_LEN;
+            }
+        }
+        else if ((serviced_interrupts & SX126X_IRQ_TIMEOUT) > 0) {
+            // Nothing arrived. Expected whenever a packet or its ACK is lost, and the caller decides when to try again,
+            // so there is no error to signal (and no blinking delay that would line up every node's retries).
+            printf("RX Timeout: nothing received\n");
+        }
+        else {
+            char err_msg[0x100];
+            snprintf(err_msg, 0x100, "RX Error: IRQ Mask = %u", serviced_interrupts);
+            err_raise(ERR_LORA_FAIL, ERR_SEV_NONFATAL, err_msg, "rdt3_0_rx_hal");
+        }
+
+    } while (0);
+
+    return rx_ok;
+}
+
+/**
+ * @brief Receives one packet.
+ */
+static bool receive_packet(lora_setup_t *setup, lora_pkt_t *lora_pkt, uint32_t radio_timeout_ms) {
+    gpio_write_hal(RX_LED, GPIO_HIGH);
+
+    bool rx_ok = start_receive(setup, radio_timeout_ms) && finish_receive(setup, lora_pkt, radio_timeout_ms);
+
+    gpio_write_hal(RX_LED, GPIO_LOW);
+
+    return rx_ok;
+}
+
+/**
+ * @brief Configures the radio for TX and starts sending one packet, with the given interrupt configuration (which must include
+ * TX Done). Sets the time the radio is given to send it.
+ */
+static bool start_transmit(lora_setup_t *setup, lora_pkt_t *lora_pkt, sx126x_dio_irq_masks_t *irq_setting, uint32_t *radio_timeout_ms) {
+    // The trailer goes just past the end of the packet, which keeps its own length, so a retransmission appends it again.
+    uint8_t air_len = lwqms_pkt_crc_append(lora_pkt->buf, lora_pkt->len);
+
+    // Initialize a transmit operation
+    printf("\n\n\nInitializing Transmit Operation...");
+    if (!lora_init_tx(setup->hw, setup->pa_setting, setup->mod_setting, setup->txPower, setup->ramp_time, ((node_config_t *)(setup->node_config))->sync_word)) return false;
+    printf("DONE\n");
+
+    discard_stale_interrupt();
+
+    // The radio gives up on the packet shortly after it should have left the antenna, and we wait a little longer still
+    // so that its TX Done or Timeout interrupt is always the one that ends the wait.
+    *radio_timeout_ms = us_to_ms_ceil(lora_time_on_air_us(setup->mod_setting, setup->pkt_setting, air_len)) + RDT3_0_TX_DONE_MARGIN_MS;
+
+    // Send the packet
+    printf("Sending the packet...");
+    if (!lora_tx(setup->hw, irq_setting, setup->pkt_setting, lora_pkt->buf, air_len, *radio_timeout_ms)) return false;
+    printf("DONE\n");
+
+    return true;
+}
+
+static bool check_tx_done(sx126x_irq_mask_t serviced_interrupts) {
+    if ((serviced_interrupts & SX126X_IRQ_TX_DONE) > 0) return true;
+
+    char err_msg[0x100];
+    snprintf(err_msg, 0x100, "TX Error: IRQ Mask = %u", serviced_interrupts);
+    err_raise(ERR_LORA_TIMEOUT, ERR_SEV_NONFATAL, err_msg, "rdt3_0_tx_hal");
+
+    return false;
+}
+
+/**
+ * @brief The ACK can only begin once the receiver has turned the link around, and the radio stops its timeout as soon as it has
+ * the ACK's header, so only the turnaround and the header need to fit in the listening window.
+ */
+static uint32_t ack_window_ms(lora_setup_t *setup, uint32_t ack_timeout_ms) {
+    if (ack_timeout_ms > 0) return ack_timeout_ms;
+
+    return RDT3_0_ACK_TURNAROUND_MS + us_to_ms_ceil(lora_header_time_us(setup->mod_setting, setup->pkt_setting));
+}
+
+static void measure_ack_delay(lora_setup_t *setup, lora_pkt_t *lora_pkt, absolute_time_t listen_start, uint32_t *ack_delay_ms) {
+    if (ack_delay_ms == NULL) return;
+
+    // RX Done comes once the whole ACK is in, but the listening window only has to last until its header. The ACK's trailer
+    // was on the air too.
+    int64_t delay_us = absolute_time_diff_us(listen_start, get_absolute_time()) -
+                       (int64_t)(lora_time_on_air_us(setup->mod_setting, setup->pkt_setting, lora_pkt->len + LWQMS_PKT_CRC_LEN) -
+                                 lora_header_time_us(setup->mod_setting, setup->pkt_setting));
+
+    *ack_delay_ms = (delay_us > 0) ? us_to_ms_ceil((uint32_t)delay_us) : 0;
+}
+
+#pragma endregion
+
+#pragma region Receiver Sequence State
+
+/**
+ * @brief What a receiver knows about one sender's sequence numbers: a sliding window of the packet IDs received, used both
+ * to build selective ACKs and to keep retransmitted packets from being delivered twice.
+ */
+typedef struct rdt3_0_sr_rx_state_s {
+    bool in_use;
+    bool anchored;                  // The start of the sender's sequence is known, so the cumulative ACK is exact
+    uint16_t src_id;
+    uint16_t sync_id;               // Packet ID the sequence was anchored on
+    uint16_t cumulative_id;         // Every packet ID up to and including this one has been received
+    uint16_t bitmap;                // Bit k set when packet ID cumulative_id + 1 + k has been received
+    uint32_t last_heard_ms;
+} rdt3_0_sr_rx_state_t;
+
+static rdt3_0_sr_rx_state_t sr_rx_states[RDT3_0_SR_MAX_PEERS];
+
+static rdt3_0_sr_rx_state_t *sr_rx_state_for(uint16_t src_id, uint16_t pkt_id, uint32_t now_ms) {
+    rdt3_0_sr_rx_state_t *oldest = &sr_rx_states[0];
+
+    for (int k = 0; k < RDT3_0_SR_MAX_PEERS; k++) {
+        rdt3_0_sr_rx_state_t *state = &sr_rx_states[k];
+
+        if (state->in_use && ((now_ms - state->last_heard_ms) >= RDT3_0_SR_STATE_EXPIRY_MS)) state->in_use = false;
+
+        if (state->in_use && (state->src_id == src_id)) return state;
+
+        if (!state->in_use || (oldest->in_use && (state->last_heard_ms < oldest->last_heard_ms))) oldest = state;
+    }
+
+    // A new transfer. Until its first packet arrives, keep the cumulative ACK far enough back that it cannot cover any packet
+    // of the sender's current window.
+    oldest->in_use = true;
+    oldest->anchored = false;
+    oldest->src_id = src_id;
+    oldest->cumulative_id = pkt_id - (RDT3_0_SR_BITMAP_WIDTH / 2);
+    oldest->bitmap = 0;
+
+    return oldest;
+}
+
+/**
+ * @brief Starts a sender's sequence at the given packet, keeping whatever has been received just after it.
+ */
+static void sr_rx_anchor(rdt3_0_sr_rx_state_t *state, uint16_t pkt_id) {
+    uint16_t shift = (uint16_t)((pkt_id - 1) - state->cumulative_id);
+
+    state->bitmap = (shift < RDT3_0_SR_BITMAP_WIDTH) ? (state->bitmap >> shift) : 0;
+    state->cumulative_id = pkt_id - 1;
+    state->sync_id = pkt_id;
+    state->anchored = true;
+}
+
+/**
+ * @brief Records a received packet ID in a sender's state. IDs are compared modulo 2^16, so the window slides across the
+ * wraparound of the packet ID.
+ * 
+ * @param state The sender's state
+ * @param pkt_id ID of the packet received
+ * @param sequence_start The packet carries `LWQMS_PKT_FLAG_SYNC`: the sender (re)started its sequence with it, as after a reboot
+ * @param windowed The packet is part of a selective repeat transfer
+ * 
+ * @returns True if the packet is new, false if it was received before.
+ */
+static bool sr_rx_record(rdt3_0_sr_rx_state_t *state, uint16_t pkt_id, bool sequence_start, bool windowed) {
+    if (sequence_start) {
+        // Re-anchor, unless this is another copy of the packet the current sequence was anchored on. The sender only resends
+        // that packet until it is acknowledged, so once the sequence has moved on, the same ID is a new sequence: a sender
+        // that rebooted and started over from the same ID.
+        uint16_t progress = (uint16_t)(state->cumulative_id - state->sync_id);
+        bool copy_of_sync = state->anchored && (pkt_id == state->sync_id) && (progress < (windowed ? RDT3_0_SR_BITMAP_WIDTH : 1));
+
+        if (!copy_of_sync) sr_rx_anchor(state, pkt_id);
+    }
+    else if (!windowed && !state->anchored) {
+        // A stop-and-wait sender has nothing outstanding but this packet, so everything before it is settled.
+        sr_rx_anchor(state, pkt_id);
+    }
+
+    int16_t distance = (int16_t)(pkt_id - state->cumulative_id);
+
+    if (distance <= 0) {
+        if (windowed || (distance > -RDT3_0_SR_BITMAP_WIDTH)) return false;
+
+        // Far behind anything recent: the stop-and-wait sender started over without saying so.
+        sr_rx_anchor(state, pkt_id);
+        distance = 1;
+    }
+
+    if (distance > RDT3_0_SR_BITMAP_WIDTH) {
+        // Beyond what the bitmap can report: deliver the packet, but let the sender resend it once the window has moved up.
+        if (windowed) return true;
+
+        // A stop-and-wait sender gave up on the packets in between; they will not be resent.
+        state->cumulative_id = pkt_id - 1;
+        state->bitmap = 0;
+        distance = 1;
+    }
+
+    uint16_t bit = (uint16_t)(1 << (distance - 1));
+
+    if (state->bitmap & bit) return false;
+
+    state->bitmap |= bit;
+
+    // Advance the cumulative ACK over every packet now received in order.
+    while (state->bitmap & 0x01) {
+        state->cumulative_id++;
+        state->bitmap >>= 1;
+    }
+
+    return true;
+}
+
+#pragma endregion
+
 bool rdt3_0_tx_hal(rdt_packet_t pkt, void* physical_context) {
     // Cast the incoming generic physical context to an application-specific type. In this case, we will use lora_setup_t.
     lora_setup_t *setup = (lora_setup_t *)physical_context;
@@ -22,51 +315,25 @@ bool rdt3_0_tx_hal(rdt_packet_t pkt, void* physical_context) {
     // Repetition is built into these functions, so we will just try to execute each one once.
     bool tx_ok = false;
 
+    if (lora_pkt->len > LORA_MAX_PKT_LEN - 1 - LWQMS_PKT_CRC_LEN) return false;
+
     gpio_write_hal(TX_LED, GPIO_HIGH);
 
     do {
-        // Initialize a transmit operation
-        printf("\n\n\nInitializing Transmit Operation...");
-        if (!lora_init_tx(setup->hw, setup->pa_setting, setup->mod_setting, setup->txPower, setup->ramp_time, ((node_config_t *)(setup->node_config))->sync_word)) break;
-        printf("DONE\n");
-    
         // Ensure the TX Done interrupt is set.
         setup->tx_interrupt_setting->dio1_mask |= SX126X_IRQ_TX_DONE;
 
-        // Send the packet
-        printf("Sending the packet...");
-        if (!lora_tx(setup->hw, setup->tx_interrupt_setting, setup->pkt_setting, lora_pkt->buf, lora_pkt->len)) break;
-        printf("DONE\n");
+        uint32_t radio_timeout_ms;
 
-        // Wait for the TX Done Interrupt
-        absolute_time_t tx_done_timeout_time = make_timeout_time_ms(setup->operation_timeout_ms);
-        bool interrupt_found = false;
-        
-        printf("Waiting for interrupt...");
-        while(get_absolute_time() < tx_done_timeout_time) {
-            if (sx126x_check_for_interrupt())  {
-                interrupt_found = true;
-                break;
-            }
-        }
+        if (!start_transmit(setup, lora_pkt, setup->tx_interrupt_setting, &radio_timeout_ms)) break;
 
-        if (!interrupt_found) {
-            printf("FAIL\n");
-            break;
-        }
-        printf("DONE\n");
+        // Wait for the TX Done Interrupt
+        if (!wait_for_interrupt(radio_timeout_ms + RDT3_0_IRQ_MARGIN_MS)) break;
 
-        sx126x_irq_mask_t serviced_interrupts = sx126x_service_interrupts();
+        if (!check_tx_done(sx126x_service_interrupts())) break;
 
-        if ((serviced_interrupts & SX126X_IRQ_TX_DONE) > 0) {
-            printf("TX Operation Successful!\n\n\n");
-            tx_ok = true;
-        }
-        else {
-            char err_msg[0x100];
-            snprintf(err_msg, 0x100, "TX Error: IRQ Mask = %u", serviced_interrupts);
-            err_raise(ERR_LORA_TIMEOUT, ERR_SEV_NONFATAL, err_msg, "rdt3_0_tx_hal");
-        }
+        printf("TX Operation Successful!\n\n\n");
+        tx_ok = true;
 
     } while (0);
 
@@ -79,72 +346,81 @@ bool rdt3_0_rx_hal(rdt_packet_t pkt, void* physical_context) {
     // Cast the incoming generic physical context to an application-specific type. In this case, we will use lora_setup_t.
     lora_setup_t *setup = (lora_setup_t *)physical_context;
 
-    // Cast the incoming generic packet data to an application-specific type. In this case, this is lora_pkt_t.
-    lora_pkt_t *lora_pkt = (lora_pkt_t*)pkt;
+    // A packet could come at any time, so listen for the whole operation timeout.
+    return receive_packet(setup, (lora_pkt_t *)pkt, setup->operation_timeout_ms);
+}
 
-    bool rx_ok = false;
+bool rdt3_0_rx_ack_hal(rdt_packet_t pkt, uint32_t ack_timeout_ms, uint32_t *ack_delay_ms, void* physical_context) {
+    lora_setup_t *setup = (lora_setup_t *)physical_context;
+    lora_pkt_t *lora_pkt = (lora_pkt_t *)pkt;
 
-    gpio_write_hal(RX_LED, GPIO_HIGH);
+    absolute_time_t listen_start = get_absolute_time();
 
-    do {
-        // Initialize a receive operation
-        printf("Initializing a receive operation...");
-        if (!lora_init_rx(setup->hw, setup->mod_setting, setup->pkt_setting)) break;
-        printf("DONE\n");
+    if (!receive_packet(setup, lora_pkt, ack_window_ms(setup, ack_timeout_ms))) return false;
 
-        // Ensure the RX Done interrupt is set
-        setup->rx_interrupt_setting->dio1_mask |= SX126X_IRQ_RX_DONE;
-        
-        // Set the radio in receive mode
-        printf("Putting the radio in receive mode...");
-        if (!lora_rx(setup->hw, setup->rx_interrupt_setting, ((node_config_t *)(setup->node_config))->sync_word, setup->operation_timeout_ms)) break;
-        printf("DONE\n");
+    measure_ack_delay(setup, lora_pkt, listen_start, ack_delay_ms);
 
-        // Wait for the RX Done Interrupt
-        absolute_time_t rx_done_timeout_time = make_timeout_time_ms(setup->operation_timeout_ms);
-        bool interrupt_found = false;
-
-        printf("Waiting for interrupt...");
-        while (get_absolute_time() < rx_done_timeout_time) {
-            if (sx126x_check_for_interrupt()) {
-                interrupt_found = true;
-                break;
-            }
-        }
+    return true;
+}
+
+bool rdt3_0_tx_then_rx_ack_hal(rdt_packet_t pkt, rdt_packet_t ack_pkt, uint32_t ack_timeout_ms, uint32_t *ack_delay_ms, void* physical_context) {
+    lora_setup_t *setup = (lora_setup_t *)physical_context;
+    lora_pkt_t *lora_pkt = (lora_pkt_t *)pkt;
+    lora_pkt_t *lora_ack_pkt = (lora_pkt_t *)ack_pkt;
 
-        if (!interrupt_found) {
-            printf("FAIL\n");
+    if (lora_pkt->len > LORA_MAX_PKT_LEN - 1 - LWQMS_PKT_CRC_LEN) return false;
+
+    // One interrupt configuration serves both halves, so nothing has to be rewritten between the TX and the RX.
+    sx126x_dio_irq_masks_t turnaround_irqs = {
+        .system_mask = setup->tx_interrupt_setting->system_mask | setup->rx_interrupt_setting->system_mask,
+        .dio1_mask = setup->tx_interrupt_setting->dio1_mask | setup->rx_interrupt_setting->dio1_mask | SX126X_IRQ_TX_DONE | SX126X_IRQ_RX_DONE,
+        .dio2_mask = setup->tx_interrupt_setting->dio2_mask | setup->rx_interrupt_setting->dio2_mask,
+        .dio3_mask = setup->tx_interrupt_setting->dio3_mask | setup->rx_interrupt_setting->dio3_mask
+    };
+
+    uint32_t radio_timeout_ms = ack_window_ms(setup, ack_timeout_ms);
+    bool ack_ok = false;
+
+    gpio_write_hal(TX_LED, GPIO_HIGH);
+
+    do {
+        uint32_t tx_timeout_ms;
+
+        if (!start_transmit(setup, lora_pkt, &turnaround_irqs, &tx_timeout_ms)) break;
+
+        // Nothing is printed until the receiver is armed: a fast ACK could otherwise start before the radio is listening.
+        if (!sx126x_wait_for_interrupt(tx_timeout_ms + RDT3_0_IRQ_MARGIN_MS)) {
+            printf("TX Done interrupt never came\n");
             break;
         }
 
-        printf("DONE\n");
+        absolute_time_t tx_end = get_absolute_time();
 
-        sx126x_irq_mask_t serviced_interrupts = sx126x_service_interrupts();
+        if (!check_tx_done(sx126x_service_interrupts())) break;
 
-        if ((serviced_interrupts & SX126X_IRQ_RX_DONE) > 0) {
-            printf("RX Operation Successful!\n");
-            rx_ok = true;
+        gpio_write_hal(TX_LED, GPIO_LOW);
+        gpio_write_hal(RX_LED, GPIO_HIGH);
 
-            // Retrieve the packet data from the radio
-            if (!lora_get_rx_data(setup->hw, lora_pkt->buf, &(lora_pkt->len))) break;  
+        if (setup->ack_rx_delay_us > 0) sleep_until(tx_end + setup->ack_rx_delay_us);
 
-            printf("Received Packet: \n");
-            hexdump(lora_pkt->buf, lora_pkt->len, 0x00);
-            printf("\n\n");
-        }
-        else {
-            char err_msg[0x100];
-            snprintf(err_msg, 0x100, "RX Error: IRQ Mask = %u", serviced_interrupts);
-            err_raise(ERR_LORA_FAIL, ERR_SEV_NONFATAL, err_msg, "rdt3_0_rx_hal");
-        }
+        // The radio still holds the modulation and packet settings the packet was sent with, and the crystal is kept running
+        // after TX, so only the interrupts need clearing before it starts receiving.
+        if (!lora_rx(setup->hw, &turnaround_irqs, ((node_config_t *)(setup->node_config))->sync_word, radio_timeout_ms)) break;
+
+        absolute_time_t listen_start = get_absolute_time();
 
-      
+        printf("TX Operation Successful! Listening for the ACK %lld us after TX Done\n", (long long)absolute_time_diff_us(tx_end, listen_start));
+
+        ack_ok = finish_receive(setup, lora_ack_pkt, radio_timeout_ms);
+
+        if (ack_ok) measure_ack_delay(setup, lora_ack_pkt, listen_start, ack_delay_ms);
 
     } while (0);
 
+    gpio_write_hal(TX_LED, GPIO_LOW);
     gpio_write_hal(RX_LED, GPIO_LOW);
 
-    return rx_ok;
+    return ack_ok;
 }
 
 rdt3_0_ack_t rdt3_0_process_ack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t sent_pkt, void *phy_setup) {
@@ -152,7 +428,12 @@ rdt3_0_ack_t rdt3_0_process_ack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t sent_
     lora_pkt_t * lora_ack_pkt = (lora_pkt_t*)ack_pkt;
     uint16_t packet_ID;
     lwqms_pkt_t processed_ack_pkt;
-    lwqms_pkt_decode(lora_ack_pkt->buf, lora_ack_pkt->len, &processed_ack_pkt);
+
+    // A damaged frame may as well be another node's packet as the ACK, so it says nothing about this one's fate. Only an
+    // intact NACK shows the channel was clear; anything else backs off as a timeout would, in case it was a collision.
+    if (lora_ack_pkt->corrupted) return RDT3_0_ACK_NONE;
+
+    if (!lwqms_pkt_decode(lora_ack_pkt->buf, lora_ack_pkt->len, &processed_ack_pkt)) return RDT3_0_ACK_NONE;
 
     // Check the destination ID of the packet
     if (processed_ack_pkt.dest_id != (((node_config_t *)(lora_setup->node_config))->ID)) return RDT3_0_ACK_BAD_ID;
@@ -162,19 +443,84 @@ rdt3_0_ack_t rdt3_0_process_ack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t sent_
     if (ack_status == LWQMS_PKT_ACK_STATUS_NONE) return RDT3_0_ACK_ERR;
 
     // Check the packet ID was correct
-    lwqms_pkt_t sent_lora_packet;
+    lora_pkt_t *sent_lora_pkt = (lora_pkt_t *)sent_pkt;
     
-    if (!lwqms_pkt_decode(((lora_pkt_t *)sent_pkt)->buf, ((lora_pkt_t *)sent_pkt)->len, &sent_lora_packet)) return RDT3_0_ACK_ERR;
+    if (sent_lora_pkt->len < LWQMS_PKT_HEADER_LEN) return RDT3_0_ACK_ERR;
 
-    if (packet_ID != sent_lora_packet.pkt_id) return RDT3_0_ACK_BAD_ID;
+    if (packet_ID != lwqms_pkt_peek_id(sent_lora_pkt->buf)) return RDT3_0_ACK_BAD_ID;
 
     // Once everything is validated, check the ack/nack status.
     return ack_status == LWQMS_PKT_ACK_STATUS_ACK ? RDT3_0_ACK : RDT3_0_NACK;
 }
 
-rdt3_0_ack_t rdt3_0_process_data_packet_hal(rdt_packet_t received_pkt, rdt_packet_t ack_pkt, void *phy_setup) {
+bool rdt3_0_mark_window_pkt_hal(rdt_packet_t pkt, bool first_in_transfer, bool ack_request, void *phy_setup) {
+    lora_pkt_t *lora_pkt = (lora_pkt_t *)pkt;
+
+    if (lora_pkt->len < LWQMS_PKT_HEADER_LEN) return false;
+
+    // Flags are rewritten on every send: a packet that asked for the ACK last round may sit mid-window in the next.
+    // They are patched in the encoded packet where it lies, which is also the buffer handed to the radio.
+    uint8_t flags = LWQMS_PKT_FLAG_WINDOWED;
+    if (first_in_transfer) flags |= LWQMS_PKT_FLAG_SYNC;
+    if (ack_request) flags |= LWQMS_PKT_FLAG_ACK_REQUEST;
+
+    lwqms_pkt_set_flags(lora_pkt->buf, flags);
+
+    return true;
+}
+
+rdt3_0_ack_t rdt3_0_process_sack_pkt_hal(rdt_packet_t ack_pkt, rdt_packet_t window_pkts, size_t qty_pkts, size_t pkt_obj_size, uint16_t *acked_mask, void *phy_setup) {
+    lora_setup_t *lora_setup = (lora_setup_t*)phy_setup;
+    lora_pkt_t *lora_ack_pkt = (lora_pkt_t*)ack_pkt;
+    uint16_t packet_ID;
+    uint16_t cumulative_ID;
+    uint16_t bitmap;
+    lwqms_pkt_t processed_ack_pkt;
+
+    // A damaged reply ends the round like a lost one: nothing in it can be trusted to mark packets as received.
+    if (lora_ack_pkt->corrupted) return RDT3_0_ACK_NONE;
+
+    if (!lwqms_pkt_decode(lora_ack_pkt->buf, lora_ack_pkt->len, &processed_ack_pkt)) return RDT3_0_ACK_NONE;
+
+    // Check the destination ID of the packet
+    if (processed_ack_pkt.dest_id != (((node_config_t *)(lora_setup->node_config))->ID)) return RDT3_0_ACK_BAD_ID;
+
+    lwqms_pkt_ack_status_t ack_status = lwqms_pkt_check_ack(&processed_ack_pkt, &packet_ID);
     
-    // For now, this will just return an ACK... implement error checking at a later date!
+    if (ack_status == LWQMS_PKT_ACK_STATUS_NONE) return RDT3_0_ACK_ERR;
+
+    // A receiver without selective repeat support still acknowledges the packet that asked.
+    bool selective = lwqms_pkt_get_sack_window(&processed_ack_pkt, &cumulative_ID, &bitmap);
+    bool answers_window = false;
+    uint16_t newly_acked = 0;
+
+    for (size_t k = 0; k < qty_pkts; k++) {
+        lora_pkt_t *sent_pkt = (lora_pkt_t *)((uint8_t *)window_pkts + (k * pkt_obj_size));
+
+        if (sent_pkt->len < LWQMS_PKT_HEADER_LEN) return RDT3_0_ACK_ERR;
+
+        uint16_t sent_pkt_id = lwqms_pkt_peek_id(sent_pkt->buf);
+
+        if (sent_pkt_id == packet_ID) answers_window = true;
+
+        int16_t distance = (int16_t)(sent_pkt_id - cumulative_ID);
+
+        bool acked = (sent_pkt_id == packet_ID) || 
+                     (selective && ((distance <= 0) || ((distance <= RDT3_0_SR_BITMAP_WIDTH) && (bitmap & (1 << (distance - 1))))));
+        
+        if (acked) newly_acked |= (uint16_t)(1 << k);
+    }
+
+    if (!answers_window) return RDT3_0_ACK_BAD_ID;
+
+    if (ack_status != LWQMS_PKT_ACK_STATUS_ACK) return RDT3_0_NACK;
+
+    *acked_mask |= newly_acked;
+
+    return RDT3_0_ACK;
+}
+
+rdt3_0_ack_t rdt3_0_process_data_packet_hal(rdt_packet_t received_pkt, rdt_packet_t ack_pkt, void *phy_setup) {
 
     lora_setup_t * lora_setup = (lora_setup_t *)phy_setup;
 
@@ -186,14 +532,50 @@ rdt3_0_ack_t rdt3_0_process_data_packet_hal(rdt_packet_t received_pkt, rdt_packe
     lwqms_pkt_t processed_incoming_packet;
     lwqms_pkt_t outgoing_ack_pkt;
 
-    lwqms_pkt_decode(raw_received_pkt->buf, raw_received_pkt->len, &processed_incoming_packet);
+    if (!lwqms_pkt_decode(raw_received_pkt->buf, raw_received_pkt->len, &processed_incoming_packet)) return RDT3_0_ACK_BAD_ID;  // Too short to be addressed to anyone
 
     // Check the destination ID
     if (processed_incoming_packet.dest_id != (((node_config_t *)(lora_setup->node_config))->ID)) return RDT3_0_ACK_BAD_ID;
 
-    lwqms_generate_ack_packet(&processed_incoming_packet, LWQMS_PKT_ACK_STATUS_ACK, &outgoing_ack_pkt);
+    if (raw_received_pkt->corrupted) {
+        // The header came through damaged as well, but if it still names this receiver the sender is most likely listening
+        // for an ACK, and a NACK gets the packet resent straight away. If the ID was hit, the sender ignores the NACK and
+        // times out as it would have anyway. A window's sender is still transmitting, so it learns from the selective ACK.
+        if (processed_incoming_packet.packet_type & LWQMS_PKT_FLAG_WINDOWED) return RDT3_0_ACK_BAD_ID;
+
+        lwqms_generate_ack_packet(&processed_incoming_packet, LWQMS_PKT_ACK_STATUS_NACK, &outgoing_ack_pkt);
+
+        lwqms_pkt_encode(&outgoing_ack_pkt, raw_pkt_out->buf, LWQMS_PKT_LEN_MAX);
+
+        return RDT3_0_NACK;
+    }
+
+    // Note the packet in the sender's sequence, so that a copy resent after a lost ACK is acknowledged but not delivered again.
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    rdt3_0_sr_rx_state_t *state = sr_rx_state_for(processed_incoming_packet.src_id, processed_incoming_packet.pkt_id, now_ms);
+
+    bool windowed = (processed_incoming_packet.packet_type & LWQMS_PKT_FLAG_WINDOWED) > 0;
+
+    state->last_heard_ms = now_ms;
+    bool is_new = sr_rx_record(state, processed_incoming_packet.pkt_id, (processed_incoming_packet.packet_type & LWQMS_PKT_FLAG_SYNC) > 0, windowed);
+
+    // Stop-and-wait: every packet is acknowledged on its own.
+    if (!windowed) {
+        lwqms_generate_ack_packet(&processed_incoming_packet, LWQMS_PKT_ACK_STATUS_ACK, &outgoing_ack_pkt);
     
+        lwqms_pkt_encode(&outgoing_ack_pkt, raw_pkt_out->buf, LWQMS_PKT_LEN_MAX);
+
+        return is_new ? RDT3_0_ACK : RDT3_0_ACK_DUPLICATE;
+    }
+
+    // Selective repeat: answer for the whole transfer once the sender asks.
+    if (!(processed_incoming_packet.packet_type & LWQMS_PKT_FLAG_ACK_REQUEST)) {
+        return is_new ? RDT3_0_ACK_DEFERRED : RDT3_0_ACK_DUPLICATE_DEFERRED;
+    }
+
+    lwqms_generate_sack_packet(&processed_incoming_packet, state->cumulative_id, state->bitmap, &outgoing_ack_pkt);
+
     lwqms_pkt_encode(&outgoing_ack_pkt, raw_pkt_out->buf, LWQMS_PKT_LEN_MAX);
 
-    return RDT3_0_ACK;
+    return is_new ? RDT3_0_ACK : RDT3_0_ACK_DUPLICATE;
 }
\ No newline at end of file
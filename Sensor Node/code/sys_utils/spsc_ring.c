@@ -0,0 +1,75 @@
+/*************************************************************************************
+ *
+ * @file spsc_ring.c
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer, for handing objects from one core to the other
+ *
+ * @author Matthew Sharp
+ *
+ * @remark Penn State Harrisburg Electrical Engineering Senior Capstone Design Course, Fall 2025
+ *
+ * ************************************************************************************/
+
+#include "spsc_ring.h"
+
+#include <string.h>
+
+bool spsc_ring_init(spsc_ring_t *ring, void *storage, size_t obj_size, uint32_t capacity) {
+    if ((capacity == 0) || ((capacity & (capacity - 1)) != 0)) return false;
+
+    ring->storage = (uint8_t *)storage;
+    ring->obj_size = obj_size;
+    ring->mask = capacity - 1;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->overflows, 0);
+    atomic_init(&ring->high_water, 0);
+
+    return true;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *obj) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Acquire: the consumer has finished copying out of the slot before it gave it back.
+    uint32_t waiting = head - atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (waiting > ring->mask) {
+        atomic_store_explicit(&ring->overflows, atomic_load_explicit(&ring->overflows, memory_order_relaxed) + 1, memory_order_relaxed);
+        return false;
+    }
+
+    memcpy(ring->storage + ((head & ring->mask) * ring->obj_size), obj, ring->obj_size);
+
+    // Release: the object is in place before the consumer can see the new head.
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    if (waiting + 1 > atomic_load_explicit(&ring->high_water, memory_order_relaxed)) {
+        atomic_store_explicit(&ring->high_water, waiting + 1, memory_order_relaxed);
+    }
+
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *ring, void *obj) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // Acquire: pairs with the producer's release, so the object is complete.
+    if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) return false;
+
+    memcpy(obj, ring->storage + ((tail & ring->mask) * ring->obj_size), ring->obj_size);
+
+    // Release: the copy is finished before the producer may reuse the slot.
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+uint32_t spsc_ring_count(spsc_ring_t *ring) {
+    return atomic_load_explicit(&ring->head, memory_order_acquire) - atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
+
+uint32_t spsc_ring_overflows(spsc_ring_t *ring) {
+    return atomic_load_explicit(&ring->overflows, memory_order_relaxed);
+}
@@ -74,8 +74,8 @@ int initialize_gpio() {
         
             if (spi_init_hal(&context_spi_0) < 0) break;
             sx126x_initialize_hardware_context(&context_radio_0);
+            sx126x_interrupt_setup(&context_radio_0);   // First, so the setup already sleeps on the BUSY line
             sx126x_radio_setup(&context_radio_0);
-            sx126x_interrupt_setup(&context_radio_0);
 
             // Initialize the SPI flash chip
             gpio_setup_hal(context_flash_0.cs, true);
@@ -208,6 +208,54 @@ int write_system_config_data(mxl23l3233f_context_t * flash_context, node_config_
 
 }
 
+int telemetry_backlog_append(mxl23l3233f_context_t * flash_context, uint8_t index, lwqms_telemetry_t * sample) {
+
+    if ((index + 1) * sizeof(lwqms_telemetry_t) > FLASH_SECTOR_SIZE) return -1;
+
+    uint32_t address = FLASH_ADDR_TELEMETRY_BACKLOG + (index * sizeof(lwqms_telemetry_t));
+
+    bool sample_write_ok = false;
+
+    for (int k = 0; k < COMMS_RETRIES; k++) {
+        do {
+            // A new backlog starts on a freshly erased sector; every later sample programs erased bytes after it.
+            if ((index == 0) && (mxl23l3233f_erase_sector(flash_context, FLASH_ADDR_TELEMETRY_BACKLOG / FLASH_SECTOR_SIZE) < 0)) break;
+
+            uint8_t txBuf[sizeof(lwqms_telemetry_t)];
+            memcpy(txBuf, sample, sizeof(lwqms_telemetry_t));
+
+            if (mxl23l3233f_write_data(flash_context, txBuf, sizeof(lwqms_telemetry_t), address) < 0) break;
+
+            // Check that the sample was written by reading it back.
+            uint8_t rxBuf[sizeof(lwqms_telemetry_t)];
+            if (mxl23l3233f_read_data(flash_context, rxBuf, sizeof(lwqms_telemetry_t), address) < 0) break;
+
+            if (memcmp(rxBuf, txBuf, sizeof(lwqms_telemetry_t)) != 0) break;
+
+            sample_write_ok = true;
+        } while (0);
+
+        if (sample_write_ok) {
+            return 0;
+        }
+    }
+
+    err_raise(ERR_SPI_TRANSACTION_FAIL, ERR_SEV_NONFATAL, "Failed to save sample to the telemetry backlog!", "telemetry_backlog_append");
+
+    return -2;
+}
+
+int telemetry_backlog_read(mxl23l3233f_context_t * flash_context, lwqms_telemetry_t * samples, uint8_t qty_samples) {
+
+    if (qty_samples * sizeof(lwqms_telemetry_t) > FLASH_SECTOR_SIZE) return -1;
+
+    for (int k = 0; k < COMMS_RETRIES; k++) {
+        if (mxl23l3233f_read_data(flash_context, (uint8_t *)samples, qty_samples * sizeof(lwqms_telemetry_t), FLASH_ADDR_TELEMETRY_BACKLOG) == 0) return 0;
+    }
+
+    return -2;
+}
+
 node_config_t get_setup_data() {
 
     config_start:
@@ -525,11 +573,11 @@ lwqms_post_err_codes_t power_on_self_test() {
 
         // 3. Initialize the radio
         printf("Testing Communication with Radio...");
+        sx126x_interrupt_setup(&context_radio_0);
         if (sx126x_radio_setup(&context_radio_0) != SX126X_STATUS_OK) {
             return_code = POST_ERR_RADIO_INIT_FAIL;
             break;
         }
-        sx126x_interrupt_setup(&context_radio_0);
         printf("DONE\n");
 
 
@@ -212,7 +212,8 @@ int main()
                 &prototyping_irq_masks,
                 &prototyping_pkt_params,
                 txBuf,
-                strnlen(txBuf, 50)
+                strnlen(txBuf, 50),
+                LORA_TIMEOUT_MS
         );
 
         usb_console_write_hal("DONE\n");